@@ -415,6 +415,15 @@ public:
 	bool HasGpuBuffer() const
 	{ return (m_gpuPhysMem != nullptr); }
 
+	/**
+		@brief Returns true if a Vulkan device exists to hold GPU-side buffers
+
+		When running without Vulkan (headless / CPU-only mode) all buffers are plain CPU memory and GPU access hints
+		are ignored.
+	 */
+	static bool HasGpu()
+	{ return (g_vkComputeDevice != nullptr); }
+
 	/**
 		@brief Returns true if the object contains only a single buffer
 	 */
@@ -496,6 +505,52 @@ public:
 			Reallocate(m_size);
 	}
 
+	/**
+		@brief Replaces our content with a region of a file, mapped copy-on-write (MEM_TYPE_CPU_PAGED)
+
+		No data is read up front: pages are faulted in from the file by the OS as they are touched, and modified pages
+		are private to this buffer so the file is never written. The mapping is released like any other paged
+		buffer when the buffer is freed or reallocated. The buffer is marked as not needing GPU access, but will be
+		moved to pinned memory automatically the first time PrepareForGpuAccess() is called.
+
+		@param fd		File descriptor to map from. The mapping holds its own reference, so this can be closed
+						as soon as the call returns.
+		@param offset	Byte offset of the data within the file. Must be a multiple of the system page size.
+		@param count	Number of elements to map
+
+		@return True on success, false if the region could not be mapped (in which case the buffer is unchanged).
+				Always fails on Windows and for non-trivially-copyable types.
+	 */
+	__attribute__((noinline))
+	bool AdoptFileRegion([[maybe_unused]] int fd, [[maybe_unused]] size_t offset, [[maybe_unused]] size_t count)
+	{
+		#ifdef _WIN32
+			return false;
+		#else
+			if(!std::is_trivially_copyable<T>::value || (count == 0) )
+				return false;
+
+			void* ptr = mmap(nullptr, count * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset);
+			if(ptr == MAP_FAILED)
+				return false;
+
+			//Discard whatever we had before
+			FreeGpuBuffer(true);
+			FreeCpuBuffer();
+
+			m_cpuPtr = reinterpret_cast<T*>(ptr);
+			m_cpuMemoryType = MEM_TYPE_CPU_PAGED;
+			m_tempFileHandle = -1;
+			m_capacity = count;
+			m_size = count;
+			m_cpuPhysMemIsStale = false;
+			m_gpuPhysMemIsStale = false;
+			m_cpuAccessHint = HINT_UNLIKELY;
+			m_gpuAccessHint = HINT_NEVER;
+			return true;
+		#endif
+	}
+
 	/**
 		@brief Copies our content from a std::vector
 	 */
@@ -620,7 +675,7 @@ protected:
 		//If we do not anticipate using the data on the CPU, we shouldn't waste RAM.
 		//Allocate a GPU-local buffer, copy data to it, then free the CPU-side buffer
 		//Don't do this if the platform has unified memory
-		if( (m_cpuAccessHint == HINT_NEVER) && !g_vulkanDeviceHasUnifiedMemory)
+		if( (m_cpuAccessHint == HINT_NEVER) && !g_vulkanDeviceHasUnifiedMemory && HasGpu())
 		{
 			PrepareForGpuAccess();
 			FreeCpuBuffer();
@@ -686,7 +741,7 @@ protected:
 		}
 
 		//We're expecting to use data on the GPU, so prepare to do stuff with it
-		if(m_gpuAccessHint != HINT_NEVER)
+		if( (m_gpuAccessHint != HINT_NEVER) && HasGpu() )
 		{
 			//If GPU access is unlikely, we probably want to just use pinned memory.
 			//If available, mark buffers as the same, and free any existing GPU buffer we might have
@@ -956,7 +1011,7 @@ public:
 	 */
 	void MarkModifiedFromGpu()
 	{
-		if(!m_buffersAreSame)
+		if(!m_buffersAreSame && HasGpu())
 			m_cpuPhysMemIsStale = true;
 	}
 
@@ -1033,8 +1088,8 @@ public:
 	 */
 	void PrepareForGpuAccess(bool outputOnly = false)
 	{
-		//Early out if no content or if unified memory
-		if(m_size == 0 || g_vulkanDeviceHasUnifiedMemory)
+		//Early out if no content, unified memory, or no GPU at all
+		if(m_size == 0 || g_vulkanDeviceHasUnifiedMemory || !HasGpu())
 			return;
 
 		//If our current hint has no GPU access at all, update to say "unlikely" and reallocate
@@ -1063,8 +1118,8 @@ public:
 	 */
 	void PrepareForGpuAccessNonblocking(bool outputOnly, vk::raii::CommandBuffer& cmdBuf)
 	{
-		//Early out if no content or if unified memory
-		if(m_size == 0 || g_vulkanDeviceHasUnifiedMemory)
+		//Early out if no content, unified memory, or no GPU at all
+		if(m_size == 0 || g_vulkanDeviceHasUnifiedMemory || !HasGpu())
 			return;
 
 		//If our current hint has no GPU access at all, update to say "unlikely" and reallocate
@@ -1286,7 +1341,7 @@ protected:
 			LogFatal("AllocateCpuBuffer with size zero (invalid)\n");
 
 		//If any GPU access is expected, use pinned memory so we don't have to move things around
-		if(m_gpuAccessHint != HINT_NEVER)
+		if( (m_gpuAccessHint != HINT_NEVER) && HasGpu() )
 		{
 			//Make a Vulkan buffer first
 			vk::BufferCreateInfo bufinfo(
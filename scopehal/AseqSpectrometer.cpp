@@ -358,9 +358,7 @@ bool AseqSpectrometer::AcquireData()
 	m_channels[0]->SetYAxisUnits(Unit::UNIT_W_M2_NM, AseqSpectrometerChannel::STREAM_ABSOLUTE_IRRADIANCE);
 
 	//Save the waveforms to our queue
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(s);
-	m_pendingWaveformsMutex.unlock();
+	PushPendingWaveform(s);
 
 	//Done, clean up
 	delete[] buf;
@@ -0,0 +1,187 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of AsyncFileWriter
+	@ingroup core
+ */
+
+#include "log.h"
+#include "AsyncFileWriter.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Construction / destruction
+
+/**
+	@brief Creates the writer and starts its thread
+
+	@param maxPending	Number of buffers which may be waiting to be written before Write() blocks the caller
+ */
+AsyncFileWriter::AsyncFileWriter(size_t maxPending)
+	: m_maxPending(maxPending)
+	, m_busy(false)
+	, m_terminating(false)
+	, m_error(false)
+{
+	m_thread = thread(&AsyncFileWriter::WriterThread, this);
+}
+
+/**
+	@brief Finishes all pending requests, then stops the thread
+ */
+AsyncFileWriter::~AsyncFileWriter()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_terminating = true;
+	}
+	m_requestCvar.notify_one();
+	m_thread.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Request submission
+
+/**
+	@brief Gets an empty buffer to format output into
+
+	Buffers passed to Write() are recycled once written, so steady-state exports don't allocate.
+ */
+vector<char> AsyncFileWriter::GetBuffer()
+{
+	vector<char> ret;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if(!m_freeBuffers.empty())
+		{
+			ret = std::move(m_freeBuffers.back());
+			m_freeBuffers.pop_back();
+		}
+	}
+
+	ret.clear();
+	ret.reserve(BUFFER_SIZE);
+	return ret;
+}
+
+/**
+	@brief Queues a buffer to be written to a file
+
+	Blocks if the writer is already more than maxPending buffers behind.
+
+	@param fp	File to write to
+	@param buf	Data to write
+ */
+void AsyncFileWriter::Write(FILE* fp, vector<char>&& buf)
+{
+	if(buf.empty())
+		return;
+
+	{
+		unique_lock<mutex> lock(m_mutex);
+		m_completionCvar.wait(lock, [&]{ return m_queue.size() < m_maxPending; });
+		m_queue.push_back(Request{fp, std::move(buf), false});
+	}
+	m_requestCvar.notify_one();
+}
+
+/**
+	@brief Queues a file to be closed once all previously queued writes to it are complete
+
+	The caller must not use the file handle after calling this function.
+ */
+void AsyncFileWriter::Close(FILE* fp)
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_queue.push_back(Request{fp, vector<char>(), true});
+	}
+	m_requestCvar.notify_one();
+}
+
+/**
+	@brief Blocks until all queued requests have completed
+ */
+void AsyncFileWriter::Flush()
+{
+	unique_lock<mutex> lock(m_mutex);
+	m_completionCvar.wait(lock, [&]{ return m_queue.empty() && !m_busy; });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Writer thread
+
+void AsyncFileWriter::WriterThread()
+{
+	#ifdef __linux__
+	pthread_setname_np(pthread_self(), "AsyncFileWriter");
+	#endif
+
+	while(true)
+	{
+		//Wait for a request
+		Request req;
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_requestCvar.wait(lock, [&]{ return !m_queue.empty() || m_terminating; });
+			if(m_queue.empty())
+				break;
+
+			req = std::move(m_queue.front());
+			m_queue.pop_front();
+			m_busy = true;
+		}
+
+		//Process it without holding the lock
+		if(req.m_close)
+			fclose(req.m_fp);
+		else if(req.m_data.size() != fwrite(req.m_data.data(), 1, req.m_data.size(), req.m_fp))
+		{
+			LogError("AsyncFileWriter: write failed\n");
+			m_error = true;
+		}
+
+		//Done, recycle the buffer
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_busy = false;
+			if(req.m_data.capacity() && (m_freeBuffers.size() < m_maxPending) )
+				m_freeBuffers.push_back(std::move(req.m_data));
+		}
+		m_completionCvar.notify_all();
+	}
+}
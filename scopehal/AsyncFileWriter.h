@@ -0,0 +1,131 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of AsyncFileWriter
+	@ingroup core
+ */
+
+#ifndef AsyncFileWriter_h
+#define AsyncFileWriter_h
+
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+	@brief Writes buffers to files from a dedicated background thread
+
+	Export filters format output into large memory buffers and hand each completed buffer to Write(), so the filter
+	graph thread never blocks on disk I/O unless the writer falls more than a fixed number of buffers behind.
+
+	Requests are processed strictly in order, so a Close() queued after a series of Write() calls to the same file
+	happens once all of the data has been written.
+	@ingroup core
+ */
+class AsyncFileWriter
+{
+public:
+	AsyncFileWriter(size_t maxPending = 8);
+	~AsyncFileWriter();
+
+	AsyncFileWriter(const AsyncFileWriter&) = delete;
+	AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+	std::vector<char> GetBuffer();
+	void Write(FILE* fp, std::vector<char>&& buf);
+	void Close(FILE* fp);
+	void Flush();
+
+	/**
+		@brief Checks if any write failed since the last call, and clears the error flag
+	 */
+	bool GetAndClearError()
+	{ return m_error.exchange(false); }
+
+	///@brief Size of buffers returned by GetBuffer()
+	static const size_t BUFFER_SIZE = 4 * 1024 * 1024;
+
+protected:
+	void WriterThread();
+
+	/**
+		@brief A single queued operation
+	 */
+	class Request
+	{
+	public:
+		///@brief File to operate on
+		FILE* m_fp;
+
+		///@brief Data to write
+		std::vector<char> m_data;
+
+		///@brief True to close the file rather than writing to it
+		bool m_close;
+	};
+
+	///@brief Mutex protecting the queues and m_busy
+	std::mutex m_mutex;
+
+	///@brief Signaled when a request is queued, or on shutdown
+	std::condition_variable m_requestCvar;
+
+	///@brief Signaled when a request completes
+	std::condition_variable m_completionCvar;
+
+	///@brief Pending requests, oldest first
+	std::deque<Request> m_queue;
+
+	///@brief Buffers which have been written and can be reused
+	std::vector<std::vector<char>> m_freeBuffers;
+
+	///@brief Maximum number of write requests which may be queued before Write() blocks
+	size_t m_maxPending;
+
+	///@brief True while the writer thread is processing a request it has removed from the queue
+	bool m_busy;
+
+	///@brief True when the writer thread should exit
+	bool m_terminating;
+
+	///@brief Set if a write has failed
+	std::atomic<bool> m_error;
+
+	///@brief The writer thread
+	std::thread m_thread;
+};
+
+#endif
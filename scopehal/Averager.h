@@ -59,6 +59,13 @@ public:
 	{
 		AssertTypeIsAnalogWaveform(wfm);
 
+		//No GPU available, do it all on the CPU
+		if(!g_gpuFilterEnabled)
+		{
+			wfm->PrepareForCpuAccess();
+			return Filter::GetAvgVoltage(wfm);
+		}
+
 		//This value experimentally gives the best speedup for an NVIDIA 2080 Ti vs an Intel Xeon Gold 6144
 		//Maybe consider dynamic tuning in the future at initialization?
 		const uint64_t numThreads = 16384;
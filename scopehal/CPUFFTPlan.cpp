@@ -0,0 +1,665 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CPUFFTPlan
+
+	@ingroup core
+ */
+#include "scopehal.h"
+#include "CPUFFTPlan.h"
+#include <omp.h>
+
+using namespace std;
+
+mutex CPUFFTPlan::m_tableCacheMutex;
+map<pair<size_t, bool>, weak_ptr<const CPUFFTPlan::Tables> > CPUFFTPlan::m_tableCache;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Construction / destruction
+
+/**
+	@brief Creates a new CPU FFT plan
+
+	@param npoints			Number of points in the FFT
+	@param nouts			Number of output samples
+	@param dir				Direction (forward or reverse)
+	@param numBatches		Number of batched FFTs to perform (for spectrograms etc)
+	@param timeDomainType	Data type of the time-domain signal (real or complex)
+ */
+CPUFFTPlan::CPUFFTPlan(
+	size_t npoints,
+	size_t nouts,
+	FFTPlanDirection dir,
+	size_t numBatches,
+	FFTDataType timeDomainType)
+	: FFTPlan(npoints, nouts, dir, numBatches, timeDomainType)
+	, m_packedReal( (timeDomainType == TYPE_REAL) && (npoints >= 2) && ((npoints & 1) == 0) )
+{
+	bool inverse = (dir == DIRECTION_REVERSE);
+	if(m_packedReal)
+	{
+		m_tables = GetTables(npoints / 2, inverse);
+
+		size_t half = npoints / 2;
+		m_splitRe.resize(half + 1);
+		m_splitIm.resize(half + 1);
+		for(size_t k=0; k<=half; k++)
+		{
+			double theta = -2 * M_PI * k / npoints;
+			m_splitRe[k] = cos(theta);
+			m_splitIm[k] = sin(theta);
+		}
+	}
+	else if(npoints > 0)
+		m_tables = GetTables(npoints, inverse);
+}
+
+CPUFFTPlan::~CPUFFTPlan()
+{
+}
+
+/**
+	@brief Computes twiddle (and, if needed, Bluestein chirp) tables for a complex transform
+
+	@param n		Transform length
+	@param inverse	True for an inverse transform
+ */
+CPUFFTPlan::Tables::Tables(size_t n, bool inverse)
+	: m_size(n)
+	, m_inverse(inverse)
+	, m_pow2( (n & (n-1)) == 0 )
+	, m_paddedSize(0)
+{
+	double sign = inverse ? 1 : -1;
+
+	if(m_pow2)
+	{
+		m_twiddleRe.resize(n/2);
+		m_twiddleIm.resize(n/2);
+		for(size_t k=0; k<n/2; k++)
+		{
+			double theta = sign * 2 * M_PI * k / n;
+			m_twiddleRe[k] = cos(theta);
+			m_twiddleIm[k] = sin(theta);
+		}
+		return;
+	}
+
+	//Bluestein: X_k = c_k * sum_j (x_j * c_j) * conj(c_{k-j}), with c_k = exp(sign * i * pi * k^2 / n).
+	//Evaluate the convolution as a power-of-two circular convolution of length >= 2n-1.
+	m_paddedSize = 1;
+	while(m_paddedSize < 2*n - 1)
+		m_paddedSize <<= 1;
+
+	m_paddedForward = GetTables(m_paddedSize, false);
+	m_paddedInverse = GetTables(m_paddedSize, true);
+
+	m_chirpRe.resize(n);
+	m_chirpIm.resize(n);
+	for(size_t k=0; k<n; k++)
+	{
+		//Reduce k^2 mod 2n in integer arithmetic to keep the angle small and precise
+		uint64_t ksq = (static_cast<uint64_t>(k) * k) % (2*n);
+		double theta = sign * M_PI * ksq / n;
+		m_chirpRe[k] = cos(theta);
+		m_chirpIm[k] = sin(theta);
+	}
+
+	m_kernelRe.resize(m_paddedSize, 0);
+	m_kernelIm.resize(m_paddedSize, 0);
+	m_kernelRe[0] = m_chirpRe[0];
+	m_kernelIm[0] = -m_chirpIm[0];
+	for(size_t k=1; k<n; k++)
+	{
+		m_kernelRe[k] = m_kernelRe[m_paddedSize - k] = m_chirpRe[k];
+		m_kernelIm[k] = m_kernelIm[m_paddedSize - k] = -m_chirpIm[k];
+	}
+
+	vector<float> tre(m_paddedSize);
+	vector<float> tim(m_paddedSize);
+	TransformPow2(*m_paddedForward, m_kernelRe.data(), m_kernelIm.data(), tre.data(), tim.data(), true);
+
+	float scale = 1.0f / m_paddedSize;
+	for(size_t k=0; k<m_paddedSize; k++)
+	{
+		m_kernelRe[k] *= scale;
+		m_kernelIm[k] *= scale;
+	}
+}
+
+/**
+	@brief Gets the shared tables for a given size and direction, creating them if needed
+ */
+shared_ptr<const CPUFFTPlan::Tables> CPUFFTPlan::GetTables(size_t n, bool inverse)
+{
+	auto key = make_pair(n, inverse);
+	{
+		lock_guard<mutex> lock(m_tableCacheMutex);
+		auto it = m_tableCache.find(key);
+		if(it != m_tableCache.end())
+		{
+			auto tables = it->second.lock();
+			if(tables)
+				return tables;
+		}
+	}
+
+	//Build outside the lock since Bluestein tables recursively request power-of-two ones
+	auto tables = make_shared<const Tables>(n, inverse);
+
+	lock_guard<mutex> lock(m_tableCacheMutex);
+	auto& slot = m_tableCache[key];
+	auto existing = slot.lock();
+	if(existing)
+		return existing;
+	slot = tables;
+
+	//Drop entries whose plans have all been destroyed
+	for(auto it = m_tableCache.begin(); it != m_tableCache.end(); )
+	{
+		if(it->second.expired())
+			it = m_tableCache.erase(it);
+		else
+			++it;
+	}
+
+	return tables;
+}
+
+/**
+	@brief Makes sure the workspace is large enough for a transform
+
+	@param n		Complex transform length
+	@param padded	Bluestein convolution length, or zero for power-of-two transforms
+ */
+void CPUFFTPlan::Workspace::Reserve(size_t n, size_t padded)
+{
+	if(m_re.size() < n)
+	{
+		m_re.resize(n);
+		m_im.resize(n);
+	}
+	if(m_bluesteinRe.size() < padded)
+	{
+		m_bluesteinRe.resize(padded);
+		m_bluesteinIm.resize(padded);
+	}
+	size_t ntemp = max(n, padded);
+	if(m_tempRe.size() < ntemp)
+	{
+		m_tempRe.resize(ntemp);
+		m_tempIm.resize(ntemp);
+	}
+}
+
+/**
+	@brief Returns the calling thread's workspace
+ */
+CPUFFTPlan::Workspace& CPUFFTPlan::GetWorkspace()
+{
+	static thread_local Workspace ws;
+	return ws;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Execution
+
+void CPUFFTPlan::AppendForward(
+	AcceleratorBuffer<float>& dataIn,
+	AcceleratorBuffer<float>& dataOut,
+	vk::raii::CommandBuffer& /*cmdBuf*/)
+{
+	size_t inlen = m_size * m_numBatches * ((m_timeDomainType == TYPE_COMPLEX) ? 2 : 1);
+	size_t outlen = m_nouts * 2 * m_numBatches;
+	if( (dataIn.size() < inlen) || (dataOut.size() < outlen) )
+	{
+		LogError("CPUFFTPlan::AppendForward: buffers too small (in %zu/%zu, out %zu/%zu)\n",
+			dataIn.size(), inlen, dataOut.size(), outlen);
+		return;
+	}
+
+	dataIn.PrepareForCpuAccess();
+	dataOut.PrepareForCpuAccess();
+	Forward(dataIn.GetCpuPointer(), dataOut.GetCpuPointer());
+	dataOut.MarkModifiedFromCpu();
+}
+
+void CPUFFTPlan::AppendReverse(
+	AcceleratorBuffer<float>& dataIn,
+	AcceleratorBuffer<float>& dataOut,
+	vk::raii::CommandBuffer& /*cmdBuf*/)
+{
+	size_t inlen = m_nouts * 2 * m_numBatches;
+	size_t outlen = m_size * m_numBatches * ((m_timeDomainType == TYPE_COMPLEX) ? 2 : 1);
+	if( (dataIn.size() < inlen) || (dataOut.size() < outlen) )
+	{
+		LogError("CPUFFTPlan::AppendReverse: buffers too small (in %zu/%zu, out %zu/%zu)\n",
+			dataIn.size(), inlen, dataOut.size(), outlen);
+		return;
+	}
+
+	dataIn.PrepareForCpuAccess();
+	dataOut.PrepareForCpuAccess();
+	Reverse(dataIn.GetCpuPointer(), dataOut.GetCpuPointer());
+	dataOut.MarkModifiedFromCpu();
+}
+
+/**
+	@brief Runs all batches of a forward transform
+
+	@param dataIn	Time domain input (m_numBatches blocks of m_size real or complex samples)
+	@param dataOut	Frequency domain output (m_numBatches blocks of m_nouts complex samples)
+ */
+void CPUFFTPlan::Forward(const float* dataIn, float* dataOut)
+{
+	size_t instride = m_size * ((m_timeDomainType == TYPE_COMPLEX) ? 2 : 1);
+	size_t outstride = m_nouts * 2;
+
+	if(m_numBatches == 1)
+		ForwardBlock(dataIn, dataOut, true);
+	else
+	{
+		#pragma omp parallel for
+		for(size_t i=0; i<m_numBatches; i++)
+			ForwardBlock(dataIn + i*instride, dataOut + i*outstride, false);
+	}
+}
+
+/**
+	@brief Runs all batches of an inverse transform
+
+	@param dataIn	Frequency domain input (m_numBatches blocks of m_nouts complex samples)
+	@param dataOut	Time domain output (m_numBatches blocks of m_size real or complex samples)
+ */
+void CPUFFTPlan::Reverse(const float* dataIn, float* dataOut)
+{
+	size_t instride = m_nouts * 2;
+	size_t outstride = m_size * ((m_timeDomainType == TYPE_COMPLEX) ? 2 : 1);
+
+	if(m_numBatches == 1)
+		ReverseBlock(dataIn, dataOut, true);
+	else
+	{
+		#pragma omp parallel for
+		for(size_t i=0; i<m_numBatches; i++)
+			ReverseBlock(dataIn + i*instride, dataOut + i*outstride, false);
+	}
+}
+
+/**
+	@brief Forward transform of a single block
+
+	@param dataIn	Time domain input
+	@param dataOut	Frequency domain output
+	@param parallel	True to parallelize within the transform
+ */
+void CPUFFTPlan::ForwardBlock(const float* dataIn, float* dataOut, bool parallel)
+{
+	size_t nbins = 0;
+	if(m_tables)
+	{
+		auto& ws = GetWorkspace();
+		ws.Reserve(m_tables->m_size, m_tables->m_paddedSize);
+		float* re = ws.m_re.data();
+		float* im = ws.m_im.data();
+
+		if(m_packedReal)
+		{
+			//Treat even/odd samples as the real/imaginary parts of a half-length complex signal
+			size_t half = m_size / 2;
+			for(size_t i=0; i<half; i++)
+			{
+				re[i] = dataIn[i*2];
+				im[i] = dataIn[i*2 + 1];
+			}
+
+			TransformComplex(*m_tables, re, im, ws, parallel);
+
+			//Split into the spectra of the even and odd samples, then combine
+			nbins = min(m_nouts, half + 1);
+			for(size_t k=0; k<nbins; k++)
+			{
+				size_t k1 = (k == half) ? 0 : k;
+				size_t k2 = (k == 0) ? 0 : half - k;
+
+				float zr = re[k1];
+				float zi = im[k1];
+				float cr = re[k2];
+				float ci = -im[k2];
+
+				float er = (zr + cr) * 0.5f;
+				float ei = (zi + ci) * 0.5f;
+				float or_ = (zi - ci) * 0.5f;
+				float oi = (cr - zr) * 0.5f;
+
+				float wr = m_splitRe[k];
+				float wi = m_splitIm[k];
+				dataOut[k*2]		= er + wr*or_ - wi*oi;
+				dataOut[k*2 + 1]	= ei + wr*oi + wi*or_;
+			}
+		}
+
+		else
+		{
+			if(m_timeDomainType == TYPE_COMPLEX)
+			{
+				for(size_t i=0; i<m_size; i++)
+				{
+					re[i] = dataIn[i*2];
+					im[i] = dataIn[i*2 + 1];
+				}
+			}
+			else
+			{
+				for(size_t i=0; i<m_size; i++)
+				{
+					re[i] = dataIn[i];
+					im[i] = 0;
+				}
+			}
+
+			TransformComplex(*m_tables, re, im, ws, parallel);
+
+			nbins = min(m_nouts, m_size);
+			for(size_t k=0; k<nbins; k++)
+			{
+				dataOut[k*2]		= re[k];
+				dataOut[k*2 + 1]	= im[k];
+			}
+		}
+	}
+
+	for(size_t k=nbins; k<m_nouts; k++)
+	{
+		dataOut[k*2]		= 0;
+		dataOut[k*2 + 1]	= 0;
+	}
+}
+
+/**
+	@brief Inverse transform of a single block
+
+	@param dataIn	Frequency domain input
+	@param dataOut	Time domain output
+	@param parallel	True to parallelize within the transform
+ */
+void CPUFFTPlan::ReverseBlock(const float* dataIn, float* dataOut, bool parallel)
+{
+	if(!m_tables)
+		return;
+
+	auto& ws = GetWorkspace();
+	ws.Reserve(m_tables->m_size, m_tables->m_paddedSize);
+	float* re = ws.m_re.data();
+	float* im = ws.m_im.data();
+
+	//Bins past the end of the input are treated as zero
+	auto binRe = [&](size_t k) { return (k < m_nouts) ? dataIn[k*2] : 0.0f; };
+	auto binIm = [&](size_t k) { return (k < m_nouts) ? dataIn[k*2 + 1] : 0.0f; };
+
+	if(m_packedReal)
+	{
+		//Merge the Hermitian half-spectrum into a half-length complex spectrum
+		size_t half = m_size / 2;
+		for(size_t k=0; k<half; k++)
+		{
+			float xr = binRe(k);
+			float xi = binIm(k);
+			float cr = binRe(half - k);
+			float ci = -binIm(half - k);
+
+			float er = xr + cr;
+			float ei = xi + ci;
+			float dr = xr - cr;
+			float di = xi - ci;
+
+			//Multiply by conj(W^k)
+			float wr = m_splitRe[k];
+			float wi = m_splitIm[k];
+			float or_ = dr*wr + di*wi;
+			float oi = di*wr - dr*wi;
+
+			re[k] = er - oi;
+			im[k] = ei + or_;
+		}
+
+		TransformComplex(*m_tables, re, im, ws, parallel);
+
+		for(size_t i=0; i<half; i++)
+		{
+			dataOut[i*2]		= re[i];
+			dataOut[i*2 + 1]	= im[i];
+		}
+	}
+
+	else if(m_timeDomainType == TYPE_COMPLEX)
+	{
+		for(size_t k=0; k<m_size; k++)
+		{
+			re[k] = binRe(k);
+			im[k] = binIm(k);
+		}
+
+		TransformComplex(*m_tables, re, im, ws, parallel);
+
+		for(size_t i=0; i<m_size; i++)
+		{
+			dataOut[i*2]		= re[i];
+			dataOut[i*2 + 1]	= im[i];
+		}
+	}
+
+	else
+	{
+		//Odd length real output: rebuild the full Hermitian spectrum
+		for(size_t k=0; k<m_size; k++)
+		{
+			if(k <= m_size/2)
+			{
+				re[k] = binRe(k);
+				im[k] = binIm(k);
+			}
+			else
+			{
+				re[k] = binRe(m_size - k);
+				im[k] = -binIm(m_size - k);
+			}
+		}
+
+		TransformComplex(*m_tables, re, im, ws, parallel);
+
+		for(size_t i=0; i<m_size; i++)
+			dataOut[i] = re[i];
+	}
+}
+
+/**
+	@brief In-place complex transform of any length
+
+	@param t		Tables for the transform
+	@param re		Real parts
+	@param im		Imaginary parts
+	@param ws		Scratch space
+	@param parallel	True to parallelize within the transform
+ */
+void CPUFFTPlan::TransformComplex(const Tables& t, float* re, float* im, Workspace& ws, bool parallel)
+{
+	if(t.m_pow2)
+	{
+		TransformPow2(t, re, im, ws.m_tempRe.data(), ws.m_tempIm.data(), parallel);
+		return;
+	}
+
+	size_t n = t.m_size;
+	size_t m = t.m_paddedSize;
+	float* __restrict br = ws.m_bluesteinRe.data();
+	float* __restrict bi = ws.m_bluesteinIm.data();
+	const float* __restrict cr = t.m_chirpRe.data();
+	const float* __restrict ci = t.m_chirpIm.data();
+
+	//Premultiply by the chirp and zero pad
+	for(size_t k=0; k<n; k++)
+	{
+		br[k] = re[k]*cr[k] - im[k]*ci[k];
+		bi[k] = re[k]*ci[k] + im[k]*cr[k];
+	}
+	for(size_t k=n; k<m; k++)
+	{
+		br[k] = 0;
+		bi[k] = 0;
+	}
+
+	//Circular convolution with the conjugate chirp
+	TransformPow2(*t.m_paddedForward, br, bi, ws.m_tempRe.data(), ws.m_tempIm.data(), parallel);
+
+	const float* __restrict kr = t.m_kernelRe.data();
+	const float* __restrict ki = t.m_kernelIm.data();
+	for(size_t k=0; k<m; k++)
+	{
+		float xr = br[k];
+		float xi = bi[k];
+		br[k] = xr*kr[k] - xi*ki[k];
+		bi[k] = xr*ki[k] + xi*kr[k];
+	}
+
+	TransformPow2(*t.m_paddedInverse, br, bi, ws.m_tempRe.data(), ws.m_tempIm.data(), parallel);
+
+	//Postmultiply by the chirp
+	for(size_t k=0; k<n; k++)
+	{
+		re[k] = br[k]*cr[k] - bi[k]*ci[k];
+		im[k] = br[k]*ci[k] + bi[k]*cr[k];
+	}
+}
+
+/**
+	@brief In-place radix-2 Stockham transform of a power-of-two length
+
+	Each stage reads from one buffer and writes to the other, so no bit reversal pass is needed.
+
+	@param t		Tables for the transform
+	@param re		Real parts
+	@param im		Imaginary parts
+	@param tre		Scratch buffer for real parts, same length as re
+	@param tim		Scratch buffer for imaginary parts, same length as im
+	@param parallel	True to parallelize large stages across threads
+ */
+void CPUFFTPlan::TransformPow2(const Tables& t, float* re, float* im, float* tre, float* tim, bool parallel)
+{
+	size_t n = t.m_size;
+	if(n <= 1)
+		return;
+
+	const float* tw_re = t.m_twiddleRe.data();
+	const float* tw_im = t.m_twiddleIm.data();
+	bool threaded = parallel && (n >= 65536) && !omp_in_parallel();
+
+	float* xr = re;
+	float* xi = im;
+	float* yr = tre;
+	float* yi = tim;
+
+	//Stage with span s combines x[q + s*p] and x[q + s*(p+half)] into y[q + s*2p] and y[q + s*(2p+1)]
+	size_t s = 1;
+	for(size_t len = n; len > 1; len >>= 1, s <<= 1)
+	{
+		size_t half = len / 2;
+
+		if(s < 16)
+		{
+			#pragma omp parallel for if(threaded)
+			for(size_t p=0; p<half; p++)
+			{
+				float wr = tw_re[p*s];
+				float wi = tw_im[p*s];
+				for(size_t q=0; q<s; q++)
+				{
+					float ar = xr[q + s*p];
+					float ai = xi[q + s*p];
+					float br = xr[q + s*(p+half)];
+					float bi = xi[q + s*(p+half)];
+					yr[q + s*2*p] = ar + br;
+					yi[q + s*2*p] = ai + bi;
+					float dr = ar - br;
+					float di = ai - bi;
+					yr[q + s*(2*p+1)] = dr*wr - di*wi;
+					yi[q + s*(2*p+1)] = dr*wi + di*wr;
+				}
+			}
+		}
+
+		else
+		{
+			//Long contiguous runs: split them into blocks so small-half stages still spread across threads
+			size_t qblock = min(s, static_cast<size_t>(4096));
+			size_t nq = s / qblock;
+			size_t nchunks = half * nq;
+
+			#pragma omp parallel for if(threaded)
+			for(size_t c=0; c<nchunks; c++)
+			{
+				size_t p = c / nq;
+				size_t q0 = (c % nq) * qblock;
+				float wr = tw_re[p*s];
+				float wi = tw_im[p*s];
+
+				const float* __restrict ar = xr + s*p + q0;
+				const float* __restrict ai = xi + s*p + q0;
+				const float* __restrict br = xr + s*(p+half) + q0;
+				const float* __restrict bi = xi + s*(p+half) + q0;
+				float* __restrict y0r = yr + s*2*p + q0;
+				float* __restrict y0i = yi + s*2*p + q0;
+				float* __restrict y1r = yr + s*(2*p+1) + q0;
+				float* __restrict y1i = yi + s*(2*p+1) + q0;
+
+				for(size_t q=0; q<qblock; q++)
+				{
+					y0r[q] = ar[q] + br[q];
+					y0i[q] = ai[q] + bi[q];
+					float dr = ar[q] - br[q];
+					float di = ai[q] - bi[q];
+					y1r[q] = dr*wr - di*wi;
+					y1i[q] = dr*wi + di*wr;
+				}
+			}
+		}
+
+		swap(xr, yr);
+		swap(xi, yi);
+	}
+
+	if(xr != re)
+	{
+		memcpy(re, xr, n * sizeof(float));
+		memcpy(im, xi, n * sizeof(float));
+	}
+}
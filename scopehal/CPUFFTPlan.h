@@ -0,0 +1,162 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CPUFFTPlan
+	@ingroup core
+ */
+#ifndef CPUFFTPlan_h
+#define CPUFFTPlan_h
+
+#include "FFTPlan.h"
+
+/**
+	@brief FFT plan executing on the CPU, for use when no GPU is available
+	@ingroup core
+
+	Power-of-two lengths use an iterative radix-2 Stockham transform on split real/imaginary arrays, structured so
+	the butterflies auto-vectorize. Other lengths (including odd ones) are converted to power-of-two convolutions with
+	Bluestein's algorithm. Real transforms of even length are done as a half-length complex transform.
+
+	Batched transforms are spread across threads with OpenMP; a single large transform parallelizes each butterfly
+	stage instead.
+
+	Twiddle and chirp tables are immutable and shared between all plans of the same size and direction.
+ */
+class CPUFFTPlan : public FFTPlan
+{
+public:
+	CPUFFTPlan(
+		size_t npoints,
+		size_t nouts,
+		FFTPlanDirection dir,
+		size_t numBatches = 1,
+		FFTDataType timeDomainType = TYPE_REAL);
+	virtual ~CPUFFTPlan();
+
+	virtual void AppendForward(
+		AcceleratorBuffer<float>& dataIn,
+		AcceleratorBuffer<float>& dataOut,
+		vk::raii::CommandBuffer& cmdBuf) override;
+
+	virtual void AppendReverse(
+		AcceleratorBuffer<float>& dataIn,
+		AcceleratorBuffer<float>& dataOut,
+		vk::raii::CommandBuffer& cmdBuf) override;
+
+	virtual bool IsGpuPlan() const override
+	{ return false; }
+
+	void Forward(const float* dataIn, float* dataOut);
+	void Reverse(const float* dataIn, float* dataOut);
+
+protected:
+
+	/**
+		@brief Precomputed tables for a complex transform of one size and direction
+	 */
+	class Tables
+	{
+	public:
+		Tables(size_t n, bool inverse);
+
+		///@brief Transform length
+		size_t m_size;
+
+		///@brief True for an inverse transform
+		bool m_inverse;
+
+		///@brief True if m_size is a power of two
+		bool m_pow2;
+
+		///@brief Twiddle factors exp(-/+ 2 pi i k / n) for k in [0, n/2), power-of-two sizes only
+		std::vector<float> m_twiddleRe;
+		std::vector<float> m_twiddleIm;
+
+		///@brief Bluestein convolution length (power of two >= 2n-1), non-power-of-two sizes only
+		size_t m_paddedSize;
+
+		///@brief Bluestein chirp exp(-/+ i pi k^2 / n)
+		std::vector<float> m_chirpRe;
+		std::vector<float> m_chirpIm;
+
+		///@brief Forward FFT of the conjugate chirp, prescaled by 1/m_paddedSize
+		std::vector<float> m_kernelRe;
+		std::vector<float> m_kernelIm;
+
+		///@brief Power-of-two tables used for the Bluestein convolution
+		std::shared_ptr<const Tables> m_paddedForward;
+		std::shared_ptr<const Tables> m_paddedInverse;
+	};
+
+	/**
+		@brief Per-thread scratch space, grown as needed and reused between transforms
+	 */
+	class Workspace
+	{
+	public:
+		void Reserve(size_t n, size_t padded);
+
+		std::vector<float> m_re;
+		std::vector<float> m_im;
+		std::vector<float> m_bluesteinRe;
+		std::vector<float> m_bluesteinIm;
+		std::vector<float> m_tempRe;
+		std::vector<float> m_tempIm;
+	};
+
+	static std::shared_ptr<const Tables> GetTables(size_t n, bool inverse);
+	static Workspace& GetWorkspace();
+
+	static void TransformComplex(const Tables& t, float* re, float* im, Workspace& ws, bool parallel);
+	static void TransformPow2(const Tables& t, float* re, float* im, float* tre, float* tim, bool parallel);
+
+	void ForwardBlock(const float* dataIn, float* dataOut, bool parallel);
+	void ReverseBlock(const float* dataIn, float* dataOut, bool parallel);
+
+	///@brief Tables for the complex transform doing the bulk of the work
+	std::shared_ptr<const Tables> m_tables;
+
+	///@brief True if this is an even-length real transform done as a half-length complex transform
+	bool m_packedReal;
+
+	///@brief exp(-2 pi i k / npoints) for k in [0, npoints/2], used to split/merge packed real transforms
+	std::vector<float> m_splitRe;
+	std::vector<float> m_splitIm;
+
+	///@brief Mutex protecting m_tableCache
+	static std::mutex m_tableCacheMutex;
+
+	///@brief Shared tables, keyed by (size, inverse)
+	static std::map<std::pair<size_t, bool>, std::weak_ptr<const Tables> > m_tableCache;
+};
+
+#endif
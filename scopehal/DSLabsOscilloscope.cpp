@@ -72,6 +72,9 @@ DSLabsOscilloscope::DSLabsOscilloscope(SCPITransport* transport)
 
 	AddDiagnosticLog("Found Model: " + m_model);
 
+	m_digitalRawWaveformBuffer.SetCpuAccessHint(AcceleratorBuffer<uint64_t>::HINT_LIKELY);
+	m_digitalRawWaveformBuffer.SetGpuAccessHint(AcceleratorBuffer<uint64_t>::HINT_NEVER);
+
 	//Add analog channel objects
 	for(size_t i = 0; i < m_analogChannelCount; i++)
 	{
@@ -371,11 +374,10 @@ bool DSLabsOscilloscope::AcquireData()
 
 		// LogDebug("ch%ld: Receive %ld samples\n", chnum, memdepth);
 
-		uint8_t* buf = new uint8_t[memdepth];
-
 		//Analog channels
 		if(chnum < m_analogChannelCount)
 		{
+			uint8_t* buf = new uint8_t[memdepth];
 			abufs.push_back(buf);
 
 			//Scale and offset are sent in the header since they might have changed since the capture began
@@ -419,6 +421,13 @@ bool DSLabsOscilloscope::AcquireData()
 			if(!m_transport->ReadRawData(sizeof(first_sample), (uint8_t*)&first_sample))
 				return false;
 
+			//Each byte holds eight consecutive samples, LSB first. Read into whole words, zero padded, so
+			//transitions can be found 64 samples at a time.
+			m_digitalRawWaveformBuffer.resize( (memdepth + 7) / 8);
+			m_digitalRawWaveformBuffer.PrepareForCpuAccess();
+			auto buf = m_digitalRawWaveformBuffer.GetCpuPointer();
+			if(memdepth % 8)
+				buf[memdepth / 8] = 0;
 			if(!m_transport->ReadRawData(memdepth * sizeof(uint8_t), (uint8_t*)buf))
 				return false;
 
@@ -429,53 +438,10 @@ bool DSLabsOscilloscope::AcquireData()
 			cap->m_triggerPhase = 0;
 			cap->m_startTimestamp = time(NULL);
 			cap->m_startFemtoseconds = fs;
-			cap->PrepareForCpuAccess();
-
-			//Preallocate memory assuming no deduplication possible
-			cap->Resize(memdepth * 8);
-
-			//First sample never gets deduplicated
-			bool last = (buf[0] & 1) ? true : false;
-			size_t k = 0;
-			cap->m_offsets[0] = first_sample;
-			cap->m_durations[0] = 1;
-			cap->m_samples[0] = last;
-
-			//Read and de-duplicate the other samples
-			//TODO: can we vectorize this somehow?
-			for(size_t m=1; m<memdepth; m++)
-			{
-				for (int bit = 0; bit < 8; bit++)
-				{
-					bool sample = (buf[m] & (1 << bit)) ? true : false;
-
-					//Deduplicate consecutive samples with same value
-					//FIXME: temporary workaround for rendering bugs
-					//if(last == sample)
-					if( (last == sample) && ((m+1) < memdepth) && (m > 0))
-						cap->m_durations[k] ++;
-
-					//Nope, it toggled - store the new value
-					else
-					{
-						k++;
-						cap->m_offsets[k] = first_sample + (m * 8) + bit;
-						cap->m_durations[k] = 1;
-						cap->m_samples[k] = sample;
-						last = sample;
-					}
-				}
-			}
-
-			//Free space reclaimed by deduplication
-			cap->Resize(k);
-			cap->m_offsets.shrink_to_fit();
-			cap->m_durations.shrink_to_fit();
-			cap->m_samples.shrink_to_fit();
-			cap->MarkSamplesModifiedFromCpu();
-			cap->MarkTimestampsModifiedFromCpu();
-
-			delete[] buf;
+
+			//Unpack and de-duplicate the samples
+			//FIXME: the last byte is never deduplicated as a temporary workaround for rendering bugs
+			ConvertSerialLogicSamples(cap, buf, memdepth * 8, first_sample, 8);
 		}
 	}
 
@@ -503,20 +469,7 @@ bool DSLabsOscilloscope::AcquireData()
 	int dropped = param->GetIntVal();
 
 	//Save the waveforms to our queue
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(s);
-
-	while (m_pendingWaveforms.size() > 2)
-	{
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
-			delete it.second;
-		m_pendingWaveforms.pop_front();
-
-		dropped++;
-	}
-
-	m_pendingWaveformsMutex.unlock();
+	dropped += PushPendingWaveform(s);
 
 	param->SetIntVal(dropped);
 
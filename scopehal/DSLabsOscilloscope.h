@@ -132,6 +132,9 @@ protected:
 	// Only configurable for the entire device
 	float m_digitalThreshold;
 
+	///@brief Buffer for storing raw digital samples before de-duplication
+	AcceleratorBuffer<uint64_t> m_digitalRawWaveformBuffer;
+
 	void SendDataSocket(size_t n, const uint8_t* p);
 	bool ReadDataSocket(size_t n, uint8_t* p);
 
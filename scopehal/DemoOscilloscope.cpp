@@ -612,9 +612,7 @@ bool DemoOscilloscope::AcquireData()
 		wfm->m_triggerPhase = 0;
 	}
 
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(s);
-	m_pendingWaveformsMutex.unlock();
+	PushPendingWaveform(s);
 
 	if(m_triggerOneShot)
 		m_triggerArmed = false;
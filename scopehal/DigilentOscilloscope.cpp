@@ -442,9 +442,7 @@ bool DigilentOscilloscope::AcquireData()
 	}
 
 	//Save the waveforms to our queue
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(s);
-	m_pendingWaveformsMutex.unlock();
+	PushPendingWaveform(s);
 
 	//If this was a one-shot trigger we're no longer armed
 	if(m_triggerOneShot)
@@ -0,0 +1,190 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of DigitalBusSample
+	@ingroup datamodel
+ */
+
+#ifndef DigitalBusSample_h
+#define DigitalBusSample_h
+
+#include <cstdint>
+#include <vector>
+
+/**
+	@brief A single sample of a digital bus up to 64 bits wide, stored inline as a packed word
+	@ingroup datamodel
+
+	Bit i of the bus is bit i of the word (LSB first), matching the lane order of the std::vector<bool> samples
+	this replaces. The class provides the subset of the std::vector<bool> API used by decoders (indexing, size(),
+	push_back(), resize(), conversion to a vector) so existing code keeps working unchanged, while new code can read
+	and write the whole word at once with GetBits() / SetBits().
+
+	Being trivially copyable, a waveform of these is a single flat allocation rather than one heap block per sample.
+
+	Buses wider than MAX_WIDTH do not fit and must use SparseWideDigitalBusWaveform instead. Creating or growing a
+	sample past MAX_WIDTH is a caller bug: the excess bits are dropped and an error is logged (once per process, since
+	the offending call is normally inside a per-sample loop).
+ */
+class DigitalBusSample
+{
+public:
+
+	///@brief Maximum width of a bus sample, in bits
+	static constexpr size_t MAX_WIDTH = 64;
+
+	DigitalBusSample()
+		: m_bits(0)
+		, m_width(0)
+	{}
+
+	/**
+		@brief Creates a bus sample from a packed word
+
+		@param bits		Sample value, LSB first. Bits above width are ignored.
+		@param width	Width of the bus, in bits. Must not exceed MAX_WIDTH.
+	 */
+	DigitalBusSample(uint64_t bits, size_t width)
+		: m_bits(bits & Mask(width))
+		, m_width(static_cast<uint8_t>( (width > MAX_WIDTH) ? MAX_WIDTH : width))
+	{
+		if(width > MAX_WIDTH)
+			OnOverflow(width);
+	}
+
+	/**
+		@brief Creates a bus sample from a vector of bits (element 0 is the LSB)
+
+		The vector must not be longer than MAX_WIDTH.
+	 */
+	explicit DigitalBusSample(const std::vector<bool>& bits)
+		: m_bits(0)
+		, m_width(0)
+	{
+		if(bits.size() > MAX_WIDTH)
+			OnOverflow(bits.size());
+
+		size_t len = (bits.size() > MAX_WIDTH) ? MAX_WIDTH : bits.size();
+		for(size_t i=0; i<len; i++)
+			push_back(bits[i]);
+	}
+
+	///@brief Returns the value of one bit of the bus
+	bool operator[](size_t i) const
+	{ return (m_bits >> i) & 1; }
+
+	///@brief Sets the value of one bit of the bus (must be less than size())
+	void set(size_t i, bool value)
+	{
+		if(value)
+			m_bits |= (1ULL << i);
+		else
+			m_bits &= ~(1ULL << i);
+	}
+
+	///@brief Returns the width of the bus, in bits
+	size_t size() const
+	{ return m_width; }
+
+	bool empty() const
+	{ return m_width == 0; }
+
+	///@brief Adds a new bit to the MSB end of the bus. The bus must be narrower than MAX_WIDTH.
+	void push_back(bool value)
+	{
+		if(m_width >= MAX_WIDTH)
+		{
+			OnOverflow(m_width + 1);
+			return;
+		}
+		if(value)
+			m_bits |= (1ULL << m_width);
+		m_width ++;
+	}
+
+	///@brief Changes the width of the bus, zeroing any new bits. The new width must not exceed MAX_WIDTH.
+	void resize(size_t width)
+	{
+		if(width > MAX_WIDTH)
+		{
+			OnOverflow(width);
+			width = MAX_WIDTH;
+		}
+		m_bits &= Mask(width);
+		m_width = static_cast<uint8_t>(width);
+	}
+
+	void clear()
+	{
+		m_bits = 0;
+		m_width = 0;
+	}
+
+	///@brief Returns the entire sample as a packed word, LSB first
+	uint64_t GetBits() const
+	{ return m_bits; }
+
+	///@brief Sets the entire sample from a packed word, LSB first. Bits above size() are ignored.
+	void SetBits(uint64_t bits)
+	{ m_bits = bits & Mask(m_width); }
+
+	///@brief Expands the sample to a vector of bits, for code that still needs one
+	operator std::vector<bool>() const
+	{
+		std::vector<bool> ret(m_width);
+		for(size_t i=0; i<m_width; i++)
+			ret[i] = (*this)[i];
+		return ret;
+	}
+
+	bool operator==(const DigitalBusSample& rhs) const
+	{ return (m_bits == rhs.m_bits) && (m_width == rhs.m_width); }
+
+	bool operator!=(const DigitalBusSample& rhs) const
+	{ return !(*this == rhs); }
+
+protected:
+
+	static void OnOverflow(size_t width);
+
+	///@brief Returns a mask with the low width bits set
+	static uint64_t Mask(size_t width)
+	{ return (width >= 64) ? ~0ULL : ((1ULL << width) - 1); }
+
+	///@brief Sample value, LSB first
+	uint64_t m_bits;
+
+	///@brief Width of the bus, in bits
+	uint8_t m_width;
+};
+
+#endif
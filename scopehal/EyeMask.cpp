@@ -45,6 +45,9 @@
 
 #include <time.h>
 #include <iostream>
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -55,6 +58,13 @@ using namespace std;
 EyeMask::EyeMask()
 	: m_hitrate(0)
 	, m_timebaseIsRelative(false)
+	, m_width(0)
+	, m_height(0)
+	, m_bitmapDirty(true)
+	, m_renderXscale(0)
+	, m_renderXoff(0)
+	, m_renderRange(0)
+	, m_renderUIWidth(0)
 {
 }
 
@@ -110,6 +120,7 @@ bool EyeMask::Load(const YAML::Node& node)
 	m_hitrate = 0;
 	m_timebaseIsRelative = false;
 	m_maskname = "";
+	m_bitmapDirty = true;
 
 	//Load protocol section
 	auto proto = node["protocol"];
@@ -223,6 +234,39 @@ void EyeMask::RenderForAnalysis(
 	}
 }
 
+/**
+	@brief Converts the rendered mask into a list of spans, so hit testing doesn't have to look at the bitmap
+ */
+void EyeMask::UpdateSpans()
+{
+	vector<uint8_t> image_data;
+	GetPixels(image_data);
+	auto data = reinterpret_cast<const uint32_t*>(image_data.data());
+
+	m_spans.clear();
+	for(size_t y=0; y<m_height; y++)
+	{
+		auto row = data + (y*m_width);
+		for(size_t x=0; x<m_width; )
+		{
+			//Skip black pixels
+			if( (row[x] & 0xff) == 0)
+			{
+				x++;
+				continue;
+			}
+
+			//Find the end of the run
+			size_t start = x;
+			while( (x < m_width) && ( (row[x] & 0xff) != 0) )
+				x++;
+			m_spans.push_back(MaskSpan{y*m_width + start, x - start});
+		}
+	}
+
+	LogTrace("Mask rendered as %zu spans\n", m_spans.size());
+}
+
 /**
 	@brief Checks a raw eye pattern dataset against the mask
  */
@@ -235,9 +279,11 @@ float EyeMask::CalculateHitRate(
 	float xoff
 	)
 {
-	//TODO: GPU this?
-	//For now, we're running on the CPU though. Make sure the data is here when we need it
-	if(!m_canvas || (m_width != width) || (m_height != height) || m_bitmapDirty)
+	//Only re-render if the mask or the eye geometry changed
+	float uiwidth = m_timebaseIsRelative ? cap->GetUIWidth() : 0;
+	if(!m_canvas || (m_width != width) || (m_height != height) || m_bitmapDirty ||
+		(m_renderXscale != xscale) || (m_renderXoff != xoff) || (m_renderRange != fullscalerange) ||
+		(m_renderUIWidth != uiwidth) )
 	{
 		m_width = width;
 		m_height = height;
@@ -252,65 +298,159 @@ float EyeMask::CalculateHitRate(
 			yscale,
 			0,
 			height);
+		UpdateSpans();
 
+		m_renderXscale = xscale;
+		m_renderXoff = xoff;
+		m_renderRange = fullscalerange;
+		m_renderUIWidth = uiwidth;
 		m_bitmapDirty = false;
 	}
 
 	//Test each pixel of the eye pattern against the mask
-
-	vector<uint8_t> image_data(width*height*4);
-	m_canvas->get_image_data(image_data.data(), width, height, m_width*4, 0,0);
-
 	if(cap->GetType() == EyeWaveform::EYE_NORMAL)
 	{
 		cap->GetAccumBuffer().PrepareForCpuAccess();
 		auto accum = cap->GetAccumData();
-		size_t nhits = 0;
 
-		uint32_t* data = reinterpret_cast<uint32_t*>(&image_data[0]);
-		for(size_t y=0; y<height; y++)
-		{
-			auto row = data + (y*width);
-			auto eyerow = accum + (y*width);
+		int64_t nhits;
+		#ifdef __x86_64__
+		if(g_hasAvx2)
+			nhits = CountHitsAVX2(accum, m_spans);
+		else
+		#endif
+			nhits = CountHitsGeneric(accum, m_spans);
 
-			for(size_t x=0; x<width; x++)
-			{
-				//If mask pixel isn't black, count violations
-				uint32_t pix = row[x];
-				auto hits = eyerow[x];
-				if(pix & 0xff)
-					nhits += hits;
-			}
-		}
-
-		LogTrace("Total %zu hits out of %zu samples\n", nhits / EYE_ACCUM_SCALE, cap->GetTotalSamples());
+		LogTrace("Total %zu hits out of %zu samples\n", (size_t)nhits / EYE_ACCUM_SCALE, cap->GetTotalSamples());
 		return nhits * 1.0 / (cap->GetTotalSamples() * EYE_ACCUM_SCALE);
 	}
 	else //if(cap->GetType() == EyeWaveform::EYE_BER)
 	{
+		//BER eyes don't need any preprocessing since the pixel values are already raw BER
 		cap->GetOutData().PrepareForCpuAccess();
-		auto accum = cap->GetData();
-		float nmax = 0;
+		auto ber = cap->GetData();
+
+		#ifdef __x86_64__
+		if(g_hasAvx2)
+			return FindMaxBERAVX2(ber, m_spans);
+		else
+		#endif
+			return FindMaxBERGeneric(ber, m_spans);
+	}
+}
+
+/**
+	@brief Sums the eye accumulator over every pixel inside the mask
+
+	@param accum	Eye accumulator buffer
+	@param spans	Pixels inside the mask
+
+	@return Total number of hits, scaled by EYE_ACCUM_SCALE
+ */
+int64_t EyeMask::CountHitsGeneric(const int64_t* accum, const vector<MaskSpan>& spans)
+{
+	int64_t nhits = 0;
+	for(auto& span : spans)
+	{
+		auto p = accum + span.m_offset;
+		for(size_t i=0; i<span.m_length; i++)
+			nhits += p[i];
+	}
+	return nhits;
+}
 
-		uint32_t* data = reinterpret_cast<uint32_t*>(&image_data[0]);
-		for(size_t y=0; y<height; y++)
+/**
+	@brief Finds the highest BER of any pixel inside the mask
+
+	@param ber		BER eye data
+	@param spans	Pixels inside the mask
+
+	@return Highest BER, or zero if the mask is empty
+ */
+float EyeMask::FindMaxBERGeneric(const float* ber, const vector<MaskSpan>& spans)
+{
+	float nmax = 0;
+	for(auto& span : spans)
+	{
+		auto p = ber + span.m_offset;
+		for(size_t i=0; i<span.m_length; i++)
 		{
-			auto row = data + (y*width);
-			auto eyerow = accum + (y*width);
-			for(size_t x=0; x<width; x++)
-			{
-				//If mask pixel isn't black, count violations
-				uint32_t pix = row[x];
-				if( (pix & 0xff) != 0)
-				{
-					//BER eyes don't need any preprocessing since the pixel values are already raw BER
-					float rate = eyerow[x];
-					if(rate > nmax)
-						nmax = rate;
-				}
-			}
+			if(p[i] > nmax)
+				nmax = p[i];
 		}
+	}
+	return nmax;
+}
+
+#ifdef __x86_64__
+/**
+	@brief AVX2 optimized version of CountHitsGeneric()
+ */
+__attribute__((target("avx2")))
+int64_t EyeMask::CountHitsAVX2(const int64_t* accum, const vector<MaskSpan>& spans)
+{
+	__m256i vsum0 = _mm256_setzero_si256();
+	__m256i vsum1 = _mm256_setzero_si256();
+	int64_t nhits = 0;
+	for(auto& span : spans)
+	{
+		auto p = accum + span.m_offset;
+		size_t len = span.m_length;
 
-		return nmax;
+		//Two accumulators to hide the add latency
+		size_t end = len - (len % 8);
+		size_t i = 0;
+		for(; i<end; i += 8)
+		{
+			vsum0 = _mm256_add_epi64(vsum0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+			vsum1 = _mm256_add_epi64(vsum1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 4)));
+		}
+
+		//Get any extras we didn't get in the SIMD loop
+		for(; i<len; i++)
+			nhits += p[i];
+	}
+
+	int64_t lanes[4] __attribute__((aligned(32)));
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(vsum0, vsum1));
+	return nhits + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+	@brief AVX2 optimized version of FindMaxBERGeneric()
+ */
+__attribute__((target("avx2")))
+float EyeMask::FindMaxBERAVX2(const float* ber, const vector<MaskSpan>& spans)
+{
+	//Operand order matters: maxps returns the second operand if either is NaN, so NaN pixels are ignored
+	//the same way as in the generic version
+	__m256 vmax = _mm256_setzero_ps();
+	float nmax = 0;
+	for(auto& span : spans)
+	{
+		auto p = ber + span.m_offset;
+		size_t len = span.m_length;
+
+		size_t end = len - (len % 8);
+		size_t i = 0;
+		for(; i<end; i += 8)
+			vmax = _mm256_max_ps(_mm256_loadu_ps(p + i), vmax);
+
+		//Get any extras we didn't get in the SIMD loop
+		for(; i<len; i++)
+		{
+			if(p[i] > nmax)
+				nmax = p[i];
+		}
+	}
+
+	float lanes[8] __attribute__((aligned(32)));
+	_mm256_store_ps(lanes, vmax);
+	for(size_t i=0; i<8; i++)
+	{
+		if(lanes[i] > nmax)
+			nmax = lanes[i];
 	}
+	return nmax;
 }
+#endif /* __x86_64__ */
@@ -136,6 +136,24 @@ public:
 		float xscale,
 		float xoff);
 
+	/**
+		@brief A horizontal run of pixels inside the rendered mask
+
+		Offsets are in pixels from the start of the eye buffer, so a span can be used to index it directly.
+	 */
+	struct MaskSpan
+	{
+		///@brief Offset of the first pixel in the span
+		size_t m_offset;
+
+		///@brief Number of pixels in the span
+		size_t m_length;
+	};
+
+	///@brief Get the rendered mask as a list of spans, valid after CalculateHitRate() has been called
+	const std::vector<MaskSpan>& GetSpans() const
+	{ return m_spans; }
+
 	///@brief Return true if there are no polygons in the mask
 	bool empty() const
 	{ return m_polygons.empty(); }
@@ -171,6 +189,14 @@ public:
 	}
 
 protected:
+	void UpdateSpans();
+
+	static int64_t CountHitsGeneric(const int64_t* accum, const std::vector<MaskSpan>& spans);
+	static float FindMaxBERGeneric(const float* ber, const std::vector<MaskSpan>& spans);
+#ifdef __x86_64__
+	static int64_t CountHitsAVX2(const int64_t* accum, const std::vector<MaskSpan>& spans);
+	static float FindMaxBERAVX2(const float* ber, const std::vector<MaskSpan>& spans);
+#endif
 
 	///@brief Filename of the mask
 	std::string m_fname;
@@ -198,6 +224,21 @@ protected:
 
     ///@brief True if we need to re-render
     bool m_bitmapDirty;
+
+	///@brief Pixels inside the mask as of the last render, one span per run of consecutive pixels in a row
+	std::vector<MaskSpan> m_spans;
+
+	///@brief Horizontal scale the mask was last rendered at
+	float m_renderXscale;
+
+	///@brief Horizontal offset the mask was last rendered at
+	float m_renderXoff;
+
+	///@brief Vertical full scale range the mask was last rendered at
+	float m_renderRange;
+
+	///@brief UI width the mask was last rendered at (only used for masks in relative units)
+	float m_renderUIWidth;
 };
 
 #endif
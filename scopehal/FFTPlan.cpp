@@ -0,0 +1,143 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of FFTPlan
+
+	@ingroup core
+ */
+#include "scopehal.h"
+#include "FFTPlan.h"
+#include "CPUFFTPlan.h"
+#include "VulkanFFTPlan.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Construction / destruction
+
+/**
+	@brief Initializes the common plan state
+
+	@param npoints			Number of points in the FFT
+	@param nouts			Number of output samples
+	@param dir				Direction (forward or reverse)
+	@param numBatches		Number of batched FFTs to perform (for spectrograms etc)
+	@param timeDomainType	Data type of the time-domain signal (real or complex)
+ */
+FFTPlan::FFTPlan(
+	size_t npoints,
+	size_t nouts,
+	FFTPlanDirection dir,
+	size_t numBatches,
+	FFTDataType timeDomainType)
+	: m_size(npoints)
+	, m_nouts(nouts)
+	, m_direction(dir)
+	, m_numBatches(numBatches)
+	, m_timeDomainType(timeDomainType)
+{
+}
+
+FFTPlan::~FFTPlan()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Plan selection
+
+/**
+	@brief Checks if this plan can be used for a transform with the given configuration
+ */
+bool FFTPlan::IsCompatible(
+	size_t npoints,
+	size_t nouts,
+	FFTPlanDirection dir,
+	size_t numBatches,
+	FFTDataType timeDomainType) const
+{
+	return
+		(m_size == npoints) &&
+		(m_nouts == nouts) &&
+		(m_direction == dir) &&
+		(m_numBatches == numBatches) &&
+		(m_timeDomainType == timeDomainType) &&
+		(IsGpuPlan() == g_gpuFilterEnabled);
+}
+
+/**
+	@brief Creates a new FFT plan using the best available backend
+
+	Transforms run on the GPU via vkFFT if GPU filter acceleration is available, otherwise on the CPU.
+
+	@param npoints			Number of points in the FFT
+	@param nouts			Number of output samples
+	@param dir				Direction (forward or reverse)
+	@param numBatches		Number of batched FFTs to perform (for spectrograms etc)
+	@param timeDomainType	Data type of the time-domain signal (real or complex)
+ */
+unique_ptr<FFTPlan> FFTPlan::Create(
+	size_t npoints,
+	size_t nouts,
+	FFTPlanDirection dir,
+	size_t numBatches,
+	FFTDataType timeDomainType)
+{
+	if(g_gpuFilterEnabled)
+		return make_unique<VulkanFFTPlan>(npoints, nouts, dir, numBatches, timeDomainType);
+	else
+		return make_unique<CPUFFTPlan>(npoints, nouts, dir, numBatches, timeDomainType);
+}
+
+/**
+	@brief Replaces a plan with a new one if it's missing or doesn't match the requested configuration
+
+	@param plan				The plan to check (may be null)
+	@param npoints			Number of points in the FFT
+	@param nouts			Number of output samples
+	@param dir				Direction (forward or reverse)
+	@param numBatches		Number of batched FFTs to perform (for spectrograms etc)
+	@param timeDomainType	Data type of the time-domain signal (real or complex)
+ */
+void FFTPlan::Update(
+	unique_ptr<FFTPlan>& plan,
+	size_t npoints,
+	size_t nouts,
+	FFTPlanDirection dir,
+	size_t numBatches,
+	FFTDataType timeDomainType)
+{
+	if(plan && plan->IsCompatible(npoints, nouts, dir, numBatches, timeDomainType))
+		return;
+
+	plan = nullptr;
+	plan = Create(npoints, nouts, dir, numBatches, timeDomainType);
+}
@@ -0,0 +1,171 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of FFTPlan
+	@ingroup core
+ */
+#ifndef FFTPlan_h
+#define FFTPlan_h
+
+#include "AcceleratorBuffer.h"
+
+/**
+	@brief Abstract base class for a FFT plan, implemented either on the GPU (VulkanFFTPlan) or CPU (CPUFFTPlan)
+	@ingroup core
+
+	Data layout is the same for all backends: real buffers are packed float32 values, complex buffers are interleaved
+	(real, imaginary) float32 pairs. Batched transforms are stored back to back. Inverse transforms are not normalized.
+ */
+class FFTPlan
+{
+public:
+
+	///@brief Direction of a FFT
+	enum FFTPlanDirection
+	{
+		///@brief Normal FFT
+		DIRECTION_FORWARD,
+
+		///@brief Inverse FFT
+		DIRECTION_REVERSE
+	};
+
+	///@brief Data type of a FFT input or output
+	enum FFTDataType
+	{
+		///@brief Real float32 values
+		TYPE_REAL,
+
+		///@brief Complex float32 values
+		TYPE_COMPLEX
+	};
+
+	FFTPlan(
+		size_t npoints,
+		size_t nouts,
+		FFTPlanDirection dir,
+		size_t numBatches,
+		FFTDataType timeDomainType);
+	virtual ~FFTPlan();
+
+	/**
+		@brief Appends a forward FFT to a command buffer
+
+		CPU plans execute the transform immediately and ignore the command buffer.
+
+		@param dataIn	Time domain input
+		@param dataOut	Frequency domain output
+		@param cmdBuf	Command buffer to append the FFT to
+	 */
+	virtual void AppendForward(
+		AcceleratorBuffer<float>& dataIn,
+		AcceleratorBuffer<float>& dataOut,
+		vk::raii::CommandBuffer& cmdBuf) =0;
+
+	/**
+		@brief Appends an inverse FFT to a command buffer
+
+		CPU plans execute the transform immediately and ignore the command buffer.
+
+		@param dataIn	Frequency domain input
+		@param dataOut	Time domain output
+		@param cmdBuf	Command buffer to append the FFT to
+	 */
+	virtual void AppendReverse(
+		AcceleratorBuffer<float>& dataIn,
+		AcceleratorBuffer<float>& dataOut,
+		vk::raii::CommandBuffer& cmdBuf) =0;
+
+	///@brief Returns true if this plan runs on the GPU, false if on the CPU
+	virtual bool IsGpuPlan() const =0;
+
+	///@brief Return the number of points in the FFT
+	size_t size() const
+	{ return m_size; }
+
+	///@brief Return the number of frequency domain points
+	size_t GetNumOutputs() const
+	{ return m_nouts; }
+
+	///@brief Return the number of transforms done in one batch
+	size_t GetNumBatches() const
+	{ return m_numBatches; }
+
+	///@brief Return the direction of the transform
+	FFTPlanDirection GetDirection() const
+	{ return m_direction; }
+
+	///@brief Return the data type of the time domain signal
+	FFTDataType GetTimeDomainType() const
+	{ return m_timeDomainType; }
+
+	bool IsCompatible(
+		size_t npoints,
+		size_t nouts,
+		FFTPlanDirection dir,
+		size_t numBatches,
+		FFTDataType timeDomainType) const;
+
+	static std::unique_ptr<FFTPlan> Create(
+		size_t npoints,
+		size_t nouts,
+		FFTPlanDirection dir,
+		size_t numBatches = 1,
+		FFTDataType timeDomainType = TYPE_REAL);
+
+	static void Update(
+		std::unique_ptr<FFTPlan>& plan,
+		size_t npoints,
+		size_t nouts,
+		FFTPlanDirection dir,
+		size_t numBatches = 1,
+		FFTDataType timeDomainType = TYPE_REAL);
+
+protected:
+
+	///@brief Number of points in the FFT
+	size_t m_size;
+
+	///@brief Number of frequency domain points
+	size_t m_nouts;
+
+	///@brief Direction of the transform
+	FFTPlanDirection m_direction;
+
+	///@brief Number of transforms in a batch
+	size_t m_numBatches;
+
+	///@brief Data type of the time domain signal
+	FFTDataType m_timeDomainType;
+};
+
+#endif
@@ -39,14 +39,15 @@
 #ifdef __x86_64__
 #include <immintrin.h>
 #endif
+#include <omp.h>
 
 using namespace std;
 
 Filter::CreateMapType Filter::m_createprocs;
 set<Filter*> Filter::m_filters;
 
-mutex Filter::m_cacheMutex;
-map<pair<WaveformBase*, float>, vector<int64_t> > Filter::m_zeroCrossingCache;
+Filter::EdgeCacheShard Filter::m_edgeCache[EDGE_CACHE_SHARDS];
+atomic<uint64_t> Filter::m_analysisCacheGeneration(0);
 
 map<string, unsigned int> Filter::m_instanceCount;
 
@@ -60,6 +61,10 @@ Filter::Filter(
 	: OscilloscopeChannel(NULL, "", color, xunit, 0)	//TODO: handle this better?
 	, m_category(cat)
 	, m_usingDefault(true)
+	, m_outputWaveformPools{
+		{WAVEFORM_POOL_SIZE}, {WAVEFORM_POOL_SIZE}, {WAVEFORM_POOL_SIZE}, {WAVEFORM_POOL_SIZE} }
+	, m_scratchWaveformPools{
+		{WAVEFORM_POOL_SIZE}, {WAVEFORM_POOL_SIZE}, {WAVEFORM_POOL_SIZE}, {WAVEFORM_POOL_SIZE} }
 {
 	m_instanceNum = 0;
 	m_filters.emplace(this);
@@ -77,9 +82,15 @@ Filter::~Filter()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Accessors
 
+/**
+	@brief Discards any state accumulated over multiple waveforms (averages, persistence, eye integration, etc)
+
+	Overrides must call the base class implementation: it forces the filter to run again on the next graph
+	evaluation even if none of its inputs changed, so it doesn't sit there with an empty or stale output.
+ */
 void Filter::ClearSweeps()
 {
-	//default no-op implementation
+	InvalidateRefreshState();
 }
 
 void Filter::AddRef()
@@ -312,10 +323,198 @@ void Filter::FillDurationsAVX2(SparseWaveformBase& wfm)
 }
 #endif /* __x86_64__ */
 
+/**
+	@brief Finds clock edges in a range of a digital waveform
+
+	An edge at index i is a transition between clock[i-1] and clock[i], so start must be at least 1.
+
+	@param clock	Clock samples
+	@param start	First sample index to check for an edge
+	@param end		One past the last sample index to check
+	@param type		Type of edge to look for
+	@param indexes	Output buffer for indexes of edges (must have room for end-start entries).
+					If null, edges are counted but not stored.
+
+	@return Number of edges found
+ */
+size_t Filter::FindClockEdges(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes)
+{
+	if(end <= start)
+		return 0;
+
+	#ifdef __x86_64__
+	if(g_hasAvx512F)
+		return FindClockEdgesAVX512F(clock, start, end, type, indexes);
+	else if(g_hasAvx2)
+		return FindClockEdgesAVX2(clock, start, end, type, indexes);
+	else
+	#endif
+		return FindClockEdgesGeneric(clock, start, end, type, indexes);
+}
+
+/**
+	@brief Checks if a pair of adjacent clock samples form the requested type of edge
+ */
+static inline bool IsClockEdge(bool prev, bool cur, Filter::ClockEdgeType type)
+{
+	switch(type)
+	{
+		case Filter::CLOCK_EDGE_RISING:
+			return cur && !prev;
+
+		case Filter::CLOCK_EDGE_FALLING:
+			return !cur && prev;
+
+		case Filter::CLOCK_EDGE_ANY:
+		default:
+			return cur != prev;
+	}
+}
+
+/**
+	@brief Scalar version of FindClockEdges()
+ */
+size_t Filter::FindClockEdgesGeneric(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes)
+{
+	size_t n = 0;
+	if(indexes)
+	{
+		//Branchless compaction: always write the index, only advance if it was an edge
+		for(size_t i=start; i<end; i++)
+		{
+			indexes[n] = i;
+			n += IsClockEdge(clock[i-1], clock[i], type);
+		}
+	}
+	else
+	{
+		for(size_t i=start; i<end; i++)
+			n += IsClockEdge(clock[i-1], clock[i], type);
+	}
+	return n;
+}
+
+#ifdef __x86_64__
+/**
+	@brief AVX2 optimized version of FindClockEdges()
+
+	Compares 32 clock samples at a time and walks the set bits of the resulting edge mask.
+ */
+__attribute__((target("avx2,bmi")))
+size_t Filter::FindClockEdgesAVX2(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes)
+{
+	size_t n = 0;
+	size_t len = end - start;
+	size_t vend = start + (len - (len % 32));
+	__m256i zero = _mm256_setzero_si256();
+
+	size_t i = start;
+	for(; i<vend; i+=32)
+	{
+		__m256i cur		= _mm256_loadu_si256(reinterpret_cast<const __m256i*>(clock + i));
+		__m256i prev	= _mm256_loadu_si256(reinterpret_cast<const __m256i*>(clock + i - 1));
+
+		//Samples are 0 or 1, so each byte of the edge vector is nonzero iff there's an edge
+		__m256i edges;
+		switch(type)
+		{
+			case CLOCK_EDGE_RISING:
+				edges = _mm256_andnot_si256(prev, cur);
+				break;
+
+			case CLOCK_EDGE_FALLING:
+				edges = _mm256_andnot_si256(cur, prev);
+				break;
+
+			case CLOCK_EDGE_ANY:
+			default:
+				edges = _mm256_xor_si256(cur, prev);
+				break;
+		}
+		uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(edges, zero)));
+
+		if(!indexes)
+			n += __builtin_popcount(mask);
+		else
+		{
+			while(mask)
+			{
+				indexes[n++] = i + _tzcnt_u32(mask);
+				mask = _blsr_u32(mask);
+			}
+		}
+	}
+
+	//Last few samples
+	return n + FindClockEdgesGeneric(clock, i, end, type, indexes ? (indexes + n) : nullptr);
+}
+
+/**
+	@brief AVX-512 optimized version of FindClockEdges()
+
+	Builds the edge mask for 32 clock samples at a time the same way as the AVX2 version, then uses
+	compress-store to write the indexes of all edges without any per-edge branching.
+ */
+__attribute__((target("avx2,avx512f")))
+size_t Filter::FindClockEdgesAVX512F(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes)
+{
+	size_t n = 0;
+	size_t len = end - start;
+	size_t vend = start + (len - (len % 32));
+	__m256i zero = _mm256_setzero_si256();
+
+	__m512i lanes	= _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+	__m512i eight	= _mm512_set1_epi64(8);
+
+	size_t i = start;
+	for(; i<vend; i+=32)
+	{
+		__m256i cur		= _mm256_loadu_si256(reinterpret_cast<const __m256i*>(clock + i));
+		__m256i prev	= _mm256_loadu_si256(reinterpret_cast<const __m256i*>(clock + i - 1));
+
+		__m256i edges;
+		switch(type)
+		{
+			case CLOCK_EDGE_RISING:
+				edges = _mm256_andnot_si256(prev, cur);
+				break;
+
+			case CLOCK_EDGE_FALLING:
+				edges = _mm256_andnot_si256(cur, prev);
+				break;
+
+			case CLOCK_EDGE_ANY:
+			default:
+				edges = _mm256_xor_si256(cur, prev);
+				break;
+		}
+		uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(edges, zero)));
+
+		if(!indexes)
+			n += __builtin_popcount(mask);
+		else if(mask)
+		{
+			//Compress-store the indexes eight at a time
+			__m512i idx = _mm512_add_epi64(_mm512_set1_epi64(i), lanes);
+			for(int j=0; j<4; j++)
+			{
+				__mmask8 m = static_cast<__mmask8>(mask >> (j*8));
+				_mm512_mask_compressstoreu_epi64(indexes + n, m, idx);
+				n += __builtin_popcount(m);
+				idx = _mm512_add_epi64(idx, eight);
+			}
+		}
+	}
+
+	//Last few samples
+	return n + FindClockEdgesGeneric(clock, i, end, type, indexes ? (indexes + n) : nullptr);
+}
+#endif /* __x86_64__ */
+
 /**
 	@brief Find rising edges in a waveform, interpolating to sub-sample resolution as necessary
  */
-void Filter::FindRisingEdges(UniformAnalogWaveform* data, float threshold, std::vector<int64_t>& edges)
+void Filter::FindRisingEdgesUncached(UniformAnalogWaveform* data, float threshold, vector<int64_t>& edges)
 {
 	//Find times of the zero crossings
 	bool first = true;
@@ -353,7 +552,7 @@ void Filter::FindRisingEdges(UniformAnalogWaveform* data, float threshold, std::
 /**
 	@brief Find rising edges in a waveform, interpolating to sub-sample resolution as necessary
  */
-void Filter::FindRisingEdges(SparseAnalogWaveform* data, float threshold, std::vector<int64_t>& edges)
+void Filter::FindRisingEdgesUncached(SparseAnalogWaveform* data, float threshold, vector<int64_t>& edges)
 {
 	//Find times of the zero crossings
 	bool first = true;
@@ -392,21 +591,8 @@ void Filter::FindRisingEdges(SparseAnalogWaveform* data, float threshold, std::v
 /**
 	@brief Find zero crossings in a waveform, interpolating as necessary
  */
-void Filter::FindZeroCrossings(SparseAnalogWaveform* data, float threshold, vector<int64_t>& edges)
+void Filter::FindZeroCrossingsUncached(SparseAnalogWaveform* data, float threshold, vector<int64_t>& edges)
 {
-	pair<WaveformBase*, float> cachekey(data, threshold);
-
-	//Check cache
-	{
-		lock_guard<mutex> lock(m_cacheMutex);
-		auto it = m_zeroCrossingCache.find(cachekey);
-		if(it != m_zeroCrossingCache.end())
-		{
-			edges = it->second;
-			return;
-		}
-	}
-
 	//Preallocate a bunch of outputs to reduce reallocations
 	edges.reserve(1024 * 1024);
 
@@ -439,30 +625,13 @@ void Filter::FindZeroCrossings(SparseAnalogWaveform* data, float threshold, vect
 		edges.push_back(t);
 		last = value;
 	}
-
-	//Add to cache
-	lock_guard<mutex> lock(m_cacheMutex);
-	m_zeroCrossingCache[cachekey] = edges;
 }
 
 /**
 	@brief Find zero crossings in a waveform, interpolating as necessary
  */
-void Filter::FindZeroCrossings(UniformAnalogWaveform* data, float threshold, vector<int64_t>& edges)
+void Filter::FindZeroCrossingsUncached(UniformAnalogWaveform* data, float threshold, vector<int64_t>& edges)
 {
-	pair<WaveformBase*, float> cachekey(data, threshold);
-
-	//Check cache
-	{
-		lock_guard<mutex> lock(m_cacheMutex);
-		auto it = m_zeroCrossingCache.find(cachekey);
-		if(it != m_zeroCrossingCache.end())
-		{
-			edges = it->second;
-			return;
-		}
-	}
-
 	//Preallocate a bunch of outputs to reduce reallocations
 	edges.reserve(1024 * 1024);
 
@@ -496,30 +665,13 @@ void Filter::FindZeroCrossings(UniformAnalogWaveform* data, float threshold, vec
 		flast = fcur;
 		timestamp += timescale;
 	}
-
-	//Add to cache
-	lock_guard<mutex> lock(m_cacheMutex);
-	m_zeroCrossingCache[cachekey] = edges;
 }
 
 /**
 	@brief Find edges in a waveform, discarding repeated samples
  */
-void Filter::FindZeroCrossings(SparseDigitalWaveform* data, vector<int64_t>& edges)
+void Filter::FindZeroCrossingsUncached(SparseDigitalWaveform* data, vector<int64_t>& edges)
 {
-	pair<WaveformBase*, float> cachekey(data, 0);
-
-	//Check cache
-	{
-		lock_guard<mutex> lock(m_cacheMutex);
-		auto it = m_zeroCrossingCache.find(cachekey);
-		if(it != m_zeroCrossingCache.end())
-		{
-			edges = it->second;
-			return;
-		}
-	}
-
 	//Find times of the zero crossings
 	bool first = true;
 	bool last = data->m_samples[0];
@@ -544,16 +696,12 @@ void Filter::FindZeroCrossings(SparseDigitalWaveform* data, vector<int64_t>& edg
 		edges.push_back(phoff + data->m_timescale * data->m_offsets[i]);
 		last = value;
 	}
-
-	//Add to cache
-	lock_guard<mutex> lock(m_cacheMutex);
-	m_zeroCrossingCache[cachekey] = edges;
 }
 
 /**
 	@brief Find edges in a waveform, discarding repeated samples
  */
-void Filter::FindZeroCrossings(UniformDigitalWaveform* data, vector<int64_t>& edges)
+void Filter::FindZeroCrossingsUncached(UniformDigitalWaveform* data, vector<int64_t>& edges)
 {
 	//Find times of the zero crossings
 	bool first = true;
@@ -584,7 +732,7 @@ void Filter::FindZeroCrossings(UniformDigitalWaveform* data, vector<int64_t>& ed
 /**
 	@brief Find rising edges in a waveform
  */
-void Filter::FindRisingEdges(SparseDigitalWaveform* data, vector<int64_t>& edges)
+void Filter::FindRisingEdgesUncached(SparseDigitalWaveform* data, vector<int64_t>& edges)
 {
 	//Find times of the zero crossings
 	bool first = true;
@@ -614,7 +762,7 @@ void Filter::FindRisingEdges(SparseDigitalWaveform* data, vector<int64_t>& edges
 /**
 	@brief Find rising edges in a waveform
  */
-void Filter::FindRisingEdges(UniformDigitalWaveform* data, vector<int64_t>& edges)
+void Filter::FindRisingEdgesUncached(UniformDigitalWaveform* data, vector<int64_t>& edges)
 {
 	//Find times of the zero crossings
 	bool first = true;
@@ -644,7 +792,7 @@ void Filter::FindRisingEdges(UniformDigitalWaveform* data, vector<int64_t>& edge
 /**
 	@brief Find falling edges in a waveform
  */
-void Filter::FindFallingEdges(SparseDigitalWaveform* data, vector<int64_t>& edges)
+void Filter::FindFallingEdgesUncached(SparseDigitalWaveform* data, vector<int64_t>& edges)
 {
 	//Find times of the zero crossings
 	bool first = true;
@@ -674,7 +822,7 @@ void Filter::FindFallingEdges(SparseDigitalWaveform* data, vector<int64_t>& edge
 /**
 	@brief Find falling edges in a waveform
  */
-void Filter::FindFallingEdges(UniformDigitalWaveform* data, vector<int64_t>& edges)
+void Filter::FindFallingEdgesUncached(UniformDigitalWaveform* data, vector<int64_t>& edges)
 {
 	//Find times of the zero crossings
 	bool first = true;
@@ -710,12 +858,13 @@ void Filter::FindPeaks(UniformAnalogWaveform* data, float peak_threshold, vector
 
 	//Threshold first difference signal in digital format, to extract falling edges later on
 	//These falling edges will correspond to peaks in the input signal
-	auto thresh_diff = new UniformDigitalWaveform;
+	ScratchWaveform<UniformDigitalWaveform> thresh_diff(nullptr, "Filter.FindPeaks.thresh_diff", len);
 	thresh_diff->m_startTimestamp = data->m_startTimestamp;
 	thresh_diff->m_startFemtoseconds = data->m_startFemtoseconds;
 	thresh_diff->m_triggerPhase = data->m_triggerPhase;
 	thresh_diff->m_timescale = data->m_timescale;
 	thresh_diff->Resize(len);
+	thresh_diff->PrepareForCpuAccess();
 
 	float* fin = (float*)__builtin_assume_aligned(data->m_samples.GetCpuPointer(), 16);
 
@@ -755,8 +904,6 @@ void Filter::FindPeaks(UniformAnalogWaveform* data, float peak_threshold, vector
 
 		last = value;
 	}
-
-	delete thresh_diff;
 }
 
 /**
@@ -768,12 +915,13 @@ void Filter::FindPeaks(SparseAnalogWaveform* data, float peak_threshold, vector<
 
 	//Threshold first difference signal in digital format, to extract falling edges later on
 	//These falling edges will correspond to peaks in the input signal
-	auto thresh_diff = new SparseDigitalWaveform;
+	ScratchWaveform<SparseDigitalWaveform> thresh_diff(nullptr, "Filter.FindPeaks.thresh_diff", len);
 	thresh_diff->m_startTimestamp = data->m_startTimestamp;
 	thresh_diff->m_startFemtoseconds = data->m_startFemtoseconds;
 	thresh_diff->m_triggerPhase = data->m_triggerPhase;
 	thresh_diff->m_timescale = data->m_timescale;
 	thresh_diff->Resize(len);
+	thresh_diff->PrepareForCpuAccess();
 
 	bool cur = false;
 
@@ -813,8 +961,6 @@ void Filter::FindPeaks(SparseAnalogWaveform* data, float peak_threshold, vector<
 
 		last = value;
 	}
-
-	delete thresh_diff;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1039,10 +1185,492 @@ float Filter::InterpolateValue(UniformAnalogWaveform* cap, size_t index, float f
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Measurement helpers
 
+/**
+	@brief Finds the lowest and highest value in a block of samples, using all available cores for large inputs
+
+	@param samples	Sample data
+	@param len		Number of samples
+	@param vmin		Lowest value (FLT_MAX if len is zero)
+	@param vmax		Highest value (-FLT_MAX if len is zero)
+ */
+void Filter::GetMinMax(const float* samples, size_t len, float& vmin, float& vmax)
+{
+	const size_t blocksize = 1024 * 1024;
+	size_t nblocks = (len + blocksize - 1) / blocksize;
+
+	vector<float> blockMin(nblocks, FLT_MAX);
+	vector<float> blockMax(nblocks, -FLT_MAX);
+
+	#pragma omp parallel for if(nblocks > 1)
+	for(size_t block=0; block<nblocks; block++)
+	{
+		size_t start = block * blocksize;
+		size_t end = min(start + blocksize, len);
+
+		//Branch-free so the compiler can vectorize to packed min/max
+		float bmin = FLT_MAX;
+		float bmax = -FLT_MAX;
+		for(size_t i=start; i<end; i++)
+		{
+			float f = samples[i];
+			bmin = (f < bmin) ? f : bmin;
+			bmax = (f > bmax) ? f : bmax;
+		}
+		blockMin[block] = bmin;
+		blockMax[block] = bmax;
+	}
+
+	vmin = FLT_MAX;
+	vmax = -FLT_MAX;
+	for(size_t block=0; block<nblocks; block++)
+	{
+		vmin = min(vmin, blockMin[block]);
+		vmax = max(vmax, blockMax[block]);
+	}
+}
+
+/**
+	@brief Adds a block of samples to a histogram, using all available cores for large inputs
+
+	@param samples	Sample data
+	@param len		Number of samples
+	@param low		Low endpoint of the histogram
+	@param high		High endpoint of the histogram
+	@param bins		Number of histogram bins
+	@param clip		If true, values outside the range are discarded. If false, they go in the first or last bin.
+	@param hist		Histogram to add to (must have at least bins entries)
+ */
+void Filter::AccumulateHistogram(
+	const float* samples,
+	size_t len,
+	float low,
+	float high,
+	size_t bins,
+	bool clip,
+	size_t* hist)
+{
+	if( (bins == 0) || (len == 0) )
+		return;
+
+	float delta = high-low;
+
+	//Each thread gets a private histogram so threads don't contend on the bins, then we merge them.
+	//Blocks are handed out to threads, so the scratch space depends on the thread count and not the input length.
+	const size_t blocksize = 1024 * 1024;
+	size_t nblocks = (len + blocksize - 1) / blocksize;
+	size_t nthreads = min<size_t>(nblocks, omp_get_max_threads());
+	vector<size_t> partial;
+	if(nthreads > 1)
+		partial.resize(nthreads * bins, 0);
+
+	#pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+	{
+		size_t* out = (nthreads > 1) ? &partial[omp_get_thread_num() * bins] : hist;
+
+		#pragma omp for schedule(static)
+		for(size_t block=0; block<nblocks; block++)
+		{
+			size_t start = block * blocksize;
+			size_t end = min(start + blocksize, len);
+
+			for(size_t i=start; i<end; i++)
+			{
+				float fbin = (samples[i]-low) / delta;
+
+				//must cast through a signed int type to avoid UB (e.g. saturates to 0 on arm64) [conv.fpint]
+				int64_t bin = static_cast<int64_t>(floor(fbin * bins));
+				if(clip)
+				{
+					if( (bin < 0) || (bin >= static_cast<int64_t>(bins)) )
+						continue;
+				}
+				else if(fbin < 0)
+					bin = 0;
+				else
+					bin = min(bin, static_cast<int64_t>(bins-1));
+				out[bin] ++;
+			}
+		}
+	}
+
+	if(nthreads > 1)
+	{
+		for(size_t t=0; t<nthreads; t++)
+		{
+			const size_t* in = &partial[t * bins];
+			for(size_t i=0; i<bins; i++)
+				hist[i] += in[i];
+		}
+	}
+}
+
+/**
+	@brief Discards everything in the analysis cache
+ */
 void Filter::ClearAnalysisCache()
 {
-	lock_guard<mutex> lock(m_cacheMutex);
-	m_zeroCrossingCache.clear();
+	for(auto& shard : m_edgeCache)
+	{
+		lock_guard<shared_mutex> lock(shard.m_mutex);
+		shard.m_entries.clear();
+	}
+}
+
+/**
+	@brief Starts a new analysis cache generation, discarding entries which were not used in the previous one
+
+	Cache keys include the waveform revision, so results for inputs that have not changed remain valid across
+	evaluations of the filter graph. Anything not looked up during the previous generation is assumed to belong to a
+	waveform that has since changed or been deleted.
+ */
+void Filter::AgeAnalysisCache()
+{
+	uint64_t generation = ++m_analysisCacheGeneration;
+
+	for(auto& shard : m_edgeCache)
+	{
+		lock_guard<shared_mutex> lock(shard.m_mutex);
+		for(auto it = shard.m_entries.begin(); it != shard.m_entries.end(); )
+		{
+			if(it->second.m_lastUsed + 1 < generation)
+				it = shard.m_entries.erase(it);
+			else
+				++it;
+		}
+	}
+}
+
+/**
+	@brief Looks up a list of edges in the analysis cache, computing and inserting it if not already present
+
+	@param data			The waveform being analyzed
+	@param type			Which edges are being searched for
+	@param threshold	Threshold level (ignored for digital waveforms, pass 0)
+	@param compute		Function to find the edges on a cache miss
+
+	@return The shared edge list
+ */
+Filter::EdgeList Filter::LookupEdgeCache(
+	WaveformBase* data,
+	EdgeCacheType type,
+	float threshold,
+	const function<void(vector<int64_t>&)>& compute)
+{
+	EdgeCacheKey key(data, type, threshold);
+	uint64_t generation = m_analysisCacheGeneration;
+
+	//Spread waveforms across shards. Low bits of heap pointers are always zero so skip them.
+	auto addr = reinterpret_cast<uintptr_t>(data);
+	auto& shard = m_edgeCache[((addr >> 4) ^ (addr >> 12)) % EDGE_CACHE_SHARDS];
+
+	//Check cache
+	{
+		shared_lock<shared_mutex> lock(shard.m_mutex);
+		auto it = shard.m_entries.find(key);
+		if(it != shard.m_entries.end())
+		{
+			it->second.m_lastUsed = generation;
+			return it->second.m_edges;
+		}
+	}
+
+	//Not found, do the work without holding the lock so other threads can use the shard meanwhile
+	auto edges = make_shared<vector<int64_t> >();
+	compute(*edges);
+	if(edges->capacity() > 2*edges->size())
+		edges->shrink_to_fit();
+
+	//If another thread got there first, use their copy so everyone shares one list
+	lock_guard<shared_mutex> lock(shard.m_mutex);
+	return shard.m_entries.try_emplace(key, edges, generation).first->second.m_edges;
+}
+
+/**
+	@brief Find rising edges in a waveform, interpolating to sub-sample resolution as necessary
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetRisingEdges(UniformAnalogWaveform* data, float threshold)
+{
+	return LookupEdgeCache(data, EDGES_RISING, threshold,
+		[&](vector<int64_t>& edges) { FindRisingEdgesUncached(data, threshold, edges); });
+}
+
+/**
+	@brief Find rising edges in a waveform, interpolating to sub-sample resolution as necessary
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetRisingEdges(SparseAnalogWaveform* data, float threshold)
+{
+	return LookupEdgeCache(data, EDGES_RISING, threshold,
+		[&](vector<int64_t>& edges) { FindRisingEdgesUncached(data, threshold, edges); });
+}
+
+/**
+	@brief Find zero crossings in a waveform, interpolating as necessary
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetZeroCrossings(SparseAnalogWaveform* data, float threshold)
+{
+	return LookupEdgeCache(data, EDGES_ALL, threshold,
+		[&](vector<int64_t>& edges) { FindZeroCrossingsUncached(data, threshold, edges); });
+}
+
+/**
+	@brief Find zero crossings in a waveform, interpolating as necessary
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetZeroCrossings(UniformAnalogWaveform* data, float threshold)
+{
+	return LookupEdgeCache(data, EDGES_ALL, threshold,
+		[&](vector<int64_t>& edges) { FindZeroCrossingsUncached(data, threshold, edges); });
+}
+
+/**
+	@brief Find edges in a waveform, discarding repeated samples
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetZeroCrossings(SparseDigitalWaveform* data)
+{
+	return LookupEdgeCache(data, EDGES_ALL, 0,
+		[&](vector<int64_t>& edges) { FindZeroCrossingsUncached(data, edges); });
+}
+
+/**
+	@brief Find edges in a waveform, discarding repeated samples
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetZeroCrossings(UniformDigitalWaveform* data)
+{
+	return LookupEdgeCache(data, EDGES_ALL, 0,
+		[&](vector<int64_t>& edges) { FindZeroCrossingsUncached(data, edges); });
+}
+
+/**
+	@brief Find rising edges in a waveform
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetRisingEdges(SparseDigitalWaveform* data)
+{
+	return LookupEdgeCache(data, EDGES_RISING, 0,
+		[&](vector<int64_t>& edges) { FindRisingEdgesUncached(data, edges); });
+}
+
+/**
+	@brief Find rising edges in a waveform
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetRisingEdges(UniformDigitalWaveform* data)
+{
+	return LookupEdgeCache(data, EDGES_RISING, 0,
+		[&](vector<int64_t>& edges) { FindRisingEdgesUncached(data, edges); });
+}
+
+/**
+	@brief Find falling edges in a waveform
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetFallingEdges(SparseDigitalWaveform* data)
+{
+	return LookupEdgeCache(data, EDGES_FALLING, 0,
+		[&](vector<int64_t>& edges) { FindFallingEdgesUncached(data, edges); });
+}
+
+/**
+	@brief Find falling edges in a waveform
+
+	The result is cached and shared with other callers analyzing the same revision of the waveform.
+ */
+Filter::EdgeList Filter::GetFallingEdges(UniformDigitalWaveform* data)
+{
+	return LookupEdgeCache(data, EDGES_FALLING, 0,
+		[&](vector<int64_t>& edges) { FindFallingEdgesUncached(data, edges); });
+}
+
+void Filter::FindRisingEdges(UniformAnalogWaveform* data, float threshold, vector<int64_t>& edges)
+{
+	edges = *GetRisingEdges(data, threshold);
+}
+
+void Filter::FindRisingEdges(SparseAnalogWaveform* data, float threshold, vector<int64_t>& edges)
+{
+	edges = *GetRisingEdges(data, threshold);
+}
+
+void Filter::FindZeroCrossings(SparseAnalogWaveform* data, float threshold, vector<int64_t>& edges)
+{
+	edges = *GetZeroCrossings(data, threshold);
+}
+
+void Filter::FindZeroCrossings(UniformAnalogWaveform* data, float threshold, vector<int64_t>& edges)
+{
+	edges = *GetZeroCrossings(data, threshold);
+}
+
+void Filter::FindZeroCrossings(SparseDigitalWaveform* data, vector<int64_t>& edges)
+{
+	edges = *GetZeroCrossings(data);
+}
+
+void Filter::FindZeroCrossings(UniformDigitalWaveform* data, vector<int64_t>& edges)
+{
+	edges = *GetZeroCrossings(data);
+}
+
+void Filter::FindRisingEdges(SparseDigitalWaveform* data, vector<int64_t>& edges)
+{
+	edges = *GetRisingEdges(data);
+}
+
+void Filter::FindRisingEdges(UniformDigitalWaveform* data, vector<int64_t>& edges)
+{
+	edges = *GetRisingEdges(data);
+}
+
+void Filter::FindFallingEdges(SparseDigitalWaveform* data, vector<int64_t>& edges)
+{
+	edges = *GetFallingEdges(data);
+}
+
+void Filter::FindFallingEdges(UniformDigitalWaveform* data, vector<int64_t>& edges)
+{
+	edges = *GetFallingEdges(data);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Waveform recycling
+
+/**
+	@brief Replaces the waveform on an output stream, returning the old one to the recycling pool
+ */
+void Filter::SetData(WaveformBase* pNew, size_t stream)
+{
+	auto old = GetData(stream);
+	if(old == pNew)
+		return;
+
+	Detach(stream);
+	RecycleWaveform(old);
+	OscilloscopeChannel::SetData(pNew, stream);
+}
+
+/**
+	@brief Gets this filter's recycling pool for a given waveform type
+
+	Each filter has its own pools, so recycled buffers are sized for its own streams and are freed along with it.
+	Output and scratch waveforms are kept in separate pools, since scratch waveforms are typically marked as CPU-only
+	and handing one out as a filter output would leave it without a GPU buffer.
+
+	@param type		Exact type of the waveform
+	@param scratch	True to get the pool for CPU-side temporaries, false for filter outputs
+
+	@return The pool, or nullptr if waveforms of this type are not recycled
+ */
+WaveformPool* Filter::GetWaveformPool(const type_info& type, bool scratch)
+{
+	WaveformPoolType index;
+	if(type == typeid(UniformAnalogWaveform))
+		index = POOL_UNIFORM_ANALOG;
+	else if(type == typeid(SparseAnalogWaveform))
+		index = POOL_SPARSE_ANALOG;
+	else if(type == typeid(UniformDigitalWaveform))
+		index = POOL_UNIFORM_DIGITAL;
+	else if(type == typeid(SparseDigitalWaveform))
+		index = POOL_SPARSE_DIGITAL;
+	else
+		return nullptr;
+
+	if(scratch)
+		return &m_scratchWaveformPools[index];
+	else
+		return &m_outputWaveformPools[index];
+}
+
+/**
+	@brief Returns a waveform to this filter's recycling pool, or deletes it if waveforms of its type are not recycled
+
+	@param w		The waveform (may be null). Ownership is transferred to the pool.
+	@param scratch	True if the waveform was allocated as a CPU-side temporary
+ */
+void Filter::RecycleWaveform(WaveformBase* w, bool scratch)
+{
+	if(!w)
+		return;
+
+	auto pool = GetWaveformPool(typeid(*w), scratch);
+	if(pool)
+		pool->Add(w);
+	else
+		delete w;
+}
+
+/**
+	@brief Free all waveforms in this filter's recycling pools to reclaim memory
+
+	@return True if memory was freed, false if pools were already empty
+ */
+bool Filter::FreeWaveformPools()
+{
+	bool freed = false;
+	for(size_t i=0; i<POOL_COUNT; i++)
+	{
+		freed |= m_outputWaveformPools[i].clear();
+		freed |= m_scratchWaveformPools[i].clear();
+	}
+	return freed;
+}
+
+/**
+	@brief Free all waveforms in every filter's recycling pools to reclaim memory
+
+	@return True if memory was freed, false if pools were already empty
+ */
+bool Filter::FreeAllWaveformPools()
+{
+	bool freed = false;
+	for(auto f : m_filters)
+		freed |= f->FreeWaveformPools();
+	return freed;
+}
+
+/**
+	@brief Prints reuse statistics for this filter's recycling pools to the debug log
+ */
+void Filter::LogWaveformPoolStatistics()
+{
+	static const char* names[POOL_COUNT] =
+	{
+		"UniformAnalogWaveform",
+		"SparseAnalogWaveform",
+		"UniformDigitalWaveform",
+		"SparseDigitalWaveform"
+	};
+
+	LogDebug("Waveform pool statistics for %s:\n", GetDisplayName().c_str());
+	LogIndenter li;
+	for(size_t i=0; i<POOL_COUNT; i++)
+	{
+		for(int scratch=0; scratch<2; scratch++)
+		{
+			auto& pool = scratch ? m_scratchWaveformPools[i] : m_outputWaveformPools[i];
+			LogDebug("%-22s %-7s: %zu free, %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " undersized, %" PRIu64 " discarded\n",
+				names[i],
+				scratch ? "scratch" : "output",
+				pool.size(),
+				pool.GetHitCount(),
+				pool.GetMissCount(),
+				pool.GetReallocationCount(),
+				pool.GetDiscardCount());
+		}
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1065,7 +1693,7 @@ UniformAnalogWaveform* Filter::SetupEmptyUniformAnalogOutputWaveform(WaveformBas
 	auto cap = dynamic_cast<UniformAnalogWaveform*>(GetData(stream));
 	if(cap == NULL)
 	{
-		cap = new UniformAnalogWaveform;
+		cap = AllocateWaveform<UniformAnalogWaveform>("", din->size());
 		SetData(cap, stream);
 	}
 
@@ -1102,7 +1730,7 @@ SparseAnalogWaveform* Filter::SetupEmptySparseAnalogOutputWaveform(WaveformBase*
 	auto cap = dynamic_cast<SparseAnalogWaveform*>(GetData(stream));
 	if(cap == NULL)
 	{
-		cap = new SparseAnalogWaveform;
+		cap = AllocateWaveform<SparseAnalogWaveform>("", din->size());
 		SetData(cap, stream);
 	}
 
@@ -1138,7 +1766,7 @@ UniformDigitalWaveform* Filter::SetupEmptyUniformDigitalOutputWaveform(WaveformB
 	auto cap = dynamic_cast<UniformDigitalWaveform*>(GetData(stream));
 	if(cap == NULL)
 	{
-		cap = new UniformDigitalWaveform;
+		cap = AllocateWaveform<UniformDigitalWaveform>("", din->size());
 		SetData(cap, stream);
 	}
 
@@ -1173,7 +1801,7 @@ SparseDigitalWaveform* Filter::SetupEmptySparseDigitalOutputWaveform(WaveformBas
 	auto cap = dynamic_cast<SparseDigitalWaveform*>(GetData(stream));
 	if(cap == NULL)
 	{
-		cap = new SparseDigitalWaveform;
+		cap = AllocateWaveform<SparseDigitalWaveform>("", din->size());
 		SetData(cap, stream);
 	}
 
@@ -1245,7 +1873,7 @@ SparseDigitalWaveform* Filter::SetupSparseDigitalOutputWaveform(SparseWaveformBa
 	auto cap = dynamic_cast<SparseDigitalWaveform*>(GetData(stream));
 	if(cap == NULL)
 	{
-		cap = new SparseDigitalWaveform;
+		cap = AllocateWaveform<SparseDigitalWaveform>("", din->size());
 		SetData(cap, stream);
 	}
 
@@ -1601,6 +2229,9 @@ bool Filter::NeedsConfig()
 
 void Filter::ClearStreams()
 {
+	for(size_t i=0; i<GetStreamCount(); i++)
+		RecycleWaveform(Detach(i));
+
 	OscilloscopeChannel::ClearStreams();
 	m_ranges.clear();
 	m_offsets.clear();
@@ -39,6 +39,9 @@
 
 #include "OscilloscopeChannel.h"
 #include "FlowGraphNode.h"
+#include <functional>
+#include <tuple>
+#include <typeinfo>
 
 class QueueHandle;
 
@@ -244,6 +247,96 @@ public:
 	//GPU accelerated refresh method
 	virtual void Refresh(vk::raii::CommandBuffer& cmdBuf, std::shared_ptr<QueueHandle> queue) override;
 
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Waveform recycling
+
+public:
+	virtual void SetData(WaveformBase* pNew, size_t stream) override;
+
+	WaveformPool* GetWaveformPool(const std::type_info& type, bool scratch = false);
+	void RecycleWaveform(WaveformBase* w, bool scratch = false);
+	bool FreeWaveformPools();
+	void LogWaveformPoolStatistics();
+
+	static bool FreeAllWaveformPools();
+
+	/**
+		@brief Gets a waveform of type T from this filter's recycling pool, or allocates a new one if none is available
+
+		@param name			Name for the waveform
+		@param minCapacity	Number of samples the caller expects to store, if known
+		@param scratch		True to use the pool for CPU-side temporaries rather than filter outputs
+
+		@return The waveform. Contents are unspecified, call clear() or Resize() before use.
+	 */
+	template<class T>
+	T* AllocateWaveform(const std::string& name = "", size_t minCapacity = 0, bool scratch = false)
+	{
+		auto pool = GetWaveformPool(typeid(T), scratch);
+		if(pool)
+		{
+			//Pools are keyed by exact type so no need for dynamic_cast here
+			auto p = static_cast<T*>(pool->Get(minCapacity));
+			if(p)
+			{
+				p->Rename(name);
+				return p;
+			}
+		}
+
+		auto p = new T;
+		if(!name.empty())
+			p->Rename(name);
+		return p;
+	}
+
+	/**
+		@brief A temporary waveform borrowed from a filter's scratch pool and returned to it when it goes out of scope
+
+		Use this instead of a stack-allocated waveform for per-refresh temporaries (e.g. sampled data streams) so
+		the underlying buffers don't get allocated and freed on every refresh. The waveform is marked as CPU-only,
+		so no GPU memory is allocated for it.
+
+		Static helpers with no filter to borrow from can pass a null owner, in which case the waveform is simply
+		allocated on construction and deleted when it goes out of scope.
+	 */
+	template<class T>
+	class ScratchWaveform
+	{
+	public:
+		ScratchWaveform(Filter* owner, const std::string& name = "", size_t minCapacity = 0)
+		: m_owner(owner)
+		, m_waveform(owner ? owner->AllocateWaveform<T>(name, minCapacity, true) : new T(name))
+		{
+			m_waveform->SetCpuOnlyHint();
+			m_waveform->clear();
+		}
+
+		~ScratchWaveform()
+		{
+			if(m_owner)
+				m_owner->RecycleWaveform(m_waveform, true);
+			else
+				delete m_waveform;
+		}
+
+		ScratchWaveform(const ScratchWaveform&) =delete;
+		ScratchWaveform& operator=(const ScratchWaveform&) =delete;
+
+		T& operator*()
+		{ return *m_waveform; }
+
+		T* operator->()
+		{ return m_waveform; }
+
+		T* get()
+		{ return m_waveform; }
+
+	protected:
+		Filter* m_owner;
+		T* m_waveform;
+	};
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Vertical scaling
 
@@ -366,7 +459,7 @@ protected:
 		auto cap = dynamic_cast<T*>(GetData(stream));
 		if(cap == nullptr)
 		{
-			cap = new T;
+			cap = AllocateWaveform<T>("", din ? din->size() : 0);
 			SetData(cap, stream);
 		}
 
@@ -460,17 +553,20 @@ public:
 	{
 		AssertTypeIsAnalogWaveform(cap);
 
-		vmin = FLT_MAX;
-		vmax = FLT_MIN;
-		for(float f : cap->m_samples)
-		{
-			if(f < vmin)
-				vmin = f;
-			if(f > vmax)
-				vmax = f;
-		}
+		GetMinMax(cap->m_samples.GetCpuPointer(), cap->size(), vmin, vmax);
 	}
 
+	static void GetMinMax(const float* samples, size_t len, float& vmin, float& vmax);
+
+	static void AccumulateHistogram(
+		const float* samples,
+		size_t len,
+		float low,
+		float high,
+		size_t bins,
+		bool clip,
+		size_t* hist);
+
 	/**
 		@brief Gets the min and max voltage of a waveform on the GPU
 	 */
@@ -489,6 +585,14 @@ public:
 	{
 		AssertTypeIsAnalogWaveform(cap);
 
+		//CPU-only mode
+		if(!g_gpuFilterEnabled)
+		{
+			cap->PrepareForCpuAccess();
+			GetMinMaxVoltage(cap, vmin, vmax);
+			return;
+		}
+
 		//GPU side min/max
 		const uint32_t nthreads = 4096;
 		const uint32_t threadsPerBlock = 64;
@@ -674,11 +778,14 @@ public:
 		AssertTypeIsAnalogWaveform(cap);
 
 		//Loop over samples and find the average
-		//TODO: more numerically stable summation algorithm for deep captures
+		//Per-thread partial sums in double precision keep deep captures reasonably stable
+		size_t len = cap->m_samples.size();
+		const float* samples = cap->m_samples.GetCpuPointer();
 		double sum = 0;
-		for(float f : cap->m_samples)
-			sum += f;
-		return sum / cap->m_samples.size();
+		#pragma omp parallel for simd reduction(+:sum) if(len > 1000000)
+		for(size_t i=0; i<len; i++)
+			sum += samples[i];
+		return sum / len;
 	}
 
 	/**
@@ -707,27 +814,8 @@ public:
 	{
 		AssertTypeIsAnalogWaveform(cap);
 
-		std::vector<size_t> ret;
-		for(size_t i=0; i<bins; i++)
-			ret.push_back(0);
-
-		//Early out if we have zero span
-		if(bins == 0)
-			return ret;
-
-		float delta = high-low;
-
-		for(float v : cap->m_samples)
-		{
-			float fbin = (v-low) / delta;
-			size_t bin = floor(fbin * bins);
-			if(fbin < 0)
-				bin = 0;
-			else
-				bin = std::min(bin, bins-1);
-			ret[bin] ++;
-		}
-
+		std::vector<size_t> ret(bins, 0);
+		AccumulateHistogram(cap->m_samples.GetCpuPointer(), cap->size(), low, high, bins, false, ret.data());
 		return ret;
 	}
 
@@ -778,6 +866,20 @@ public:
 		if(bins == 0)
 			return;
 
+		//CPU-only mode
+		if(!g_gpuFilterEnabled)
+		{
+			cap->PrepareForCpuAccess();
+			hist.resize(bins);
+			hist.PrepareForCpuAccess();
+			std::vector<size_t> tmp(bins, 0);
+			AccumulateHistogram(cap->m_samples.GetCpuPointer(), cap->size(), low, high, bins, false, tmp.data());
+			for(size_t i=0; i<bins; i++)
+				hist[i] = tmp[i];
+			hist.MarkModifiedFromCpu();
+			return;
+		}
+
 		const uint32_t nthreads = 4096;
 		const uint32_t threadsPerBlock = 8;
 
@@ -821,29 +923,19 @@ public:
 	{
 		AssertTypeIsAnalogWaveform(cap);
 
-		std::vector<size_t> ret;
-		for(size_t i=0; i<bins; i++)
-			ret.push_back(0);
-
-		//Early out if we have zero span
-		if(bins == 0)
-			return ret;
-
-		float delta = high-low;
-
-		for(float v : cap->m_samples)
-		{
-			float fbin = (v-low) / delta;
-			// must cast through a signed int type to avoid UB (e.g. saturates to 0 on arm64) [conv.fpint]
-			size_t bin = static_cast<ssize_t>(floor(fbin * bins));
-			if(bin >= bins)	//negative values wrap to huge positive and get caught here
-				continue;
-			ret[bin] ++;
-		}
-
+		std::vector<size_t> ret(bins, 0);
+		AccumulateHistogram(cap->m_samples.GetCpuPointer(), cap->size(), low, high, bins, true, ret.data());
 		return ret;
 	}
 
+	///@brief Types of clock edge to sample on
+	enum ClockEdgeType
+	{
+		CLOCK_EDGE_RISING,
+		CLOCK_EDGE_FALLING,
+		CLOCK_EDGE_ANY
+	};
+
 	/**
 		@brief Samples a waveform on all edges of a clock
 
@@ -872,64 +964,10 @@ public:
 		data->PrepareForCpuAccess();
 		samples.PrepareForCpuAccess();
 
-		//TODO: split up into blocks and multithread?
-		//TODO: AVX vcompress?
-		size_t len = clock->size();
-		size_t dlen = data->size();
-
-		//If the clock is sparse, assume it probably has edges on every sample and allocate that much buffer to start
-		//(we might overallocate here but it'll be a lot faster)
-		if(dynamic_cast<SparseDigitalWaveform*>(clock) != nullptr)
-		{
-			//Allocate exactly enough space
-			samples.Resize(clock->size());
+		SampleOnClockEdges(data, clock, samples, CLOCK_EDGE_ANY,
+			[data](size_t ndata, int64_t /*clkstart*/) -> S
+			{ return data->m_samples[ndata]; });
 
-			size_t ndata = 0;
-			size_t nout = 0;
-			for(size_t i=1; i<len; i++)
-			{
-				//Throw away clock samples until we find an edge
-				if(clock->m_samples[i] == clock->m_samples[i-1])
-					continue;
-
-				//Throw away data samples until the data is synced with us
-				int64_t clkstart = GetOffsetScaled(clock, i);
-				while( (ndata+1 < dlen) && (GetOffsetScaled(data, ndata+1) < clkstart) )
-					ndata ++;
-				if(ndata >= dlen)
-					break;
-
-				//Add the new sample
-				samples.m_offsets[nout] = clkstart;
-				samples.m_samples[nout] = data->m_samples[ndata];
-				nout ++;
-			}
-			samples.Resize(nout);
-		}
-		else
-		{
-			samples.Reserve(1 * 1024 * 1024);	//preallocate 1 MB sample buffer to avoid lots of reallocation when small
-												//if it's smaller than this, we won't waste a lot of memory
-
-			size_t ndata = 0;
-			for(size_t i=1; i<len; i++)
-			{
-				//Throw away clock samples until we find an edge
-				if(clock->m_samples[i] == clock->m_samples[i-1])
-					continue;
-
-				//Throw away data samples until the data is synced with us
-				int64_t clkstart = GetOffsetScaled(clock, i);
-				while( (ndata+1 < dlen) && (GetOffsetScaled(data, ndata+1) < clkstart) )
-					ndata ++;
-				if(ndata >= dlen)
-					break;
-
-				//Add the new sample
-				samples.m_offsets.push_back(clkstart);
-				samples.m_samples.push_back(data->m_samples[ndata]);
-			}
-		}
 		samples.MarkModifiedFromCpu();
 
 		//Compute sample durations
@@ -1002,33 +1040,10 @@ public:
 
 		samples.clear();
 		samples.SetGpuAccessHint(AcceleratorBuffer<S>::HINT_NEVER);	//assume we're being used as part of a CPU-side filter
-		samples.Reserve(1 * 1024 * 1024);	//preallocate 1 MB sample buffer to avoid lots of reallocation when small
-											//if it's smaller than this, we won't waste a lot of memory
 
-		//TODO: split up into blocks and multithread?
-		//TODO: AVX vcompress?
-
-		size_t len = clock->size();
-		size_t dlen = data->size();
-
-		size_t ndata = 0;
-		for(size_t i=1; i<len; i++)
-		{
-			//Throw away clock samples until we find a rising edge
-			if(!(clock->m_samples[i] && !clock->m_samples[i-1]))
-				continue;
-
-			//Throw away data samples until the data is synced with us
-			int64_t clkstart = GetOffsetScaled(clock, i);
-			while( (ndata+1 < dlen) && (GetOffsetScaled(data, ndata+1) < clkstart) )
-				ndata ++;
-			if(ndata >= dlen)
-				break;
-
-			//Add the new sample
-			samples.m_offsets.push_back(clkstart);
-			samples.m_samples.push_back(data->m_samples[ndata]);
-		}
+		SampleOnClockEdges(data, clock, samples, CLOCK_EDGE_RISING,
+			[data](size_t ndata, int64_t /*clkstart*/) -> S
+			{ return data->m_samples[ndata]; });
 
 		//Compute sample durations
 		#ifdef __x86_64__
@@ -1100,33 +1115,10 @@ public:
 
 		samples.clear();
 		samples.SetGpuAccessHint(AcceleratorBuffer<S>::HINT_NEVER);	//assume we're being used as part of a CPU-side filter
-		samples.Reserve(1 * 1024 * 1024);	//preallocate 1 MB sample buffer to avoid lots of reallocation when small
-											//if it's smaller than this, we won't waste a lot of memory
-
-		//TODO: split up into blocks and multithread?
-		//TODO: AVX vcompress?
 
-		size_t len = clock->size();
-		size_t dlen = data->size();
-
-		size_t ndata = 0;
-		for(size_t i=1; i<len; i++)
-		{
-			//Throw away clock samples until we find a falling edge
-			if(!(!clock->m_samples[i] && clock->m_samples[i-1]))
-				continue;
-
-			//Throw away data samples until the data is synced with us
-			int64_t clkstart = GetOffsetScaled(clock, i);
-			while( (ndata+1 < dlen) && (GetOffsetScaled(data, ndata+1) < clkstart) )
-				ndata ++;
-			if(ndata >= dlen)
-				break;
-
-			//Add the new sample
-			samples.m_offsets.push_back(clkstart);
-			samples.m_samples.push_back(data->m_samples[ndata]);
-		}
+		SampleOnClockEdges(data, clock, samples, CLOCK_EDGE_FALLING,
+			[data](size_t ndata, int64_t /*clkstart*/) -> S
+			{ return data->m_samples[ndata]; });
 
 		//Compute sample durations
 		#ifdef __x86_64__
@@ -1160,38 +1152,16 @@ public:
 
 		samples.clear();
 		samples.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);	//assume we're being used as part of a CPU-side filter
-		samples.Reserve(1 * 1024 * 1024);	//preallocate 1 MB sample buffer to avoid lots of reallocation when small
-											//if it's smaller than this, we won't waste a lot of memory
-
-		//TODO: split up into blocks and multithread?
-		//TODO: AVX vcompress
-
-		size_t len = clock->size();
-		size_t dlen = data->size();
-
-		size_t ndata = 0;
-		for(size_t i=1; i<len; i++)
-		{
-			//Throw away clock samples until we find an edge
-			if(clock->m_samples[i] == clock->m_samples[i-1])
-				continue;
 
-			//Throw away data samples until the data is synced with us
-			int64_t clkstart = GetOffsetScaled(clock, i);
-			while( (ndata+1 < dlen) && (GetOffsetScaled(data, ndata+1) < clkstart) )
-				ndata ++;
-			if(ndata >= dlen)
-				break;
-
-			//Find the fractional position of the clock edge
-			int64_t tsample = GetOffsetScaled(data, ndata);
-			int64_t delta = clkstart - tsample;
-			float frac = delta * 1.0 / data->m_timescale;
-
-			//Add the new sample
-			samples.m_offsets.push_back(clkstart);
-			samples.m_samples.push_back(InterpolateValue(data, ndata, frac));
-		}
+		SampleOnClockEdges(data, clock, samples, CLOCK_EDGE_ANY,
+			[data](size_t ndata, int64_t clkstart) -> float
+			{
+				//Find the fractional position of the clock edge
+				int64_t tsample = GetOffsetScaled(data, ndata);
+				int64_t delta = clkstart - tsample;
+				float frac = delta * 1.0 / data->m_timescale;
+				return InterpolateValue(data, ndata, frac);
+			});
 
 		//Compute sample durations
 		#ifdef __x86_64__
@@ -1264,6 +1234,20 @@ public:
 			u->PrepareForGpuAccess();
 	}
 
+	///@brief Shared, read-only list of edge timestamps from the analysis cache
+	typedef std::shared_ptr<const std::vector<int64_t> > EdgeList;
+
+	static EdgeList GetRisingEdges(UniformAnalogWaveform* data, float threshold);
+	static EdgeList GetRisingEdges(SparseAnalogWaveform* data, float threshold);
+	static EdgeList GetZeroCrossings(SparseAnalogWaveform* data, float threshold);
+	static EdgeList GetZeroCrossings(UniformAnalogWaveform* data, float threshold);
+	static EdgeList GetZeroCrossings(UniformDigitalWaveform* data);
+	static EdgeList GetZeroCrossings(SparseDigitalWaveform* data);
+	static EdgeList GetRisingEdges(UniformDigitalWaveform* data);
+	static EdgeList GetRisingEdges(SparseDigitalWaveform* data);
+	static EdgeList GetFallingEdges(UniformDigitalWaveform* data);
+	static EdgeList GetFallingEdges(SparseDigitalWaveform* data);
+
 	static void FindRisingEdges(UniformAnalogWaveform* data, float threshold, std::vector<int64_t>& edges);
 	static void FindRisingEdges(SparseAnalogWaveform* data, float threshold, std::vector<int64_t>& edges);
 	static void FindZeroCrossings(SparseAnalogWaveform* data, float threshold, std::vector<int64_t>& edges);
@@ -1334,7 +1318,35 @@ public:
 	}
 
 	static void ClearAnalysisCache();
+	static void AgeAnalysisCache();
+
+protected:
+	static void FindRisingEdgesUncached(UniformAnalogWaveform* data, float threshold, std::vector<int64_t>& edges);
+	static void FindRisingEdgesUncached(SparseAnalogWaveform* data, float threshold, std::vector<int64_t>& edges);
+	static void FindZeroCrossingsUncached(SparseAnalogWaveform* data, float threshold, std::vector<int64_t>& edges);
+	static void FindZeroCrossingsUncached(UniformAnalogWaveform* data, float threshold, std::vector<int64_t>& edges);
+	static void FindZeroCrossingsUncached(UniformDigitalWaveform* data, std::vector<int64_t>& edges);
+	static void FindZeroCrossingsUncached(SparseDigitalWaveform* data, std::vector<int64_t>& edges);
+	static void FindRisingEdgesUncached(UniformDigitalWaveform* data, std::vector<int64_t>& edges);
+	static void FindRisingEdgesUncached(SparseDigitalWaveform* data, std::vector<int64_t>& edges);
+	static void FindFallingEdgesUncached(UniformDigitalWaveform* data, std::vector<int64_t>& edges);
+	static void FindFallingEdgesUncached(SparseDigitalWaveform* data, std::vector<int64_t>& edges);
+
+	///@brief Kinds of edge list stored in the analysis cache
+	enum EdgeCacheType
+	{
+		EDGES_ALL,
+		EDGES_RISING,
+		EDGES_FALLING
+	};
+
+	static EdgeList LookupEdgeCache(
+		WaveformBase* data,
+		EdgeCacheType type,
+		float threshold,
+		const std::function<void(std::vector<int64_t>&)>& compute);
 
+public:
 	enum FIRFilterType
 	{
 		FILTER_TYPE_LOWPASS,
@@ -1358,6 +1370,116 @@ protected:
 	static void FillDurationsAVX2(SparseWaveformBase& wfm);
 #endif
 
+	//Helpers for sampling on clock edges
+	static size_t FindClockEdges(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes);
+	static size_t FindClockEdgesGeneric(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes);
+#ifdef __x86_64__
+	static size_t FindClockEdgesAVX2(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes);
+	static size_t FindClockEdgesAVX512F(const bool* clock, size_t start, size_t end, ClockEdgeType type, size_t* indexes);
+#endif
+
+	/**
+		@brief Finds the data sample in effect at a given time
+
+		Returns the last sample starting strictly before the timestamp (or the first sample if none do).
+		This is the same index a linear scan from the start of the waveform would stop at.
+
+		@param data		The data waveform. Must not be empty.
+		@param t		Timestamp, in femtoseconds
+	 */
+	template<class T>
+	static size_t FindDataIndexBefore(T* data, int64_t t)
+	{
+		size_t lo = 0;
+		size_t hi = data->size() - 1;
+		while(lo < hi)
+		{
+			size_t mid = lo + (hi - lo + 1) / 2;
+			if(GetOffsetScaled(data, mid) < t)
+				lo = mid;
+			else
+				hi = mid - 1;
+		}
+		return lo;
+	}
+
+	/**
+		@brief Common implementation of the SampleOn*Edges() family
+
+		The clock is split into blocks. The edges in each block are counted first so the output can be sized
+		exactly, then each block extracts its edge indexes with SIMD compaction and resyncs the data independently,
+		so long clocks are processed in parallel.
+
+		@param data		The data signal to sample
+		@param clock	The clock signal to use
+		@param samples	Output waveform. Must be empty.
+		@param type		Type of clock edge to sample on
+		@param sampler	Functor returning the output value given the synced data index and clock edge timestamp
+	 */
+	template<class T, class R, class S, class F>
+	static void SampleOnClockEdges(T* data, R* clock, SparseWaveform<S>& samples, ClockEdgeType type, F sampler)
+	{
+		size_t len = clock->size();
+		size_t dlen = data->size();
+		if( (len < 2) || (dlen == 0) )
+			return;
+
+		const bool* pclk = clock->m_samples.GetCpuPointer();
+
+		//Count edges in each block so we know where its output goes
+		const size_t blocksize = 65536;
+		size_t nblocks = (len - 1 + blocksize - 1) / blocksize;
+		std::vector<size_t> blockOffsets(nblocks + 1, 0);
+		#pragma omp parallel for if(nblocks > 1)
+		for(size_t b=0; b<nblocks; b++)
+		{
+			size_t start = 1 + b*blocksize;
+			size_t end = std::min(start + blocksize, len);
+			blockOffsets[b+1] = FindClockEdges(pclk, start, end, type, nullptr);
+		}
+		for(size_t b=0; b<nblocks; b++)
+			blockOffsets[b+1] += blockOffsets[b];
+		samples.Resize(blockOffsets[nblocks]);
+
+		#pragma omp parallel for if(nblocks > 1)
+		for(size_t b=0; b<nblocks; b++)
+		{
+			size_t nout = blockOffsets[b];
+			if(nout == blockOffsets[b+1])
+				continue;
+
+			size_t start = 1 + b*blocksize;
+			size_t end = std::min(start + blocksize, len);
+
+			//Extract edges in small batches so the index buffer stays in L1
+			const size_t batchsize = 1024;
+			size_t indexes[batchsize];
+			bool synced = false;
+			size_t ndata = 0;
+			for(size_t base = start; base < end; base += batchsize)
+			{
+				size_t nedges = FindClockEdges(pclk, base, std::min(base + batchsize, end), type, indexes);
+				for(size_t j=0; j<nedges; j++)
+				{
+					//Throw away data samples until the data is synced with us
+					int64_t clkstart = GetOffsetScaled(clock, indexes[j]);
+					if(!synced)
+					{
+						ndata = FindDataIndexBefore(data, clkstart);
+						synced = true;
+					}
+					while( (ndata+1 < dlen) && (GetOffsetScaled(data, ndata+1) < clkstart) )
+						ndata ++;
+
+					//Add the new sample
+					samples.m_offsets[nout] = clkstart;
+					samples.m_samples[nout] = sampler(ndata, clkstart);
+					nout ++;
+				}
+			}
+		}
+	}
+
 public:
 	sigc::signal<void()> signal_outputsChanged()
 	{ return m_outputsChangedSignal; }
@@ -1391,9 +1513,72 @@ protected:
 	//Instance naming
 	static std::map<std::string, unsigned int> m_instanceCount;
 
+	//Waveform recycling, indexed by WaveformPoolType
+	enum WaveformPoolType
+	{
+		POOL_UNIFORM_ANALOG,
+		POOL_SPARSE_ANALOG,
+		POOL_UNIFORM_DIGITAL,
+		POOL_SPARSE_DIGITAL,
+
+		POOL_COUNT
+	};
+
+	///@brief Number of waveforms each of our pools can hold, only needs to cover a few streams' worth
+	static const size_t WAVEFORM_POOL_SIZE = 2;
+
+	///@brief Recycled output waveforms, owned by this filter
+	WaveformPool m_outputWaveformPools[POOL_COUNT];
+
+	///@brief Recycled CPU-side temporaries, owned by this filter
+	WaveformPool m_scratchWaveformPools[POOL_COUNT];
+
+	///@brief Identifies one edge list in the analysis cache
+	class EdgeCacheKey
+	{
+	public:
+		EdgeCacheKey(WaveformBase* wfm, EdgeCacheType type, float threshold)
+		: m_wfm(wfm)
+		, m_type(type)
+		, m_threshold(threshold)
+		{}
+
+		bool operator<(const EdgeCacheKey& rhs) const
+		{
+			return std::tie(m_wfm.m_wfm, m_wfm.m_rev, m_type, m_threshold) <
+				std::tie(rhs.m_wfm.m_wfm, rhs.m_wfm.m_rev, rhs.m_type, rhs.m_threshold);
+		}
+
+		WaveformCacheKey m_wfm;
+		EdgeCacheType m_type;
+		float m_threshold;
+	};
+
+	///@brief A cached edge list and the last cache generation it was used in
+	class EdgeCacheEntry
+	{
+	public:
+		EdgeCacheEntry(EdgeList edges, uint64_t generation)
+		: m_edges(edges)
+		, m_lastUsed(generation)
+		{}
+
+		EdgeList m_edges;
+		std::atomic<uint64_t> m_lastUsed;
+	};
+
+	///@brief One independently locked slice of the analysis cache
+	class EdgeCacheShard
+	{
+	public:
+		std::shared_mutex m_mutex;
+		std::map<EdgeCacheKey, EdgeCacheEntry> m_entries;
+	};
+
 	//Caching
-	static std::mutex m_cacheMutex;
-	static std::map<std::pair<WaveformBase*, float>, std::vector<int64_t> > m_zeroCrossingCache;
+	static const size_t EDGE_CACHE_SHARDS = 16;
+	static EdgeCacheShard m_edgeCache[EDGE_CACHE_SHARDS];
+	static std::atomic<uint64_t> m_analysisCacheGeneration;
 };
 
 #define PROTOCOL_DECODER_INITPROC(T) \
@@ -36,6 +36,7 @@
 
 #include "scopehal.h"
 #include <shared_mutex>
+#include <unordered_map>
 
 using namespace std;
 
@@ -43,9 +44,19 @@ using namespace std;
 // Construction / destruction
 
 FilterGraphExecutor::FilterGraphExecutor(size_t numThreads)
-	: m_allWorkersComplete(true)
+	: m_topologyVersion(0)
+	, m_nodesRemaining(0)
+	, m_nodesSkipped(0)
+	, m_incrementalEvaluation(true)
+	, m_allWorkersComplete(true)
 	, m_terminating(false)
+	, m_predictedMakespan(0)
+	, m_actualMakespan(0)
 {
+	//Create scheduling state first, since the threads start using it as soon as they're launched
+	for(size_t i=0; i<numThreads; i++)
+		m_workers.push_back(make_unique<WorkerContext>());
+
 	//Create our thread pool
 	for(size_t i=0; i<numThreads; i++)
 		m_threads.push_back(make_unique<thread>(&FilterGraphExecutor::ExecutorThread, this, i));
@@ -55,7 +66,12 @@ FilterGraphExecutor::~FilterGraphExecutor()
 {
 	//Terminate worker threads
 	m_terminating = true;
-	m_workerCvar.notify_all();
+	for(auto& w : m_workers)
+	{
+		lock_guard<mutex> lock(w->m_wakeMutex);
+		w->m_wakePending = true;
+		w->m_wakeCvar.notify_one();
+	}
 	for(auto& t : m_threads)
 		t->join();
 }
@@ -77,39 +93,75 @@ void FilterGraphExecutor::RunBlocking(const set<FlowGraphNode*>& nodes)
 		m_currentExecutionTime.clear();
 	}
 
+	//Don't crash if a null filter somehow ended up in the list
+	if(nodes.find(nullptr) != nodes.end())
 	{
-		lock_guard<mutex> lock(m_mutex);
+		auto tmp = nodes;
+		tmp.erase(nullptr);
+		UpdateTopology(tmp);
+	}
+	else
+		UpdateTopology(nodes);
+	if(m_nodes.empty())
+		return;
 
+	{
+		lock_guard<mutex> lock(m_completionCvarMutex);
 		if(!m_allWorkersComplete)
 			LogWarning("Entering RunBlocking() but not all workers are complete from previous run\n");
+		m_allWorkersComplete = false;
+	}
 
-		m_incompleteNodes = nodes;
-		m_incompleteNodes.erase(nullptr);	//don't crash if a null filter somehow ended up in the list
+	//Drop cached analysis results for waveforms nobody looked at last time
+	Filter::AgeAnalysisCache();
 
-		m_runnableNodes.clear();
-		m_allWorkersComplete = false;
+	//Figure out what to prioritize based on how long things took last time
+	UpdateCriticalPaths();
 
-		Filter::ClearAnalysisCache();
+	//Reset dependency counters
+	m_nodesRemaining = m_nodes.size();
+	m_nodesSkipped = 0;
+	for(size_t i=0; i<m_nodes.size(); i++)
+	{
+		m_pendingInputs[i] = m_dependencyCount[i];
+		m_upstreamRefreshed[i] = false;
 	}
 
+	//Seed the run queues with every node that has no dependencies.
+	//Deal them out most critical first so every worker starts on the most important thing it can.
+	vector<size_t> roots;
+	for(size_t i=0; i<m_nodes.size(); i++)
+	{
+		if(m_dependencyCount[i] == 0)
+			roots.push_back(i);
+	}
+	sort(roots.begin(), roots.end(), [this](size_t a, size_t b) { return m_criticalPath[a] > m_criticalPath[b]; });
+	for(size_t i=0; i<roots.size(); i++)
+	{
+		auto& w = *m_workers[i % m_workers.size()];
+		lock_guard<mutex> lock(w.m_queueMutex);
+		w.m_runQueue.emplace(m_criticalPath[roots[i]], roots[i]);
+	}
+	double start = GetTime();
+
 	//Wake up our workers
-	m_workerCvar.notify_all();
+	WakeIdleWorkers(m_workers.size());
 
 	//Block until they're finished
-	while(true)
 	{
 		unique_lock<mutex> lock(m_completionCvarMutex);
 		m_completionCvar.wait(lock, [this]{return m_allWorkersComplete;});
-
-		lock_guard<mutex> lock2(m_mutex);
-		if(m_runnableNodes.empty())
-			break;
 	}
+	double dt = GetTime() - start;
 
 	//Update global performance stats
 	{
 		lock_guard<mutex> lock(m_perfStatsMutex);
 
+		m_actualMakespan = dt * FS_PER_SECOND;
+		LogTrace("Filter graph evaluation: predicted makespan %.3f ms, actual %.3f ms\n",
+			m_predictedMakespan * 1e-12, m_actualMakespan * 1e-12);
+
 		//For now, fixed half life exponential moving average
 		float halflife = 8;
 		float decay = 1 / pow(2, 1/halflife);
@@ -122,80 +174,222 @@ void FilterGraphExecutor::RunBlocking(const set<FlowGraphNode*>& nodes)
 	}
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Scheduling
-
 /**
-	@brief Returns the next filter available to run, blocking if none are ready.
+	@brief Recomputes the cached graph topology, if the node set or any node's inputs have changed since last time
 
-	Returns null if there are no remaining filters to evaluate.
+	Must only be called when no evaluation is in progress.
  */
-FlowGraphNode* FilterGraphExecutor::GetNextRunnableNode()
+void FilterGraphExecutor::UpdateTopology(const set<FlowGraphNode*>& nodes)
 {
-	while(true)
+	auto version = FlowGraphNode::GetTopologyVersion();
+	if( (version == m_topologyVersion) && (nodes == m_topologyNodes) && !m_nodes.empty() )
+		return;
+
+	m_topologyNodes = nodes;
+	m_topologyVersion = version;
+
+	//Assign indexes to each node
+	m_nodes.assign(nodes.begin(), nodes.end());
+	unordered_map<FlowGraphNode*, size_t> indexes;
+	for(size_t i=0; i<m_nodes.size(); i++)
+		indexes[m_nodes[i]] = i;
+
+	//Find the producers of each node's inputs. Inputs from outside the set (e.g. instrument channels) are ignored
+	//since they are never evaluated, and a node using the same producer for several inputs only depends on it once.
+	m_consumers.clear();
+	m_consumers.resize(m_nodes.size());
+	m_dependencyCount.assign(m_nodes.size(), 0);
+	for(size_t i=0; i<m_nodes.size(); i++)
 	{
-		//Check for stuff
+		auto f = m_nodes[i];
+		set<size_t> producers;
+		for(size_t j=0; j<f->GetInputCount(); j++)
 		{
-			lock_guard<mutex> lock(m_mutex);
+			auto it = indexes.find(f->GetInput(j).m_channel);
+			if( (it != indexes.end()) && (it->second != i) )
+				producers.emplace(it->second);
+		}
 
-			//Nothing left to run? Stop
-			if(m_incompleteNodes.empty())
-				return nullptr;
+		m_dependencyCount[i] = producers.size();
+		for(auto p : producers)
+			m_consumers[p].push_back(i);
+	}
 
-			//Nothing ready to run? Update the run queue
-			if(m_runnableNodes.empty())
-				UpdateRunnable();
+	//Topologically sort the graph
+	m_topologicalOrder.clear();
+	vector<size_t> remaining = m_dependencyCount;
+	for(size_t i=0; i<m_nodes.size(); i++)
+	{
+		if(remaining[i] == 0)
+			m_topologicalOrder.push_back(i);
+	}
+	for(size_t i=0; i<m_topologicalOrder.size(); i++)
+	{
+		for(auto c : m_consumers[m_topologicalOrder[i]])
+		{
+			if(--remaining[c] == 0)
+				m_topologicalOrder.push_back(c);
+		}
+	}
+	if(m_topologicalOrder.size() != m_nodes.size())
+		LogWarning("Filter graph contains a cycle, some nodes will never be evaluated\n");
 
-			//If there is something ready to run, grab it
-			if(!m_runnableNodes.empty())
-			{
-				auto f = *m_runnableNodes.begin();
-				m_runnableNodes.erase(f);
-				m_runningNodes.emplace(f);
-				return f;
-			}
+	m_pendingInputs = make_unique<atomic<size_t>[]>(m_nodes.size());
+	m_upstreamRefreshed = make_unique<atomic<bool>[]>(m_nodes.size());
+	m_criticalPath.assign(m_nodes.size(), 0);
+}
+
+/**
+	@brief Recomputes the critical path length of each node from the most recent run time statistics
+
+	Also updates the predicted makespan for this evaluation.
+ */
+void FilterGraphExecutor::UpdateCriticalPaths()
+{
+	lock_guard<mutex> lock(m_perfStatsMutex);
+
+	//Get the estimated run time of each node.
+	//Nodes we haven't seen before are assumed to take the average time of the ones we have.
+	vector<int64_t> cost(m_nodes.size(), -1);
+	int64_t total = 0;
+	size_t nknown = 0;
+	for(size_t i=0; i<m_nodes.size(); i++)
+	{
+		auto it = m_lastExecutionTime.find(m_nodes[i]);
+		if(it != m_lastExecutionTime.end())
+		{
+			cost[i] = it->second;
+			total += it->second;
+			nknown ++;
 		}
+	}
+	int64_t defaultCost = nknown ? (total / nknown) : 1;
+	for(auto& c : cost)
+	{
+		if(c < 0)
+		{
+			c = defaultCost;
+			total += defaultCost;
+		}
+	}
 
-		//Still nothing to run? Block
-		unique_lock<mutex> lock(m_workerCvarMutex);
-		m_workerCvar.wait(lock);
+	//Walk the graph from the sinks back towards the sources
+	int64_t longest = 0;
+	for(auto it = m_topologicalOrder.rbegin(); it != m_topologicalOrder.rend(); it++)
+	{
+		auto i = *it;
+		int64_t downstream = 0;
+		for(auto c : m_consumers[i])
+			downstream = max(downstream, m_criticalPath[c]);
+		m_criticalPath[i] = cost[i] + downstream;
+		longest = max(longest, m_criticalPath[i]);
 	}
+
+	m_predictedMakespan = max(longest, total / static_cast<int64_t>(m_workers.size()));
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scheduling
+
 /**
-	@brief Searches m_incompleteNodes for any that are unblocked, and adds them to m_runnableNodes
+	@brief Gets the next node available to run, without blocking
+
+	Work from the thread's own queue is taken first. If that is empty, the most critical node in another thread's
+	queue is stolen.
 
-	Assumes m_mutex is locked
+	@param i		Index of the calling thread
+	@param node		Index of the node to run
+
+	@return True if a node was found, false if there is nothing to do right now
  */
-void FilterGraphExecutor::UpdateRunnable()
+bool FilterGraphExecutor::GetNextRunnableNode(size_t i, size_t& node)
 {
-	//Do nothing if we already have other filters marked runnable
-	if(!m_runnableNodes.empty())
-		return;
+	//Check our own queue first
+	{
+		auto& w = *m_workers[i];
+		lock_guard<mutex> lock(w.m_queueMutex);
+		if(!w.m_runQueue.empty())
+		{
+			node = w.m_runQueue.top().second;
+			w.m_runQueue.pop();
+			return true;
+		}
+	}
 
-	//Look for new filters that are eligible to run
-	for(auto f : m_incompleteNodes)
+	//Nothing there, try to steal from somebody else
+	for(size_t j=1; j<m_workers.size(); j++)
 	{
-		//If the filter is already running, nothing we can do
-		if(m_runningNodes.find(f) != m_runningNodes.end())
-			continue;
+		auto& w = *m_workers[(i + j) % m_workers.size()];
+		lock_guard<mutex> lock(w.m_queueMutex);
+		if(!w.m_runQueue.empty())
+		{
+			node = w.m_runQueue.top().second;
+			w.m_runQueue.pop();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+	@brief Marks a node as completed and queues any of its consumers that are now ready to run
 
-		//Not actively running.
-		//Is it blocked by any of our incomplete filters?
-		bool ok = true;
-		for(size_t i=0; i<f->GetInputCount(); i++)
+	@param i			Index of the calling thread
+	@param node			Index of the node that finished
+	@param refreshed	True if the node was actually refreshed, false if it was skipped
+ */
+void FilterGraphExecutor::OnNodeComplete(size_t i, size_t node, bool refreshed)
+{
+	//Push newly readied nodes onto our own queue
+	size_t readied = 0;
+	auto& w = *m_workers[i];
+	for(auto c : m_consumers[node])
+	{
+		if(refreshed)
+			m_upstreamRefreshed[c] = true;
+
+		if(--m_pendingInputs[c] == 0)
 		{
-			auto in = f->GetInput(i).m_channel;
-			if(m_incompleteNodes.find(in) != m_incompleteNodes.end())
-			{
-				ok = false;
-				break;
-			}
+			lock_guard<mutex> lock(w.m_queueMutex);
+			w.m_runQueue.emplace(m_criticalPath[c], c);
+			readied ++;
+		}
+	}
+
+	//We'll run one of them ourselves, get help with the rest
+	if(readied > 1)
+		WakeIdleWorkers(readied - 1);
+
+	//If this was the last node, we're done - wake up the main thread
+	if(--m_nodesRemaining == 0)
+	{
+		{
+			lock_guard<mutex> lock(m_completionCvarMutex);
+			m_allWorkersComplete = true;
 		}
+		m_completionCvar.notify_all();
+	}
+}
 
-		//Not blocked. It's runnable.
-		if(ok)
-			m_runnableNodes.emplace(f);
+/**
+	@brief Wakes up to the specified number of idle worker threads
+ */
+void FilterGraphExecutor::WakeIdleWorkers(size_t count)
+{
+	for(auto& w : m_workers)
+	{
+		if(count == 0)
+			break;
+		if(!w->m_idle)
+			continue;
+
+		lock_guard<mutex> lock(w->m_wakeMutex);
+		if(w->m_wakePending)
+			continue;
+		w->m_wakePending = true;
+		w->m_wakeCvar.notify_one();
+		count --;
 	}
 }
 
@@ -226,57 +420,75 @@ void FilterGraphExecutor::DoExecutorThread(size_t i)
 		nvtx3::scoped_range range("FilterGraphExecutor::DoExecutorThread");
 	#endif
 
-	//Create a queue and command buffer for this thread's accelerated processing
-	std::shared_ptr<QueueHandle> queue(g_vkQueueManager->GetComputeQueue("FilterGraphExecutor[" + to_string(i) + "].queue"));
-	vk::CommandPoolCreateInfo poolInfo(
-		vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-		queue->m_family );
-	vk::raii::CommandPool pool(*g_vkComputeDevice, poolInfo);
+	//Create a queue and command buffer for this thread's accelerated processing.
+	//In CPU-only mode there is no Vulkan device: filters get a null queue and command buffer and must not use them.
+	shared_ptr<QueueHandle> queue;
+	vk::raii::CommandPool pool(nullptr);
+	vk::raii::CommandBuffer cmdbuf(nullptr);
+	if(g_gpuFilterEnabled)
+	{
+		queue = g_vkQueueManager->GetComputeQueue("FilterGraphExecutor[" + to_string(i) + "].queue");
+		vk::CommandPoolCreateInfo poolInfo(
+			vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+			queue->m_family );
+		pool = vk::raii::CommandPool(*g_vkComputeDevice, poolInfo);
 
-	vk::CommandBufferAllocateInfo bufinfo(*pool, vk::CommandBufferLevel::ePrimary, 1);
-	vk::raii::CommandBuffer cmdbuf(std::move(vk::raii::CommandBuffers(*g_vkComputeDevice, bufinfo).front()));
+		vk::CommandBufferAllocateInfo bufinfo(*pool, vk::CommandBufferLevel::ePrimary, 1);
+		cmdbuf = std::move(vk::raii::CommandBuffers(*g_vkComputeDevice, bufinfo).front());
 
-	if(g_hasDebugUtils)
-	{
-		string prefix = string("FilterGraphExecutor[") + to_string(i) + "]";
-
-		string poolname = prefix + ".pool";
-		string bufname = prefix + ".cmdbuf";
-
-		g_vkComputeDevice->setDebugUtilsObjectNameEXT(
-			vk::DebugUtilsObjectNameInfoEXT(
-				vk::ObjectType::eCommandPool,
-				reinterpret_cast<uint64_t>(static_cast<VkCommandPool>(*pool)),
-				poolname.c_str()));
-
-		g_vkComputeDevice->setDebugUtilsObjectNameEXT(
-			vk::DebugUtilsObjectNameInfoEXT(
-				vk::ObjectType::eCommandBuffer,
-				reinterpret_cast<uint64_t>(static_cast<VkCommandBuffer>(*cmdbuf)),
-				bufname.c_str()));
+		if(g_hasDebugUtils)
+		{
+			string prefix = string("FilterGraphExecutor[") + to_string(i) + "]";
+
+			string poolname = prefix + ".pool";
+			string bufname = prefix + ".cmdbuf";
+
+			g_vkComputeDevice->setDebugUtilsObjectNameEXT(
+				vk::DebugUtilsObjectNameInfoEXT(
+					vk::ObjectType::eCommandPool,
+					reinterpret_cast<uint64_t>(static_cast<VkCommandPool>(*pool)),
+					poolname.c_str()));
+
+			g_vkComputeDevice->setDebugUtilsObjectNameEXT(
+				vk::DebugUtilsObjectNameInfoEXT(
+					vk::ObjectType::eCommandBuffer,
+					reinterpret_cast<uint64_t>(static_cast<VkCommandBuffer>(*cmdbuf)),
+					bufname.c_str()));
+		}
 	}
 
 	//Main loop
-	while(true)
+	auto& ctx = *m_workers[i];
+	while(!m_terminating)
 	{
+		size_t node;
+		if(!GetNextRunnableNode(i, node))
 		{
-			//Wait until the main thread starts a new round of execution, or the timeout elapses
-			//When we time out, check if we're shutting down
-			unique_lock<mutex> lock(m_workerCvarMutex);
-			m_workerCvar.wait_for(lock, chrono::milliseconds(50));
+			//Advertise that we're idle, then check again so we can't miss work pushed in the meantime
+			ctx.m_idle = true;
+			if(!GetNextRunnableNode(i, node))
+			{
+				//Still nothing to do. Sleep until somebody hands us work, or the timeout elapses
+				//When we time out, check if we're shutting down
+				unique_lock<mutex> lock(ctx.m_wakeMutex);
+				ctx.m_wakeCvar.wait_for(lock, chrono::milliseconds(50), [&]{return ctx.m_wakePending;});
+				ctx.m_wakePending = false;
+				ctx.m_idle = false;
+				continue;
+			}
+			ctx.m_idle = false;
 		}
 
-		//If they woke us up because the context is being destroyed, we're done
-		if(m_terminating)
-			break;
-
-		//If we're already done, nothing to do
-		if(m_allWorkersComplete)
+		//If nothing changed since last time, keep the output we already have
+		auto f = m_nodes[node];
+		if(m_incrementalEvaluation && !m_upstreamRefreshed[node] && !f->IsRefreshAlwaysRequired() &&
+			!f->HasInputOrParameterChanges())
+		{
+			m_nodesSkipped ++;
+			OnNodeComplete(i, node, false);
 			continue;
+		}
 
-		//Evaluate nodes as they become available, then stop when there's nothing left to do
-		FlowGraphNode* f;
-		while( (f = GetNextRunnableNode()) != nullptr)
 		{
 			shared_lock<shared_mutex> lock(g_vulkanActivityMutex);
 
@@ -307,31 +519,23 @@ void FilterGraphExecutor::DoExecutorThread(size_t i)
 				lock_guard<mutex> slock(m_perfStatsMutex);
 				m_currentExecutionTime[f] = dt * FS_PER_SECOND;
 			}
-
-			//Filter execution has completed, remove it from the running list and mark as completed
-			lock_guard<mutex> lock2(m_mutex);
-			m_runningNodes.erase(f);
-			m_incompleteNodes.erase(f);
-
-			//Wake up all threads that might have been waiting on this filter to complete
-			m_workerCvar.notify_all();
 		}
 
-		//We have no more filters to run.
-		//If this was the last filter (nothing left incomplete), we're done - wake up the main thread
-		bool empty = false;
-		{
-			lock_guard<mutex> lock2(m_mutex);
-			empty = m_incompleteNodes.empty();
-		}
-		if(empty)
+		//Remember what we consumed, and make sure anything downstream that isn't part of this pass will see our
+		//outputs as changed (not all filters bump the revision of outputs they modify in place)
+		f->SaveRefreshState();
+		auto chan = dynamic_cast<InstrumentChannel*>(f);
+		if(chan)
 		{
+			for(size_t j=0; j<chan->GetStreamCount(); j++)
 			{
-				lock_guard<mutex> lock3(m_completionCvarMutex);
-				m_allWorkersComplete = true;
+				auto data = chan->GetData(j);
+				if(data)
+					data->m_revision ++;
 			}
-
-			m_completionCvar.notify_all();
 		}
+
+		//Filter execution has completed, release anything waiting on it
+		OnNodeComplete(i, node, true);
 	}
 }
@@ -39,9 +39,27 @@
 
 #include <condition_variable>
 #include <atomic>
+#include <queue>
 
 /**
 	@brief Execution manager / scheduler for the filter graph
+
+	The graph topology (node indexes, consumer lists, input dependency counts, and a topological ordering) is computed
+	once and cached until the set of nodes passed to RunBlocking(), or the global FlowGraphNode topology version,
+	changes.
+
+	Each evaluation keeps a per-node counter of inputs which have not yet been computed. When a node finishes, the
+	counters of its consumers are decremented and any that reach zero are pushed onto the finishing thread's own run
+	queue. Idle threads steal work from the other queues, so there is no global lock on the scheduling fast path.
+
+	Run queues are ordered by critical path length: the estimated time (from the moving average of previous run
+	times) from the start of a node to the completion of the slowest chain of nodes downstream of it. The node
+	with the longest critical path is always dispatched first.
+
+	When incremental evaluation is enabled (the default), a node is only refreshed if one of its upstream nodes was
+	refreshed during the same pass, it has no inputs, or FlowGraphNode::HasInputOrParameterChanges() reports that its
+	inputs or parameters have changed since it was last refreshed. Otherwise it keeps its previous output.
+
 	@ingroup core
  */
 class FilterGraphExecutor
@@ -52,8 +70,6 @@ public:
 
 	void RunBlocking(const std::set<FlowGraphNode*>& nodes);
 
-	FlowGraphNode* GetNextRunnableNode();
-
 	///@brief Get the run times of the most recent filter graph evaluation
 	std::map<FlowGraphNode*, int64_t> GetRunTimes()
 	{
@@ -61,32 +77,127 @@ public:
 		return m_lastExecutionTime;
 	}
 
+	/**
+		@brief Get the predicted makespan (wall clock time from start to end) of the most recent evaluation, in fs
+
+		This is the larger of the critical path length and the total estimated work divided by the thread count,
+		i.e. a lower bound on how quickly the graph could be evaluated given the historical run time statistics.
+	 */
+	int64_t GetPredictedMakespan()
+	{
+		std::lock_guard<std::mutex> lock(m_perfStatsMutex);
+		return m_predictedMakespan;
+	}
+
+	///@brief Get the actual makespan (wall clock time from start to end) of the most recent evaluation, in fs
+	int64_t GetActualMakespan()
+	{
+		std::lock_guard<std::mutex> lock(m_perfStatsMutex);
+		return m_actualMakespan;
+	}
+
+	///@brief Get the number of nodes which were skipped by the most recent evaluation because they were up to date
+	size_t GetSkippedNodeCount()
+	{ return m_nodesSkipped; }
+
+	/**
+		@brief Enables or disables incremental evaluation
+
+		If disabled, every node passed to RunBlocking() is refreshed regardless of whether its inputs changed.
+	 */
+	void SetIncrementalEvaluationEnabled(bool enabled)
+	{ m_incrementalEvaluation = enabled; }
+
+	///@brief Checks if incremental evaluation is enabled
+	bool IsIncrementalEvaluationEnabled()
+	{ return m_incrementalEvaluation; }
+
 protected:
 	static void ExecutorThread(FilterGraphExecutor* pThis, size_t i);
 	void DoExecutorThread(size_t i);
 
-	void UpdateRunnable();
+	void UpdateTopology(const std::set<FlowGraphNode*>& nodes);
+	void UpdateCriticalPaths();
 
-	///@brief Mutex for access to shared state
-	std::mutex m_mutex;
+	bool GetNextRunnableNode(size_t i, size_t& node);
+	void OnNodeComplete(size_t i, size_t node, bool refreshed);
+	void WakeIdleWorkers(size_t count);
 
-	///@brief Nodes that have not yet been updated
-	std::set<FlowGraphNode*> m_incompleteNodes;
+	/**
+		@brief Per-thread scheduling state
+	 */
+	class WorkerContext
+	{
+	public:
+		WorkerContext()
+		: m_idle(false)
+		, m_wakePending(false)
+		{}
+
+		///@brief Mutex for access to m_runQueue
+		std::mutex m_queueMutex;
+
+		/**
+			@brief Nodes which are ready to run, as (critical path length, node index) tuples
+
+			Both the owning thread and other threads stealing work take the node with the longest critical path.
+		 */
+		std::priority_queue<std::pair<int64_t, size_t>> m_runQueue;
+
+		///@brief True if the thread is waiting for work
+		std::atomic<bool> m_idle;
 
-	///@brief Nodes that have no dependencies and are eligible to run now
-	std::set<FlowGraphNode*> m_runnableNodes;
+		///@brief Mutex for access to m_wakeCvar
+		std::mutex m_wakeMutex;
 
-	///@brief Nodes that are actively being run
-	std::set<FlowGraphNode*> m_runningNodes;
+		///@brief Condition variable for waking up this thread when work arrives
+		std::condition_variable m_wakeCvar;
+
+		///@brief Set when another thread has explicitly requested that we wake up
+		bool m_wakePending;
+	};
+
+	///@brief Per-thread scheduling state
+	std::vector<std::unique_ptr<WorkerContext>> m_workers;
 
 	///@brief Set of thread contexts
 	std::vector<std::unique_ptr<std::thread>> m_threads;
 
-	///@brief Condition variable for waking up worker threads when work arrives
-	std::condition_variable m_workerCvar;
+	///@brief The set of nodes the cached topology was computed for
+	std::set<FlowGraphNode*> m_topologyNodes;
+
+	///@brief FlowGraphNode topology version the cached topology was computed for
+	uint64_t m_topologyVersion;
+
+	///@brief All nodes to be evaluated, in arbitrary order
+	std::vector<FlowGraphNode*> m_nodes;
+
+	///@brief For each node, the indexes of the nodes which consume its output
+	std::vector<std::vector<size_t>> m_consumers;
 
-	///@brief Mutex for access to m_workerCvar
-	std::mutex m_workerCvarMutex;
+	///@brief For each node, the number of distinct nodes in the graph which it takes input from
+	std::vector<size_t> m_dependencyCount;
+
+	///@brief Node indexes sorted such that every node comes after all of its inputs
+	std::vector<size_t> m_topologicalOrder;
+
+	///@brief For each node, estimated time from its start to the end of the slowest chain of its consumers (in fs)
+	std::vector<int64_t> m_criticalPath;
+
+	///@brief For each node, the number of inputs which have not yet been evaluated during the current pass
+	std::unique_ptr<std::atomic<size_t>[]> m_pendingInputs;
+
+	///@brief For each node, true if any of its upstream nodes was refreshed during the current pass
+	std::unique_ptr<std::atomic<bool>[]> m_upstreamRefreshed;
+
+	///@brief Number of nodes which have not yet been evaluated during the current pass
+	std::atomic<size_t> m_nodesRemaining;
+
+	///@brief Number of nodes skipped during the current (or most recent) pass
+	std::atomic<size_t> m_nodesSkipped;
+
+	///@brief True if nodes whose inputs have not changed should be skipped
+	std::atomic<bool> m_incrementalEvaluation;
 
 	///@brief Condition variable for waking up main thread when work is complete
 	std::condition_variable m_completionCvar;
@@ -98,7 +209,7 @@ protected:
 	bool m_allWorkersComplete;
 
 	///@brief Shutdown flag
-	bool m_terminating;
+	std::atomic<bool> m_terminating;
 
 	///@brief Performance statistics from previous execution
 	std::map<FlowGraphNode*, int64_t> m_lastExecutionTime;
@@ -106,6 +217,12 @@ protected:
 	///@brief Performance statistics from current execution
 	std::map<FlowGraphNode*, int64_t> m_currentExecutionTime;
 
+	///@brief Predicted makespan of the most recent evaluation (in fs)
+	int64_t m_predictedMakespan;
+
+	///@brief Actual makespan of the most recent evaluation (in fs)
+	int64_t m_actualMakespan;
+
 	///@brief Mutex for updating performance statistics
 	std::mutex m_perfStatsMutex;
 };
@@ -39,6 +39,8 @@
 
 using namespace std;
 
+std::atomic<uint64_t> FilterParameter::m_nextChangeSerial(0);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // FilterParameter
 
@@ -51,6 +53,7 @@ using namespace std;
 FilterParameter::FilterParameter(ParameterTypes type, Unit unit)
 	: m_fileIsOutput(false)
 	, m_type(type)
+	, m_changeSerial(0)
 	, m_unit(unit)
 	, m_intval(0)
 	, m_floatval(0)
@@ -61,6 +64,15 @@ FilterParameter::FilterParameter(ParameterTypes type, Unit unit)
 
 }
 
+/**
+	@brief Records that the parameter's value has changed, and notifies anyone listening to signal_changed()
+ */
+void FilterParameter::OnChanged()
+{
+	m_changeSerial = ++m_nextChangeSerial;
+	m_changeSignal.emit();
+}
+
 /**
 	@brief Constructs a FilterParameter object for choosing from available units
  */
@@ -216,7 +228,7 @@ void FilterParameter::ParseString(const string& str, bool useDisplayLocale)
 			break;
 	}
 
-	m_changeSignal.emit();
+	OnChanged();
 }
 
 /**
@@ -298,7 +310,7 @@ void FilterParameter::SetBoolVal(bool b)
 	m_string = b ? "1" : "0";
 	m_8b10bPattern.clear();
 
-	m_changeSignal.emit();
+	OnChanged();
 }
 
 /**
@@ -314,7 +326,7 @@ void FilterParameter::SetIntVal(int64_t i)
 	if(m_reverseEnumMap.find(i) != m_reverseEnumMap.end())
 		m_string = m_reverseEnumMap[i];
 
-	m_changeSignal.emit();
+	OnChanged();
 }
 
 /**
@@ -327,7 +339,7 @@ void FilterParameter::SetFloatVal(float f)
 	m_string = "";
 	m_8b10bPattern.clear();
 
-	m_changeSignal.emit();
+	OnChanged();
 }
 
 /**
@@ -348,7 +360,7 @@ void FilterParameter::SetFileName(const string& f)
 	m_string = f;
 	m_8b10bPattern.clear();
 
-	m_changeSignal.emit();
+	OnChanged();
 }
 
 void FilterParameter::Set8B10BPattern(const vector<T8B10BSymbol>& pattern)
@@ -358,5 +370,5 @@ void FilterParameter::Set8B10BPattern(const vector<T8B10BSymbol>& pattern)
 	m_8b10bPattern = pattern;
 	m_string = ToString();
 
-	m_changeSignal.emit();
+	OnChanged();
 }
@@ -206,6 +206,15 @@ public:
 	sigc::signal<void()> signal_changed()
 	{ return m_changeSignal; }
 
+	/**
+		@brief Returns a globally unique, monotonically increasing serial number of the most recent change to this
+		parameter's value (zero if never set)
+
+		Comparing serial numbers is a cheap way to detect if a parameter has changed without hooking signal_changed().
+	 */
+	uint64_t GetChangeSerial() const
+	{ return m_changeSerial; }
+
 	/**
 		@brief Signal emitted every time the list of enumeration values changes
 	 */
@@ -244,9 +253,17 @@ public:
 	{ return m_readOnly; }
 
 protected:
+	void OnChanged();
+
 	ParameterTypes				m_type;
 
 	sigc::signal<void()>		m_changeSignal;
+
+	///@brief Serial number of the most recent change, see GetChangeSerial()
+	uint64_t					m_changeSerial;
+
+	///@brief Source of serial numbers for GetChangeSerial()
+	static std::atomic<uint64_t> m_nextChangeSerial;
 	sigc::signal<void()>		m_enumSignal;
 
 	Unit						m_unit;
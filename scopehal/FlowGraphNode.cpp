@@ -45,10 +45,14 @@ string StreamDescriptor::GetName() const
 	return name;
 }
 
+std::atomic<uint64_t> FlowGraphNode::m_topologyVersion(0);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Construction / destruction
 
 FlowGraphNode::FlowGraphNode()
+	: m_lastRefreshParameterSerial(0)
+	, m_refreshStateValid(false)
 {
 }
 
@@ -122,6 +126,117 @@ FlowGraphNode::DataLocation FlowGraphNode::GetInputLocation()
 	return LOC_CPU;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Incremental evaluation
+
+/**
+	@brief Checks if this node has to be refreshed every time the filter graph is evaluated, even if none of its
+	inputs or parameters have changed.
+
+	The default implementation returns true for nodes with no inputs (such as waveform generators) and false for
+	everything else. Nodes whose output depends on anything other than their inputs and parameters (e.g. wall clock
+	time) must override this to return true.
+ */
+bool FlowGraphNode::IsRefreshAlwaysRequired()
+{
+	return m_inputs.empty();
+}
+
+/**
+	@brief Returns the largest change serial number of any of our parameters
+ */
+uint64_t FlowGraphNode::GetParameterChangeSerial()
+{
+	uint64_t ret = 0;
+	for(auto& it : m_parameters)
+		ret = max(ret, it.second.GetChangeSerial());
+	return ret;
+}
+
+/**
+	@brief Gets the current state of an input for comparison with the state at the last refresh
+
+	@return False if the state of the input can't be tracked (a scalar value from an instrument, which may have been
+			updated with an identical value), true otherwise
+ */
+bool FlowGraphNode::GetInputState(size_t i, InputState& state)
+{
+	auto& in = m_inputs[i];
+	state.m_channel = in.m_channel;
+	state.m_stream = in.m_stream;
+	state.m_data = nullptr;
+	state.m_revision = 0;
+	if(in.m_channel == nullptr)
+		return true;
+
+	state.m_data = in.GetData();
+	if(state.m_data)
+		state.m_revision = state.m_data->m_revision;
+
+	//Scalar from another filter, it only changes when the filter refreshes
+	else if(dynamic_cast<Filter*>(in.m_channel) != nullptr)
+	{
+		float f = in.GetScalarValue();
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+		state.m_revision = bits;
+	}
+
+	//Scalar from an instrument
+	else
+		return false;
+
+	return true;
+}
+
+/**
+	@brief Checks if any input or parameter has changed since the last call to SaveRefreshState()
+
+	Inputs are compared by waveform pointer and revision number.
+ */
+bool FlowGraphNode::HasInputOrParameterChanges()
+{
+	if(!m_refreshStateValid)
+		return true;
+	if(m_lastRefreshInputs.size() != m_inputs.size())
+		return true;
+	if(GetParameterChangeSerial() != m_lastRefreshParameterSerial)
+		return true;
+
+	InputState state;
+	for(size_t i=0; i<m_inputs.size(); i++)
+	{
+		if(!GetInputState(i, state))
+			return true;
+		if(!(state == m_lastRefreshInputs[i]))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+	@brief Records the current state of all inputs and parameters, for use by HasInputOrParameterChanges()
+
+	Should be called immediately after refreshing the node.
+ */
+void FlowGraphNode::SaveRefreshState()
+{
+	m_lastRefreshInputs.resize(m_inputs.size());
+	for(size_t i=0; i<m_inputs.size(); i++)
+		GetInputState(i, m_lastRefreshInputs[i]);
+	m_lastRefreshParameterSerial = GetParameterChangeSerial();
+	m_refreshStateValid = true;
+}
+
+/**
+	@brief Forces the node to be refreshed the next time the filter graph is evaluated
+ */
+void FlowGraphNode::InvalidateRefreshState()
+{
+	m_refreshStateValid = false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Accessors
 
@@ -189,6 +304,7 @@ void FlowGraphNode::SetInput(size_t i, StreamDescriptor stream, bool force)
 
 			//Make the new connection
 			m_inputs[i] = StreamDescriptor(nullptr, 0);
+			m_topologyVersion ++;
 
 			//Notify the derived class in case it wants to do anything
 			OnInputChanged(i);
@@ -231,6 +347,7 @@ void FlowGraphNode::SetInput(size_t i, StreamDescriptor stream, bool force)
 
 		//All good, we can save the new input
 		m_inputs[i] = stream;
+		m_topologyVersion ++;
 
 		//Notify the derived class in case it wants to do anything
 		OnInputChanged(i);
@@ -302,6 +419,7 @@ void FlowGraphNode::CreateInput(const string& name)
 {
 	m_signalNames.push_back(name);
 	m_inputs.push_back(StreamDescriptor(NULL, 0));
+	m_topologyVersion ++;
 }
 
 bool FlowGraphNode::ValidateChannel(size_t /*i*/, StreamDescriptor /*stream*/)
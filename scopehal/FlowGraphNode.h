@@ -37,9 +37,12 @@
 #define FlowGraphNode_h
 
 class OscilloscopeChannel;
+class InstrumentChannel;
 class WaveformBase;
 class StreamDescriptor;
 
+#include <atomic>
+
 #include "FilterParameter.h"
 #include "Waveform.h"
 #include "Stream.h"
@@ -117,6 +120,14 @@ public:
 
 	bool IsDownstreamOf(std::set<FlowGraphNode*> nodes);
 
+	/**
+		@brief Returns a counter which is incremented whenever any input of any node is connected or disconnected
+
+		Used by FilterGraphExecutor to detect when cached graph topology needs to be recomputed.
+	 */
+	static uint64_t GetTopologyVersion()
+	{ return m_topologyVersion; }
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Accelerated waveform accessors
 
@@ -139,6 +150,52 @@ public:
 	//Filter evaluation (GPU accelerated)
 	virtual void Refresh(vk::raii::CommandBuffer& cmdBuf, std::shared_ptr<QueueHandle> queue);
 
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Incremental evaluation
+
+	virtual bool IsRefreshAlwaysRequired();
+	bool HasInputOrParameterChanges();
+	void SaveRefreshState();
+	void InvalidateRefreshState();
+
+protected:
+	uint64_t GetParameterChangeSerial();
+
+	///@brief State of a single input as seen by the most recent refresh
+	class InputState
+	{
+	public:
+		///@brief The channel connected to the input
+		InstrumentChannel* m_channel;
+
+		///@brief Stream index within m_channel
+		size_t m_stream;
+
+		///@brief The waveform on the input, if any
+		WaveformBase* m_data;
+
+		///@brief Revision of m_data, or bit pattern of the scalar value if the input has no waveform
+		uint64_t m_revision;
+
+		bool operator==(const InputState& rhs) const
+		{
+			return (m_channel == rhs.m_channel) && (m_stream == rhs.m_stream) &&
+				(m_data == rhs.m_data) && (m_revision == rhs.m_revision);
+		}
+	};
+
+	bool GetInputState(size_t i, InputState& state);
+
+	///@brief Input state as of the most recent refresh
+	std::vector<InputState> m_lastRefreshInputs;
+
+	///@brief Parameter change serial number as of the most recent refresh
+	uint64_t m_lastRefreshParameterSerial;
+
+	///@brief True if m_lastRefreshInputs and m_lastRefreshParameterSerial are valid
+	///(atomic since InvalidateRefreshState() may be called from the UI thread during graph evaluation)
+	std::atomic<bool> m_refreshStateValid;
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Error detection and reporting
 public:
@@ -206,6 +263,9 @@ protected:
 	//Parameters
 	ParameterMapType m_parameters;
 
+	///@brief Global graph topology version, see GetTopologyVersion()
+	static std::atomic<uint64_t> m_topologyVersion;
+
 public:
 
 	sigc::signal<void()> signal_parametersChanged()
@@ -475,20 +475,7 @@ bool HaasoscopePro::AcquireData()
 	int dropped = param->GetIntVal();
 
 	//Save the waveforms to our queue
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(s);
-
-	while (m_pendingWaveforms.size() > 2)
-	{
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
-			delete it.second;
-		m_pendingWaveforms.pop_front();
-
-		dropped++;
-	}
-
-	m_pendingWaveformsMutex.unlock();
+	dropped += PushPendingWaveform(s);
 
 	param->SetIntVal(dropped);
 
@@ -90,53 +90,43 @@ void ImportFilter::Refresh()
 	//everything happens in OnFileNameChanged
 }
 
+bool ImportFilter::IsRefreshAlwaysRequired()
+{
+	//Output only changes when parameters do
+	return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Import helpers
 
 /**
-	@brief Cleans up timebase of data that might be regularly or irregularly sampled.
+	@brief Decides whether a set of sample intervals looks like a uniformly sampled waveform
 
-	This function identifies data sampled at regular intervals and adjusts the timescale and sample duration/offset
-	values accordingly, to enable dense packed optimizations and proper display of instrument timebase settings on
-	imported waveforms.
-
-	This function doesn't actually generate a uniform waveform, the caller has to take care of that.
+	@param stats		Statistics of every sample duration in the waveform (including the last one)
+	@param timescale	If uniform, set to the average sample interval
 
-	@param wfm	The waveform to attempt normalization on
+	@return True if the waveform should be treated as uniformly sampled
  */
-bool ImportFilter::TryNormalizeTimebase(SparseWaveformBase* wfm)
+bool ImportFilter::IsTimebaseUniform(const IntervalStats& stats, uint64_t& timescale)
 {
+	if(stats.m_count == 0)
+		return false;
+
 	//Find the min, max, and mean sample interval
 	Unit xunit(GetXAxisUnits());
-	uint64_t interval_sum = 0;
-	uint64_t interval_count = wfm->size();
-	uint64_t interval_min = std::numeric_limits<uint64_t>::max();
-	uint64_t interval_max = std::numeric_limits<uint64_t>::min();
-	for(size_t i=0; i<interval_count; i++)
-	{
-		uint64_t dur = wfm->m_durations[i];
-		if(dur == 0)
-			continue;
-
-		interval_sum += dur;
-		interval_min = min(interval_min, dur);
-		interval_max = max(interval_max, dur);
-	}
-	uint64_t avg = interval_sum / interval_count;
-	LogTrace("Min sample interval:     %s\n", xunit.PrettyPrint(interval_min).c_str());
+	uint64_t avg = stats.m_sum / stats.m_count;
+	LogTrace("Min sample interval:     %s\n", xunit.PrettyPrint(stats.m_min).c_str());
 	LogTrace("Average sample interval: %s\n", xunit.PrettyPrint(avg).c_str());
-	LogTrace("Max sample interval:     %s\n", xunit.PrettyPrint(interval_max).c_str());
+	LogTrace("Max sample interval:     %s\n", xunit.PrettyPrint(stats.m_max).c_str());
 	if(avg == 0)
 		return false;
 
 	//Find the standard deviation of sample intervals
-	uint64_t stdev_sum = 0;
-	for(size_t i=0; i<interval_count; i++)
-	{
-		int64_t delta = (wfm->m_durations[i] - avg);
-		stdev_sum += delta*delta;
-	}
-	uint64_t stdev = sqrt(stdev_sum / interval_count);
+	//sum((x - avg)^2) = sum(x^2) - 2*avg*sum(x) + n*avg^2
+	double davg = avg;
+	double variance =
+		(stats.m_sumSquares - 2*davg*stats.m_sum + stats.m_count*davg*davg) / stats.m_count;
+	uint64_t stdev = sqrt(max(variance, 0.0));
 	LogTrace("Stdev of intervals:      %s\n", xunit.PrettyPrint(stdev).c_str());
 
 	//If the standard deviation is more than 2% of the average sample period, assume the data is sampled irregularly.
@@ -147,17 +137,42 @@ bool ImportFilter::TryNormalizeTimebase(SparseWaveformBase* wfm)
 	}
 
 	//If there's a significant delta between min and max, it's nonuniform
-	if(interval_max*2 > 3*interval_min)
+	if(stats.m_max*2 > 3*stats.m_min)
 	{
 		LogTrace("Delta between min and max is too large, assuming non-uniform sample interval\n");
 		return false;
 	}
 
+	timescale = avg;
+	return true;
+}
+
+/**
+	@brief Cleans up timebase of data that might be regularly or irregularly sampled.
+
+	This function identifies data sampled at regular intervals and adjusts the timescale and sample duration/offset
+	values accordingly, to enable dense packed optimizations and proper display of instrument timebase settings on
+	imported waveforms.
+
+	This function doesn't actually generate a uniform waveform, the caller has to take care of that.
+
+	@param wfm	The waveform to attempt normalization on
+ */
+bool ImportFilter::TryNormalizeTimebase(SparseWaveformBase* wfm)
+{
+	IntervalStats stats;
+	size_t len = wfm->size();
+	for(size_t i=0; i<len; i++)
+		stats.Add(wfm->m_durations[i]);
+
+	uint64_t avg;
+	if(!IsTimebaseUniform(stats, avg))
+		return false;
+
 	//If we get here, assume uniform sampling.
 	//Use time zero as the trigger phase.
 	wfm->m_timescale = avg;
 	wfm->m_triggerPhase = wfm->m_offsets[0];
-	size_t len = wfm->m_offsets.size();
 	for(size_t j=0; j<len; j++)
 	{
 		wfm->m_offsets[j] = j;
@@ -52,6 +52,7 @@ public:
 	virtual void SetDefaultName() override;
 
 	virtual bool NeedsConfig() override;
+	virtual bool IsRefreshAlwaysRequired() override;
 
 	virtual bool ValidateChannel(size_t i, StreamDescriptor stream) override;
 
@@ -62,6 +63,65 @@ public:
 protected:
 	std::string m_fpname;
 
+	/**
+		@brief Running statistics of the sample intervals of a waveform
+
+		Lets an importer decide whether a timebase is uniform while it is still parsing, without first building the
+		sparse offset/duration arrays. Statistics from independently parsed blocks of a file can be merged.
+	 */
+	class IntervalStats
+	{
+	public:
+		IntervalStats()
+			: m_count(0)
+			, m_sum(0)
+			, m_sumSquares(0)
+			, m_min(std::numeric_limits<uint64_t>::max())
+			, m_max(0)
+		{}
+
+		///@brief Adds one sample duration
+		void Add(uint64_t dur)
+		{
+			m_count ++;
+
+			//Zero-length samples count towards the average but don't set the bounds
+			if(dur == 0)
+				return;
+
+			m_sum += dur;
+			m_sumSquares += static_cast<double>(dur) * dur;
+			m_min = std::min(m_min, dur);
+			m_max = std::max(m_max, dur);
+		}
+
+		///@brief Merges statistics from another block of samples
+		void Merge(const IntervalStats& rhs)
+		{
+			m_count += rhs.m_count;
+			m_sum += rhs.m_sum;
+			m_sumSquares += rhs.m_sumSquares;
+			m_min = std::min(m_min, rhs.m_min);
+			m_max = std::max(m_max, rhs.m_max);
+		}
+
+		///@brief Number of durations seen
+		uint64_t m_count;
+
+		///@brief Sum of all durations
+		uint64_t m_sum;
+
+		///@brief Sum of the squares of all durations
+		double m_sumSquares;
+
+		///@brief Shortest nonzero duration
+		uint64_t m_min;
+
+		///@brief Longest duration
+		uint64_t m_max;
+	};
+
+	bool IsTimebaseUniform(const IntervalStats& stats, uint64_t& timescale);
 	bool TryNormalizeTimebase(SparseWaveformBase* wfm);
 };
 
@@ -126,7 +126,7 @@ public:
 	// Stream management
 public:
 
-	void SetData(WaveformBase* pNew, size_t stream);
+	virtual void SetData(WaveformBase* pNew, size_t stream);
 
 	/**
 		@brief Returns the X axis unit for this channel
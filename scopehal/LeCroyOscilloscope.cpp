@@ -133,6 +133,14 @@ void LeCroyOscilloscope::SharedCtorInit()
 		m_channels.size());
 	m_channels.push_back(m_fastEdgeChannel);
 
+	//Raw sample buffers are only ever touched from the CPU
+	for(size_t i=0; i<m_analogChannelCount; i++)
+	{
+		m_analogRawWaveformBuffers.push_back(std::make_unique<AcceleratorBuffer<uint8_t> >());
+		m_analogRawWaveformBuffers[i]->SetCpuAccessHint(AcceleratorBuffer<uint8_t>::HINT_LIKELY);
+		m_analogRawWaveformBuffers[i]->SetGpuAccessHint(AcceleratorBuffer<uint8_t>::HINT_NEVER);
+	}
+
 	//Desired format for waveform data
 	//Only use increased bit depth if the scope actually puts content there!
 	if(m_highDefinition)
@@ -2358,18 +2366,9 @@ bool LeCroyOscilloscope::PeekTriggerArmed()
 
 bool LeCroyOscilloscope::ReadWaveformBlock(string& data)
 {
-	//Prefix "DESC,\n" or "DAT1,\n". Always seems to be 6 chars and start with a D.
-	//Next is the length header. Looks like #9000000346. #9 followed by nine ASCII length digits.
-	//Ignore that too.
-	string tmp = m_transport->ReadReply();
-	if(tmp.empty())
-		return false;
-	size_t offset = tmp.find("D");
-
-	//Copy the rest of the block
-	data = tmp.substr(offset + 16);
-
-	return true;
+	//Prefix "DESC," or "DAT1,", then the length header. Looks like #9000000346.
+	//The transport discards the prefix and header for us and reads the payload in place.
+	return m_transport->ReadBinaryBlock(data);
 }
 
 /**
@@ -2825,7 +2824,6 @@ bool LeCroyOscilloscope::AcquireData()
 	time_t ttime = 0;
 	double basetime = 0;
 	bool denabled = false;
-	map<int, string> analogWaveformData;
 	string wavetime;
 	bool enabled[8] = {false};
 	vector<string> wavedescs;
@@ -2916,8 +2914,9 @@ bool LeCroyOscilloscope::AcquireData()
 			ttime = ExtractTimestamp(pdesc, basetime);
 			if(num_sequences > 1)
 			{
-				wavetime = m_transport->ReadReply();
-				pwtime = reinterpret_cast<double*>(&wavetime[16]);	//skip 16-byte SCPI header
+				if(!ReadWaveformBlock(wavetime))
+					LogError("ReadWaveformBlock for trigger times failed\n");
+				pwtime = reinterpret_cast<double*>(&wavetime[0]);
 			}
 
 			//If instrument timestamp in the WAVEDESC is not valid, use our local clock instead
@@ -2933,9 +2932,13 @@ bool LeCroyOscilloscope::AcquireData()
 			{
 				if(enabled[i])
 				{
-					analogWaveformData[i] = m_transport->ReadReply(
-						false,
-						[i, this] (float progress) { ChannelsDownloadStatusUpdate(i, InstrumentChannel::DownloadState::DOWNLOAD_IN_PROGRESS, progress); });
+					//Read straight into the raw sample buffer, no intermediate copies
+					if(!m_transport->ReadBinaryBlock(
+						*m_analogRawWaveformBuffers[i],
+						[i, this] (float progress) { ChannelsDownloadStatusUpdate(i, InstrumentChannel::DownloadState::DOWNLOAD_IN_PROGRESS, progress); }))
+					{
+						LogError("ReadBinaryBlock for channel %u failed\n", i);
+					}
 					ChannelsDownloadStatusUpdate(i, InstrumentChannel::DownloadState::DOWNLOAD_FINISHED, 1.0);
 				}
 			}
@@ -2988,9 +2991,10 @@ bool LeCroyOscilloscope::AcquireData()
 				m_channels[i]->SetYAxisUnits(Unit(Unit::UNIT_AMPS), 0);
 			//else unknown unit, ignore for now
 
+			auto& rawbuf = *m_analogRawWaveformBuffers[i];
 			waveforms[i] = ProcessAnalogWaveform(
-				&analogWaveformData[i][16],			//skip 16-byte SCPI header DATA,\n#9xxxxxxxx
-				analogWaveformData[i].size() - 17,	//skip header plus \n at end
+				reinterpret_cast<const char*>(rawbuf.GetCpuPointer()),
+				rawbuf.size(),
 				wavedescs[i],
 				num_sequences,
 				ttime,
@@ -3023,7 +3027,6 @@ bool LeCroyOscilloscope::AcquireData()
 	}
 
 	//Now that we have all of the pending waveforms, save them in sets across all channels
-	m_pendingWaveformsMutex.lock();
 	for(size_t i=0; i<num_sequences; i++)
 	{
 		SequenceSet s;
@@ -3032,9 +3035,8 @@ bool LeCroyOscilloscope::AcquireData()
 			if(pending_waveforms.find(j) != pending_waveforms.end())
 				s[GetOscilloscopeChannel(j)] = pending_waveforms[j][i];
 		}
-		m_pendingWaveforms.push_back(s);
+		PushPendingWaveform(s);
 	}
-	m_pendingWaveformsMutex.unlock();
 
 	double dt = GetTime() - start;
 	LogTrace("Waveform download and processing took %.3f ms\n", dt * 1000);
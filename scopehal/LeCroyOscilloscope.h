@@ -387,6 +387,9 @@ protected:
 	//True if we have >8 bit capture depth
 	bool m_highDefinition;
 
+	///@brief Buffers for raw ADC samples downloaded from each analog channel, reused across acquisitions
+	std::vector<std::unique_ptr<AcceleratorBuffer<uint8_t> > > m_analogRawWaveformBuffers;
+
 	///@brief External trigger input
 	OscilloscopeChannel* m_extTrigChannel;
 
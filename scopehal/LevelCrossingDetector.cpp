@@ -82,16 +82,13 @@ int64_t LevelCrossingDetector::FindZeroCrossings(
 	vk::raii::CommandBuffer& cmdBuf,
 	shared_ptr<QueueHandle> queue)
 {
-	//Fallback in case GPU has no int64 support
-	if(!g_hasShaderInt64)
+	//Fallback in case we have no GPU, or it has no int64 support
+	if(!g_gpuFilterEnabled || !g_hasShaderInt64)
 	{
-		vector<int64_t> edges;
-		Filter::FindZeroCrossings(wfm, threshold, edges);
-
-		int64_t len = edges.size();
-		m_outbuf.resize(len);
-		memcpy(&m_outbuf[0], &edges[0], len*sizeof(int64_t));
-		return len;
+		wfm->PrepareForCpuAccess();
+		auto edges = Filter::GetZeroCrossings(wfm, threshold);
+		m_outbuf.CopyFrom(*edges);
+		return edges->size();
 	}
 
 	//This value experimentally gives the best speedup for an NVIDIA 2080 Ti vs an Intel Xeon Gold 6144
@@ -1636,7 +1636,6 @@ bool MagnovaOscilloscope::AcquireData()
 
 	
 	{	//Now that we have all of the pending waveforms, save them in sets across all channels
-		lock_guard<mutex> lock(m_pendingWaveformsMutex);
 		for(size_t i = 0; i < num_sequences; i++)
 		{
 			SequenceSet s;
@@ -1645,7 +1644,7 @@ bool MagnovaOscilloscope::AcquireData()
 				if(pending_waveforms.find(j) != pending_waveforms.end())
 					s[GetOscilloscopeChannel(j)] = pending_waveforms[j][i];
 			}
-			m_pendingWaveforms.push_back(s);
+			PushPendingWaveform(s);
 		}
 	}
 
@@ -0,0 +1,212 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of MappedFile
+	@ingroup core
+ */
+
+#include "log.h"
+#include "MappedFile.h"
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Construction / destruction
+
+MappedFile::MappedFile()
+	: m_open(false)
+	, m_data(nullptr)
+	, m_size(0)
+	, m_mapped(false)
+#ifdef _WIN32
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_mapping(nullptr)
+#else
+	, m_fd(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Opening and closing
+
+/**
+	@brief Opens a file and maps its contents into memory
+
+	@param path	Path to the file
+
+	@return True on success, false if the file could not be opened or read
+ */
+bool MappedFile::Open(const string& path)
+{
+	Close();
+
+#ifdef _WIN32
+
+	m_file = CreateFileA(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr);
+	if(m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER len;
+	if(!GetFileSizeEx(m_file, &len))
+	{
+		Close();
+		return false;
+	}
+	m_size = len.QuadPart;
+	m_open = true;
+
+	//Can't map a zero byte file, but there's nothing to read anyway
+	if(m_size == 0)
+		return true;
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(m_mapping)
+	{
+		m_data = reinterpret_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if(m_data)
+		{
+			m_mapped = true;
+			return true;
+		}
+	}
+
+#else
+
+	m_fd = open(path.c_str(), O_RDONLY);
+	if(m_fd < 0)
+		return false;
+
+	struct stat st;
+	if(0 != fstat(m_fd, &st))
+	{
+		Close();
+		return false;
+	}
+	m_size = st.st_size;
+	m_open = true;
+
+	//Can't map a zero byte file, but there's nothing to read anyway
+	if(m_size == 0)
+		return true;
+
+	if(S_ISREG(st.st_mode))
+	{
+		void* ptr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+		if(ptr != MAP_FAILED)
+		{
+			//Parsers walk the file front to back (possibly in several places at once), so ask for aggressive readahead
+			madvise(ptr, m_size, MADV_SEQUENTIAL);
+
+			m_data = reinterpret_cast<const char*>(ptr);
+			m_mapped = true;
+			return true;
+		}
+	}
+
+#endif
+
+	//If we get here, mapping failed. Fall back to reading the whole file.
+	//Read it as binary because "read whole file" is problematic in text mode
+	//since length can change and we'll get less than we asked for
+	//(see https://github.com/ngscopeclient/scopehal/issues/1002)
+	LogTrace("Could not map %s, reading it instead\n", path.c_str());
+	FILE* fp = fopen(path.c_str(), "rb");
+	if(!fp)
+	{
+		Close();
+		return false;
+	}
+	m_fallback.resize(m_size);
+	size_t nread = fread(m_fallback.data(), 1, m_size, fp);
+	fclose(fp);
+	if(nread != m_size)
+	{
+		Close();
+		return false;
+	}
+	m_data = m_fallback.data();
+	return true;
+}
+
+/**
+	@brief Unmaps and closes the file, if one is open
+ */
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if(m_mapped)
+		UnmapViewOfFile(m_data);
+	if(m_mapping)
+		CloseHandle(m_mapping);
+	if(m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if(m_mapped)
+		munmap(const_cast<char*>(m_data), m_size);
+	if(m_fd >= 0)
+		close(m_fd);
+	m_fd = -1;
+#endif
+
+	m_open = false;
+	m_mapped = false;
+	m_data = nullptr;
+	m_size = 0;
+	m_fallback.clear();
+	m_fallback.shrink_to_fit();
+}
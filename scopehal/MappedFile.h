@@ -0,0 +1,110 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of MappedFile
+	@ingroup core
+ */
+
+#ifndef MappedFile_h
+#define MappedFile_h
+
+#include <string>
+#include <vector>
+
+/**
+	@brief A read-only view of an entire file, memory mapped where possible
+	@ingroup core
+
+	Import filters use this instead of reading the whole file into a heap buffer, so multi-GB captures are paged in
+	on demand by the OS and can be parsed from several threads at once without any copying.
+
+	If the file cannot be mapped (e.g. it is not a regular file) the contents are read into memory instead, so callers
+	never need to care which strategy was used.
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& path);
+	void Close();
+
+	///@brief Returns true if a file is currently open
+	bool IsOpen() const
+	{ return m_open; }
+
+	///@brief Returns a pointer to the start of the file contents (may be null for an empty file)
+	const char* data() const
+	{ return m_data; }
+
+	///@brief Returns the size of the file, in bytes
+	size_t size() const
+	{ return m_size; }
+
+	///@brief Returns a pointer one past the end of the file contents
+	const char* end() const
+	{ return m_data + m_size; }
+
+protected:
+
+	///@brief True if a file is open
+	bool m_open;
+
+	///@brief Start of the file contents
+	const char* m_data;
+
+	///@brief Size of the file contents
+	size_t m_size;
+
+	///@brief True if m_data points into a mapping (vs m_fallback)
+	bool m_mapped;
+
+#ifdef _WIN32
+	///@brief Handle to the file
+	void* m_file;
+
+	///@brief Handle to the file mapping object
+	void* m_mapping;
+#else
+	///@brief File descriptor
+	int m_fd;
+#endif
+
+	///@brief Buffer for the file contents if mapping failed
+	std::vector<char> m_fallback;
+};
+
+#endif
@@ -53,9 +53,15 @@ Oscilloscope::CreateMapType Oscilloscope::m_createprocs;
 // Construction / destruction
 
 Oscilloscope::Oscilloscope()
+	: m_pendingQueueDepth(0)
+	, m_pendingQueuePolicy(QUEUE_DROP_OLDEST)
+	, m_pendingQueueBlockTimeout(1)
+	, m_pendingSpilledCount(0)
 {
 	m_trigger = NULL;
 
+	ResetPendingQueueStats();
+
 	m_serializers.push_back(sigc::mem_fun(*this, &Oscilloscope::DoSerializeConfiguration));
 	m_loaders.push_back(sigc::mem_fun(*this, &Oscilloscope::DoLoadConfiguration));
 	m_preloaders.push_back(sigc::mem_fun(*this, &Oscilloscope::DoPreLoadConfiguration));
@@ -70,10 +76,13 @@ Oscilloscope::~Oscilloscope()
 		m_trigger = NULL;
 	}
 
-	for(auto set : m_pendingWaveforms)
+	//Don't use ClearPendingWaveforms() here, derived class overrides of DiscardPendingWaveform() are already gone
+	for(auto& entry : m_pendingWaveforms)
 	{
-		for(auto it : set)
+		for(auto it : entry.m_set)
 			delete it.second;
+		if(entry.m_spillFile)
+			fclose(entry.m_spillFile);
 	}
 	m_pendingWaveforms.clear();
 }
@@ -156,33 +165,392 @@ bool Oscilloscope::HasPendingWaveforms()
  */
 void Oscilloscope::ClearPendingWaveforms()
 {
-	lock_guard<mutex> lock(m_pendingWaveformsMutex);
-	while(!m_pendingWaveforms.empty())
 	{
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
-			delete it.second;
-		m_pendingWaveforms.pop_front();
+		lock_guard<mutex> lock(m_pendingWaveformsMutex);
+		for(auto& entry : m_pendingWaveforms)
+			DiscardPendingSet(entry);
+		m_pendingWaveforms.clear();
+		m_pendingSpilledCount = 0;
 	}
+	m_pendingWaveformsSpace.notify_all();
 }
 
 /**
 	@brief Pops the queue of pending waveforms and updates each channel with a new waveform
  */
 bool Oscilloscope::PopPendingWaveform()
+{
+	SequenceSet set;
+	if(!TakePendingWaveform(set))
+		return false;
+
+	for(auto it : set)
+		it.first.m_channel->SetData(it.second, it.first.m_stream);
+	return true;
+}
+
+/**
+	@brief Sets the maximum number of waveforms the pending queue will hold in memory
+
+	When a driver pushes a waveform to a full queue, the queue policy decides what happens.
+
+	@param depth	Maximum number of waveforms, or zero for no limit
+ */
+void Oscilloscope::SetPendingQueueDepth(size_t depth)
+{
+	{
+		lock_guard<mutex> lock(m_pendingWaveformsMutex);
+		m_pendingQueueDepth = depth;
+	}
+	m_pendingWaveformsSpace.notify_all();
+}
+
+/**
+	@brief Gets the maximum number of waveforms the pending queue will hold in memory (zero for no limit)
+ */
+size_t Oscilloscope::GetPendingQueueDepth()
+{
+	lock_guard<mutex> lock(m_pendingWaveformsMutex);
+	return m_pendingQueueDepth;
+}
+
+/**
+	@brief Sets what to do when a waveform is pushed to a full pending queue
+ */
+void Oscilloscope::SetPendingQueuePolicy(PendingQueuePolicy policy)
+{
+	{
+		lock_guard<mutex> lock(m_pendingWaveformsMutex);
+		m_pendingQueuePolicy = policy;
+	}
+	m_pendingWaveformsSpace.notify_all();
+}
+
+/**
+	@brief Gets what to do when a waveform is pushed to a full pending queue
+ */
+Oscilloscope::PendingQueuePolicy Oscilloscope::GetPendingQueuePolicy()
 {
 	lock_guard<mutex> lock(m_pendingWaveformsMutex);
-	if(m_pendingWaveforms.size())
+	return m_pendingQueuePolicy;
+}
+
+/**
+	@brief Sets how long a producer waits for space in the queue under QUEUE_BLOCK_PRODUCER
+
+	This keeps the acquisition thread from hanging forever (and blocking shutdown) if nothing is popping waveforms.
+
+	@param timeout	Timeout in seconds
+ */
+void Oscilloscope::SetPendingQueueBlockTimeout(double timeout)
+{
+	lock_guard<mutex> lock(m_pendingWaveformsMutex);
+	m_pendingQueueBlockTimeout = timeout;
+}
+
+/**
+	@brief Gets a snapshot of the pending queue performance counters
+ */
+Oscilloscope::PendingQueueStats Oscilloscope::GetPendingQueueStats()
+{
+	lock_guard<mutex> lock(m_pendingWaveformsMutex);
+	return m_pendingQueueStats;
+}
+
+/**
+	@brief Zeroes the pending queue performance counters
+ */
+void Oscilloscope::ResetPendingQueueStats()
+{
+	lock_guard<mutex> lock(m_pendingWaveformsMutex);
+	m_pendingQueueStats.m_produced = 0;
+	m_pendingQueueStats.m_consumed = 0;
+	m_pendingQueueStats.m_dropped = 0;
+	m_pendingQueueStats.m_spilled = 0;
+	m_pendingQueueStats.m_lastLatency = 0;
+	m_pendingQueueStats.m_maxLatency = 0;
+	m_pendingQueueStats.m_totalLatency = 0;
+}
+
+/**
+	@brief Adds a set of newly acquired waveforms to the end of the pending queue
+
+	Drivers must use this rather than touching m_pendingWaveforms directly, so the queue depth and policy are
+	honored and the counters stay accurate. Ownership of the waveforms passes to the queue.
+
+	@param set	The waveforms to push
+
+	@return Number of waveform sets discarded to make room, including the new one if it was dropped
+ */
+size_t Oscilloscope::PushPendingWaveform(const SequenceSet& set)
+{
+	PendingWaveformSet entry;
+	entry.m_set = set;
+	entry.m_pushTime = GetTime();
+	entry.m_spillFile = nullptr;
+
+	unique_lock<mutex> lock(m_pendingWaveformsMutex);
+	m_pendingQueueStats.m_produced ++;
+
+	size_t dropped = 0;
+	bool keep = true;
+	size_t depth = m_pendingQueueDepth;
+	if( (depth != 0) && (GetInMemoryPendingCount() >= depth) )
+	{
+		switch(m_pendingQueuePolicy)
+		{
+			case QUEUE_DROP_OLDEST:
+				while(!m_pendingWaveforms.empty() && (GetInMemoryPendingCount() >= depth) )
+				{
+					LogTrace("Dropping waveform due to excessive pend queue depth\n");
+
+					auto& oldest = m_pendingWaveforms.front();
+					if(oldest.m_spillFile)
+						m_pendingSpilledCount --;
+					DiscardPendingSet(oldest);
+					m_pendingWaveforms.pop_front();
+					dropped ++;
+				}
+				break;
+
+			case QUEUE_BLOCK_PRODUCER:
+				{
+					auto timeout = chrono::duration<double>(m_pendingQueueBlockTimeout);
+					if(m_pendingWaveformsSpace.wait_for(lock, timeout, [&]
+						{
+							return (m_pendingQueueDepth == 0) ||
+								(GetInMemoryPendingCount() < m_pendingQueueDepth) ||
+								(m_pendingQueuePolicy != QUEUE_BLOCK_PRODUCER);
+						}))
+					{
+						break;
+					}
+				}
+				LogTrace("Timed out waiting for space in pend queue, dropping waveform\n");
+				DiscardPendingSet(entry);
+				keep = false;
+				dropped ++;
+				break;
+
+			case QUEUE_SPILL_TO_DISK:
+				//Don't hold the lock while writing, the consumer can keep going in the meantime
+				lock.unlock();
+				SpillPendingSet(entry);
+				lock.lock();
+
+				if(entry.m_spillFile)
+				{
+					m_pendingSpilledCount ++;
+					m_pendingQueueStats.m_spilled ++;
+				}
+				break;
+
+			case QUEUE_DROP_NEWEST:
+			default:
+				LogTrace("Dropping waveform due to excessive pend queue depth\n");
+				DiscardPendingSet(entry);
+				keep = false;
+				dropped ++;
+				break;
+		}
+	}
+
+	if(keep)
+		m_pendingWaveforms.push_back(entry);
+	m_pendingQueueStats.m_dropped += dropped;
+	return dropped;
+}
+
+/**
+	@brief Removes the oldest set of waveforms from the pending queue
+
+	Waveforms which were spilled to disk are read back before returning. Ownership of the waveforms passes to the
+	caller.
+
+	@param set	Set of waveforms
+
+	@return True if a set was popped, false if the queue was empty
+ */
+bool Oscilloscope::TakePendingWaveform(SequenceSet& set)
+{
+	//If a spilled set can't be read back, drop it and move on to the next one
+	while(true)
 	{
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
-			it.first.m_channel->SetData(it.second, it.first.m_stream);
-		m_pendingWaveforms.pop_front();
+		PendingWaveformSet entry;
+		{
+			lock_guard<mutex> lock(m_pendingWaveformsMutex);
+			if(m_pendingWaveforms.empty())
+				return false;
+
+			entry = m_pendingWaveforms.front();
+			m_pendingWaveforms.pop_front();
+			if(entry.m_spillFile)
+				m_pendingSpilledCount --;
+
+			double latency = GetTime() - entry.m_pushTime;
+			m_pendingQueueStats.m_consumed ++;
+			m_pendingQueueStats.m_lastLatency = latency;
+			m_pendingQueueStats.m_maxLatency = max(m_pendingQueueStats.m_maxLatency, latency);
+			m_pendingQueueStats.m_totalLatency += latency;
+		}
+		m_pendingWaveformsSpace.notify_one();
+
+		if(entry.m_spillFile && !RestorePendingSet(entry))
+		{
+			LogError("Failed to read spilled waveform back from disk\n");
+			DiscardPendingSet(entry);
+
+			lock_guard<mutex> lock(m_pendingWaveformsMutex);
+			m_pendingQueueStats.m_dropped ++;
+			continue;
+		}
+
+		set = entry.m_set;
 		return true;
 	}
+}
+
+/**
+	@brief Frees a waveform that was dropped from the pending queue
+
+	The default implementation deletes it. Drivers which allocate from the waveform pools can override this to
+	recycle the buffer instead.
+ */
+void Oscilloscope::DiscardPendingWaveform(WaveformBase* w)
+{
+	delete w;
+}
+
+/**
+	@brief Frees every waveform in a pending set, and its spill file if any
+ */
+void Oscilloscope::DiscardPendingSet(PendingWaveformSet& entry)
+{
+	for(auto it : entry.m_set)
+		DiscardPendingWaveform(it.second);
+	entry.m_set.clear();
+
+	if(entry.m_spillFile)
+	{
+		fclose(entry.m_spillFile);
+		entry.m_spillFile = nullptr;
+	}
+}
+
+/**
+	@brief Calls a function on each sample data buffer of a waveform
+
+	@return False if the waveform type can't be spilled or the function failed, true otherwise
+ */
+template<class F>
+static bool ForEachSampleBuffer(WaveformBase* w, F f)
+{
+	if(auto ua = dynamic_cast<UniformAnalogWaveform*>(w))
+		return f(ua->m_samples);
+	if(auto sa = dynamic_cast<SparseAnalogWaveform*>(w))
+		return f(sa->m_offsets) && f(sa->m_durations) && f(sa->m_samples);
+	if(auto ud = dynamic_cast<UniformDigitalWaveform*>(w))
+		return f(ud->m_samples);
+	if(auto sd = dynamic_cast<SparseDigitalWaveform*>(w))
+		return f(sd->m_offsets) && f(sd->m_durations) && f(sd->m_samples);
 	return false;
 }
 
+/**
+	@brief Moves the sample data of a pending set to a temporary file, freeing its memory
+
+	The waveform objects themselves (and their timebase metadata) stay in memory. Only analog and digital waveforms
+	can be spilled; if the set contains anything else, or the file can't be written, it's left untouched.
+
+	@return True if the set was spilled
+ */
+bool Oscilloscope::SpillPendingSet(PendingWaveformSet& entry)
+{
+	for(auto it : entry.m_set)
+	{
+		if(!ForEachSampleBuffer(it.second, [](auto& /*buf*/) { return true; }))
+			return false;
+	}
+
+	FILE* fp = tmpfile();
+	if(!fp)
+	{
+		LogWarning("Couldn't create temporary file to spill waveform to disk, keeping it in memory\n");
+		return false;
+	}
+
+	bool ok = true;
+	for(auto it : entry.m_set)
+	{
+		ok = ForEachSampleBuffer(it.second, [fp](auto& buf)
+			{
+				buf.PrepareForCpuAccess();
+				size_t len = buf.size();
+				if(fwrite(&len, sizeof(len), 1, fp) != 1)
+					return false;
+				return (len == 0) || (fwrite(buf.GetCpuPointer(), sizeof(buf[0]), len, fp) == len);
+			});
+
+		if(!ok)
+			break;
+	}
+	if(!ok || (fflush(fp) != 0) )
+	{
+		LogWarning("Failed to spill waveform to disk, keeping it in memory\n");
+		fclose(fp);
+		return false;
+	}
+
+	//Everything is safely on disk, free the memory
+	for(auto it : entry.m_set)
+	{
+		ForEachSampleBuffer(it.second, [](auto& buf)
+			{
+				buf.clear();
+				buf.shrink_to_fit();
+				buf.FreeGpuBuffer();
+				return true;
+			});
+	}
+
+	entry.m_spillFile = fp;
+	return true;
+}
+
+/**
+	@brief Reads the sample data of a spilled pending set back into memory and deletes the temporary file
+
+	@return True on success
+ */
+bool Oscilloscope::RestorePendingSet(PendingWaveformSet& entry)
+{
+	FILE* fp = entry.m_spillFile;
+	rewind(fp);
+
+	bool ok = true;
+	for(auto it : entry.m_set)
+	{
+		ok = ForEachSampleBuffer(it.second, [fp](auto& buf)
+			{
+				size_t len;
+				if(fread(&len, sizeof(len), 1, fp) != 1)
+					return false;
+				buf.resize(len);
+				buf.PrepareForCpuAccess();
+				if( (len != 0) && (fread(buf.GetCpuPointer(), sizeof(buf[0]), len, fp) != len) )
+					return false;
+				buf.MarkModifiedFromCpu();
+				return true;
+			});
+		if(!ok)
+			break;
+	}
+
+	fclose(fp);
+	entry.m_spillFile = nullptr;
+	return ok;
+}
+
 /**
 	@brief Checks if we are appending to the existing waveform or creating a new one
  */
@@ -1513,3 +1881,342 @@ void Oscilloscope::Convert16BitSamplesAVX512F(float* pout, const int16_t* pin, f
 
 #endif /* __x86_64__ */
 
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers for converting raw logic analyzer samples to sparse digital waveforms
+
+///@brief Number of samples processed by each thread at a time when converting logic analyzer samples
+#define LOGIC_BLOCK_SIZE 65536
+
+/**
+	@brief Common back end for ConvertLogicPodSamples() and ConvertSerialLogicSamples()
+
+	Each block of samples is scanned once to count the transitions of every line, the counts are prefix summed so
+	every waveform can be sized exactly, and then each block is scanned again to write its transitions straight to
+	their final position. Since every transition toggles the line, sample values are filled in from the parity of
+	the transition index rather than read back from the input.
+
+	@param caps			Output waveforms, one per line
+	@param nlines		Number of lines
+	@param count		Number of input samples
+	@param firstOffset	Offset of the first sample, in timebase units
+	@param forceTail	Number of samples at the end of the capture to always emit, even if unchanged
+	@param find			Callback (start, end, counts, offsets) which finds transitions of each line within [start, end)
+	@param value		Callback (m, line) returning the value of a line at sample m
+ */
+template<class F, class V>
+static void ConvertLogicSamples(
+	SparseDigitalWaveform** caps,
+	size_t nlines,
+	size_t count,
+	int64_t firstOffset,
+	size_t forceTail,
+	F find,
+	V value)
+{
+	if(count == 0)
+	{
+		for(size_t j=0; j<nlines; j++)
+			caps[j]->Resize(0);
+		return;
+	}
+
+	//The first sample always starts a new run, and samples at or after tailStart are always emitted
+	size_t tail = min(forceTail, count - 1);
+	size_t tailStart = count - tail;
+	size_t nblocks = (tailStart - 1 + LOGIC_BLOCK_SIZE - 1) / LOGIC_BLOCK_SIZE;
+
+	//Count transitions in each block. Row b+1 holds the counts for block b so the prefix sum leaves row b holding
+	//the index of block b's first transition, and row nblocks the total.
+	vector<size_t> blockCounts( (nblocks + 1) * nlines, 0);
+	#pragma omp parallel for if(nblocks > 1)
+	for(size_t b=0; b<nblocks; b++)
+	{
+		size_t start = 1 + b*LOGIC_BLOCK_SIZE;
+		size_t end = min(start + LOGIC_BLOCK_SIZE, tailStart);
+		find(start, end, &blockCounts[(b+1) * nlines], nullptr);
+	}
+	for(size_t b=1; b<=nblocks; b++)
+	{
+		for(size_t j=0; j<nlines; j++)
+			blockCounts[b*nlines + j] += blockCounts[(b-1)*nlines + j];
+	}
+	const size_t* totals = &blockCounts[nblocks * nlines];
+
+	for(size_t j=0; j<nlines; j++)
+	{
+		caps[j]->Resize(1 + totals[j] + tail);
+		caps[j]->PrepareForCpuAccess();
+	}
+
+	//Write each block's transitions to their final location
+	#pragma omp parallel for if(nblocks > 1)
+	for(size_t b=0; b<nblocks; b++)
+	{
+		size_t start = 1 + b*LOGIC_BLOCK_SIZE;
+		size_t end = min(start + LOGIC_BLOCK_SIZE, tailStart);
+
+		int64_t* offsets[Oscilloscope::MAX_LOGIC_POD_LINES];
+		size_t counts[Oscilloscope::MAX_LOGIC_POD_LINES] = {0};
+		for(size_t j=0; j<nlines; j++)
+			offsets[j] = caps[j]->m_offsets.GetCpuPointer() + 1 + blockCounts[b*nlines + j];
+		find(start, end, counts, offsets);
+	}
+
+	//Fill in everything else
+	#pragma omp parallel for if(nlines > 1)
+	for(size_t j=0; j<nlines; j++)
+	{
+		auto cap = caps[j];
+		int64_t* offsets = cap->m_offsets.GetCpuPointer();
+		int64_t* durations = cap->m_durations.GetCpuPointer();
+		bool* samples = cap->m_samples.GetCpuPointer();
+		size_t total = totals[j];
+		size_t len = cap->size();
+
+		offsets[0] = 0;
+		for(size_t i=0; i<tail; i++)
+			offsets[1 + total + i] = tailStart + i;
+
+		bool first = value(0, j);
+		for(size_t k=0; k<=total; k++)
+			samples[k] = first ^ (k & 1);
+		for(size_t k=total+1; k<len; k++)
+			samples[k] = value(offsets[k], j);
+
+		for(size_t k=0; k+1<len; k++)
+			durations[k] = offsets[k+1] - offsets[k];
+		durations[len-1] = count - offsets[len-1];
+
+		if(firstOffset != 0)
+		{
+			for(size_t k=0; k<len; k++)
+				offsets[k] += firstOffset;
+		}
+
+		cap->MarkSamplesModifiedFromCpu();
+		cap->MarkTimestampsModifiedFromCpu();
+	}
+}
+
+/**
+	@brief Converts samples from a logic analyzer pod, one bit per line, to run-length encoded digital waveforms
+
+	All lines are unpacked in a single pass over the input. The output waveforms are resized to exactly fit the
+	de-duplicated sample data and have their offsets, durations, and samples filled in. Timebase, trigger phase, and
+	start time are left for the caller to set.
+
+	@param caps			Output waveforms, one per line. Line j is taken from bit j of each sample.
+	@param nlines		Number of lines (at most MAX_LOGIC_POD_LINES)
+	@param pin			Input samples
+	@param count		Number of input samples
+	@param forceTail	Number of samples at the end of the capture to always emit as new samples, even if they are
+						the same as the previous sample (workaround for rendering bugs)
+ */
+void Oscilloscope::ConvertLogicPodSamples(
+	SparseDigitalWaveform** caps,
+	size_t nlines,
+	const uint16_t* pin,
+	size_t count,
+	size_t forceTail)
+{
+	if(nlines > MAX_LOGIC_POD_LINES)
+	{
+		LogError("ConvertLogicPodSamples: %zu lines requested but at most %zu are supported\n",
+			nlines, MAX_LOGIC_POD_LINES);
+		return;
+	}
+
+	ConvertLogicSamples(caps, nlines, count, 0, forceTail,
+		[pin, nlines](size_t start, size_t end, size_t* counts, int64_t** offsets)
+		{ FindLogicPodTransitions(pin, start, end, nlines, counts, offsets); },
+		[pin](size_t m, size_t line)
+		{ return ( (pin[m] >> line) & 1 ) ? true : false; });
+}
+
+/**
+	@brief Converts a bit-serial stream of logic analyzer samples for a single line to a run-length encoded waveform
+
+	@param cap			Output waveform
+	@param pin			Input samples, LSB first (sample m is bit m % 64 of word m / 64)
+	@param count		Number of input samples (bits)
+	@param firstOffset	Offset of the first sample, in timebase units
+	@param forceTail	Number of samples at the end of the capture to always emit as new samples, even if they are
+						the same as the previous sample (workaround for rendering bugs)
+ */
+void Oscilloscope::ConvertSerialLogicSamples(
+	SparseDigitalWaveform* cap,
+	const uint64_t* pin,
+	size_t count,
+	int64_t firstOffset,
+	size_t forceTail)
+{
+	ConvertLogicSamples(&cap, 1, count, firstOffset, forceTail,
+		[pin](size_t start, size_t end, size_t* counts, int64_t** offsets)
+		{ FindSerialLogicTransitions(pin, start, end, counts, offsets); },
+		[pin](size_t m, size_t /*line*/)
+		{ return ( (pin[m / 64] >> (m % 64)) & 1 ) ? true : false; });
+}
+
+/**
+	@brief Finds transitions of each line of a logic analyzer pod within a range of samples
+
+	A transition is a sample whose value differs from the one before it, so start must be at least 1.
+
+	@param pin		Input samples
+	@param start	First sample to check
+	@param end		One past the last sample to check
+	@param nlines	Number of lines
+	@param counts	Per-line transition counts, incremented for each transition found
+	@param offsets	If not null, the sample index of each transition of line j is written to offsets[j][counts[j]]
+ */
+void Oscilloscope::FindLogicPodTransitions(
+	const uint16_t* pin, size_t start, size_t end, size_t nlines, size_t* counts, int64_t** offsets)
+{
+	#ifdef __x86_64__
+	if(g_hasAvx2)
+		FindLogicPodTransitionsAVX2(pin, start, end, nlines, counts, offsets);
+	else
+	#endif
+		FindLogicPodTransitionsGeneric(pin, start, end, nlines, counts, offsets);
+}
+
+/**
+	@brief Generic backend for FindLogicPodTransitions()
+ */
+void Oscilloscope::FindLogicPodTransitionsGeneric(
+	const uint16_t* pin, size_t start, size_t end, size_t nlines, size_t* counts, int64_t** offsets)
+{
+	uint32_t linemask = (1U << nlines) - 1;
+
+	if(offsets)
+	{
+		for(size_t m=start; m<end; m++)
+		{
+			uint32_t toggled = (pin[m] ^ pin[m-1]) & linemask;
+			while(toggled)
+			{
+				size_t j = __builtin_ctz(toggled);
+				offsets[j][counts[j]++] = m;
+				toggled &= toggled - 1;
+			}
+		}
+	}
+	else
+	{
+		for(size_t m=start; m<end; m++)
+		{
+			uint32_t toggled = (pin[m] ^ pin[m-1]) & linemask;
+			while(toggled)
+			{
+				counts[__builtin_ctz(toggled)] ++;
+				toggled &= toggled - 1;
+			}
+		}
+	}
+}
+
+#ifdef __x86_64__
+/**
+	@brief AVX2 backend for FindLogicPodTransitions()
+
+	Each sample is XORed with the one before it, 32 at a time. Groups with no transitions are skipped outright;
+	otherwise each line's bit is shifted into the sign position and gathered with a byte movemask, giving a 32-bit
+	mask of that line's transitions to count or walk.
+ */
+__attribute__((target("avx2,bmi,popcnt")))
+void Oscilloscope::FindLogicPodTransitionsAVX2(
+	const uint16_t* pin, size_t start, size_t end, size_t nlines, size_t* counts, int64_t** offsets)
+{
+	__m256i linemask = _mm256_set1_epi16( (1U << nlines) - 1);
+
+	size_t m = start;
+	for(; m+32 <= end; m += 32)
+	{
+		__m256i toggled0 = _mm256_xor_si256(
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pin + m)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pin + m - 1)));
+		__m256i toggled1 = _mm256_xor_si256(
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pin + m + 16)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pin + m + 15)));
+		toggled0 = _mm256_and_si256(toggled0, linemask);
+		toggled1 = _mm256_and_si256(toggled1, linemask);
+
+		__m256i any = _mm256_or_si256(toggled0, toggled1);
+		if(_mm256_testz_si256(any, any))
+			continue;
+
+		for(size_t j=0; j<nlines; j++)
+		{
+			//Move this line to the sign bit, then saturate to bytes (which keeps the sign) and collect them.
+			//packs works within 128-bit lanes so the qwords need to be put back in order before the movemask.
+			__m128i shift = _mm_cvtsi32_si128(15 - j);
+			__m256i packed = _mm256_packs_epi16(
+				_mm256_sll_epi16(toggled0, shift),
+				_mm256_sll_epi16(toggled1, shift));
+			packed = _mm256_permute4x64_epi64(packed, 0xd8);
+			uint32_t mask = _mm256_movemask_epi8(packed);
+
+			if(!offsets)
+				counts[j] += __builtin_popcount(mask);
+			else
+			{
+				while(mask)
+				{
+					offsets[j][counts[j]++] = m + __builtin_ctz(mask);
+					mask &= mask - 1;
+				}
+			}
+		}
+	}
+
+	//Get any extras we didn't get in the SIMD loop
+	FindLogicPodTransitionsGeneric(pin, m, end, nlines, counts, offsets);
+}
+#endif /* __x86_64__ */
+
+/**
+	@brief Finds transitions within a range of a bit-serial logic analyzer stream, 64 samples at a time
+
+	A transition is a sample whose value differs from the one before it, so start must be at least 1.
+
+	@param pin		Input samples, LSB first
+	@param start	First sample to check
+	@param end		One past the last sample to check
+	@param counts	Transition count (single entry), incremented for each transition found
+	@param offsets	If not null, the sample index of each transition is written to offsets[0][counts[0]]
+ */
+void Oscilloscope::FindSerialLogicTransitions(
+	const uint64_t* pin, size_t start, size_t end, size_t* counts, int64_t** offsets)
+{
+	if(end <= start)
+		return;
+
+	size_t firstword = start / 64;
+	size_t lastword = (end - 1) / 64;
+	for(size_t i=firstword; i<=lastword; i++)
+	{
+		//Each bit of this is the value of the sample before the corresponding bit of the word
+		uint64_t prev = (i > 0) ? pin[i-1] : 0;
+		uint64_t before = (pin[i] << 1) | (prev >> 63);
+		uint64_t mask = pin[i] ^ before;
+
+		//Trim to the requested range
+		if(i == firstword)
+			mask &= ~0ULL << (start % 64);
+		if( (i == lastword) && (end % 64) )
+			mask &= (1ULL << (end % 64)) - 1;
+
+		if(!offsets)
+			counts[0] += __builtin_popcountll(mask);
+		else
+		{
+			size_t base = i*64;
+			while(mask)
+			{
+				offsets[0][counts[0]++] = base + __builtin_ctzll(mask);
+				mask &= mask - 1;
+			}
+		}
+	}
+}
@@ -874,6 +874,36 @@ public:
 	static void Convert16BitSamplesAVX512F(float* pout, const int16_t* pin, float gain, float offset, size_t count);
 #endif
 
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Logic analyzer sample conversion
+public:
+	static void ConvertLogicPodSamples(
+		SparseDigitalWaveform** caps,
+		size_t nlines,
+		const uint16_t* pin,
+		size_t count,
+		size_t forceTail = 0);
+	static void ConvertSerialLogicSamples(
+		SparseDigitalWaveform* cap,
+		const uint64_t* pin,
+		size_t count,
+		int64_t firstOffset = 0,
+		size_t forceTail = 0);
+
+	static void FindLogicPodTransitions(
+		const uint16_t* pin, size_t start, size_t end, size_t nlines, size_t* counts, int64_t** offsets);
+	static void FindLogicPodTransitionsGeneric(
+		const uint16_t* pin, size_t start, size_t end, size_t nlines, size_t* counts, int64_t** offsets);
+#ifdef __x86_64__
+	static void FindLogicPodTransitionsAVX2(
+		const uint16_t* pin, size_t start, size_t end, size_t nlines, size_t* counts, int64_t** offsets);
+#endif
+	static void FindSerialLogicTransitions(
+		const uint64_t* pin, size_t start, size_t end, size_t* counts, int64_t** offsets);
+
+	///@brief Maximum number of lines ConvertLogicPodSamples() can unpack from each sample
+	static const size_t MAX_LOGIC_POD_LINES = 16;
+
 public:
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Waveform Access
@@ -884,10 +914,115 @@ public:
 	virtual bool PopPendingWaveform();
 	virtual bool IsAppendingToWaveform();
 
+	/**
+		@brief What to do when a waveform is pushed while the pending waveform queue is full
+	 */
+	enum PendingQueuePolicy
+	{
+		///@brief Discard the oldest queued waveform to make room
+		QUEUE_DROP_OLDEST,
+
+		///@brief Discard the waveform being pushed
+		QUEUE_DROP_NEWEST,
+
+		///@brief Wait for the consumer to make room, dropping the new waveform if it times out
+		QUEUE_BLOCK_PRODUCER,
+
+		///@brief Move sample data of waveforms past the depth limit to temporary files until they're popped
+		QUEUE_SPILL_TO_DISK
+	};
+
+	/**
+		@brief Performance counters for the pending waveform queue
+	 */
+	struct PendingQueueStats
+	{
+		///@brief Number of waveforms pushed by the driver
+		uint64_t m_produced;
+
+		///@brief Number of waveforms popped by the application
+		uint64_t m_consumed;
+
+		///@brief Number of waveforms discarded because the queue was full
+		uint64_t m_dropped;
+
+		///@brief Number of waveforms spilled to disk
+		uint64_t m_spilled;
+
+		///@brief Time between push and pop of the most recently popped waveform, in seconds
+		double m_lastLatency;
+
+		///@brief Longest time between push and pop of any waveform, in seconds
+		double m_maxLatency;
+
+		///@brief Sum of push-to-pop time of all popped waveforms, in seconds
+		double m_totalLatency;
+
+		///@brief Mean time between push and pop, in seconds
+		double GetAverageLatency() const
+		{ return m_consumed ? (m_totalLatency / m_consumed) : 0; }
+	};
+
+	void SetPendingQueueDepth(size_t depth);
+	size_t GetPendingQueueDepth();
+	void SetPendingQueuePolicy(PendingQueuePolicy policy);
+	PendingQueuePolicy GetPendingQueuePolicy();
+	void SetPendingQueueBlockTimeout(double timeout);
+	PendingQueueStats GetPendingQueueStats();
+	void ResetPendingQueueStats();
+
 protected:
 	typedef std::map<StreamDescriptor, WaveformBase*> SequenceSet;
-	std::list<SequenceSet> m_pendingWaveforms;
+
+	size_t PushPendingWaveform(const SequenceSet& set);
+	bool TakePendingWaveform(SequenceSet& set);
+	virtual void DiscardPendingWaveform(WaveformBase* w);
+
+	///@brief A set of waveforms in the pending queue
+	struct PendingWaveformSet
+	{
+		///@brief The waveforms
+		SequenceSet m_set;
+
+		///@brief Time the set was pushed
+		double m_pushTime;
+
+		///@brief Temporary file holding the sample data, if spilled to disk
+		FILE* m_spillFile;
+	};
+
+	void DiscardPendingSet(PendingWaveformSet& entry);
+	static bool SpillPendingSet(PendingWaveformSet& entry);
+	static bool RestorePendingSet(PendingWaveformSet& entry);
+
+	///@brief Waveforms which have been acquired but not yet popped by the application
+	std::deque<PendingWaveformSet> m_pendingWaveforms;
+
+	///@brief Mutex for the pending waveform queue and its configuration and counters
 	std::mutex m_pendingWaveformsMutex;
+
+	///@brief Signaled when a waveform is popped, to wake producers blocked on a full queue
+	std::condition_variable m_pendingWaveformsSpace;
+
+	///@brief Maximum number of waveforms held in memory by the pending queue (0 for unlimited)
+	size_t m_pendingQueueDepth;
+
+	///@brief What to do when the pending queue is full
+	PendingQueuePolicy m_pendingQueuePolicy;
+
+	///@brief Longest time, in seconds, to wait for space in the queue under QUEUE_BLOCK_PRODUCER
+	double m_pendingQueueBlockTimeout;
+
+	///@brief Number of entries in m_pendingWaveforms which are currently spilled to disk
+	size_t m_pendingSpilledCount;
+
+	///@brief Number of pending sets held in memory, which is what the depth limit applies to (caller must hold the mutex)
+	size_t GetInMemoryPendingCount() const
+	{ return m_pendingWaveforms.size() - m_pendingSpilledCount; }
+
+	///@brief Counters for the pending queue
+	PendingQueueStats m_pendingQueueStats;
+
 	std::recursive_mutex m_mutex;
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -931,9 +1066,16 @@ protected:
 
 	WaveformPool m_digitalWaveformPool;
 
-	UniformAnalogWaveform* AllocateAnalogWaveform(const std::string& name)
+	/**
+		@brief Gets a analog waveform from the pool, or allocates a new one if the pool is empty
+
+		@param name			Name for the waveform
+		@param minCapacity	Number of samples the caller is about to store, if known.
+							Used to pick a pooled waveform that will not need to be reallocated.
+	 */
+	UniformAnalogWaveform* AllocateAnalogWaveform(const std::string& name, size_t minCapacity = 0)
 	{
-		auto p = m_analogWaveformPool.Get();
+		auto p = m_analogWaveformPool.Get(minCapacity);
 		auto ret = dynamic_cast<UniformAnalogWaveform*>(p);
 		if(ret)
 		{
@@ -949,9 +1091,16 @@ protected:
 		return new UniformAnalogWaveform(name);
 	}
 
-	SparseDigitalWaveform* AllocateDigitalWaveform(const std::string& name)
+	/**
+		@brief Gets a digital waveform from the pool, or allocates a new one if the pool is empty
+
+		@param name			Name for the waveform
+		@param minCapacity	Number of samples the caller is about to store, if known.
+							Used to pick a pooled waveform that will not need to be reallocated.
+	 */
+	SparseDigitalWaveform* AllocateDigitalWaveform(const std::string& name, size_t minCapacity = 0)
 	{
-		auto p = m_digitalWaveformPool.Get();
+		auto p = m_digitalWaveformPool.Get(minCapacity);
 		auto ret = dynamic_cast<SparseDigitalWaveform*>(p);
 		if(ret)
 		{
@@ -0,0 +1,321 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of PackedDigitalWaveform
+	@ingroup datamodel
+ */
+
+#include "scopehal.h"
+#include "PackedDigitalWaveform.h"
+
+using namespace std;
+
+//Number of words processed by each thread when working on large waveforms
+static const size_t BLOCK_WORDS = 65536;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Construction / destruction
+
+PackedDigitalWaveform::PackedDigitalWaveform(const string& name)
+	: m_size(0)
+{
+	Rename(name);
+
+	//Packed waveforms are only used by CPU-side code for now
+	m_words.SetCpuAccessHint(AcceleratorBuffer<uint64_t>::HINT_LIKELY);
+	m_words.SetGpuAccessHint(AcceleratorBuffer<uint64_t>::HINT_UNLIKELY);
+	m_words.PrepareForCpuAccess();
+}
+
+PackedDigitalWaveform::~PackedDigitalWaveform()
+{
+}
+
+void PackedDigitalWaveform::Rename(const string& name)
+{
+	if(name.empty())
+		m_words.SetName("PackedDigitalWaveform.m_words");
+	else
+		m_words.SetName(name + ".m_words");
+}
+
+/**
+	@brief Changes the number of samples in the waveform
+
+	If the waveform grows, new samples are uninitialized.
+ */
+void PackedDigitalWaveform::Resize(size_t size)
+{
+	m_words.resize( (size + 63) / 64);
+	m_size = size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Conversion to and from unpacked waveforms
+
+/**
+	@brief Copies timebase information from one waveform to another
+ */
+static void CopyMetadata(WaveformBase* dst, const WaveformBase* src)
+{
+	dst->m_timescale = src->m_timescale;
+	dst->m_startTimestamp = src->m_startTimestamp;
+	dst->m_startFemtoseconds = src->m_startFemtoseconds;
+	dst->m_triggerPhase = src->m_triggerPhase;
+	dst->m_flags = src->m_flags;
+}
+
+/**
+	@brief Replaces the contents of this waveform with a packed copy of a one-byte-per-sample waveform
+
+	@param wfm	The waveform to pack
+ */
+void PackedDigitalWaveform::Pack(UniformDigitalWaveform* wfm)
+{
+	wfm->PrepareForCpuAccess();
+	PrepareForCpuAccess();
+	CopyMetadata(this, wfm);
+
+	size_t len = wfm->size();
+	Resize(len);
+	size_t nwords = m_words.size();
+	if(!nwords)
+		return;
+
+	const bool* src = wfm->m_samples.GetCpuPointer();
+	uint64_t* dst = m_words.GetCpuPointer();
+
+	//Full words
+	size_t fullwords = len / 64;
+	#pragma omp parallel for if(fullwords > BLOCK_WORDS)
+	for(size_t i=0; i<fullwords; i++)
+	{
+		const bool* p = src + i*64;
+		uint64_t word = 0;
+		for(size_t j=0; j<8; j++)
+		{
+			//Each byte is 0 or 1, so multiplying gathers the low bit of each byte into the top byte
+			uint64_t bytes;
+			memcpy(&bytes, p + j*8, sizeof(bytes));
+			word |= ( (bytes * 0x0102040810204080ULL) >> 56) << (j*8);
+		}
+		dst[i] = word;
+	}
+
+	//Partial word at the end, if any
+	if(fullwords < nwords)
+	{
+		uint64_t word = 0;
+		for(size_t i=fullwords*64; i<len; i++)
+		{
+			if(src[i])
+				word |= 1ULL << (i % 64);
+		}
+		dst[fullwords] = word;
+	}
+
+	MarkModifiedFromCpu();
+}
+
+/**
+	@brief Expands this waveform into a one-byte-per-sample waveform, for use with filters that don't support packed data
+
+	@param wfm	The waveform to write to
+ */
+void PackedDigitalWaveform::Unpack(UniformDigitalWaveform* wfm)
+{
+	PrepareForCpuAccess();
+	wfm->PrepareForCpuAccess();
+	CopyMetadata(wfm, this);
+
+	size_t len = m_size;
+	wfm->Resize(len);
+
+	const uint64_t* src = m_words.GetCpuPointer();
+	bool* dst = wfm->m_samples.GetCpuPointer();
+
+	size_t nwords = m_words.size();
+	#pragma omp parallel for if(nwords > BLOCK_WORDS)
+	for(size_t i=0; i<nwords; i++)
+	{
+		uint64_t word = src[i];
+		size_t base = i*64;
+		size_t end = min(base + 64, len);
+		for(size_t j=base; j<end; j++)
+			dst[j] = (word >> (j - base)) & 1;
+	}
+
+	wfm->MarkModifiedFromCpu();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Edge detection
+
+/**
+	@brief Returns a mask of which samples in a word are edges of the requested type
+
+	@param word		Sample data
+	@param prev		Sample data from the previous word
+	@param type		Type of edge to look for
+ */
+static inline uint64_t GetEdgeMask(uint64_t word, uint64_t prev, PackedDigitalWaveform::EdgeType type)
+{
+	//Each bit of this is the value of the sample before the corresponding bit of the word
+	uint64_t before = (word << 1) | (prev >> 63);
+
+	switch(type)
+	{
+		case PackedDigitalWaveform::EDGE_RISING:
+			return word & ~before;
+
+		case PackedDigitalWaveform::EDGE_FALLING:
+			return ~word & before;
+
+		case PackedDigitalWaveform::EDGE_ANY:
+		default:
+			return word ^ before;
+	}
+}
+
+/**
+	@brief Finds edges in a range of packed samples, 64 samples at a time
+
+	An edge at index i is a transition between samples i-1 and i, so start must be at least 1.
+
+	@param words	Packed sample data
+	@param start	First sample index to check for an edge
+	@param end		One past the last sample index to check
+	@param type		Type of edge to look for
+	@param indexes	Output buffer for indexes of edges (must have room for end-start entries).
+					If null, edges are counted but not stored.
+
+	@return Number of edges found
+ */
+size_t PackedDigitalWaveform::FindEdges(const uint64_t* words, size_t start, size_t end, EdgeType type, size_t* indexes)
+{
+	if(end <= start)
+		return 0;
+
+	size_t n = 0;
+	size_t firstword = start / 64;
+	size_t lastword = (end - 1) / 64;
+	for(size_t i=firstword; i<=lastword; i++)
+	{
+		uint64_t prev = (i > 0) ? words[i-1] : 0;
+		uint64_t mask = GetEdgeMask(words[i], prev, type);
+
+		//Trim to the requested range
+		if(i == firstword)
+			mask &= ~0ULL << (start % 64);
+		if( (i == lastword) && (end % 64) )
+			mask &= (1ULL << (end % 64)) - 1;
+
+		if(!indexes)
+			n += __builtin_popcountll(mask);
+		else
+		{
+			size_t base = i*64;
+			while(mask)
+			{
+				indexes[n++] = base + __builtin_ctzll(mask);
+				mask &= mask - 1;
+			}
+		}
+	}
+	return n;
+}
+
+/**
+	@brief Counts the edges of a given type in the waveform
+ */
+size_t PackedDigitalWaveform::CountEdges(EdgeType type)
+{
+	PrepareForCpuAccess();
+	if(m_size < 2)
+		return 0;
+
+	const uint64_t* words = m_words.GetCpuPointer();
+	size_t nblocks = (m_words.size() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+	size_t count = 0;
+	#pragma omp parallel for reduction(+:count) if(nblocks > 1)
+	for(size_t b=0; b<nblocks; b++)
+	{
+		size_t start = max<size_t>(b * BLOCK_WORDS * 64, 1);
+		size_t end = min( (b+1) * BLOCK_WORDS * 64, m_size);
+		count += FindEdges(words, start, end, type, nullptr);
+	}
+	return count;
+}
+
+/**
+	@brief Finds the sample indexes of all edges of a given type in the waveform
+
+	The waveform is split into blocks which are counted in parallel, then each block writes its edges straight to
+	its final position in the output.
+
+	@param type		Type of edge to look for
+	@param indexes	Output sample indexes (any previous contents are discarded)
+
+	@return Number of edges found
+ */
+size_t PackedDigitalWaveform::FindEdges(EdgeType type, vector<size_t>& indexes)
+{
+	PrepareForCpuAccess();
+	indexes.clear();
+	if(m_size < 2)
+		return 0;
+
+	const uint64_t* words = m_words.GetCpuPointer();
+	size_t nblocks = (m_words.size() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+
+	vector<size_t> blockOffsets(nblocks + 1, 0);
+	#pragma omp parallel for if(nblocks > 1)
+	for(size_t b=0; b<nblocks; b++)
+	{
+		size_t start = max<size_t>(b * BLOCK_WORDS * 64, 1);
+		size_t end = min( (b+1) * BLOCK_WORDS * 64, m_size);
+		blockOffsets[b+1] = FindEdges(words, start, end, type, nullptr);
+	}
+	for(size_t b=0; b<nblocks; b++)
+		blockOffsets[b+1] += blockOffsets[b];
+
+	indexes.resize(blockOffsets[nblocks]);
+	#pragma omp parallel for if(nblocks > 1)
+	for(size_t b=0; b<nblocks; b++)
+	{
+		size_t start = max<size_t>(b * BLOCK_WORDS * 64, 1);
+		size_t end = min( (b+1) * BLOCK_WORDS * 64, m_size);
+		FindEdges(words, start, end, type, indexes.data() + blockOffsets[b]);
+	}
+
+	return indexes.size();
+}
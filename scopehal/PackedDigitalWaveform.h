@@ -0,0 +1,154 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of PackedDigitalWaveform
+	@ingroup datamodel
+ */
+
+#ifndef PackedDigitalWaveform_h
+#define PackedDigitalWaveform_h
+
+#include "Waveform.h"
+
+/**
+	@brief A uniformly sampled digital waveform stored one bit per sample
+	@ingroup datamodel
+
+	UniformDigitalWaveform uses a full byte per sample. This class packs 64 samples into each word (sample i is bit
+	i % 64 of word i / 64), cutting memory and bandwidth by a factor of eight for long logic analyzer captures, and
+	allows edges to be found 64 samples at a time.
+
+	Pack() and Unpack() convert to and from UniformDigitalWaveform so filters which have not yet been converted to
+	work on packed data directly can still be used.
+ */
+class PackedDigitalWaveform : public UniformWaveformBase
+{
+public:
+	PackedDigitalWaveform(const std::string& name = "");
+	virtual ~PackedDigitalWaveform();
+
+	virtual void Rename(const std::string& name = "") override;
+
+	///@brief Packed sample data, LSB first
+	AcceleratorBuffer<uint64_t> m_words;
+
+	///@brief Returns the value of a single sample
+	bool Get(size_t i) const
+	{ return (m_words[i / 64] >> (i % 64)) & 1; }
+
+	/**
+		@brief Sets the value of a single sample
+
+		Not thread safe if other threads are writing to samples in the same 64-sample word.
+	 */
+	void Set(size_t i, bool value)
+	{
+		uint64_t bit = 1ULL << (i % 64);
+		if(value)
+			m_words[i / 64] |= bit;
+		else
+			m_words[i / 64] &= ~bit;
+	}
+
+	///@brief Adds a sample to the end of the waveform
+	void push_back(bool value)
+	{
+		Resize(m_size + 1);
+		Set(m_size - 1, value);
+	}
+
+	void Pack(UniformDigitalWaveform* wfm);
+	void Unpack(UniformDigitalWaveform* wfm);
+
+	///@brief Types of edge to look for
+	enum EdgeType
+	{
+		EDGE_RISING,
+		EDGE_FALLING,
+		EDGE_ANY
+	};
+
+	size_t FindEdges(EdgeType type, std::vector<size_t>& indexes);
+	size_t CountEdges(EdgeType type);
+
+	static size_t FindEdges(const uint64_t* words, size_t start, size_t end, EdgeType type, size_t* indexes);
+
+	virtual void FreeGpuMemory() override
+	{ m_words.FreeGpuBuffer(); }
+
+	virtual bool HasGpuBuffer() override
+	{ return m_words.HasGpuBuffer(); }
+
+	virtual void Resize(size_t size) override;
+
+	virtual void Reserve(size_t size) override
+	{ m_words.reserve( (size + 63) / 64); }
+
+	virtual size_t size() const override
+	{ return m_size; }
+
+	virtual size_t capacity() const override
+	{ return m_words.capacity() * 64; }
+
+	virtual void clear() override
+	{
+		m_words.clear();
+		m_size = 0;
+	}
+
+	virtual void PrepareForCpuAccess() override
+	{ m_words.PrepareForCpuAccess(); }
+
+	virtual void PrepareForGpuAccess() override
+	{ m_words.PrepareForGpuAccess(); }
+
+	virtual void PrepareForGpuAccessNonblocking(vk::raii::CommandBuffer& cmdBuf) override
+	{ m_words.PrepareForGpuAccessNonblocking(false, cmdBuf); }
+
+	virtual void MarkSamplesModifiedFromCpu() override
+	{ m_words.MarkModifiedFromCpu(); }
+
+	virtual void MarkSamplesModifiedFromGpu() override
+	{ m_words.MarkModifiedFromGpu(); }
+
+	virtual void MarkModifiedFromCpu() override
+	{ MarkSamplesModifiedFromCpu(); }
+
+	virtual void MarkModifiedFromGpu() override
+	{ MarkSamplesModifiedFromGpu(); }
+
+protected:
+	///@brief Number of samples (bits) in the waveform
+	size_t m_size;
+};
+
+#endif
@@ -30,6 +30,8 @@
 #include "scopehal.h"
 #include "PacketDecoder.h"
 
+using namespace std;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Color schemes
 
@@ -44,6 +46,189 @@ std::string PacketDecoder::m_backgroundColors[PROTO_STANDARD_COLOR_COUNT] =
 	"#600050",		//PROTO_COLOR_COMMAND
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Interned strings
+
+/**
+	@brief A thread-safe table of distinct strings, each identified by a small integer
+
+	Strings are never removed, so IDs and references to the strings stay valid for the life of the program.
+ */
+class PacketStringTable
+{
+public:
+
+	/**
+		@brief Looks up the ID of a string, adding it to the table if it's not already there
+
+		@param str			The string
+		@param isColor		True to also parse the string as a color and cache the packed value
+	 */
+	uint32_t Intern(const string& str, bool isColor = false)
+	{
+		{
+			shared_lock<shared_mutex> lock(m_mutex);
+			auto it = m_ids.find(str);
+			if(it != m_ids.end())
+				return it->second;
+		}
+
+		lock_guard<shared_mutex> lock(m_mutex);
+
+		//Someone else might have added it while we weren't holding the lock
+		auto it = m_ids.find(str);
+		if(it != m_ids.end())
+			return it->second;
+
+		uint32_t id = m_strings.size();
+		m_strings.push_back(str);
+		m_packed.push_back(isColor ? ColorFromString(str) : 0);
+		m_ids[str] = id;
+		return id;
+	}
+
+	///@brief Gets the string for an ID
+	const string& GetString(uint32_t id)
+	{
+		shared_lock<shared_mutex> lock(m_mutex);
+		return m_strings[id];
+	}
+
+	///@brief Gets the packed color for an ID interned with isColor set
+	uint32_t GetPacked(uint32_t id)
+	{
+		shared_lock<shared_mutex> lock(m_mutex);
+		return m_packed[id];
+	}
+
+protected:
+	shared_mutex m_mutex;
+
+	///@brief Map of strings to IDs
+	unordered_map<string, uint32_t> m_ids;
+
+	///@brief The strings, indexed by ID (a deque so references stay valid as it grows)
+	deque<string> m_strings;
+
+	///@brief Packed color values, indexed by ID
+	deque<uint32_t> m_packed;
+};
+
+/**
+	@brief Gets the table of header column names
+
+	Function-local static so it's safe to use from other static initializers.
+ */
+static PacketStringTable& GetColumnTable()
+{
+	static PacketStringTable table;
+	return table;
+}
+
+///@brief Gets the table of packet colors
+static PacketStringTable& GetColorTable()
+{
+	static PacketStringTable table;
+	return table;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PacketHeaders
+
+/**
+	@brief Gets the ID of a header column, assigning a new one if this is the first time the name has been seen
+ */
+uint32_t PacketHeaders::GetColumnID(const string& name)
+{
+	return GetColumnTable().Intern(name);
+}
+
+/**
+	@brief Gets the name of a header column from its ID
+ */
+const string& PacketHeaders::GetColumnName(uint32_t id)
+{
+	return GetColumnTable().GetString(id);
+}
+
+/**
+	@brief Gets a reference to the value of a field, creating it (with an empty value) if it doesn't exist
+ */
+string& PacketHeaders::operator[](const string& name)
+{
+	uint32_t id = GetColumnID(name);
+	for(auto& f : m_fields)
+	{
+		if(f.first == id)
+			return f.second;
+	}
+
+	m_fields.push_back(Field(id, ""));
+	return m_fields.back().second;
+}
+
+/**
+	@brief Checks if a field exists, without creating it
+ */
+bool PacketHeaders::HasField(const string& name) const
+{
+	uint32_t id = GetColumnID(name);
+	for(auto& f : m_fields)
+	{
+		if(f.first == id)
+			return true;
+	}
+	return false;
+}
+
+/**
+	@brief Checks if two sets of headers have the same fields with the same values, regardless of creation order
+ */
+bool PacketHeaders::operator==(const PacketHeaders& rhs) const
+{
+	if(m_fields.size() != rhs.m_fields.size())
+		return false;
+
+	//Packets only have a handful of fields, so a quadratic search is faster than sorting
+	for(auto& f : m_fields)
+	{
+		bool found = false;
+		for(auto& g : rhs.m_fields)
+		{
+			if(f.first == g.first)
+			{
+				if(f.second != g.second)
+					return false;
+				found = true;
+				break;
+			}
+		}
+		if(!found)
+			return false;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PacketDisplayColor
+
+uint32_t PacketDisplayColor::Intern(const string& color)
+{
+	return GetColorTable().Intern(color, true);
+}
+
+///@brief Gets the color as an HTML color string
+const string& PacketDisplayColor::GetString() const
+{
+	return GetColorTable().GetString(m_id);
+}
+
+///@brief Gets the color in packed form, as returned by ColorFromString()
+uint32_t PacketDisplayColor::GetPacked() const
+{
+	return GetColorTable().GetPacked(m_id);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Packet
 
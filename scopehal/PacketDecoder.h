@@ -32,6 +32,99 @@
 
 #include "Filter.h"
 
+/**
+	@brief Header fields of a Packet
+
+	Column names are interned in a global table, so each packet only stores a small integer ID and the value for each
+	field it has, rather than a full std::map node with its own copy of the name. Lookup is by name, and operator[]
+	creates an empty field if it doesn't already exist, like the std::map<std::string, std::string> this replaces.
+
+	Fields are kept in a linked list so that, as with std::map, references returned by operator[] stay valid when
+	other fields are added later. Iteration visits fields in the order they were created, not sorted by name.
+ */
+class PacketHeaders
+{
+public:
+
+	///@brief A single field: column ID and value
+	typedef std::pair<uint32_t, std::string> Field;
+
+	std::string& operator[](const std::string& name);
+
+	bool HasField(const std::string& name) const;
+
+	///@brief Removes all fields
+	void clear()
+	{ m_fields.clear(); }
+
+	///@brief Returns the number of fields
+	size_t size() const
+	{ return m_fields.size(); }
+
+	///@brief Returns true if there are no fields
+	bool empty() const
+	{ return m_fields.empty(); }
+
+	std::list<Field>::const_iterator begin() const
+	{ return m_fields.begin(); }
+
+	std::list<Field>::const_iterator end() const
+	{ return m_fields.end(); }
+
+	bool operator==(const PacketHeaders& rhs) const;
+
+	bool operator!=(const PacketHeaders& rhs) const
+	{ return !(*this == rhs); }
+
+	static uint32_t GetColumnID(const std::string& name);
+	static const std::string& GetColumnName(uint32_t id);
+
+protected:
+
+	///@brief The fields, in creation order
+	std::list<Field> m_fields;
+};
+
+/**
+	@brief A packet foreground or background color
+
+	Behaves like the HTML color string it's assigned from, but only stores an index into a global table of distinct
+	colors. The table also caches each color in packed form, so it's only parsed once per color instead of once per
+	packet.
+ */
+class PacketDisplayColor
+{
+public:
+	PacketDisplayColor(const std::string& color)
+	: m_id(Intern(color))
+	{}
+
+	///@brief Sets the color from an HTML color string
+	PacketDisplayColor& operator=(const std::string& color)
+	{
+		m_id = Intern(color);
+		return *this;
+	}
+
+	operator const std::string&() const
+	{ return GetString(); }
+
+	const std::string& GetString() const;
+	uint32_t GetPacked() const;
+
+	bool operator==(const PacketDisplayColor& rhs) const
+	{ return m_id == rhs.m_id; }
+
+	bool operator!=(const PacketDisplayColor& rhs) const
+	{ return m_id != rhs.m_id; }
+
+protected:
+	static uint32_t Intern(const std::string& color);
+
+	///@brief Index of the color in the global table
+	uint32_t m_id;
+};
+
 /**
 	@class
 	@brief Generic display representation for arbitrary packetized data
@@ -49,16 +142,16 @@ public:
 	int64_t m_len;
 
 	//Arbitrary header properties (human readable)
-	std::map<std::string, std::string> m_headers;
+	PacketHeaders m_headers;
 
 	//Packet bytes
 	std::vector<uint8_t> m_data;
 
 	//Text color of the packet
-	std::string m_displayForegroundColor;
+	PacketDisplayColor m_displayForegroundColor;
 
 	//Background color of the packet
-	std::string m_displayBackgroundColor;
+	PacketDisplayColor m_displayBackgroundColor;
 
 	//Packed colors
 	uint32_t m_displayForegroundColorPacked;
@@ -72,8 +165,8 @@ public:
 			return;
 		m_packedColorsValid = true;
 
-		m_displayForegroundColorPacked = ColorFromString(m_displayForegroundColor);
-		m_displayBackgroundColorPacked = ColorFromString(m_displayBackgroundColor);
+		m_displayForegroundColorPacked = m_displayForegroundColor.GetPacked();
+		m_displayBackgroundColorPacked = m_displayBackgroundColor.GetPacked();
 	}
 };
 
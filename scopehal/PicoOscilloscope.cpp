@@ -292,6 +292,8 @@ PicoOscilloscope::PicoOscilloscope(SCPITransport* transport)
 		m_analogRawWaveformBuffers[i]->SetCpuAccessHint(AcceleratorBuffer<int16_t>::HINT_LIKELY);
 		m_analogRawWaveformBuffers[i]->SetGpuAccessHint(AcceleratorBuffer<int16_t>::HINT_LIKELY);
 	}
+	m_digitalRawWaveformBuffer.SetCpuAccessHint(AcceleratorBuffer<uint16_t>::HINT_LIKELY);
+	m_digitalRawWaveformBuffer.SetGpuAccessHint(AcceleratorBuffer<uint16_t>::HINT_NEVER);
 
 	//Create Vulkan objects for the waveform conversion
 	m_queue = g_vkQueueManager->GetComputeQueue("PicoOscilloscope.queue");
@@ -756,6 +758,17 @@ void PicoOscilloscope::BackgroundProcessing()
 	PushPendingWaveformsIfReady();
 }
 
+/**
+	@brief Recycles waveforms dropped from the pending queue instead of freeing them
+ */
+void PicoOscilloscope::DiscardPendingWaveform(WaveformBase* w)
+{
+	if(dynamic_cast<SparseDigitalWaveform*>(w))
+		AddWaveformToDigitalPool(w);
+	else
+		AddWaveformToAnalogPool(w);
+}
+
 /**
 	@brief Wait for waveform conversion to finish, then push it to the pending waveforms buffer
  */
@@ -768,22 +781,8 @@ void PicoOscilloscope::PushPendingWaveformsIfReady()
 	if(!m_queue->WaitIdleWithTimeout(1000 * 1000))
 		return;
 
-	//Save the waveforms to our queue
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(m_wipWaveforms);
-
-	//If we got backed up, drop the extra waveforms
-	while (m_pendingWaveforms.size() > 2)
-	{
-		LogTrace("Dropping waveform due to excessive pend queue depth\n");
-
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
-			AddWaveformToAnalogPool(it.second);
-		m_pendingWaveforms.pop_front();
-	}
-
-	m_pendingWaveformsMutex.unlock();
+	//Save the waveforms to our queue (if we got backed up, the queue drops the extra waveforms)
+	PushPendingWaveform(m_wipWaveforms);
 	m_wipWaveforms.clear();
 }
 
@@ -906,7 +905,7 @@ bool PicoOscilloscope::DoAcquireData(bool keep)
 				continue;
 
 			//Create our waveform
-			auto cap = AllocateAnalogWaveform(m_nickname + "." + GetOscilloscopeChannel(i)->GetHwname());
+			auto cap = AllocateAnalogWaveform(m_nickname + "." + GetOscilloscopeChannel(i)->GetHwname(), memdepth);
 			cap->m_timescale = fs_per_sample;
 			cap->m_triggerPhase = trigphase;
 			cap->m_startTimestamp = time(NULL);
@@ -962,13 +961,15 @@ bool PicoOscilloscope::DoAcquireData(bool keep)
 		//Digital pod
 		else
 		{
-			int16_t* buf = new int16_t[memdepth];
-
 			float trigphase;
 			if(!m_transport->ReadRawData(sizeof(trigphase), (uint8_t*)&trigphase))
 				return false;
 			trigphase = -trigphase * fs_per_sample;
-			if(!m_transport->ReadRawData(memdepth * sizeof(int16_t), (uint8_t*)buf))
+
+			m_digitalRawWaveformBuffer.resize(memdepth);
+			m_digitalRawWaveformBuffer.PrepareForCpuAccess();
+			auto buf = m_digitalRawWaveformBuffer.GetCpuPointer();
+			if(!m_transport->ReadRawData(memdepth * sizeof(uint16_t), (uint8_t*)buf))
 				return false;
 
 			if(!keep)
@@ -989,66 +990,16 @@ bool PicoOscilloscope::DoAcquireData(bool keep)
 				auto nchan = m_digitalChannelBase + 8*podnum + j;
 				caps[j] = AllocateDigitalWaveform(m_nickname + "." + GetOscilloscopeChannel(nchan)->GetHwname());
 				m_wipWaveforms[GetOscilloscopeChannel(nchan) ] = caps[j];
-			}
 
-			//Now that we have the waveform data, unpack it into individual channels
-			#pragma omp parallel for
-			for(size_t j=0; j<8; j++)
-			{
-				//Bitmask for this digital channel
-				int16_t mask = (1 << j);
-
-				//Create the waveform
-				auto cap = caps[j];
-				cap->m_timescale = fs_per_sample;
-				cap->m_triggerPhase = trigphase;
-				cap->m_startTimestamp = time(NULL);
-				cap->m_startFemtoseconds = fs;
-
-				//Preallocate memory assuming no deduplication possible
-				cap->Resize(memdepth);
-				cap->PrepareForCpuAccess();
-
-				//First sample never gets deduplicated
-				bool last = (buf[0] & mask) ? true : false;
-				size_t k = 0;
-				cap->m_offsets[0] = 0;
-				cap->m_durations[0] = 1;
-				cap->m_samples[0] = last;
-
-				//Read and de-duplicate the other samples
-				//TODO: can we vectorize this somehow?
-				for(size_t m=1; m<memdepth; m++)
-				{
-					bool sample = (buf[m] & mask) ? true : false;
-
-					//Deduplicate consecutive samples with same value
-					//FIXME: temporary workaround for rendering bugs
-					//if(last == sample)
-					if( (last == sample) && ((m+3) < memdepth) )
-						cap->m_durations[k] ++;
-
-					//Nope, it toggled - store the new value
-					else
-					{
-						k++;
-						cap->m_offsets[k] = m;
-						cap->m_durations[k] = 1;
-						cap->m_samples[k] = sample;
-						last = sample;
-					}
-				}
-
-				//Free space reclaimed by deduplication
-				cap->Resize(k);
-				cap->m_offsets.shrink_to_fit();
-				cap->m_durations.shrink_to_fit();
-				cap->m_samples.shrink_to_fit();
-				cap->MarkSamplesModifiedFromCpu();
-				cap->MarkTimestampsModifiedFromCpu();
+				caps[j]->m_timescale = fs_per_sample;
+				caps[j]->m_triggerPhase = trigphase;
+				caps[j]->m_startTimestamp = time(NULL);
+				caps[j]->m_startFemtoseconds = fs;
 			}
 
-			delete[] buf;
+			//Now that we have the waveform data, unpack and de-duplicate all eight channels in one pass
+			//FIXME: the last three samples are never deduplicated as a temporary workaround for rendering bugs
+			ConvertLogicPodSamples(caps, 8, buf, memdepth, 3);
 		}
 	}
 
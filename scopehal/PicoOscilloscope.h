@@ -200,6 +200,7 @@ protected:
 	void IdentifyHardware();
 
 	void PushPendingWaveformsIfReady();
+	virtual void DiscardPendingWaveform(WaveformBase* w) override;
 
 	//Helpers for determining legal configurations
 	bool Is10BitModeAvailable();
@@ -290,6 +291,9 @@ protected:
 	///@brief Index of next buffer from m_analogRawWaveformBuffers to use
 	unsigned int m_nextWaveformWriteBuffer;
 
+	///@brief Buffer for storing raw digital pod samples before unpacking to individual channels
+	AcceleratorBuffer<uint16_t> m_digitalRawWaveformBuffer;
+
 	//Vulkan waveform conversion
 	std::shared_ptr<QueueHandle> m_queue;
 	std::unique_ptr<vk::raii::CommandPool> m_pool;
@@ -374,9 +374,7 @@ bool PicoVNA::AcquireData()
 		}
 
 		//Save the waveforms to our queue
-		m_pendingWaveformsMutex.lock();
-		m_pendingWaveforms.push_back(s);
-		m_pendingWaveformsMutex.unlock();
+		PushPendingWaveform(s);
 	}
 
 	//Done, clean up
@@ -2165,7 +2165,7 @@ vector<WaveformBase*> RSRTB2kOscilloscope::ProcessAnalogWaveform(
 
 	//Set up the capture we're going to store our data into
 	//~ auto cap = AllocateAnalogWaveform(m_nickname + "." + GetChannel(ch)->GetHwname());
-	auto cap = AllocateAnalogWaveform(m_nickname + "." + m_channels[ch]->GetHwname());
+	auto cap = AllocateAnalogWaveform(m_nickname + "." + m_channels[ch]->GetHwname(), sampleCount);
 	cap->m_timescale = round(interval);
 
 	//~ cap->m_triggerPhase = h_off_frac;
@@ -2532,14 +2532,13 @@ bool RSRTB2kOscilloscope::AcquireData()
 
 
 	{	//Now that we have all of the pending waveforms, save them in sets across all channels
-		lock_guard<mutex> lock(m_pendingWaveformsMutex);
 		SequenceSet s;
 		for(size_t i = 0; i < m_analogAndDigitalChannelCount; i++)
 		{
 			if(pending_waveforms.find(i) != pending_waveforms.end())
 				s[GetOscilloscopeChannel(i)] = pending_waveforms[i][0];
 		}
-		m_pendingWaveforms.push_back(s);
+		PushPendingWaveform(s);
 	}
 
 	//double dt = GetTime() - start;
@@ -966,7 +966,6 @@ bool RSRTO6Oscilloscope::AcquireData()
 	if (any_data)
 	{
 		//Now that we have all of the pending waveforms, save them in sets across all channels
-		m_pendingWaveformsMutex.lock();
 		size_t num_pending = 1;	//TODO: segmented capture support
 		for(size_t i=0; i<num_pending; i++)
 		{
@@ -976,9 +975,8 @@ bool RSRTO6Oscilloscope::AcquireData()
 				if(IsChannelEnabled(j))
 					s[m_channels[j]] = pending_waveforms[j][i];
 			}
-			m_pendingWaveforms.push_back(s);
+			PushPendingWaveform(s);
 		}
-		m_pendingWaveformsMutex.unlock();
 	}
 
 	if(!any_data || !m_triggerOneShot)
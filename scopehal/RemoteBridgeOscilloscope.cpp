@@ -40,7 +40,9 @@ RemoteBridgeOscilloscope::RemoteBridgeOscilloscope(SCPITransport* transport, boo
 	, SCPIOscilloscope()
 	, m_triggerArmed(false)
 {
-
+	//Bridges stream waveforms as fast as they can, so only keep the most recent couple if the UI falls behind
+	SetPendingQueueDepth(2);
+	SetPendingQueuePolicy(QUEUE_DROP_OLDEST);
 }
 
 RemoteBridgeOscilloscope::~RemoteBridgeOscilloscope()
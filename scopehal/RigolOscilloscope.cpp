@@ -984,7 +984,6 @@ bool RigolOscilloscope::AcquireData()
 	}
 
 	//Now that we have all of the pending waveforms, save them in sets across all channels
-	m_pendingWaveformsMutex.lock();
 	size_t num_pending = 1;	   //TODO: segmented capture support
 	for(size_t i = 0; i < num_pending; i++)
 	{
@@ -994,9 +993,8 @@ bool RigolOscilloscope::AcquireData()
 			if(pending_waveforms.count(j) > 0)
 				s[GetOscilloscopeChannel(j)] = pending_waveforms[j][i];
 		}
-		m_pendingWaveforms.push_back(s);
+		PushPendingWaveform(s);
 	}
-	m_pendingWaveformsMutex.unlock();
 
 	//Clean up
 	delete[] temp_buf;
@@ -38,6 +38,9 @@
 
 using namespace std;
 
+///@brief Size of the receive staging buffer
+#define SOCKET_RX_BUFFER_SIZE (256 * 1024)
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Construction / destruction
 
@@ -49,6 +52,8 @@ using namespace std;
  */
 SCPISocketTransport::SCPISocketTransport(const string& args)
 	: m_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)
+	, m_rxBufferStart(0)
+	, m_rxBufferEnd(0)
 {
 	char hostname[128];
 	unsigned int port = 0;
@@ -77,6 +82,8 @@ SCPISocketTransport::SCPISocketTransport(const string& hostname, unsigned short
 	: m_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)
 	, m_hostname(hostname)
 	, m_port(port)
+	, m_rxBufferStart(0)
+	, m_rxBufferEnd(0)
 {
 	SharedCtorInit();
 }
@@ -88,6 +95,8 @@ void SCPISocketTransport::SharedCtorInit()
 {
 	LogDebug("Connecting to SCPI device at %s:%d\n", m_hostname.c_str(), m_port);
 
+	m_rxBuffer.resize(SOCKET_RX_BUFFER_SIZE);
+
 	if(!m_socket.Connect(m_hostname, m_port))
 	{
 		m_socket.Close();
@@ -144,26 +153,86 @@ bool SCPISocketTransport::SendCommand(const string& cmd)
 	return m_socket.SendLooped((unsigned char*)tempbuf.c_str(), tempbuf.length());
 }
 
+/**
+	@brief Reads as much data as is currently available from the socket (at least one byte) into the staging buffer
+
+	Must only be called when the staging buffer is empty.
+
+	@return True on success, false on timeout or socket error
+ */
+bool SCPISocketTransport::RefillRxBuffer()
+{
+	m_rxBufferStart = 0;
+	m_rxBufferEnd = 0;
+
+	ZSOCKET sock = m_socket;
+	while(true)
+	{
+		#ifdef _WIN32
+			int len = recv(sock, reinterpret_cast<char*>(&m_rxBuffer[0]), m_rxBuffer.size(), 0);
+		#else
+			ssize_t len = recv(sock, &m_rxBuffer[0], m_rxBuffer.size(), 0);
+			if( (len < 0) && (errno == EINTR) )
+				continue;
+		#endif
+
+		//Timeout, error, or connection closed
+		if(len <= 0)
+			return false;
+
+		m_rxBufferEnd = len;
+		return true;
+	}
+}
+
 string SCPISocketTransport::ReadReply(bool endOnSemicolon, [[maybe_unused]] function<void(float)> progress)
 {
-	//FIXME: there *has* to be a more efficient way to do this...
-	char tmp = ' ';
 	string ret;
 	while(true)
 	{
-		if(!m_socket.RecvLooped((unsigned char*)&tmp, 1))
-			break;
-		if( (tmp == '\n') || ( (tmp == ';') && endOnSemicolon ) )
+		if(m_rxBufferStart == m_rxBufferEnd)
+		{
+			if(!RefillRxBuffer())
+				break;
+		}
+
+		//Look for the end of the reply within the data we have so far
+		auto start = &m_rxBuffer[m_rxBufferStart];
+		size_t avail = GetRxBufferedSize();
+		auto end = static_cast<const uint8_t*>(memchr(start, '\n', avail));
+		size_t len = end ? (end - start) : avail;
+		if(endOnSemicolon)
+		{
+			auto semi = static_cast<const uint8_t*>(memchr(start, ';', len));
+			if(semi)
+			{
+				end = semi;
+				len = semi - start;
+			}
+		}
+
+		ret.append(reinterpret_cast<const char*>(start), len);
+		m_rxBufferStart += len;
+
+		//Found the terminator? Consume it and stop
+		if(end)
+		{
+			m_rxBufferStart ++;
 			break;
-		else
-			ret += tmp;
+		}
 	}
-	LogTrace("[%s] Got %s\n", m_hostname.c_str(), ret.c_str());
+
+	if(ret.size() > 256)
+		LogTrace("[%s] Got large reply of %zu bytes, not printing\n", m_hostname.c_str(), ret.size());
+	else
+		LogTrace("[%s] Got %s\n", m_hostname.c_str(), ret.c_str());
 	return ret;
 }
 
 void SCPISocketTransport::FlushRXBuffer(void)
 {
+	m_rxBufferStart = 0;
+	m_rxBufferEnd = 0;
 	m_socket.FlushRxBuffer();
 }
 
@@ -174,6 +243,14 @@ void SCPISocketTransport::SendRawData(size_t len, const unsigned char* buf)
 
 size_t SCPISocketTransport::ReadRawData(size_t len, unsigned char* buf, std::function<void(float)> progress)
 {
+	//Start by consuming anything left over in the staging buffer from a previous ReadReply()
+	size_t pos = min(len, GetRxBufferedSize());
+	if(pos)
+	{
+		memcpy(buf, &m_rxBuffer[m_rxBufferStart], pos);
+		m_rxBufferStart += pos;
+	}
+
 	size_t chunk_size = len;
 	if (progress)
 	{
@@ -183,16 +260,36 @@ size_t SCPISocketTransport::ReadRawData(size_t len, unsigned char* buf, std::fun
 			chunk_size = 32768;
 	}
 
-	for (size_t pos = 0; pos < len; )
+	while(pos < len)
 	{
 		size_t n = chunk_size;
 		if (n > (len - pos))
 			n = len - pos;
-		if(!m_socket.RecvLooped(buf + pos, n))
+
+		//Large reads go straight into the caller's buffer, no point in double buffering
+		if( (n >= m_rxBuffer.size() / 2) && (m_rxBufferStart == m_rxBufferEnd) )
 		{
-			LogTrace("Failed to get %zu bytes (@ pos %zu)\n", len, pos);
-			return 0;
+			if(!m_socket.RecvLooped(buf + pos, n))
+			{
+				LogTrace("Failed to get %zu bytes (@ pos %zu)\n", len, pos);
+				return 0;
+			}
 		}
+
+		//Small reads go through the staging buffer so any trailing data (e.g. the newline after a binary block)
+		//is picked up in the same syscall
+		else
+		{
+			if( (m_rxBufferStart == m_rxBufferEnd) && !RefillRxBuffer() )
+			{
+				LogTrace("Failed to get %zu bytes (@ pos %zu)\n", len, pos);
+				return 0;
+			}
+			n = min(n, GetRxBufferedSize());
+			memcpy(buf + pos, &m_rxBuffer[m_rxBufferStart], n);
+			m_rxBufferStart += n;
+		}
+
 		pos += n;
 		if (progress)
 		{
@@ -89,6 +89,12 @@ protected:
 
 	void SharedCtorInit();
 
+	bool RefillRxBuffer();
+
+	///@brief Number of bytes currently buffered and not yet consumed
+	size_t GetRxBufferedSize()
+	{ return m_rxBufferEnd - m_rxBufferStart; }
+
 	///@brief The socket for commands
 	Socket m_socket;
 
@@ -97,6 +103,20 @@ protected:
 
 	///@brief TCP port number of the instrument
 	unsigned short m_port;
+
+	/**
+		@brief Staging buffer for data received from the socket but not yet consumed
+
+		ReadReply(), ReadRawData(), and FlushRXBuffer() all go through this buffer so that replies can be read with a
+		small number of large recv() calls rather than one syscall per byte.
+	 */
+	std::vector<uint8_t> m_rxBuffer;
+
+	///@brief Index of the first valid byte in m_rxBuffer
+	size_t m_rxBufferStart;
+
+	///@brief Index one past the last valid byte in m_rxBuffer
+	size_t m_rxBufferEnd;
 };
 
 #endif
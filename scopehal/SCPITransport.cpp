@@ -272,6 +272,112 @@ void* SCPITransport::SendCommandImmediateWithRawBlockReply(string cmd, size_t& l
 	return buf;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Binary block API
+
+/**
+	@brief Reads the header of an IEEE 488.2 definite length binary block
+
+	Any text prefix (such as "DAT1," on LeCroy scopes) before the leading '#' is discarded.
+
+	@return Length of the block payload in bytes, or -1 if the header was malformed
+ */
+int64_t SCPITransport::ReadBinaryBlockHeader()
+{
+	//Read and discard data until we see the '#'
+	unsigned char tmp = 0;
+	const int maxPrefix = 32;
+	for(int i=0; ; i++)
+	{
+		if(1 != ReadBinaryBlockData(1, &tmp))
+			return -1;
+		if(tmp == '#')
+			break;
+
+		if(i == maxPrefix)
+		{
+			LogError("ReadBinaryBlockHeader: threw away %d bytes of data and never saw a '#'\n", maxPrefix);
+			return -1;
+		}
+	}
+
+	//Number of length digits
+	if(1 != ReadBinaryBlockData(1, &tmp))
+		return -1;
+	if( (tmp < '1') || (tmp > '9') )
+	{
+		LogError("ReadBinaryBlockHeader: invalid length-of-length '%c'\n", tmp);
+		return -1;
+	}
+	size_t ndigits = tmp - '0';
+
+	//The length itself
+	char digits[10] = {0};
+	if(ndigits != ReadBinaryBlockData(ndigits, reinterpret_cast<unsigned char*>(digits)))
+		return -1;
+	int64_t len = 0;
+	for(size_t i=0; i<ndigits; i++)
+	{
+		if(!isdigit(digits[i]))
+		{
+			LogError("ReadBinaryBlockHeader: invalid length field '%s'\n", digits);
+			return -1;
+		}
+		len = (len * 10) + (digits[i] - '0');
+	}
+
+	LogTrace("Binary block of %" PRIi64 " bytes\n", len);
+	return len;
+}
+
+/**
+	@brief Reads part of the payload of a binary block
+
+	The default implementation is a thin wrapper around ReadRawData(). Transports with message framing of their own
+	(such as VICP) override this to strip it.
+
+	@return Number of bytes actually read
+ */
+size_t SCPITransport::ReadBinaryBlockData(size_t len, unsigned char* buf, function<void(float)> progress)
+{
+	return ReadRawData(len, buf, progress);
+}
+
+/**
+	@brief Discards everything after a binary block payload up to and including the end-of-message terminator
+ */
+void SCPITransport::ReadBinaryBlockTrailer()
+{
+	unsigned char tmp = 0;
+	while(tmp != '\n')
+	{
+		if(1 != ReadBinaryBlockData(1, &tmp))
+			break;
+	}
+}
+
+/**
+	@brief Reads an entire binary block reply into a string
+
+	Unlike ReadReply(), the payload may contain embedded newlines or semicolons.
+
+	@return True on success, false on a malformed header or truncated payload
+ */
+bool SCPITransport::ReadBinaryBlock(string& buf, function<void(float)> progress)
+{
+	lock_guard<recursive_mutex> lock(m_netMutex);
+
+	auto len = ReadBinaryBlockHeader();
+	if(len < 0)
+		return false;
+
+	buf.resize(len);
+	bool ok = (static_cast<size_t>(len) ==
+		ReadBinaryBlockData(len, reinterpret_cast<unsigned char*>(&buf[0]), progress));
+	ReadBinaryBlockTrailer();
+	return ok;
+}
+
 void SCPITransport::FlushRXBuffer(void)
 {
 	LogError("SCPITransport::FlushRXBuffer is unimplemented\n");
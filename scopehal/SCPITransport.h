@@ -83,6 +83,57 @@ public:
 	virtual bool IsCommandBatchingSupported() =0;
 	virtual bool IsConnected() =0;
 
+	/*
+		IEEE 488.2 definite length binary block API
+
+		A block consists of an optional text prefix (e.g. "DAT1,"), a header of the form #Nxxxx where N is the number of
+		ASCII length digits to follow, the payload, and a terminator. The caller must hold the transport mutex.
+	 */
+	virtual int64_t ReadBinaryBlockHeader();
+	virtual size_t ReadBinaryBlockData(size_t len, unsigned char* buf, std::function<void(float)> progress = nullptr);
+	virtual void ReadBinaryBlockTrailer();
+
+	/**
+		@brief Reads an entire binary block reply straight into a buffer, without any intermediate copies
+
+		The buffer is resized to fit the payload. Any trailing partial element (if the payload is not a multiple of
+		sizeof(T)) is discarded.
+
+		@param buf			Buffer to store the payload in
+		@param progress		Optional callback for download progress reporting
+
+		@return True on success, false on a malformed header or truncated payload
+	 */
+	template<class T>
+	bool ReadBinaryBlock(AcceleratorBuffer<T>& buf, std::function<void(float)> progress = nullptr)
+	{
+		std::lock_guard<std::recursive_mutex> lock(m_netMutex);
+
+		auto len = ReadBinaryBlockHeader();
+		if(len < 0)
+			return false;
+
+		size_t count = len / sizeof(T);
+		buf.PrepareForCpuAccessIgnoringGpuData();
+		buf.resize(count);
+
+		bool ok = (ReadBinaryBlockData(count * sizeof(T), reinterpret_cast<unsigned char*>(buf.GetCpuPointer()), progress)
+			== count * sizeof(T));
+
+		//Discard any leftover bytes that didn't make a full element
+		for(size_t i=count * sizeof(T); i<static_cast<size_t>(len); i++)
+		{
+			unsigned char dummy;
+			ReadBinaryBlockData(1, &dummy);
+		}
+
+		ReadBinaryBlockTrailer();
+		buf.MarkModifiedFromCpu();
+		return ok;
+	}
+
+	bool ReadBinaryBlock(std::string& buf, std::function<void(float)> progress = nullptr);
+
 	/**
 		@brief Enables rate limiting. Rate limiting is only applied to the queued command API.
 
@@ -1612,40 +1612,25 @@ Oscilloscope::TriggerMode SiglentSCPIOscilloscope::PollTrigger()
 int SiglentSCPIOscilloscope::ReadWaveformBlock(uint32_t maxsize, size_t& readBytes, char* data, bool hdSizeWorkaround, std::function<void(float)> progress)
 {
 	readBytes = 0;
-	//Read and discard data until we see the '#'
-	uint8_t tmp;
-	for(int i=0; i<20; i++)
-	{
-		m_transport->ReadRawData(1, &tmp);
-		if(tmp == '#')
-			break;
 
-		//shouldn't ever get here
-		if(i == 19)
-		{
-			LogError("ReadWaveformBlock: threw away 20 bytes of data and never saw a '#'\n");
-			// This is a protocol error, flush pending rx data
-			flush();
-			// Stop aqcuisition after this protocol error
-			Stop();
-			return 0;
-		}
+	//Parse the #9 header (discarding anything before the '#')
+	int64_t blockLength = m_transport->ReadBinaryBlockHeader();
+	if(blockLength < 0)
+	{
+		LogError("ReadWaveformBlock: invalid binary block header\n");
+		// This is a protocol error, flush pending rx data
+		flush();
+		// Stop aqcuisition after this protocol error
+		Stop();
+		return 0;
 	}
-
-	//Read length of the length field
-	m_transport->ReadRawData(1, &tmp);
-	int lengthOfLength = tmp - '0';
-
-	//Read the actual length field
-	char textlen[10] = {0};
-	m_transport->ReadRawData(lengthOfLength, (unsigned char*)textlen);
-	uint32_t getLength = atoi(textlen);
+	uint32_t getLength = blockLength;
 
 	uint32_t len = getLength;
 	if(hdSizeWorkaround)
 		len *= 2;
 
-	LogTrace("Got length %" PRIu32 " ('%s') from scope, hdSizeWorkaround = %s, expected bytes = %" PRIu32 ", maxsize = %" PRIu32 " => reading %" PRIu32 " bytes.\n",getLength, textlen, hdSizeWorkaround ? "true" : "false", len, maxsize, min(len, maxsize));
+	LogTrace("Got length %" PRIu32 " from scope, hdSizeWorkaround = %s, expected bytes = %" PRIu32 ", maxsize = %" PRIu32 " => reading %" PRIu32 " bytes.\n",getLength, hdSizeWorkaround ? "true" : "false", len, maxsize, min(len, maxsize));
 	if(len > maxsize)
 	{
 		len = maxsize;
@@ -1654,7 +1639,7 @@ int SiglentSCPIOscilloscope::ReadWaveformBlock(uint32_t maxsize, size_t& readByt
 
 	while(readBytes < len)
 	{
-		size_t newBytes = m_transport->ReadRawData(len-readBytes, (unsigned char*)(data+readBytes), progress);
+		size_t newBytes = m_transport->ReadBinaryBlockData(len-readBytes, (unsigned char*)(data+readBytes), progress);
 		if(newBytes == 0) break;
 		readBytes += newBytes;
 	}
@@ -2439,7 +2424,6 @@ bool SiglentSCPIOscilloscope::AcquireData()
 	}
 
 	//Now that we have all of the pending waveforms, save them in sets across all channels
-	m_pendingWaveformsMutex.lock();
 	for(size_t i = 0; i < num_sequences; i++)
 	{
 		SequenceSet s;
@@ -2448,9 +2432,8 @@ bool SiglentSCPIOscilloscope::AcquireData()
 			if(pending_waveforms.find(j) != pending_waveforms.end())
 				s[GetOscilloscopeChannel(j)] = pending_waveforms[j][i];
 		}
-		m_pendingWaveforms.push_back(s);
+		PushPendingWaveform(s);
 	}
-	m_pendingWaveformsMutex.unlock();
 
 	//Clean up
 	for(int i = 0; i < MAX_ANALOG; i++)
@@ -193,42 +193,39 @@ bool SocketCANAnalyzer::IsAppendingToWaveform()
 
 bool SocketCANAnalyzer::PopPendingWaveform()
 {
-	lock_guard<mutex> lock(m_pendingWaveformsMutex);
-	if(m_pendingWaveforms.size())
+	SequenceSet set;
+	if(!TakePendingWaveform(set))
+		return false;
+
+	for(auto it : set)
 	{
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
+		auto chan = it.first.m_channel;
+		auto data = dynamic_cast<CANWaveform*>(it.second);
+		auto nstream = it.first.m_stream;
+
+		//If there is an existing waveform, append to it
+		//TODO: make this more efficient
+		auto oldWaveform = dynamic_cast<CANWaveform*>(chan->GetData(nstream));
+		if(oldWaveform && data && m_appendingNext)
 		{
-			auto chan = it.first.m_channel;
-			auto data = dynamic_cast<CANWaveform*>(it.second);
-			auto nstream = it.first.m_stream;
-
-			//If there is an existing waveform, append to it
-			//TODO: make this more efficient
-			auto oldWaveform = dynamic_cast<CANWaveform*>(chan->GetData(nstream));
-			if(oldWaveform && data && m_appendingNext)
+			size_t len = data->size();
+			oldWaveform->PrepareForCpuAccess();
+			data->PrepareForCpuAccess();
+			for(size_t i=0; i<len; i++)
 			{
-				size_t len = data->size();
-				oldWaveform->PrepareForCpuAccess();
-				data->PrepareForCpuAccess();
-				for(size_t i=0; i<len; i++)
-				{
-					oldWaveform->m_samples.push_back(data->m_samples[i]);
-					oldWaveform->m_offsets.push_back(data->m_offsets[i]);
-					oldWaveform->m_durations.push_back(data->m_durations[i]);
-				}
-				oldWaveform->m_revision ++;
-				oldWaveform->MarkModifiedFromCpu();
+				oldWaveform->m_samples.push_back(data->m_samples[i]);
+				oldWaveform->m_offsets.push_back(data->m_offsets[i]);
+				oldWaveform->m_durations.push_back(data->m_durations[i]);
 			}
-			else
-				chan->SetData(data, nstream);
+			oldWaveform->m_revision ++;
+			oldWaveform->MarkModifiedFromCpu();
 		}
-		m_pendingWaveforms.pop_front();
-
-		m_appendingNext = true;
-		return true;
+		else
+			chan->SetData(data, nstream);
 	}
-	return false;
+
+	m_appendingNext = true;
+	return true;
 }
 
 bool SocketCANAnalyzer::AcquireData()
@@ -346,11 +343,9 @@ bool SocketCANAnalyzer::AcquireData()
 	cap->MarkModifiedFromCpu();
 
 	//Save newly created waveform
-	m_pendingWaveformsMutex.lock();
-		SequenceSet s;
-		s[m_channels[0]] = cap;
-		m_pendingWaveforms.push_back(s);
-	m_pendingWaveformsMutex.unlock();
+	SequenceSet s;
+	s[m_channels[0]] = cap;
+	PushPendingWaveform(s);
 
 	if(m_triggerOneShot)
 		m_triggerArmed = false;
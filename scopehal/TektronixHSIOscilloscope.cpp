@@ -60,6 +60,10 @@ TektronixHSIOscilloscope::TektronixHSIOscilloscope(SCPITransport* transport)
 	if(!csock)
 		LogFatal("TektronixHSIOscilloscope expects a SCPITwinLanTransport\n");
 
+	//Streaming source, keep only the most recent waveforms if the UI falls behind
+	SetPendingQueueDepth(2);
+	SetPendingQueuePolicy(QUEUE_DROP_OLDEST);
+
 	// greeting = transport.ReadRawData()
 }
 
@@ -99,7 +103,7 @@ bool TektronixHSIOscilloscope::AcquireData()
 	LogTrace("About to recv %ld floats\n", num_samples);
 
 	SequenceSet s;
-	UniformAnalogWaveform* cap = AllocateAnalogWaveform(m_nickname + "." + GetChannel(0)->GetHwname());
+	UniformAnalogWaveform* cap = AllocateAnalogWaveform(m_nickname + "." + GetChannel(0)->GetHwname(), num_samples);
 	cap->m_timescale = sr_fs;
 	cap->m_triggerPhase = 0;
 	cap->m_startTimestamp = time(NULL);
@@ -112,18 +116,7 @@ bool TektronixHSIOscilloscope::AcquireData()
 
 	s[GetOscilloscopeChannel(0)] = cap;
 
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(s);
-
-	while (m_pendingWaveforms.size() > 2)
-	{
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
-			delete it.second;
-		m_pendingWaveforms.pop_front();
-	}
-
-	m_pendingWaveformsMutex.unlock();
+	PushPendingWaveform(s);
 
 	if (m_triggerOneShot)
 		m_triggerArmed = false;
@@ -1579,7 +1579,6 @@ bool TektronixOscilloscope::AcquireData()
 	}
 
 	//Now that we have all of the pending waveforms, save them in sets across all channels
-	m_pendingWaveformsMutex.lock();
 	size_t num_pending = 1;	//TODO: segmented capture support
 	for(size_t i=0; i<num_pending; i++)
 	{
@@ -1589,9 +1588,8 @@ bool TektronixOscilloscope::AcquireData()
 			if(IsChannelEnabled(j))
 				s[GetOscilloscopeChannel(j)] = pending_waveforms[j][i];
 		}
-		m_pendingWaveforms.push_back(s);
+		PushPendingWaveform(s);
 	}
-	m_pendingWaveformsMutex.unlock();
 
 	//Re-arm the trigger if not in one-shot mode
 	if(!m_triggerOneShot)
@@ -1884,7 +1882,7 @@ bool TektronixOscilloscope::AcquireDataMSO56(map<int, vector<WaveformBase*> >& p
 
 			//Set up the capture we're going to store our data into
 			//(no TDC data or fine timestamping available on Tektronix scopes?)
-			auto cap = AllocateAnalogWaveform(m_nickname + "." + GetChannel(i)->GetHwname());
+			auto cap = AllocateAnalogWaveform(m_nickname + "." + GetChannel(i)->GetHwname(), nsamples);
 			cap->m_timescale = timebase;
 			cap->m_triggerPhase = 0;
 			cap->m_startTimestamp = time(NULL);
@@ -628,6 +628,14 @@ bool ThunderScopeOscilloscope::DoAcquireData(bool keep)
 	return true;
 }
 
+/**
+	@brief Recycles waveforms dropped from the pending queue instead of freeing them
+ */
+void ThunderScopeOscilloscope::DiscardPendingWaveform(WaveformBase* w)
+{
+	AddWaveformToAnalogPool(w);
+}
+
 /**
 	@brief Wait for waveform conversion to finish, then push it to the pending waveforms buffer
  */
@@ -640,37 +648,21 @@ void ThunderScopeOscilloscope::PushPendingWaveformsIfReady()
 	if(!m_queue->WaitIdleWithTimeout(1000 * 1000))
 		return;
 
-	//Save the waveforms to our queue
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(m_wipWaveforms);
+	//Save the waveforms to our queue (if we got backed up, the queue drops the extra waveforms)
+	size_t newlyDropped = PushPendingWaveform(m_wipWaveforms);
 
 	//Bump waveform performance counters
 	FilterParameter* param = &m_diag_totalWFMs;
 	int total = param->GetIntVal() + 1;
 	param->SetIntVal(total);
 
-	//If we got backed up, drop the extra waveforms
-	param = &m_diag_droppedWFMs;
-	int dropped = param->GetIntVal();
-	while (m_pendingWaveforms.size() > 2)
-	{
-		LogTrace("Dropping waveform due to excessive pend queue depth\n");
-
-		SequenceSet set = *m_pendingWaveforms.begin();
-		for(auto it : set)
-			AddWaveformToAnalogPool(it.second);
-		m_pendingWaveforms.pop_front();
-
-		dropped++;
-	}
-
 	//Update dropped waveform perf counter
+	param = &m_diag_droppedWFMs;
+	int dropped = param->GetIntVal() + newlyDropped;
 	param->SetIntVal(dropped);
 	param = &m_diag_droppedPercent;
 	param->SetFloatVal((float)dropped / (float)total);
 
-	m_pendingWaveformsMutex.unlock();
-
 	m_wipWaveforms.clear();
 
 	#ifdef HAVE_NVTX
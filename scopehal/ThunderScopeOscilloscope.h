@@ -111,6 +111,7 @@ protected:
 	bool DoAcquireData(bool keep);
 
 	void PushPendingWaveformsIfReady();
+	virtual void DiscardPendingWaveform(WaveformBase* w) override;
 
 	std::string GetChannelColor(size_t i);
 
@@ -364,7 +364,6 @@ bool TinySA::AcquireData()
 		m_queue);
 
 	//Now that we have all of the pending waveforms, save them in sets across all channels
-	m_pendingWaveformsMutex.lock();
 	size_t num_pending = 1;
 	for(size_t i=0; i<num_pending; i++)
 	{
@@ -374,9 +373,8 @@ bool TinySA::AcquireData()
 			if(IsChannelEnabled(j))
 				s[GetOscilloscopeChannel(j)] = pending_waveforms[j][i];
 		}
-		m_pendingWaveforms.push_back(s);
+		PushPendingWaveform(s);
 	}
-	m_pendingWaveformsMutex.unlock();
 
 	if(m_triggerOneShot)
 		m_triggerArmed = false;
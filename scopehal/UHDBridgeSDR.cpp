@@ -403,14 +403,14 @@ bool UHDBridgeSDR::AcquireData()
 			LogDebug("got %" PRIu64 " samples\n", depth);
 
 		//Create our waveforms
-		auto icap = AllocateAnalogWaveform(m_nickname + "." + GetOscilloscopeChannel(i)->GetHwname() + ".i");
+		auto icap = AllocateAnalogWaveform(m_nickname + "." + GetOscilloscopeChannel(i)->GetHwname() + ".i", depth);
 		icap->m_timescale = fs_per_sample;
 		icap->m_triggerPhase = 0;
 		icap->m_startTimestamp = floor(now);
 		icap->m_startFemtoseconds = (now - floor(now)) * FS_PER_SECOND;
 		icap->Resize(depth);
 
-		auto qcap = AllocateAnalogWaveform(m_nickname + "." + GetOscilloscopeChannel(i)->GetHwname() + ".q");
+		auto qcap = AllocateAnalogWaveform(m_nickname + "." + GetOscilloscopeChannel(i)->GetHwname() + ".q", depth);
 		qcap->m_timescale = fs_per_sample;
 		qcap->m_triggerPhase = 0;
 		qcap->m_startTimestamp = floor(now);
@@ -440,9 +440,7 @@ bool UHDBridgeSDR::AcquireData()
 	}
 
 	//Save the waveforms to our queue
-	m_pendingWaveformsMutex.lock();
-	m_pendingWaveforms.push_back(s);
-	m_pendingWaveformsMutex.unlock();
+	PushPendingWaveform(s);
 
 	//If this was a one-shot trigger we're no longer armed
 	if(m_triggerOneShot)
@@ -37,6 +37,7 @@
 #include "scopehal.h"
 
 #include <cinttypes>
+#include <charconv>
 
 using namespace std;
 
@@ -247,7 +248,7 @@ string Unit::ToString() const
 /**
 	@brief Gets the appropriate SI scaling factor for a number.
  */
-void Unit::GetSIScalingFactor(double num, double& scaleFactor, string& prefix) const
+void Unit::GetSIScalingFactor(double num, double& scaleFactor, const char*& prefix) const
 {
 	scaleFactor = 1;
 	prefix = "";
@@ -326,9 +327,16 @@ void Unit::GetSIScalingFactor(double num, double& scaleFactor, string& prefix) c
 
 	Note that this function may modify the SI scale factor and prefix
  */
-void Unit::GetUnitSuffix(UnitType type, double num, double& scaleFactor, string& prefix, string& numprefix, string& suffix) const
+void Unit::GetUnitSuffix(
+	UnitType type,
+	double num,
+	double& scaleFactor,
+	const char*& prefix,
+	const char*& numprefix,
+	const char*& suffix) const
 {
 	numprefix = "";
+	suffix = "";
 
 	switch(type)
 	{
@@ -653,9 +661,9 @@ string Unit::PrettyPrint(double value, int sigfigs, bool useDisplayLocale) const
 
 	//Figure out scaling, prefix, and suffix
 	double scaleFactor;
-	string prefix;
-	string numprefix;
-	string suffix;
+	const char* prefix;
+	const char* numprefix;
+	const char* suffix;
 	GetSIScalingFactor(value, scaleFactor, prefix);
 	GetUnitSuffix(m_type, value, scaleFactor, prefix, numprefix, suffix);
 
@@ -708,34 +716,34 @@ string Unit::PrettyPrint(double value, int sigfigs, bool useDisplayLocale) const
 						leftdigits = 2;
 					else if(fabs(value_rescaled) > 1)
 						leftdigits = 1;
-					int rightdigits = sigfigs - leftdigits;
+					int rightdigits = max(sigfigs - leftdigits, 0);
 
 					string format = string("%") + to_string(leftdigits) + "." + to_string(rightdigits) + "f%s%s%s";
-					snprintf(tmp, sizeof(tmp), format.c_str(), value_rescaled, space, prefix.c_str(), suffix.c_str());
+					snprintf(tmp, sizeof(tmp), format.c_str(), value_rescaled, space, prefix, suffix);
 				}
 
 				//If not a round number, add more digits (up to 5)
 				else
 				{
 					if( fabs(round(value_rescaled) - value_rescaled) < 0.001 )
-						snprintf(tmp, sizeof(tmp), "%.0f%s%s%s", value_rescaled, space, prefix.c_str(), suffix.c_str());
+						snprintf(tmp, sizeof(tmp), "%.0f%s%s%s", value_rescaled, space, prefix, suffix);
 					else if(fabs(round(value_rescaled*10) - value_rescaled*10) < 0.001)
-						snprintf(tmp, sizeof(tmp), "%.1f%s%s%s", value_rescaled, space, prefix.c_str(), suffix.c_str());
+						snprintf(tmp, sizeof(tmp), "%.1f%s%s%s", value_rescaled, space, prefix, suffix);
 					else if(fabs(round(value_rescaled*100) - value_rescaled*100) < 0.001 )
-						snprintf(tmp, sizeof(tmp), "%.2f%s%s%s", value_rescaled, space, prefix.c_str(), suffix.c_str());
+						snprintf(tmp, sizeof(tmp), "%.2f%s%s%s", value_rescaled, space, prefix, suffix);
 					else if(fabs(round(value_rescaled*1000) - value_rescaled*1000) < 0.001 )
-						snprintf(tmp, sizeof(tmp), "%.3f%s%s%s", value_rescaled, space, prefix.c_str(), suffix.c_str());
+						snprintf(tmp, sizeof(tmp), "%.3f%s%s%s", value_rescaled, space, prefix, suffix);
 					else if(fabs(round(value_rescaled*10000) - value_rescaled*10000) < 0.001 )
-						snprintf(tmp, sizeof(tmp), "%.4f%s%s%s", value_rescaled, space, prefix.c_str(), suffix.c_str());
+						snprintf(tmp, sizeof(tmp), "%.4f%s%s%s", value_rescaled, space, prefix, suffix);
 					else
-						snprintf(tmp, sizeof(tmp), "%.5f%s%s%s", value_rescaled, space, prefix.c_str(), suffix.c_str());
+						snprintf(tmp, sizeof(tmp), "%.5f%s%s%s", value_rescaled, space, prefix, suffix);
 				}
 			}
 			break;
 	}
 
 	SetDefaultLocale();
-	return numprefix + string(tmp);
+	return string(numprefix) + tmp;
 }
 
 /**
@@ -753,9 +761,9 @@ string Unit::PrettyPrintInt64(int64_t value, int /*sigfigs*/, bool useDisplayLoc
 
 	//Figure out scaling, prefix, and suffix
 	double scaleFactor;
-	string prefix;
-	string numprefix;
-	string suffix;
+	const char* prefix;
+	const char* numprefix;
+	const char* suffix;
 	GetSIScalingFactor(value, scaleFactor, prefix);
 	GetUnitSuffix(m_type, value, scaleFactor, prefix, numprefix, suffix);
 
@@ -847,7 +855,7 @@ string Unit::PrettyPrintInt64(int64_t value, int /*sigfigs*/, bool useDisplayLoc
 	}
 
 	SetDefaultLocale();
-	return numprefix + string(tmp) + (space_after_number ? " " : "") + prefix + suffix;
+	return string(numprefix) + tmp + (space_after_number ? " " : "") + prefix + suffix;
 }
 
 
@@ -873,9 +881,9 @@ string Unit::PrettyPrintRange(double pixelMin, double pixelMax, double rangeMin,
 
 	//Figure out the scale factor to use. Use the full-scale range to select the factor even if we're small here
 	double scaleFactor;
-	string prefix;
-	string numprefix;
-	string suffix;
+	const char* prefix;
+	const char* numprefix;
+	const char* suffix;
 	double extremeValue = max(fabs(rangeMin), fabs(rangeMax));
 	GetSIScalingFactor(extremeValue, scaleFactor, prefix);
 	GetUnitSuffix(m_type, extremeValue, scaleFactor, prefix, numprefix, suffix);
@@ -1033,7 +1041,7 @@ string Unit::PrettyPrintRange(double pixelMin, double pixelMax, double rangeMin,
 	//Final formatting
 	if(m_type != Unit::UNIT_UI)
 		out += " ";
-	out = numprefix + out;
+	out = string(numprefix) + out;
 	out += prefix;
 	out += suffix;
 
@@ -1279,6 +1287,491 @@ int64_t Unit::ParseStringInt64(const string& str, bool useDisplayLocale)
 	return ret;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Bulk formatting and parsing
+
+//Number of values handled by each thread in the bulk APIs
+static const size_t BULK_CHUNK_SIZE = 16384;
+
+/**
+	@brief Prints a value in fixed point notation with the given number of decimal places, in the "C" locale
+
+	@return Pointer to the end of the printed text, or null if it didn't fit
+ */
+static char* PrintFixed(char* p, char* end, double value, int precision)
+{
+	//Apple's libc++ has no floating point to_chars on older OS versions
+	#ifdef __APPLE__
+		int len = snprintf(p, end - p, "%.*f", precision, value);
+		if( (len < 0) || (len >= (end - p)) )
+			return nullptr;
+		return p + len;
+	#else
+		auto result = to_chars(p, end, value, chars_format::fixed, precision);
+		if(result.ec != errc())
+			return nullptr;
+		return result.ptr;
+	#endif
+}
+
+/**
+	@brief Prints a value in scientific notation with the given number of decimal places, in the "C" locale
+
+	@return Pointer to the end of the printed text, or null if it didn't fit
+ */
+static char* PrintScientific(char* p, char* end, double value, int precision)
+{
+	#ifdef __APPLE__
+		int len = snprintf(p, end - p, "%.*e", precision, value);
+		if( (len < 0) || (len >= (end - p)) )
+			return nullptr;
+		return p + len;
+	#else
+		auto result = to_chars(p, end, value, chars_format::scientific, precision);
+		if(result.ec != errc())
+			return nullptr;
+		return result.ptr;
+	#endif
+}
+
+/**
+	@brief Appends a C string to a buffer
+
+	@return Pointer to the end of the text, or null if it didn't fit
+ */
+static char* PrintString(char* p, char* end, const char* str)
+{
+	size_t len = strlen(str);
+	if(static_cast<size_t>(end - p) < len)
+		return nullptr;
+	memcpy(p, str, len);
+	return p + len;
+}
+
+/**
+	@brief Formats a single value exactly as PrettyPrint() would, but without any heap allocation or locale changes
+
+	@param value				The value
+	@param sigfigs				Number of significant digits to display
+	@param useDisplayLocale		True to use the user's decimal separator
+	@param buf					Output buffer
+	@param buflen				Size of the output buffer
+
+	@return Length of the formatted text (not NUL terminated), or zero if this value needs to go through PrettyPrint()
+ */
+size_t Unit::FormatValue(double value, int sigfigs, bool useDisplayLocale, char* buf, size_t buflen) const
+{
+	char* end = buf + buflen;
+
+	// Special handling for overload value
+	if(value >= std::numeric_limits<double>::max())
+	{
+		char* p = PrintString(buf, end, UNIT_OVERLOAD_LABEL);
+		return p ? (p - buf) : 0;
+	}
+
+	//Figure out scaling, prefix, and suffix
+	double scaleFactor;
+	const char* prefix;
+	const char* numprefix;
+	const char* suffix;
+	GetSIScalingFactor(value, scaleFactor, prefix);
+	GetUnitSuffix(m_type, value, scaleFactor, prefix, numprefix, suffix);
+
+	double value_rescaled = value * scaleFactor;
+
+	char* p = PrintString(buf, end, numprefix);
+	if(!p)
+		return 0;
+	char* numstart = p;
+
+	switch(m_type)
+	{
+		case UNIT_LOG_BER:
+			p = PrintScientific(p, end, pow(10, value), 2);
+			break;
+
+		case UNIT_RATIO_SCI:
+			p = PrintScientific(p, end, value, 2);
+			break;
+
+		case UNIT_HEXNUM:
+			{
+				auto result = to_chars(p, end, static_cast<uint32_t>(value), 16);
+				p = (result.ec == errc()) ? result.ptr : nullptr;
+			}
+			break;
+
+		default:
+			{
+				int precision;
+				if(sigfigs > 0)
+				{
+					int leftdigits = 0;
+					if(fabs(value_rescaled) > 1000)
+						leftdigits = 4;
+					else if(fabs(value_rescaled) > 100)
+						leftdigits = 3;
+					else if(fabs(value_rescaled) > 10)
+						leftdigits = 2;
+					else if(fabs(value_rescaled) > 1)
+						leftdigits = 1;
+					precision = max(sigfigs - leftdigits, 0);
+				}
+
+				//If not a round number, add more digits (up to 5)
+				else
+				{
+					precision = 5;
+					double scale = 1;
+					for(int i=0; i<5; i++)
+					{
+						if(fabs(round(value_rescaled*scale) - value_rescaled*scale) < 0.001)
+						{
+							precision = i;
+							break;
+						}
+						scale *= 10;
+					}
+				}
+
+				p = PrintFixed(p, end, value_rescaled, precision);
+				if(!p)
+					return 0;
+
+				switch(m_type)
+				{
+					case Unit::UNIT_UI:
+					case Unit::UNIT_COUNTS:
+						break;
+
+					default:
+						p = PrintString(p, end, " ");
+						break;
+				}
+				if(p)
+					p = PrintString(p, end, prefix);
+				if(p)
+					p = PrintString(p, end, suffix);
+			}
+			break;
+	}
+
+	if(!p)
+		return 0;
+
+	//Use correct decimal separator for user's locale if needed
+	if(useDisplayLocale && (m_decimalSeparator != '.') )
+	{
+		for(char* q = numstart; q < p; q++)
+		{
+			if(*q == '.')
+			{
+				*q = m_decimalSeparator;
+				break;
+			}
+		}
+	}
+
+	return p - buf;
+}
+
+/**
+	@brief Common implementation of both PrettyPrintBulk() overloads
+ */
+template<class T>
+void Unit::DoPrettyPrintBulk(const T* values, size_t count, TextArena& out, int sigfigs, bool useDisplayLocale) const
+{
+	/*
+		Format one chunk of values into an arena.
+
+		Values FormatValue() can't handle have to go through PrettyPrint(), which may switch the process-wide locale
+		(on Windows) and so must never run on more than one thread at once. If allowFallback is false, stop at the
+		first such value and return its index so the rest of the chunk can be finished later on a single thread.
+	 */
+	auto formatChunk = [&](size_t start, size_t end, TextArena& arena, bool allowFallback)
+	{
+		char tmp[128];
+		for(size_t i=start; i<end; i++)
+		{
+			size_t len = FormatValue(values[i], sigfigs, useDisplayLocale, tmp, sizeof(tmp));
+			if(len)
+				arena.push_back(string_view(tmp, len));
+			else if(allowFallback)
+				arena.push_back(PrettyPrint(values[i], sigfigs, useDisplayLocale));
+			else
+				return i;
+		}
+		return end;
+	};
+
+	//Small batches: just format in place
+	size_t nchunks = (count + BULK_CHUNK_SIZE - 1) / BULK_CHUNK_SIZE;
+	if(nchunks <= 1)
+	{
+		formatChunk(0, count, out, true);
+		return;
+	}
+
+	//Format each chunk into its own arena in parallel, noting where each one had to stop (if anywhere)
+	vector<TextArena> chunks(nchunks);
+	vector<size_t> stops(nchunks);
+	#pragma omp parallel for
+	for(size_t i=0; i<nchunks; i++)
+		stops[i] = formatChunk(i*BULK_CHUNK_SIZE, min((i+1)*BULK_CHUNK_SIZE, count), chunks[i], false);
+
+	//Finish any chunks that needed PrettyPrint() serially
+	for(size_t i=0; i<nchunks; i++)
+	{
+		size_t end = min((i+1)*BULK_CHUNK_SIZE, count);
+		if(stops[i] < end)
+			formatChunk(stops[i], end, chunks[i], true);
+	}
+
+	//Then concatenate them
+	size_t textlen = out.m_text.size();
+	size_t nstrings = out.m_offsets.size();
+	for(auto& c : chunks)
+	{
+		textlen += c.m_text.size();
+		nstrings += c.m_offsets.size();
+	}
+	out.m_text.reserve(textlen);
+	out.m_offsets.reserve(nstrings);
+	for(auto& c : chunks)
+	{
+		size_t base = out.m_text.size();
+		out.m_text.insert(out.m_text.end(), c.m_text.begin(), c.m_text.end());
+		for(auto off : c.m_offsets)
+			out.m_offsets.push_back(base + off);
+	}
+}
+
+/**
+	@brief Prints many values with SI scaling factors
+
+	The output is identical to calling PrettyPrint() on each value, but avoids the per-value locale switching and
+	string allocation, and splits large batches across threads.
+
+	@param values				The values to print
+	@param count				Number of values
+	@param out					Arena to append the formatted strings to
+	@param sigfigs				Number of significant digits to display
+	@param useDisplayLocale		True if the string is formatted for display (user's locale)
+								False if the string is formatted for serialization ("C" locale regardless of user pref)
+ */
+void Unit::PrettyPrintBulk(const float* values, size_t count, TextArena& out, int sigfigs, bool useDisplayLocale) const
+{
+	DoPrettyPrintBulk(values, count, out, sigfigs, useDisplayLocale);
+}
+
+/**
+	@brief Prints many values with SI scaling factors
+
+	The output is identical to calling PrettyPrint() on each value, but avoids the per-value locale switching and
+	string allocation, and splits large batches across threads.
+
+	@param values				The values to print
+	@param count				Number of values
+	@param out					Arena to append the formatted strings to
+	@param sigfigs				Number of significant digits to display
+	@param useDisplayLocale		True if the string is formatted for display (user's locale)
+								False if the string is formatted for serialization ("C" locale regardless of user pref)
+ */
+void Unit::PrettyPrintBulk(const double* values, size_t count, TextArena& out, int sigfigs, bool useDisplayLocale) const
+{
+	DoPrettyPrintBulk(values, count, out, sigfigs, useDisplayLocale);
+}
+
+/**
+	@brief Parses a single value exactly as ParseString() would, but without any heap allocation or locale changes
+
+	@param str					The string to parse
+	@param useDisplayLocale		True if the string uses the user's decimal separator
+	@param value				Parsed value
+
+	@return True on success, false if this string needs to go through ParseString()
+ */
+bool Unit::ParseValue(string_view str, bool useDisplayLocale, double& value) const
+{
+	//Apple's libc++ has no floating point from_chars on older OS versions
+	#ifdef __APPLE__
+		return false;
+	#else
+
+	if(str == UNIT_OVERLOAD_LABEL)
+	{
+		value = std::numeric_limits<double>::max();
+		return true;
+	}
+
+	//Hex parsing has enough sscanf quirks that it's not worth duplicating
+	if(m_type == UNIT_HEXNUM)
+		return false;
+
+	//Find the first non-numeric character in the string
+	double scale = 1;
+	for(size_t i=0; i<str.size(); i++)
+	{
+		char c = str[i];
+		if(isspace(c) || isdigit(c) || (c == '.') || (c == ',') || (c == '-') )
+			continue;
+
+		if(c == 'T')
+		{
+			scale = 1e12;
+			if(m_type == UNIT_BYTES)
+				scale = 1024 * 1024 * 1024 * 1024LL;
+		}
+		else if(c == 'G')
+		{
+			scale = 1e9;
+			if(m_type == UNIT_BYTES)
+				scale = 1024 * 1024 * 1024;
+		}
+		else if(c == 'M')
+		{
+			scale = 1e6;
+			if(m_type == UNIT_BYTES)
+				scale = 1024 * 1024;
+		}
+		else if(c == 'K' || c == 'k')
+		{
+			scale = 1e3;
+			if(m_type == UNIT_BYTES)
+				scale = 1024;
+		}
+		else if(c == 'm')
+			scale = 1e-3;
+		else if( (c == 'u') || (str.substr(i, 2) == "μ") )
+			scale = 1e-6;
+		else if(c == 'n')
+			scale = 1e-9;
+		else if(c == 'p')
+			scale = 1e-12;
+		else if(c == 'f')
+			scale = 1e-15;
+
+		break;
+	}
+
+	//Skip leading whitespace, then take at most 20 characters (same as "%20lf")
+	size_t start = 0;
+	while( (start < str.size()) && isspace(str[start]) )
+		start ++;
+	char tmp[21];
+	size_t len = min(str.size() - start, sizeof(tmp) - 1);
+	memcpy(tmp, str.data() + start, len);
+
+	//Convert to "C" locale format. Anything from_chars and strtod might disagree on goes the slow way
+	char sep = (useDisplayLocale ? m_decimalSeparator : '.');
+	for(size_t i=0; i<len; i++)
+	{
+		char c = tmp[i];
+		if( (c == '+') || (c == 'x') || (c == 'X') )
+			return false;
+		if( (sep != '.') && (c == '.') )
+			return false;
+		if(c == sep)
+			tmp[i] = '.';
+	}
+
+	double ret;
+	auto result = from_chars(tmp, tmp + len, ret);
+	if(result.ec != errc())
+		return false;
+
+	//Apply a unit-specific scaling factor
+	switch(m_type)
+	{
+		case Unit::UNIT_FS:
+			ret *= 1e15;
+			break;
+
+		case Unit::UNIT_MICROVOLTS:
+		case Unit::UNIT_MICROHZ:
+			ret *= 1e6;
+			break;
+
+		case Unit::UNIT_PM:
+			ret *= 1e12;
+			break;
+
+		case Unit::UNIT_PERCENT:
+			ret *= 0.01;
+			break;
+
+		default:
+			break;
+	}
+
+	value = ret * scale;
+	return true;
+
+	#endif
+}
+
+/**
+	@brief Common implementation of both ParseStringBulk() overloads
+ */
+template<class S>
+void Unit::DoParseStringBulk(const S& strings, size_t count, double* values, bool useDisplayLocale)
+{
+	//Parse each chunk in parallel, noting any strings ParseValue() can't handle
+	size_t nchunks = (count + BULK_CHUNK_SIZE - 1) / BULK_CHUNK_SIZE;
+	vector< vector<size_t> > fallbacks(nchunks);
+	#pragma omp parallel for if(nchunks > 1)
+	for(size_t i=0; i<nchunks; i++)
+	{
+		size_t end = min((i+1)*BULK_CHUNK_SIZE, count);
+		for(size_t j=i*BULK_CHUNK_SIZE; j<end; j++)
+		{
+			if(!ParseValue(strings[j], useDisplayLocale, values[j]))
+				fallbacks[i].push_back(j);
+		}
+	}
+
+	//ParseString() may switch the process-wide locale (on Windows), so the leftovers are parsed on one thread
+	for(auto& f : fallbacks)
+	{
+		for(auto j : f)
+			values[j] = ParseString(string(string_view(strings[j])), useDisplayLocale);
+	}
+}
+
+/**
+	@brief Parses many strings based on the supplied unit
+
+	The result is identical to calling ParseString() on each string, but avoids the per-value locale switching
+	and string allocation, and splits large batches across threads.
+
+	@param strings				The strings to parse
+	@param values				Output array, must have room for one value per string
+	@param useDisplayLocale		True if the strings are formatted for display (user's locale)
+								False if the strings are formatted for serialization ("C" locale regardless of user pref)
+ */
+void Unit::ParseStringBulk(const TextArena& strings, double* values, bool useDisplayLocale)
+{
+	DoParseStringBulk(strings, strings.size(), values, useDisplayLocale);
+}
+
+/**
+	@brief Parses many strings based on the supplied unit
+
+	The result is identical to calling ParseString() on each string, but avoids the per-value locale switching
+	and string allocation, and splits large batches across threads.
+
+	@param strings				The strings to parse
+	@param count				Number of strings
+	@param values				Output array, must have room for one value per string
+	@param useDisplayLocale		True if the strings are formatted for display (user's locale)
+								False if the strings are formatted for serialization ("C" locale regardless of user pref)
+ */
+void Unit::ParseStringBulk(const string* strings, size_t count, double* values, bool useDisplayLocale)
+{
+	DoParseStringBulk(strings, count, values, useDisplayLocale);
+}
+
 /**
 	@brief Multiplies two units and calculates the resulting unit
  */
@@ -46,6 +46,10 @@
 
 #endif
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 #define UNIT_OVERLOAD_LABEL "Overload"
 
 /**
@@ -125,6 +129,74 @@ public:
 	double ParseString(const std::string& str, bool useDisplayLocale = true);
 	int64_t ParseStringInt64(const std::string& str, bool useDisplayLocale = true);
 
+	/**
+		@brief Packed storage for many short strings, used by the bulk formatting and parsing APIs
+
+		Strings are stored back to back in a single buffer, each followed by a NUL, so once the arena has grown to
+		its working size, filling it again costs no heap allocation at all. Reuse one arena across calls.
+	 */
+	class TextArena
+	{
+	public:
+		void clear()
+		{
+			m_text.clear();
+			m_offsets.clear();
+		}
+
+		///@brief Returns the number of strings in the arena
+		size_t size() const
+		{ return m_offsets.size(); }
+
+		bool empty() const
+		{ return m_offsets.empty(); }
+
+		///@brief Returns string i, not including the trailing NUL
+		std::string_view operator[](size_t i) const
+		{ return std::string_view(&m_text[m_offsets[i]], length(i)); }
+
+		///@brief Returns string i as a NUL terminated C string
+		const char* c_str(size_t i) const
+		{ return &m_text[m_offsets[i]]; }
+
+		///@brief Returns the length of string i, not including the trailing NUL
+		size_t length(size_t i) const
+		{
+			size_t end = (i+1 < m_offsets.size()) ? m_offsets[i+1] : m_text.size();
+			return end - m_offsets[i] - 1;
+		}
+
+		///@brief Appends a string to the arena
+		void push_back(std::string_view str)
+		{
+			m_offsets.push_back(m_text.size());
+			m_text.insert(m_text.end(), str.begin(), str.end());
+			m_text.push_back('\0');
+		}
+
+		///@brief Character data for all strings
+		std::vector<char> m_text;
+
+		///@brief Offset of the start of each string within m_text
+		std::vector<size_t> m_offsets;
+	};
+
+	void PrettyPrintBulk(
+		const float* values,
+		size_t count,
+		TextArena& out,
+		int sigfigs = -1,
+		bool useDisplayLocale = true) const;
+	void PrettyPrintBulk(
+		const double* values,
+		size_t count,
+		TextArena& out,
+		int sigfigs = -1,
+		bool useDisplayLocale = true) const;
+
+	void ParseStringBulk(const TextArena& strings, double* values, bool useDisplayLocale = true);
+	void ParseStringBulk(const std::string* strings, size_t count, double* values, bool useDisplayLocale = true);
+
 	UnitType GetType()
 	{ return m_type; }
 
@@ -147,8 +219,22 @@ public:
 protected:
 	UnitType m_type;
 
-	void GetSIScalingFactor(double num, double& scaleFactor, std::string& prefix) const;
-	void GetUnitSuffix(UnitType type, double num, double& scaleFactor, std::string& prefix, std::string& numprefix, std::string& suffix) const;
+	template<class T>
+	void DoPrettyPrintBulk(const T* values, size_t count, TextArena& out, int sigfigs, bool useDisplayLocale) const;
+	size_t FormatValue(double value, int sigfigs, bool useDisplayLocale, char* buf, size_t buflen) const;
+
+	template<class S>
+	void DoParseStringBulk(const S& strings, size_t count, double* values, bool useDisplayLocale);
+	bool ParseValue(std::string_view str, bool useDisplayLocale, double& value) const;
+
+	void GetSIScalingFactor(double num, double& scaleFactor, const char*& prefix) const;
+	void GetUnitSuffix(
+		UnitType type,
+		double num,
+		double& scaleFactor,
+		const char*& prefix,
+		const char*& numprefix,
+		const char*& suffix) const;
 
 #ifdef _WIN32
 	/**
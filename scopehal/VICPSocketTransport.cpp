@@ -50,6 +50,8 @@ VICPSocketTransport::VICPSocketTransport(const string& args)
 	: m_nextSequence(1)
 	, m_lastSequence(1)
 	, m_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)
+	, m_rxFrameBytesLeft(0)
+	, m_rxFrameEOI(false)
 {
 	char hostname[128];
 	unsigned int port = 0;
@@ -284,9 +286,106 @@ size_t VICPSocketTransport::ReadRawData(size_t len, unsigned char* buf, function
 
 void VICPSocketTransport::FlushRXBuffer(void)
 {
+	m_rxFrameBytesLeft = 0;
+	m_rxFrameEOI = false;
 	m_socket.FlushRxBuffer();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Binary block API
+
+/**
+	@brief Reads the header of the next VICP frame and updates the binary block framing state
+
+	@return True on success, false on a socket or protocol error
+ */
+bool VICPSocketTransport::ReadFrameHeader()
+{
+	unsigned char header[8];
+	if(8 != ReadRawData(8, header))
+		return false;
+
+	if( (header[1] != 1) || (header[3] != 0) )
+	{
+		LogError("Bad VICP frame header\n");
+		return false;
+	}
+
+	m_rxFrameBytesLeft = (header[4] << 24) | (header[5] << 16) | (header[6] << 8) | header[7];
+	m_rxFrameEOI = (header[0] & OP_EOI) != 0;
+	return true;
+}
+
+int64_t VICPSocketTransport::ReadBinaryBlockHeader()
+{
+	//Always start a new message at a frame boundary
+	m_rxFrameBytesLeft = 0;
+	m_rxFrameEOI = false;
+
+	return SCPITransport::ReadBinaryBlockHeader();
+}
+
+/**
+	@brief Reads binary block payload data, transparently stripping VICP frame headers
+
+	The block may be split across any number of frames, and frames may split the block at any point.
+ */
+size_t VICPSocketTransport::ReadBinaryBlockData(size_t len, unsigned char* buf, function<void(float)> progress)
+{
+	size_t pos = 0;
+	while(pos < len)
+	{
+		//Start of a new frame? Read its header
+		if(m_rxFrameBytesLeft == 0)
+		{
+			//If the previous frame was the end of the message, there's nothing more to read
+			if(m_rxFrameEOI)
+				break;
+			if(!ReadFrameHeader())
+				break;
+			continue;
+		}
+
+		size_t n = min(len - pos, m_rxFrameBytesLeft);
+		if(n != ReadRawData(n, buf + pos))
+			break;
+		m_rxFrameBytesLeft -= n;
+		pos += n;
+
+		if(progress)
+			progress((float)pos / (float)len);
+	}
+
+	return pos;
+}
+
+/**
+	@brief Discards everything up to and including the end of the VICP message (the frame with EOI set)
+ */
+void VICPSocketTransport::ReadBinaryBlockTrailer()
+{
+	unsigned char tmp[256];
+	while(true)
+	{
+		while(m_rxFrameBytesLeft > 0)
+		{
+			size_t n = min(sizeof(tmp), m_rxFrameBytesLeft);
+			if(n != ReadRawData(n, tmp))
+			{
+				m_rxFrameBytesLeft = 0;
+				m_rxFrameEOI = false;
+				return;
+			}
+			m_rxFrameBytesLeft -= n;
+		}
+
+		if(m_rxFrameEOI || !ReadFrameHeader())
+			break;
+	}
+
+	m_rxFrameEOI = false;
+}
+
 bool VICPSocketTransport::IsCommandBatchingSupported()
 {
 	return true;
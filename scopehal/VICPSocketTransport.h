@@ -71,6 +71,10 @@ public:
 
 	virtual void FlushRXBuffer() override;
 
+	virtual int64_t ReadBinaryBlockHeader() override;
+	virtual size_t ReadBinaryBlockData(size_t len, unsigned char* buf, std::function<void(float)> progress = nullptr) override;
+	virtual void ReadBinaryBlockTrailer() override;
+
 	///@brief VICP header opcode values
 	enum HEADER_OPS
 	{
@@ -100,6 +104,7 @@ public:
 
 protected:
 	uint8_t GetNextSequenceNumber();
+	bool ReadFrameHeader();
 
 	///@brief Next sequence number
 	uint8_t m_nextSequence;
@@ -115,6 +120,12 @@ protected:
 
 	///@brief Port our socket is connected to
 	unsigned short m_port;
+
+	///@brief Number of payload bytes left in the VICP frame currently being read by the binary block API
+	size_t m_rxFrameBytesLeft;
+
+	///@brief True if the VICP frame currently being read by the binary block API has the EOI flag set
+	bool m_rxFrameEOI;
 };
 
 #endif
@@ -57,7 +57,7 @@ VulkanFFTPlan::VulkanFFTPlan(
 	VulkanFFTPlanDirection dir,
 	size_t numBatches,
 	VulkanFFTDataType timeDomainType)
-	: m_size(npoints)
+	: FFTPlan(npoints, nouts, dir, numBatches, timeDomainType)
 	, m_fence(*g_vkComputeDevice, vk::FenceCreateInfo())
 {
 	memset(&m_app, 0, sizeof(m_app));
@@ -49,6 +49,7 @@
 
 #include "AcceleratorBuffer.h"
 #include "PipelineCacheManager.h"
+#include "FFTPlan.h"
 
 /**
 	@brief Arguments to a window function for FFT processing
@@ -98,29 +99,15 @@ struct DeEmbedNormalizationArgs
 	@brief RAII wrapper around a VkFFTApplication and VkFFTConfiguration
 	@ingroup core
  */
-class VulkanFFTPlan
+class VulkanFFTPlan : public FFTPlan
 {
 public:
 
-	///@brief Direction of a FFT
-	enum VulkanFFTPlanDirection
-	{
-		///@brief Normal FFT
-		DIRECTION_FORWARD,
+	///@brief Direction of a FFT (kept for compatibility with code predating FFTPlan)
+	typedef FFTPlanDirection VulkanFFTPlanDirection;
 
-		///@brief Inverse FFT
-		DIRECTION_REVERSE
-	};
-
-	///@brief Data type of a FFT input or output
-	enum VulkanFFTDataType
-	{
-		///@brief Real float32 values
-		TYPE_REAL,
-
-		///@brief Complex float32 values
-		TYPE_COMPLEX
-	};
+	///@brief Data type of a FFT input or output (kept for compatibility with code predating FFTPlan)
+	typedef FFTDataType VulkanFFTDataType;
 
 	VulkanFFTPlan(
 		size_t npoints,
@@ -128,21 +115,20 @@ public:
 		VulkanFFTPlanDirection dir,
 		size_t numBatches = 1,
 		VulkanFFTDataType timeDomainType = VulkanFFTPlan::TYPE_REAL);
-	~VulkanFFTPlan();
+	virtual ~VulkanFFTPlan();
 
-	void AppendForward(
+	virtual void AppendForward(
 		AcceleratorBuffer<float>& dataIn,
 		AcceleratorBuffer<float>& dataOut,
-		vk::raii::CommandBuffer& cmdBuf);
+		vk::raii::CommandBuffer& cmdBuf) override;
 
-	void AppendReverse(
+	virtual void AppendReverse(
 		AcceleratorBuffer<float>& dataIn,
 		AcceleratorBuffer<float>& dataOut,
-		vk::raii::CommandBuffer& cmdBuf);
+		vk::raii::CommandBuffer& cmdBuf) override;
 
-	///@brief Return the number of points in the FFT
-	size_t size() const
-	{ return m_size; }
+	virtual bool IsGpuPlan() const override
+	{ return true; }
 
 protected:
 
@@ -152,9 +138,6 @@ protected:
 	///@brief VkFFT configuration state
 	VkFFTConfiguration m_config;
 
-	///@brief Number of points in the FFT
-	size_t m_size;
-
 	//this is ugly but apparently we can't take a pointer to the underlying vk:: c++ wrapper objects?
 	///@brief Physical device the FFT is runnning on
 	VkPhysicalDevice m_physicalDevice;
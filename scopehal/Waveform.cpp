@@ -40,6 +40,8 @@
 
 using namespace std;
 
+std::atomic<uint64_t> WaveformBase::m_nextInitialRevision(0);
+
 template<class T>
 size_t BinarySearchForGequal(T* buf, size_t len, T value)
 {
@@ -39,10 +39,12 @@
 
 #include <vector>
 #include <optional>
+#include <atomic>
 #include <AlignedAllocator.h>
 
 #include "StandardColors.h"
 #include "AcceleratorBuffer.h"
+#include "DigitalBusSample.h"
 
 /**
 	@brief Base class for all Waveform specializations
@@ -68,7 +70,7 @@ public:
 		, m_startFemtoseconds(0)
 		, m_triggerPhase(0)
 		, m_flags(0)
-		, m_revision(0)
+		, m_revision(NewRevisionRange())
 		, m_cachedColorRevision(0)
 	{
 	}
@@ -82,7 +84,8 @@ public:
 		, m_startFemtoseconds(rhs.m_startFemtoseconds)
 		, m_triggerPhase(rhs.m_triggerPhase)
 		, m_flags(rhs.m_flags)
-		, m_revision(rhs.m_revision)
+		, m_revision(NewRevisionRange())
+		, m_cachedColorRevision(0)
 	{}
 
 	//empty virtual destructor in case any derived classes need one
@@ -138,6 +141,23 @@ public:
 	 */
 	uint64_t m_revision;
 
+	/**
+		@brief Index of the revision range for the next newly created waveform
+
+		Each waveform gets its own range of 2^32 revision numbers, starting at this index times 2^32, and bumps its
+		revision within that range. A new waveform allocated at the same address as a recently deleted one therefore
+		can never have a revision the old one had, so (pointer, revision) pairs are never reused.
+	 */
+	static std::atomic<uint64_t> m_nextInitialRevision;
+
+protected:
+
+	///@brief Allocates a fresh revision range for a newly created waveform and returns its first revision
+	static uint64_t NewRevisionRange()
+	{ return (++m_nextInitialRevision) << 32; }
+
+public:
+
 	///@brief Flags which may apply to m_flags
 	enum WaveformFlags_t
 	{
@@ -166,6 +186,14 @@ public:
 	///@brief Returns the number of samples in this waveform
 	virtual size_t size() const  =0;
 
+	/**
+		@brief Returns the number of samples this waveform can hold without reallocating its buffers
+
+		Derived classes with more than one sample buffer report the smallest of them.
+	 */
+	virtual size_t capacity() const
+	{ return size(); }
+
 	///@brief Returns true if this waveform contains no samples, false otherwise
 	virtual bool empty()
 	{ return size() == 0; }
@@ -431,6 +459,15 @@ public:
 	virtual ~UniformWaveform()
 	{}
 
+	/**
+		@brief Helper function to indicate this waveform will only be used on the CPU
+	 */
+	void SetCpuOnlyHint()
+	{
+		m_samples.SetCpuAccessHint(AcceleratorBuffer<S>::HINT_LIKELY);
+		m_samples.SetGpuAccessHint(AcceleratorBuffer<S>::HINT_NEVER);
+	}
+
 	///@brief Sample data
 	AcceleratorBuffer<S> m_samples;
 
@@ -449,6 +486,9 @@ public:
 	virtual size_t size() const override
 	{ return m_samples.size(); }
 
+	virtual size_t capacity() const override
+	{ return m_samples.capacity(); }
+
 	virtual void clear() override
 	{ m_samples.clear(); }
 
@@ -592,6 +632,9 @@ public:
 	virtual size_t size() const override
 	{ return m_samples.size(); }
 
+	virtual size_t capacity() const override
+	{ return std::min(m_samples.capacity(), std::min(m_offsets.capacity(), m_durations.capacity())); }
+
 	virtual void clear() override
 	{
 		m_offsets.clear();
@@ -643,7 +686,10 @@ typedef SparseWaveform<bool> 					SparseDigitalWaveform;
 typedef UniformWaveform<bool>					UniformDigitalWaveform;
 typedef SparseWaveform<float>					SparseAnalogWaveform;
 typedef UniformWaveform<float>					UniformAnalogWaveform;
-typedef SparseWaveform< std::vector<bool> > 	SparseDigitalBusWaveform;
+typedef SparseWaveform<DigitalBusSample>		SparseDigitalBusWaveform;
+
+///@brief Digital bus waveform for buses too wide to fit in a DigitalBusSample (one heap block per sample)
+typedef SparseWaveform< std::vector<bool> >	SparseWideDigitalBusWaveform;
 
 //Make sure inline helpers aren't warned about if unused
 #pragma GCC diagnostic push
@@ -0,0 +1,1025 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of WaveformFileWriter and WaveformFileReader
+	@ingroup core
+ */
+
+#include "scopehal.h"
+#include "WaveformFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAS_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef HAS_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// WaveformFile
+
+/**
+	@brief Checks if this build of the library can read and write chunks using a given compression algorithm
+ */
+bool WaveformFile::IsCompressionSupported(Compression c)
+{
+	switch(c)
+	{
+		case COMPRESSION_NONE:
+			return true;
+
+		#ifdef HAS_LZ4
+		case COMPRESSION_LZ4:
+			return true;
+		#endif
+
+		#ifdef HAS_ZSTD
+		case COMPRESSION_ZSTD:
+			return true;
+		#endif
+
+		default:
+			return false;
+	}
+}
+
+/**
+	@brief Compresses a single block of data
+
+	@param compression	Compression algorithm
+	@param level		Compression level (zstd only)
+	@param in			Input data
+	@param len			Length of the input data
+	@param out			Compressed data (empty on failure)
+ */
+static void CompressBlock(
+	WaveformFile::Compression compression,
+	int level,
+	const uint8_t* in,
+	size_t len,
+	vector<uint8_t>& out)
+{
+	out.clear();
+	switch(compression)
+	{
+		#ifdef HAS_LZ4
+		case WaveformFile::COMPRESSION_LZ4:
+			{
+				out.resize(LZ4_compressBound(len));
+				int n = LZ4_compress_default(
+					reinterpret_cast<const char*>(in),
+					reinterpret_cast<char*>(out.data()),
+					len,
+					out.size());
+				out.resize(max(n, 0));
+			}
+			break;
+		#endif
+
+		#ifdef HAS_ZSTD
+		case WaveformFile::COMPRESSION_ZSTD:
+			{
+				out.resize(ZSTD_compressBound(len));
+				size_t n = ZSTD_compress(out.data(), out.size(), in, len, level);
+				out.resize(ZSTD_isError(n) ? 0 : n);
+			}
+			break;
+		#endif
+
+		default:
+			break;
+	}
+}
+
+/**
+	@brief Decompresses a single block of data
+
+	@param compression	Compression algorithm
+	@param in			Compressed data
+	@param len			Length of the compressed data
+	@param out			Output buffer
+	@param rawlen		Expected length of the decompressed data
+
+	@return True if the block decompressed to exactly rawlen bytes
+ */
+static bool DecompressBlock(
+	WaveformFile::Compression compression,
+	const uint8_t* in,
+	size_t len,
+	uint8_t* out,
+	size_t rawlen)
+{
+	switch(compression)
+	{
+		#ifdef HAS_LZ4
+		case WaveformFile::COMPRESSION_LZ4:
+			{
+				int n = LZ4_decompress_safe(
+					reinterpret_cast<const char*>(in),
+					reinterpret_cast<char*>(out),
+					len,
+					rawlen);
+				return (n >= 0) && (static_cast<size_t>(n) == rawlen);
+			}
+		#endif
+
+		#ifdef HAS_ZSTD
+		case WaveformFile::COMPRESSION_ZSTD:
+			{
+				size_t n = ZSTD_decompress(out, rawlen, in, len);
+				return !ZSTD_isError(n) && (n == rawlen);
+			}
+		#endif
+
+		default:
+			return false;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// WaveformFileWriter
+
+WaveformFileWriter::WaveformFileWriter()
+	: m_compression(WaveformFile::COMPRESSION_NONE)
+	, m_compressionLevel(0)
+	, m_fp(nullptr)
+	, m_pos(0)
+	, m_channelCount(0)
+{
+}
+
+WaveformFileWriter::~WaveformFileWriter()
+{
+	if(m_fp)
+		Close();
+}
+
+/**
+	@brief Creates a new waveform file, overwriting any existing file at the same path
+
+	Data is written to a temporary file in the same directory, which Close() renames over the destination. An
+	existing file at that path is never truncated, since WaveformFileReader may have it memory mapped into live
+	waveforms (which may be the very waveforms being written out).
+
+	@param path	Path to the file
+
+	@return True on success
+ */
+bool WaveformFileWriter::Open(const string& path)
+{
+	if(m_fp)
+		Close();
+
+	m_path = path;
+	m_tempPath = path + ".tmp";
+	m_fp = fopen(m_tempPath.c_str(), "wb");
+	if(!m_fp)
+	{
+		LogError("Couldn't create waveform file \"%s\"\n", m_tempPath.c_str());
+		return false;
+	}
+	m_pos = 0;
+	m_directory.clear();
+	m_channelCount = 0;
+
+	WaveformFileHeader header;
+	memcpy(header.magic, WAVEFORM_FILE_MAGIC, sizeof(header.magic));
+	header.version = WAVEFORM_FILE_VERSION;
+	header.reserved = 0;
+	return Write(&header, sizeof(header));
+}
+
+/**
+	@brief Selects the compression algorithm for chunks written from now on
+
+	Chunks that don't get any smaller when compressed are stored uncompressed regardless of this setting.
+
+	@param compression	Compression algorithm
+	@param level		Compression level for zstd (0 for the library default). Ignored for LZ4.
+
+	@return False if this build doesn't support the requested algorithm
+ */
+bool WaveformFileWriter::SetCompression(WaveformFile::Compression compression, int level)
+{
+	if(!WaveformFile::IsCompressionSupported(compression))
+	{
+		LogError("Waveform file compression type %d is not supported by this build\n", compression);
+		return false;
+	}
+
+	m_compression = compression;
+	m_compressionLevel = level;
+	return true;
+}
+
+/**
+	@brief Writes a waveform to the file
+
+	Analog waveforms captured from an ADC can be stored as the original ADC codes rather than expanded floats, which
+	halves or quarters their size and makes them far more compressible. The stored codes are
+	round((value + adcOffset) / gain), i.e. the inverse of Oscilloscope::Convert8BitSamples() and friends, so passing
+	the same gain and offset the driver used for the conversion is lossless.
+
+	@param name			Display name of the channel
+	@param wfm			The waveform to write
+	@param xunit		X axis unit of the waveform
+	@param yunit		Y axis unit of the waveform
+	@param adcBits		8 or 16 to store analog samples as ADC codes, 0 to store floats
+	@param gain			Volts per ADC code (ignored if adcBits is 0)
+	@param adcOffset	Offset subtracted from scaled ADC codes (ignored if adcBits is 0)
+
+	@return True on success, false on a write error or unsupported waveform type
+ */
+bool WaveformFileWriter::AddChannel(
+	const string& name,
+	WaveformBase* wfm,
+	Unit xunit,
+	Unit yunit,
+	int adcBits,
+	float gain,
+	float adcOffset)
+{
+	if(!m_fp || !wfm)
+		return false;
+
+	auto ua = dynamic_cast<UniformAnalogWaveform*>(wfm);
+	auto sa = dynamic_cast<SparseAnalogWaveform*>(wfm);
+	auto ud = dynamic_cast<UniformDigitalWaveform*>(wfm);
+	auto sd = dynamic_cast<SparseDigitalWaveform*>(wfm);
+
+	WaveformFileChannel chan;
+	memset(&chan, 0, sizeof(chan));
+	if(ua)
+		chan.type = WaveformFile::CHANNEL_UNIFORM_ANALOG;
+	else if(sa)
+		chan.type = WaveformFile::CHANNEL_SPARSE_ANALOG;
+	else if(ud)
+		chan.type = WaveformFile::CHANNEL_UNIFORM_DIGITAL;
+	else if(sd)
+		chan.type = WaveformFile::CHANNEL_SPARSE_DIGITAL;
+	else
+	{
+		LogError("Waveform for channel %s is of a type that can't be saved to a waveform file\n", name.c_str());
+		return false;
+	}
+
+	wfm->PrepareForCpuAccess();
+	size_t len = wfm->size();
+
+	chan.flags = wfm->m_flags;
+	chan.nameLength = min(name.length(), static_cast<size_t>(UINT16_MAX));
+	chan.xunit = xunit.GetType();
+	chan.yunit = yunit.GetType();
+	chan.timescale = wfm->m_timescale;
+	chan.triggerPhase = wfm->m_triggerPhase;
+	chan.startTimestamp = wfm->m_startTimestamp;
+	chan.startFemtoseconds = wfm->m_startFemtoseconds;
+	chan.sampleCount = len;
+
+	vector<WaveformFileChunk> chunks;
+
+	//Timestamps for sparse waveforms
+	auto swfm = dynamic_cast<SparseWaveformBase*>(wfm);
+	if(swfm)
+	{
+		if(!WriteChunk(WaveformFile::CHUNK_OFFSETS, WaveformFile::ENCODING_INT64,
+			swfm->m_offsets.GetCpuPointer(), len * sizeof(int64_t), chunks))
+		{
+			return false;
+		}
+		if(!WriteChunk(WaveformFile::CHUNK_DURATIONS, WaveformFile::ENCODING_INT64,
+			swfm->m_durations.GetCpuPointer(), len * sizeof(int64_t), chunks))
+		{
+			return false;
+		}
+	}
+
+	//Analog samples are written as-is, or converted back to ADC codes
+	if(ua || sa)
+	{
+		const float* samples = ua ? ua->m_samples.GetCpuPointer() : sa->m_samples.GetCpuPointer();
+		if(adcBits == 0)
+		{
+			if(!WriteChunk(WaveformFile::CHUNK_SAMPLES, WaveformFile::ENCODING_FLOAT32,
+				samples, len * sizeof(float), chunks))
+			{
+				return false;
+			}
+		}
+		else if( (adcBits == 8) || (adcBits == 16) )
+		{
+			if(gain == 0)
+			{
+				LogError("Can't store channel %s as ADC codes with zero gain\n", name.c_str());
+				return false;
+			}
+
+			float scale = 1.0f / gain;
+			float codemin = (adcBits == 8) ? INT8_MIN : INT16_MIN;
+			float codemax = (adcBits == 8) ? INT8_MAX : INT16_MAX;
+			size_t nbytes = len * (adcBits / 8);
+			vector<uint8_t> codes(nbytes);
+			auto codes8 = reinterpret_cast<int8_t*>(codes.data());
+			auto codes16 = reinterpret_cast<int16_t*>(codes.data());
+
+			#pragma omp parallel for if(len > 100000)
+			for(size_t i=0; i<len; i++)
+			{
+				float code = min(codemax, max(codemin, roundf((samples[i] + adcOffset) * scale)));
+				if(adcBits == 8)
+					codes8[i] = code;
+				else
+					codes16[i] = code;
+			}
+
+			auto encoding = (adcBits == 8) ? WaveformFile::ENCODING_ADC_INT8 : WaveformFile::ENCODING_ADC_INT16;
+			if(!WriteChunk(WaveformFile::CHUNK_SAMPLES, encoding, codes.data(), nbytes, chunks, gain, adcOffset))
+				return false;
+		}
+		else
+		{
+			LogError("Can't store channel %s as %d-bit ADC codes (only 8 and 16 bit are supported)\n",
+				name.c_str(), adcBits);
+			return false;
+		}
+	}
+
+	//Digital samples are packed eight to a byte, LSB first
+	else
+	{
+		const bool* samples = ud ? ud->m_samples.GetCpuPointer() : sd->m_samples.GetCpuPointer();
+		size_t nbytes = (len + 7) / 8;
+		vector<uint8_t> packed(nbytes);
+		#pragma omp parallel for if(nbytes > 100000)
+		for(size_t i=0; i<nbytes; i++)
+		{
+			uint8_t b = 0;
+			size_t base = i*8;
+			size_t n = min(static_cast<size_t>(8), len - base);
+			for(size_t j=0; j<n; j++)
+				b |= (samples[base + j] ? 1 : 0) << j;
+			packed[i] = b;
+		}
+
+		if(!WriteChunk(WaveformFile::CHUNK_SAMPLES, WaveformFile::ENCODING_BITPACKED, packed.data(), nbytes, chunks))
+			return false;
+	}
+
+	//Add to the directory
+	chan.chunkCount = chunks.size();
+	auto pchan = reinterpret_cast<const uint8_t*>(&chan);
+	m_directory.insert(m_directory.end(), pchan, pchan + sizeof(chan));
+	m_directory.insert(m_directory.end(), name.begin(), name.begin() + chan.nameLength);
+	auto pchunks = reinterpret_cast<const uint8_t*>(chunks.data());
+	m_directory.insert(m_directory.end(), pchunks, pchunks + chunks.size()*sizeof(WaveformFileChunk));
+	m_channelCount ++;
+
+	return true;
+}
+
+/**
+	@brief Writes the channel directory, closes the file, and moves it into place
+
+	If anything failed to write, the temporary file is deleted and any existing file at the destination is left
+	untouched.
+
+	@return True if everything was written successfully
+ */
+bool WaveformFileWriter::Close()
+{
+	if(!m_fp)
+		return false;
+
+	WaveformFileTrailer trailer;
+	trailer.directoryOffset = m_pos;
+	trailer.channelCount = m_channelCount;
+	trailer.reserved = 0;
+	memcpy(trailer.magic, WAVEFORM_FILE_MAGIC, sizeof(trailer.magic));
+
+	bool ok = Write(m_directory.data(), m_directory.size());
+	ok &= Write(&trailer, sizeof(trailer));
+	ok &= (0 == fclose(m_fp));
+	m_fp = nullptr;
+	m_directory.clear();
+
+	if(!ok)
+	{
+		LogError("Couldn't write waveform file \"%s\"\n", m_path.c_str());
+		remove(m_tempPath.c_str());
+		return false;
+	}
+
+	//Replace the destination atomically. Waveforms mapped from the old file keep its data alive.
+	#ifdef _WIN32
+		ok = MoveFileExA(m_tempPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING);
+	#else
+		ok = (0 == rename(m_tempPath.c_str(), m_path.c_str()));
+	#endif
+	if(!ok)
+	{
+		LogError("Couldn't replace waveform file \"%s\"\n", m_path.c_str());
+		remove(m_tempPath.c_str());
+	}
+	return ok;
+}
+
+/**
+	@brief Writes raw data to the file and keeps track of the position
+ */
+bool WaveformFileWriter::Write(const void* data, size_t len)
+{
+	if(len == 0)
+		return true;
+	if(len != fwrite(data, 1, len, m_fp))
+	{
+		LogError("Write to waveform file failed\n");
+		return false;
+	}
+	m_pos += len;
+	return true;
+}
+
+/**
+	@brief Pads the file with zeroes to the next chunk boundary
+ */
+bool WaveformFileWriter::Align()
+{
+	static const uint8_t zeroes[4096] = {0};
+
+	size_t pad = (WAVEFORM_FILE_ALIGN - (m_pos % WAVEFORM_FILE_ALIGN)) % WAVEFORM_FILE_ALIGN;
+	while(pad > 0)
+	{
+		size_t n = min(pad, sizeof(zeroes));
+		if(!Write(zeroes, n))
+			return false;
+		pad -= n;
+	}
+	return true;
+}
+
+/**
+	@brief Writes a block of sample data as a new chunk
+
+	@param type		What the data represents
+	@param encoding	How the data is stored
+	@param data			The data to write
+	@param len			Length of the data, in bytes
+	@param chunks		Chunk table to append the new chunk's descriptor to
+	@param gain			Scale factor for ADC code encodings
+	@param adcOffset	Offset for ADC code encodings
+ */
+bool WaveformFileWriter::WriteChunk(
+	WaveformFile::ChunkType type,
+	WaveformFile::Encoding encoding,
+	const void* data,
+	size_t len,
+	vector<WaveformFileChunk>& chunks,
+	float gain,
+	float adcOffset)
+{
+	if(!Align())
+		return false;
+
+	WaveformFileChunk chunk;
+	chunk.type = type;
+	chunk.encoding = encoding;
+	chunk.compression = WaveformFile::COMPRESSION_NONE;
+	chunk.reserved = 0;
+	chunk.blockSize = 0;
+	chunk.offset = m_pos;
+	chunk.length = len;
+	chunk.rawLength = len;
+	chunk.gain = gain;
+	chunk.adcOffset = adcOffset;
+
+	//Try compressing it first
+	vector<vector<uint8_t>> blocks;
+	if( (m_compression != WaveformFile::COMPRESSION_NONE) && (len > 0) && CompressBlocks(data, len, blocks) )
+	{
+		chunk.compression = m_compression;
+		chunk.blockSize = WAVEFORM_FILE_BLOCK_SIZE;
+
+		vector<uint64_t> sizes;
+		for(auto& b : blocks)
+			sizes.push_back(b.size());
+		if(!Write(sizes.data(), sizes.size() * sizeof(uint64_t)))
+			return false;
+		for(auto& b : blocks)
+		{
+			if(!Write(b.data(), b.size()))
+				return false;
+		}
+		chunk.length = m_pos - chunk.offset;
+	}
+
+	//Store it uncompressed
+	else if(!Write(data, len))
+		return false;
+
+	chunks.push_back(chunk);
+	return true;
+}
+
+/**
+	@brief Compresses a chunk of data as a series of independent blocks, in parallel
+
+	@param data		The data to compress
+	@param len		Length of the data, in bytes
+	@param blocks	Compressed data for each WAVEFORM_FILE_BLOCK_SIZE byte block of the input
+
+	@return True if compression succeeded and saved space, false if the data should be stored uncompressed
+ */
+bool WaveformFileWriter::CompressBlocks(const void* data, size_t len, vector<vector<uint8_t>>& blocks)
+{
+	size_t nblocks = (len + WAVEFORM_FILE_BLOCK_SIZE - 1) / WAVEFORM_FILE_BLOCK_SIZE;
+	blocks.resize(nblocks);
+	auto src = reinterpret_cast<const uint8_t*>(data);
+	auto compression = m_compression;
+	int level = m_compressionLevel;
+
+	#pragma omp parallel for schedule(dynamic)
+	for(size_t i=0; i<nblocks; i++)
+	{
+		size_t blocklen = min(static_cast<size_t>(WAVEFORM_FILE_BLOCK_SIZE), len - i*WAVEFORM_FILE_BLOCK_SIZE);
+		CompressBlock(compression, level, src + i*WAVEFORM_FILE_BLOCK_SIZE, blocklen, blocks[i]);
+	}
+
+	//Make sure every block compressed, and that it was worth doing
+	size_t total = nblocks * sizeof(uint64_t);
+	for(auto& b : blocks)
+	{
+		if(b.empty())
+			return false;
+		total += b.size();
+	}
+	return (total < len);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// WaveformFileReader
+
+WaveformFileReader::WaveformFileReader()
+	: m_fd(-1)
+{
+}
+
+WaveformFileReader::~WaveformFileReader()
+{
+	Close();
+}
+
+/**
+	@brief Opens a waveform file and reads the channel directory
+
+	@param path	Path to the file
+
+	@return True if the file was opened and is a valid waveform file
+ */
+bool WaveformFileReader::Open(const string& path)
+{
+	Close();
+
+	if(!m_file.Open(path))
+	{
+		LogError("Couldn't open waveform file \"%s\"\n", path.c_str());
+		return false;
+	}
+
+	//Sanity check header and trailer
+	size_t len = m_file.size();
+	const char* base = m_file.data();
+	if(len < sizeof(WaveformFileHeader) + sizeof(WaveformFileTrailer))
+	{
+		LogError("Waveform file \"%s\" is truncated\n", path.c_str());
+		Close();
+		return false;
+	}
+	WaveformFileHeader header;
+	WaveformFileTrailer trailer;
+	memcpy(&header, base, sizeof(header));
+	memcpy(&trailer, base + len - sizeof(trailer), sizeof(trailer));
+	if( (0 != memcmp(header.magic, WAVEFORM_FILE_MAGIC, sizeof(header.magic))) ||
+		(0 != memcmp(trailer.magic, WAVEFORM_FILE_MAGIC, sizeof(trailer.magic))) )
+	{
+		LogError("\"%s\" is not a waveform file, or is truncated\n", path.c_str());
+		Close();
+		return false;
+	}
+	if(header.version != WAVEFORM_FILE_VERSION)
+	{
+		LogError("Waveform file \"%s\" is version %u, only version %d is supported\n",
+			path.c_str(), header.version, WAVEFORM_FILE_VERSION);
+		Close();
+		return false;
+	}
+
+	//Read the directory
+	size_t dirEnd = len - sizeof(trailer);
+	size_t pos = trailer.directoryOffset;
+	for(uint32_t i=0; i<trailer.channelCount; i++)
+	{
+		ChannelInfo info;
+		if( (pos > dirEnd) || (dirEnd - pos < sizeof(WaveformFileChannel)) )
+			break;
+		memcpy(&info.m_header, base + pos, sizeof(WaveformFileChannel));
+		pos += sizeof(WaveformFileChannel);
+
+		size_t tableLen = info.m_header.nameLength + info.m_header.chunkCount * sizeof(WaveformFileChunk);
+		if(dirEnd - pos < tableLen)
+			break;
+		info.m_name.assign(base + pos, info.m_header.nameLength);
+		pos += info.m_header.nameLength;
+
+		info.m_chunks.resize(info.m_header.chunkCount);
+		memcpy(info.m_chunks.data(), base + pos, info.m_header.chunkCount * sizeof(WaveformFileChunk));
+		pos += info.m_header.chunkCount * sizeof(WaveformFileChunk);
+
+		m_channels.push_back(info);
+	}
+	if(m_channels.size() != trailer.channelCount)
+	{
+		LogError("Waveform file \"%s\" has a corrupted channel directory\n", path.c_str());
+		Close();
+		return false;
+	}
+
+	//Separate handle for mapping sample data straight into waveform buffers
+	#ifndef _WIN32
+		m_fd = open(path.c_str(), O_RDONLY);
+	#endif
+
+	return true;
+}
+
+/**
+	@brief Closes the file
+
+	Waveforms already loaded from the file remain valid.
+ */
+void WaveformFileReader::Close()
+{
+	#ifndef _WIN32
+		if(m_fd >= 0)
+			close(m_fd);
+	#endif
+	m_fd = -1;
+
+	m_file.Close();
+	m_channels.clear();
+}
+
+/**
+	@brief Loads one channel from the file
+
+	@param i	Index of the channel
+
+	@return The waveform (owned by the caller), or nullptr if the channel data is corrupted
+ */
+WaveformBase* WaveformFileReader::LoadWaveform(size_t i)
+{
+	if(i >= m_channels.size())
+		return nullptr;
+	auto& info = m_channels[i];
+	size_t len = info.m_header.sampleCount;
+
+	auto samples = FindChunk(info, WaveformFile::CHUNK_SAMPLES);
+	auto offsets = FindChunk(info, WaveformFile::CHUNK_OFFSETS);
+	auto durations = FindChunk(info, WaveformFile::CHUNK_DURATIONS);
+
+	WaveformBase* wfm = nullptr;
+	bool ok = false;
+	switch(info.m_header.type)
+	{
+		case WaveformFile::CHANNEL_UNIFORM_ANALOG:
+			{
+				auto w = new UniformAnalogWaveform;
+				ok = LoadAnalog(samples, w->m_samples, len);
+				wfm = w;
+			}
+			break;
+
+		case WaveformFile::CHANNEL_SPARSE_ANALOG:
+			{
+				auto w = new SparseAnalogWaveform;
+				ok = LoadArray(offsets, w->m_offsets, len) &&
+					LoadArray(durations, w->m_durations, len) &&
+					LoadAnalog(samples, w->m_samples, len);
+				wfm = w;
+			}
+			break;
+
+		case WaveformFile::CHANNEL_UNIFORM_DIGITAL:
+			{
+				auto w = new UniformDigitalWaveform;
+				ok = LoadBits(samples, w->m_samples, len);
+				wfm = w;
+			}
+			break;
+
+		case WaveformFile::CHANNEL_SPARSE_DIGITAL:
+			{
+				auto w = new SparseDigitalWaveform;
+				ok = LoadArray(offsets, w->m_offsets, len) &&
+					LoadArray(durations, w->m_durations, len) &&
+					LoadBits(samples, w->m_samples, len);
+				wfm = w;
+			}
+			break;
+
+		default:
+			LogError("Channel %s has unknown waveform type %d\n", info.m_name.c_str(), info.m_header.type);
+			return nullptr;
+	}
+
+	if(!ok)
+	{
+		LogError("Channel %s has missing or corrupted sample data\n", info.m_name.c_str());
+		delete wfm;
+		return nullptr;
+	}
+
+	wfm->m_flags = info.m_header.flags;
+	wfm->m_timescale = info.m_header.timescale;
+	wfm->m_triggerPhase = info.m_header.triggerPhase;
+	wfm->m_startTimestamp = info.m_header.startTimestamp;
+	wfm->m_startFemtoseconds = info.m_header.startFemtoseconds;
+	wfm->MarkModifiedFromCpu();
+	return wfm;
+}
+
+/**
+	@brief Finds the first chunk of a given type belonging to a channel
+
+	@return The chunk descriptor, or nullptr if not present
+ */
+const WaveformFileChunk* WaveformFileReader::FindChunk(const ChannelInfo& info, WaveformFile::ChunkType type)
+{
+	for(auto& c : info.m_chunks)
+	{
+		if(c.type == type)
+			return &c;
+	}
+	return nullptr;
+}
+
+/**
+	@brief Checks that a chunk is present and lies entirely within the file
+ */
+bool WaveformFileReader::IsChunkValid(const WaveformFileChunk* chunk)
+{
+	if(!chunk)
+		return false;
+	return (chunk->offset <= m_file.size()) && (m_file.size() - chunk->offset >= chunk->length);
+}
+
+/**
+	@brief Reads the contents of a chunk into memory, decompressing it if needed
+
+	@param chunk	The chunk to read (must have passed IsChunkValid())
+	@param dst		Output buffer, must be chunk->rawLength bytes in size
+
+	@return True on success, false if the data is corrupted or uses an unsupported compression algorithm
+ */
+bool WaveformFileReader::ReadChunk(const WaveformFileChunk* chunk, void* dst)
+{
+	auto src = reinterpret_cast<const uint8_t*>(m_file.data() + chunk->offset);
+	auto out = reinterpret_cast<uint8_t*>(dst);
+
+	auto compression = static_cast<WaveformFile::Compression>(chunk->compression);
+	if(compression == WaveformFile::COMPRESSION_NONE)
+	{
+		if(chunk->length != chunk->rawLength)
+			return false;
+		if(chunk->length)
+			memcpy(out, src, chunk->length);
+		return true;
+	}
+
+	if(!WaveformFile::IsCompressionSupported(compression))
+	{
+		LogError("Waveform file uses compression type %d, which is not supported by this build\n", compression);
+		return false;
+	}
+	if(chunk->blockSize == 0)
+		return false;
+
+	//Read the block table and figure out where each block starts
+	size_t nblocks = (chunk->rawLength + chunk->blockSize - 1) / chunk->blockSize;
+	if(nblocks > chunk->length / sizeof(uint64_t))
+		return false;
+	vector<uint64_t> sizes(nblocks);
+	memcpy(sizes.data(), src, nblocks * sizeof(uint64_t));
+	vector<size_t> starts(nblocks);
+	size_t pos = nblocks * sizeof(uint64_t);
+	for(size_t i=0; i<nblocks; i++)
+	{
+		if(sizes[i] > chunk->length - pos)
+			return false;
+		starts[i] = pos;
+		pos += sizes[i];
+	}
+
+	//Decompress them all in parallel
+	vector<uint8_t> ok(nblocks, 0);
+	#pragma omp parallel for schedule(dynamic)
+	for(size_t i=0; i<nblocks; i++)
+	{
+		size_t rawlen = min(static_cast<size_t>(chunk->blockSize), chunk->rawLength - i*chunk->blockSize);
+		ok[i] = DecompressBlock(compression, src + starts[i], sizes[i], out + i*chunk->blockSize, rawlen);
+	}
+
+	for(auto b : ok)
+	{
+		if(!b)
+			return false;
+	}
+	return true;
+}
+
+/**
+	@brief Loads an array of samples into a buffer
+
+	If possible the chunk is mapped into the buffer in place, otherwise it is copied or decompressed.
+
+	@param chunk	The chunk to load
+	@param buf		Buffer to load into
+	@param count	Expected number of elements
+
+	@return True on success, false if the chunk is missing or doesn't match the expected size
+ */
+template<class T>
+bool WaveformFileReader::LoadArray(const WaveformFileChunk* chunk, AcceleratorBuffer<T>& buf, size_t count)
+{
+	if(!IsChunkValid(chunk) || (chunk->rawLength != count * sizeof(T)) )
+		return false;
+
+	if(count == 0)
+	{
+		buf.clear();
+		return true;
+	}
+
+	//Map it in place if we can. The whole mapping has to lie inside the file, since touching a page past EOF is
+	//a SIGBUS rather than an error we can report.
+	bool mappable =
+		(chunk->compression == WaveformFile::COMPRESSION_NONE) &&
+		(chunk->length == chunk->rawLength) &&
+		(m_file.size() - chunk->offset >= chunk->rawLength) &&
+		(chunk->offset % WAVEFORM_FILE_ALIGN == 0);
+	if(mappable && (m_fd >= 0) && buf.AdoptFileRegion(m_fd, chunk->offset, count) )
+		return true;
+
+	//Nope, copy it (ReadChunk() reports anything malformed)
+	buf.resize(count);
+	buf.PrepareForCpuAccess();
+	if(!ReadChunk(chunk, buf.GetCpuPointer()))
+		return false;
+	buf.MarkModifiedFromCpu();
+	return true;
+}
+
+/**
+	@brief Loads analog samples into a buffer, converting ADC codes to floats if needed
+
+	@param chunk	The chunk to load
+	@param buf		Buffer to load into
+	@param count	Expected number of elements
+
+	@return True on success, false if the chunk is missing or doesn't match the expected size
+ */
+bool WaveformFileReader::LoadAnalog(const WaveformFileChunk* chunk, AcceleratorBuffer<float>& buf, size_t count)
+{
+	if(!IsChunkValid(chunk))
+		return false;
+
+	size_t width;
+	switch(chunk->encoding)
+	{
+		case WaveformFile::ENCODING_FLOAT32:
+			return LoadArray(chunk, buf, count);
+
+		case WaveformFile::ENCODING_ADC_INT8:
+			width = 1;
+			break;
+
+		case WaveformFile::ENCODING_ADC_INT16:
+			width = 2;
+			break;
+
+		default:
+			return false;
+	}
+	if(chunk->rawLength != count * width)
+		return false;
+
+	//Uncompressed codes can be converted straight out of the file, otherwise decompress them first
+	vector<uint8_t> codes;
+	auto src = reinterpret_cast<const uint8_t*>(m_file.data() + chunk->offset);
+	if(chunk->compression != WaveformFile::COMPRESSION_NONE)
+	{
+		codes.resize(chunk->rawLength);
+		if(!ReadChunk(chunk, codes.data()))
+			return false;
+		src = codes.data();
+	}
+	else if(chunk->length != chunk->rawLength)
+		return false;
+
+	buf.resize(count);
+	buf.PrepareForCpuAccess();
+	if(width == 1)
+	{
+		Oscilloscope::Convert8BitSamples(
+			buf.GetCpuPointer(), reinterpret_cast<const int8_t*>(src), chunk->gain, chunk->adcOffset, count);
+	}
+	else
+	{
+		Oscilloscope::Convert16BitSamples(
+			buf.GetCpuPointer(), reinterpret_cast<const int16_t*>(src), chunk->gain, chunk->adcOffset, count);
+	}
+	buf.MarkModifiedFromCpu();
+	return true;
+}
+
+/**
+	@brief Loads a bit-packed array of digital samples into a buffer
+
+	@param chunk	The chunk to load
+	@param buf		Buffer to load into
+	@param count	Expected number of elements
+
+	@return True on success, false if the chunk is missing or doesn't match the expected size
+ */
+bool WaveformFileReader::LoadBits(const WaveformFileChunk* chunk, AcceleratorBuffer<bool>& buf, size_t count)
+{
+	size_t nbytes = (count + 7) / 8;
+	if(!IsChunkValid(chunk) || (chunk->encoding != WaveformFile::ENCODING_BITPACKED) || (chunk->rawLength != nbytes) )
+		return false;
+
+	//Decompress if needed
+	vector<uint8_t> unpacked;
+	auto packed = reinterpret_cast<const uint8_t*>(m_file.data() + chunk->offset);
+	if(chunk->compression != WaveformFile::COMPRESSION_NONE)
+	{
+		unpacked.resize(nbytes);
+		if(!ReadChunk(chunk, unpacked.data()))
+			return false;
+		packed = unpacked.data();
+	}
+	else if(chunk->length != nbytes)
+		return false;
+
+	buf.resize(count);
+	buf.PrepareForCpuAccess();
+
+	bool* samples = buf.GetCpuPointer();
+	#pragma omp parallel for if(nbytes > 100000)
+	for(size_t i=0; i<nbytes; i++)
+	{
+		uint8_t b = packed[i];
+		size_t base = i*8;
+		size_t n = min(static_cast<size_t>(8), count - base);
+		for(size_t j=0; j<n; j++)
+			samples[base + j] = (b >> j) & 1;
+	}
+
+	buf.MarkModifiedFromCpu();
+	return true;
+}
@@ -0,0 +1,305 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopehal                                                                                                          *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of WaveformFileWriter and WaveformFileReader
+	@ingroup core
+ */
+
+#ifndef WaveformFile_h
+#define WaveformFile_h
+
+#include "MappedFile.h"
+
+/*
+	Native binary waveform file format.
+
+	All integers are little endian. The file consists of:
+		* WaveformFileHeader
+		* Raw sample data chunks, each starting on a WAVEFORM_FILE_ALIGN byte boundary so they can be memory mapped
+		  directly as AcceleratorBuffer backing storage
+		* Channel directory. For each channel: a WaveformFileChannel, the channel name (not nul terminated), then
+		  chunkCount WaveformFileChunk descriptors
+		* WaveformFileTrailer
+
+	The directory is at the end so the writer can stream sample data out without knowing the layout in advance.
+
+	Chunks may optionally be compressed. A compressed chunk is split into blocks of WaveformFileChunk::blockSize
+	uncompressed bytes which are compressed independently (so they can be encoded and decoded in parallel). The chunk
+	starts with a table of uint64_t compressed block sizes, followed by the compressed blocks back to back.
+ */
+
+///@brief Magic number at the start and end of a waveform file
+#define WAVEFORM_FILE_MAGIC "SCOPEWFM"
+
+///@brief Current version of the waveform file format
+#define WAVEFORM_FILE_VERSION 2
+
+///@brief Alignment of sample data chunks (large enough for the mapping granularity of every supported OS)
+#define WAVEFORM_FILE_ALIGN 65536
+
+///@brief Uncompressed size of each independently compressed block within a chunk
+#define WAVEFORM_FILE_BLOCK_SIZE (4 * 1024 * 1024)
+
+///@brief Header at the start of a waveform file
+struct __attribute__((packed)) WaveformFileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+};
+
+///@brief Trailer at the end of a waveform file
+struct __attribute__((packed)) WaveformFileTrailer
+{
+	uint64_t directoryOffset;
+	uint32_t channelCount;
+	uint32_t reserved;
+	char magic[8];
+};
+
+///@brief Directory entry for a single channel
+struct __attribute__((packed)) WaveformFileChannel
+{
+	uint8_t type;
+	uint8_t flags;
+	uint16_t nameLength;
+	uint32_t chunkCount;
+	int32_t xunit;
+	int32_t yunit;
+	int64_t timescale;
+	int64_t triggerPhase;
+	int64_t startTimestamp;
+	int64_t startFemtoseconds;
+	uint64_t sampleCount;
+};
+
+///@brief Descriptor for one chunk of sample data belonging to a channel
+struct __attribute__((packed)) WaveformFileChunk
+{
+	uint8_t type;
+	uint8_t encoding;
+	uint8_t compression;
+	uint8_t reserved;
+	uint32_t blockSize;
+	uint64_t offset;
+	uint64_t length;
+	uint64_t rawLength;
+	float gain;
+	float adcOffset;
+};
+
+/**
+	@brief Constants shared by the waveform file reader and writer
+	@ingroup core
+ */
+class WaveformFile
+{
+public:
+	///@brief Kinds of waveform that can be stored in a channel
+	enum ChannelType
+	{
+		CHANNEL_UNIFORM_ANALOG	= 0,
+		CHANNEL_SPARSE_ANALOG	= 1,
+		CHANNEL_UNIFORM_DIGITAL	= 2,
+		CHANNEL_SPARSE_DIGITAL	= 3
+	};
+
+	///@brief What a chunk contains
+	enum ChunkType
+	{
+		CHUNK_SAMPLES			= 0,
+		CHUNK_OFFSETS			= 1,
+		CHUNK_DURATIONS			= 2
+	};
+
+	///@brief How the data in a chunk is stored
+	enum Encoding
+	{
+		ENCODING_FLOAT32		= 0,
+		ENCODING_INT64			= 1,
+		ENCODING_BITPACKED		= 2,
+		ENCODING_ADC_INT8		= 3,	//value = gain*code - adcOffset
+		ENCODING_ADC_INT16		= 4		//value = gain*code - adcOffset
+	};
+
+	///@brief How a chunk is compressed
+	enum Compression
+	{
+		COMPRESSION_NONE		= 0,
+		COMPRESSION_LZ4			= 1,
+		COMPRESSION_ZSTD		= 2
+	};
+
+	static bool IsCompressionSupported(Compression c);
+};
+
+/**
+	@brief Writes waveforms to a native binary waveform file
+	@ingroup core
+ */
+class WaveformFileWriter
+{
+public:
+	WaveformFileWriter();
+	~WaveformFileWriter();
+
+	bool Open(const std::string& path);
+	bool AddChannel(
+		const std::string& name,
+		WaveformBase* wfm,
+		Unit xunit,
+		Unit yunit,
+		int adcBits = 0,
+		float gain = 1,
+		float adcOffset = 0);
+	bool Close();
+
+	bool SetCompression(WaveformFile::Compression compression, int level = 0);
+
+protected:
+	bool Write(const void* data, size_t len);
+	bool Align();
+	bool WriteChunk(
+		WaveformFile::ChunkType type,
+		WaveformFile::Encoding encoding,
+		const void* data,
+		size_t len,
+		std::vector<WaveformFileChunk>& chunks,
+		float gain = 0,
+		float adcOffset = 0);
+	bool CompressBlocks(const void* data, size_t len, std::vector<std::vector<uint8_t>>& blocks);
+
+	///@brief Compression algorithm for new chunks
+	WaveformFile::Compression m_compression;
+
+	///@brief Compression level (algorithm specific, 0 for default)
+	int m_compressionLevel;
+
+	///@brief The file being written
+	FILE* m_fp;
+
+	///@brief Final path of the file
+	std::string m_path;
+
+	///@brief Temporary file the data is actually written to, renamed over m_path by Close()
+	std::string m_tempPath;
+
+	///@brief Current write position
+	uint64_t m_pos;
+
+	///@brief Channel directory, written at the end of the file
+	std::vector<uint8_t> m_directory;
+
+	///@brief Number of channels written so far
+	uint32_t m_channelCount;
+};
+
+/**
+	@brief Reads waveforms from a native binary waveform file
+
+	Uncompressed float samples, offsets, and durations are memory mapped directly into the waveform buffers so even
+	very large files load almost instantly; data is paged in from disk as it is used. Compressed chunks are decoded
+	in parallel, one block per thread.
+	@ingroup core
+ */
+class WaveformFileReader
+{
+public:
+	WaveformFileReader();
+	~WaveformFileReader();
+
+	bool Open(const std::string& path);
+	void Close();
+
+	///@brief Returns the number of channels in the file
+	size_t GetChannelCount() const
+	{ return m_channels.size(); }
+
+	///@brief Returns the name of a channel
+	const std::string& GetChannelName(size_t i) const
+	{ return m_channels[i].m_name; }
+
+	///@brief Returns the X axis unit of a channel
+	Unit GetXAxisUnits(size_t i) const
+	{ return Unit(static_cast<Unit::UnitType>(m_channels[i].m_header.xunit)); }
+
+	///@brief Returns the Y axis unit of a channel
+	Unit GetYAxisUnits(size_t i) const
+	{ return Unit(static_cast<Unit::UnitType>(m_channels[i].m_header.yunit)); }
+
+	///@brief Returns true if a channel contains digital data
+	bool IsDigital(size_t i) const
+	{
+		auto type = m_channels[i].m_header.type;
+		return (type == WaveformFile::CHANNEL_UNIFORM_DIGITAL) || (type == WaveformFile::CHANNEL_SPARSE_DIGITAL);
+	}
+
+	WaveformBase* LoadWaveform(size_t i);
+
+protected:
+
+	/**
+		@brief Directory information for one channel
+	 */
+	class ChannelInfo
+	{
+	public:
+		///@brief Fixed size channel header
+		WaveformFileChannel m_header;
+
+		///@brief Display name of the channel
+		std::string m_name;
+
+		///@brief Descriptors for each chunk of sample data
+		std::vector<WaveformFileChunk> m_chunks;
+	};
+
+	const WaveformFileChunk* FindChunk(const ChannelInfo& info, WaveformFile::ChunkType type);
+
+	template<class T>
+	bool LoadArray(const WaveformFileChunk* chunk, AcceleratorBuffer<T>& buf, size_t count);
+	bool LoadBits(const WaveformFileChunk* chunk, AcceleratorBuffer<bool>& buf, size_t count);
+	bool LoadAnalog(const WaveformFileChunk* chunk, AcceleratorBuffer<float>& buf, size_t count);
+	bool ReadChunk(const WaveformFileChunk* chunk, void* dst);
+	bool IsChunkValid(const WaveformFileChunk* chunk);
+
+	///@brief Mapped view of the file, used for the directory and anything that can't be mapped directly
+	MappedFile m_file;
+
+	///@brief File descriptor used to map chunks into waveform buffers (-1 if not available)
+	int m_fd;
+
+	///@brief Directory of all channels in the file
+	std::vector<ChannelInfo> m_channels;
+};
+
+#endif
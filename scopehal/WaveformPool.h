@@ -42,6 +42,11 @@
 
 	Allocating and freeing GPU memory can be an expensive operation so it's usually preferable to recycle existing
 	Waveform objects if possible.
+
+	Free waveforms are sorted into buckets by the power-of-two class of their buffer capacity, so that a request for a
+	deep waveform is satisfied by one that is already large enough rather than whichever one happens to be on top.
+	Each bucket is a fixed array of slots manipulated with atomic compare-and-swap, so Add() and Get() never block
+	each other even when many filter threads are recycling waveforms at once.
  */
 class WaveformPool
 {
@@ -54,15 +59,20 @@ public:
 	 */
 	WaveformPool(size_t maxSize = 16)
 	: m_maxSize(maxSize)
-	{}
-
-	~WaveformPool()
+	, m_slots(new std::atomic<WaveformBase*>[NUM_BUCKETS * maxSize])
+	, m_count(0)
+	, m_hits(0)
+	, m_misses(0)
+	, m_reallocations(0)
+	, m_discards(0)
 	{
-		for(auto w : m_waveforms)
-			delete w;
-		m_waveforms.clear();
+		for(size_t i=0; i<NUM_BUCKETS * m_maxSize; i++)
+			m_slots[i] = nullptr;
 	}
 
+	~WaveformPool()
+	{ clear(); }
+
 	/**
 		@brief Adds a new waveform to the pool if there's sufficient free slots in the pool.
 
@@ -72,31 +82,85 @@ public:
 	 */
 	void Add(WaveformBase* w)
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		//Reserve space in the pool before publishing the waveform, so the number of waveforms actually stored in
+		//the slots never exceeds m_count. This guarantees the target bucket has a free slot once we get here.
+		if(m_count.fetch_add(1) >= m_maxSize)
+		{
+			m_count --;
+			m_discards ++;
+			delete w;
+			return;
+		}
+
 		w->Rename("WaveformPool.freelist");
 
-		if(m_waveforms.size() < m_maxSize)
-			m_waveforms.push_back(w);
-		else
-			delete w;
+		auto slots = &m_slots[GetBucket(w->capacity()) * m_maxSize];
+		while(true)
+		{
+			for(size_t i=0; i<m_maxSize; i++)
+			{
+				WaveformBase* expected = nullptr;
+				if(slots[i].compare_exchange_strong(expected, w))
+					return;
+			}
+		}
 	}
 
 	/**
 		@brief Attempts to get a waveform from the pool.
 
+		The smallest waveform with at least the requested capacity is preferred. If no waveform is big enough, the
+		largest available one is returned anyway (and counted as a reallocation) since recycling the object still
+		avoids some allocator traffic and keeps undersized waveforms from clogging up the pool.
+
+		@param minCapacity	Number of samples the caller is about to store in the waveform.
+							If zero, the largest available waveform is returned.
+
 		@return The waveform, if one is available. Returns nullptr if the pool is empty.
 	 */
-	WaveformBase* Get()
+	WaveformBase* Get(size_t minCapacity = 0)
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		WaveformBase* ret = nullptr;
 
-		if(m_waveforms.empty())
+		//No size hint: prefer the biggest buffer we have
+		if(minCapacity == 0)
+		{
+			for(size_t b=NUM_BUCKETS; b>0 && !ret; b--)
+				ret = TakeFromBucket(b-1, 0);
+			if(ret)
+				m_hits ++;
+		}
+
+		else
+		{
+			//The bucket containing minCapacity may hold waveforms on either side of it, so check each one.
+			//Every waveform in a higher bucket is big enough.
+			size_t first = GetBucket(minCapacity);
+			ret = TakeFromBucket(first, minCapacity);
+			for(size_t b=first+1; b<NUM_BUCKETS && !ret; b++)
+				ret = TakeFromBucket(b, 0);
+
+			if(ret)
+				m_hits ++;
+
+			//Nothing big enough, fall back to the largest smaller one
+			else
+			{
+				for(size_t b=first+1; b>0 && !ret; b--)
+					ret = TakeFromBucket(b-1, 0);
+				if(ret)
+					m_reallocations ++;
+			}
+		}
+
+		if(!ret)
+		{
+			m_misses ++;
 			return nullptr;
+		}
 
-		auto ret = *m_waveforms.begin();
+		m_count --;
 		ret->m_revision ++;
-		m_waveforms.pop_front();
-
 		ret->Rename("WaveformPool.allocated");
 		return ret;
 	}
@@ -108,28 +172,124 @@ public:
 	 */
 	bool clear()
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		bool freed = false;
+		for(size_t i=0; i<NUM_BUCKETS * m_maxSize; i++)
+		{
+			auto w = m_slots[i].exchange(nullptr);
+			if(w)
+			{
+				m_count --;
+				delete w;
+				freed = true;
+			}
+		}
+		return freed;
+	}
 
-		if(m_waveforms.empty())
-			return false;
+	///@brief Returns the number of waveforms currently in the pool
+	size_t size() const
+	{ return m_count; }
 
-		for(auto w : m_waveforms)
-			delete w;
-		m_waveforms.clear();
+	///@brief Returns the number of Get() calls which returned a waveform with sufficient capacity
+	uint64_t GetHitCount() const
+	{ return m_hits; }
 
-		return true;
-	}
+	///@brief Returns the number of Get() calls which found the pool empty
+	uint64_t GetMissCount() const
+	{ return m_misses; }
+
+	///@brief Returns the number of Get() calls which returned a waveform too small for the requested capacity
+	uint64_t GetReallocationCount() const
+	{ return m_reallocations; }
+
+	///@brief Returns the number of waveforms deleted by Add() because the pool was full
+	uint64_t GetDiscardCount() const
+	{ return m_discards; }
 
 protected:
 
+	///@brief Number of capacity buckets (one per bit of size_t)
+	static const size_t NUM_BUCKETS = 64;
+
+	/**
+		@brief Gets the bucket index for a given capacity
+
+		Bucket N holds waveforms with capacity in [2^N, 2^(N+1)). Empty waveforms share bucket 0 with 1-sample ones.
+	 */
+	static size_t GetBucket(size_t capacity)
+	{
+		if(capacity <= 1)
+			return 0;
+
+#ifdef __GNUC__
+		return 63 - __builtin_clzll(capacity);
+#else
+		size_t ret = 0;
+		while(capacity >>= 1)
+			ret ++;
+		return ret;
+#endif
+	}
+
+	/**
+		@brief Removes a waveform of at least the requested capacity from a single bucket
+
+		@param bucket		Bucket index
+		@param minCapacity	Minimum capacity, or zero to accept any waveform in the bucket
+	 */
+	WaveformBase* TakeFromBucket(size_t bucket, size_t minCapacity)
+	{
+		auto slots = &m_slots[bucket * m_maxSize];
+		for(size_t i=0; i<m_maxSize; i++)
+		{
+			auto w = slots[i].load();
+			if(!w)
+				continue;
+
+			//Only look at the capacity of a waveform we own
+			w = slots[i].exchange(nullptr);
+			if(!w)
+				continue;
+			if(w->capacity() >= minCapacity)
+				return w;
+
+			//Too small, put it back. The slot we just emptied may have been refilled in the meantime,
+			//but our reservation in m_count guarantees there is a free slot somewhere in this bucket.
+			while(true)
+			{
+				bool done = false;
+				for(size_t j=0; j<m_maxSize && !done; j++)
+				{
+					WaveformBase* expected = nullptr;
+					done = slots[j].compare_exchange_strong(expected, w);
+				}
+				if(done)
+					break;
+			}
+		}
+		return nullptr;
+	}
+
 	///@brief Maximum number of waveforms to store in the pool
 	size_t m_maxSize;
 
-	///@brief Mutex for synchronizing access to m_waveforms across threads
-	std::mutex m_mutex;
+	///@brief Free waveform slots, m_maxSize per bucket. Null means the slot is empty.
+	std::unique_ptr<std::atomic<WaveformBase*>[]> m_slots;
+
+	///@brief Number of waveforms currently in (or being added to) the pool
+	std::atomic<size_t> m_count;
+
+	///@brief Number of Get() calls returning a waveform of sufficient capacity
+	std::atomic<uint64_t> m_hits;
+
+	///@brief Number of Get() calls returning nullptr
+	std::atomic<uint64_t> m_misses;
+
+	///@brief Number of Get() calls returning a waveform that will need to grow
+	std::atomic<uint64_t> m_reallocations;
 
-	///@brief The list of free waveforms
-	std::list<WaveformBase*> m_waveforms;
+	///@brief Number of waveforms deleted because the pool was full
+	std::atomic<uint64_t> m_discards;
 };
 
 #endif
@@ -229,6 +229,9 @@ void DetectCPUFeatures()
 
 void ScopehalStaticCleanup()
 {
+	//Pooled filter waveforms may own GPU buffers, so they have to go before the device does
+	Filter::FreeAllWaveformPools();
+
 	VulkanCleanup();
 }
 
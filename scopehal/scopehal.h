@@ -44,9 +44,11 @@
 #endif
 
 #include <deque>
+#include <list>
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <stdint.h>
 #include <chrono>
 #include <thread>
@@ -56,6 +58,7 @@
 #include <set>
 #include <float.h>
 #include <shared_mutex>
+#include <condition_variable>
 
 #include <sigc++/sigc++.h>
 
@@ -142,6 +145,7 @@ uint32_t GetComputeBlockCount(size_t numGlobal, size_t blockSize);
 #endif
 
 #include "FlowGraphNode.h"
+#include "PackedDigitalWaveform.h"
 #include "SinkNode.h"
 #include "Instrument.h"
 #include "StreamDescriptor.h"
@@ -195,6 +199,7 @@ uint32_t GetComputeBlockCount(size_t numGlobal, size_t blockSize);
 #include "FilterParameter.h"
 #include "Filter.h"
 #include "ImportFilter.h"
+#include "WaveformFile.h"
 #include "PeakDetectionFilter.h"
 #include "SpectrumChannel.h"
 #include "SParameterSourceFilter.h"
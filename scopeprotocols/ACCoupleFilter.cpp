@@ -110,31 +110,51 @@ void ACCoupleFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHa
 	cfg.delta = average;
 	cfg.size = len;
 
-	cmdBuf.begin({});
-
-	//Set up waveforms
+	//Set up output waveform
+	AcceleratorBuffer<float>* inbuf;
+	AcceleratorBuffer<float>* outbuf;
 	if(sdata)
 	{
 		auto cap = SetupSparseOutputWaveform(sdata, 0, 0, 0);
-		m_computePipeline.BindBufferNonblocking(0, sdata->m_samples, cmdBuf);
-		m_computePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
-		cap->MarkSamplesModifiedFromGpu();
+		inbuf = &sdata->m_samples;
+		outbuf = &cap->m_samples;
 	}
 	else
 	{
 		auto cap = SetupEmptyUniformAnalogOutputWaveform(udata, 0);
 		cap->Resize(len);
-		m_computePipeline.BindBufferNonblocking(0, udata->m_samples, cmdBuf);
-		m_computePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
-		cap->MarkSamplesModifiedFromGpu();
+		inbuf = &udata->m_samples;
+		outbuf = &cap->m_samples;
 	}
 
 	//Do the actual subtraction
-	const uint32_t compute_block_count = GetComputeBlockCount(len, 64);
-	m_computePipeline.Dispatch(cmdBuf, cfg,
-		min(compute_block_count, 32768u),
-		compute_block_count / 32768 + 1);
+	if(g_gpuFilterEnabled)
+	{
+		cmdBuf.begin({});
+
+		m_computePipeline.BindBufferNonblocking(0, *inbuf, cmdBuf);
+		m_computePipeline.BindBufferNonblocking(1, *outbuf, cmdBuf, true);
+		const uint32_t compute_block_count = GetComputeBlockCount(len, 64);
+		m_computePipeline.Dispatch(cmdBuf, cfg,
+			min(compute_block_count, 32768u),
+			compute_block_count / 32768 + 1);
+
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+
+		outbuf->MarkModifiedFromGpu();
+	}
+	else
+	{
+		inbuf->PrepareForCpuAccess();
+		outbuf->PrepareForCpuAccess();
 
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
+		float* in = inbuf->GetCpuPointer();
+		float* out = outbuf->GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<len; i++)
+			out[i] = in[i] - average;
+
+		outbuf->MarkModifiedFromCpu();
+	}
 }
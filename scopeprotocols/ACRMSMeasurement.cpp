@@ -214,27 +214,44 @@ void ACRMSMeasurement::DoRefreshUniform(
 	//Maybe consider dynamic tuning in the future at initialization?
 	const uint64_t numThreads = 16384;
 
-	//Do the bulk RMS calculation on the GPU
-	ACRMSPushConstants push;
-	push.numSamples = length;
-	push.numThreads = numThreads;
-	push.samplesPerThread = (length + numThreads) / numThreads;
-	push.dcBias = average;
-	m_temporaryResults.resize(numThreads);
-	cmdBuf.begin({});
-	m_rmsComputePipeline->BindBufferNonblocking(0, m_temporaryResults, cmdBuf, true);
-	m_rmsComputePipeline->BindBufferNonblocking(1, wfm->m_samples, cmdBuf);
-	m_rmsComputePipeline->Dispatch(cmdBuf, push, numThreads, 1);
-	m_temporaryResults.MarkModifiedFromGpu();
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
-
-	//Do the final summation of the temporary results
-	//These should all be roughly equal in value (famous last words) so don't both with Kahan here
-	m_temporaryResults.PrepareForCpuAccess();
 	float temp = 0;
-	for(uint64_t i=0; i<numThreads; i++)
-		temp += m_temporaryResults[i];
+	if(g_gpuFilterEnabled)
+	{
+		//Do the bulk RMS calculation on the GPU
+		ACRMSPushConstants push;
+		push.numSamples = length;
+		push.numThreads = numThreads;
+		push.samplesPerThread = (length + numThreads) / numThreads;
+		push.dcBias = average;
+		m_temporaryResults.resize(numThreads);
+		cmdBuf.begin({});
+		m_rmsComputePipeline->BindBufferNonblocking(0, m_temporaryResults, cmdBuf, true);
+		m_rmsComputePipeline->BindBufferNonblocking(1, wfm->m_samples, cmdBuf);
+		m_rmsComputePipeline->Dispatch(cmdBuf, push, numThreads, 1);
+		m_temporaryResults.MarkModifiedFromGpu();
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+
+		//Do the final summation of the temporary results
+		//These should all be roughly equal in value (famous last words) so don't both with Kahan here
+		m_temporaryResults.PrepareForCpuAccess();
+		for(uint64_t i=0; i<numThreads; i++)
+			temp += m_temporaryResults[i];
+	}
+	else
+	{
+		//No GPU, do the same reduction on the CPU with per-thread partial sums
+		wfm->PrepareForCpuAccess();
+		const float* samples = wfm->m_samples.GetCpuPointer();
+		double sum = 0;
+		#pragma omp parallel for simd reduction(+:sum) if(length > 1000000)
+		for(size_t i=0; i<length; i++)
+		{
+			float delta = samples[i] - average;
+			sum += delta * delta;
+		}
+		temp = sum;
+	}
 
 	//Divide by total number of samples and take the square root to get the final AC RMS
 	m_streams[1].m_value = sqrt(temp / length);
@@ -259,7 +276,7 @@ void ACRMSMeasurement::DoRefreshUniform(
 	cap->Resize((elen-1)/2);
 
 	//GPU path needs native int64, no bignum fallback for now
-	if(g_hasShaderInt64)
+	if(g_gpuFilterEnabled && g_hasShaderInt64)
 	{
 		cmdBuf.begin({});
 
@@ -286,12 +303,15 @@ void ACRMSMeasurement::DoRefreshUniform(
 		cap->MarkModifiedFromGpu();
 	}
 
-	//CPU fallback if no int64 capability
+	//CPU fallback if no int64 capability or no GPU
 	else
 	{
 		cap->PrepareForCpuAccess();
 		edges.PrepareForCpuAccess();
-		temp = 0;
+		wfm->PrepareForCpuAccess();
+
+		//Cycles are independent so spread them across all cores
+		#pragma omp parallel for
 		for(size_t i = 0; i < (elen - 2); i += 2)
 		{
 			//Measure from edge to 2 edges later, since we find all zero crossings regardless of polarity
@@ -300,7 +320,7 @@ void ACRMSMeasurement::DoRefreshUniform(
 			int64_t j = 0;
 
 			//Simply sum the squares of all values in a cycle after subtracting the DC value
-			temp = 0;
+			float temp = 0;
 			for(j = start; (j <= end) && (j < (int64_t)length); j++)
 				temp += ((wfm->m_samples[j] - average) * (wfm->m_samples[j] - average));
 
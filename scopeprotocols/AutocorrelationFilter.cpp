@@ -108,17 +108,140 @@ void AutocorrelationFilter::Refresh(
 	auto cap = SetupEmptyUniformAnalogOutputWaveform(din, 0, true);
 	cap->PrepareForCpuAccess();
 	din->PrepareForCpuAccess();
+	cap->Resize(range);
 
+	//Estimate the cost of each approach and pick the cheaper one.
+	//Constant factor is the approximate cost of one FFT butterfly relative to one multiply-add of the direct path.
 	size_t end = len - range;
+	size_t fftlen = GetFFTBlockSize(len, range);
+	size_t nblocks = (end + (fftlen - range) - 1) / (fftlen - range);
+	double directCost = static_cast<double>(end) * range;
+	double fftCost = 1.5 * (2*nblocks + 1) * fftlen * log2(fftlen);
+
+	auto samples = din->m_samples.GetCpuPointer();
+	if(fftCost < directCost)
+		CorrelateFFT(samples, len, end, range, cap->m_samples.GetCpuPointer());
+	else
+		CorrelateDirect(samples, end, range, cap->m_samples.GetCpuPointer());
+
+	cap->MarkSamplesModifiedFromCpu();
+	SetData(cap, 0);
+}
+
+/**
+	@brief Picks the FFT length for the blocked FFT path
+
+	Each block of fftlen points produces fftlen - range points of useful output, so blocks need to be several times
+	the lag range to keep the overlap overhead low. There's no point going beyond the length of the whole waveform.
+ */
+size_t AutocorrelationFilter::GetFFTBlockSize(size_t len, size_t range)
+{
+	size_t blocklen = max(static_cast<size_t>(65536), static_cast<size_t>(next_pow2(4*range)));
+	return min(static_cast<size_t>(next_pow2(len)), blocklen);
+}
+
+/**
+	@brief Computes the autocorrelation directly, one lag at a time
+
+	@param samples	Input samples
+	@param end		Number of samples to correlate for each lag
+	@param range	Maximum lag
+	@param out		Output (range points, starting from a lag of 1)
+ */
+void AutocorrelationFilter::CorrelateDirect(const float* samples, size_t end, size_t range, float* out)
+{
+	#pragma omp parallel for schedule(dynamic, 16)
 	for(size_t delta=1; delta <= range; delta ++)
 	{
+		const float* shifted = samples + delta;
 		double total = 0;
+
+		#pragma omp simd reduction(+:total)
 		for(size_t i=0; i<end; i++)
-			total += din->m_samples[i] * din->m_samples[i+delta];
+			total += samples[i] * shifted[i];
 
-		cap->m_samples.push_back(total / end);
+		out[delta-1] = total / end;
 	}
+}
 
-	cap->MarkSamplesModifiedFromCpu();
-	SetData(cap, 0);
+/**
+	@brief Computes the autocorrelation via FFT
+
+	The first end samples are split into blocks of B = fftlen - range points. Block k of the reference (samples
+	[kB, kB+B), zero padded) is correlated against samples [kB, kB+B+range) of the input. Since every lag is at most
+	range, the circular correlation of the two padded blocks never wraps, so the cross spectra of all blocks can
+	simply be summed and transformed back once.
+
+	@param samples	Input samples
+	@param len		Total number of input samples
+	@param end		Number of samples to correlate for each lag
+	@param range	Maximum lag
+	@param out		Output (range points, starting from a lag of 1)
+ */
+void AutocorrelationFilter::CorrelateFFT(const float* samples, size_t len, size_t end, size_t range, float* out)
+{
+	size_t fftlen = GetFFTBlockSize(len, range);
+	size_t nouts = fftlen/2 + 1;
+	size_t blocksize = fftlen - range;
+	size_t nblocks = (end + blocksize - 1) / blocksize;
+
+	//Transform several blocks at a time to bound memory usage.
+	//Each batch contains the reference blocks followed by the input blocks.
+	size_t batchsize = min(nblocks, static_cast<size_t>(32));
+	if(!m_forwardPlan || (m_forwardPlan->size() != fftlen) || (m_forwardPlan->GetNumBatches() != 2*batchsize) )
+		m_forwardPlan = make_unique<CPUFFTPlan>(fftlen, nouts, FFTPlan::DIRECTION_FORWARD, 2*batchsize);
+	if(!m_reversePlan || (m_reversePlan->size() != fftlen) )
+		m_reversePlan = make_unique<CPUFFTPlan>(fftlen, nouts, FFTPlan::DIRECTION_REVERSE);
+
+	m_fftIn.resize(2 * batchsize * fftlen);
+	m_fftOut.resize(2 * batchsize * nouts * 2);
+	m_spectrum.assign(nouts * 2, 0);
+	m_correlation.resize(fftlen);
+
+	for(size_t batchstart = 0; batchstart < nblocks; batchstart += batchsize)
+	{
+		//Copy and zero pad the blocks
+		#pragma omp parallel for
+		for(size_t j=0; j<batchsize; j++)
+		{
+			float* ref = m_fftIn.data() + j*fftlen;
+			float* sig = m_fftIn.data() + (batchsize + j)*fftlen;
+
+			size_t base = (batchstart + j) * blocksize;
+			size_t nref = (base < end) ? min(blocksize, end - base) : 0;
+			size_t nsig = (base < len) ? min(fftlen, len - base) : 0;
+
+			memcpy(ref, samples + base, nref * sizeof(float));
+			memset(ref + nref, 0, (fftlen - nref) * sizeof(float));
+			memcpy(sig, samples + base, nsig * sizeof(float));
+			memset(sig + nsig, 0, (fftlen - nsig) * sizeof(float));
+		}
+
+		m_forwardPlan->Forward(m_fftIn.data(), m_fftOut.data());
+
+		//Accumulate conj(ref) * sig
+		float* spectrum = m_spectrum.data();
+		const float* spectra = m_fftOut.data();
+		#pragma omp parallel for
+		for(size_t k=0; k<nouts; k++)
+		{
+			float re = 0;
+			float im = 0;
+			for(size_t j=0; j<batchsize; j++)
+			{
+				const float* a = spectra + (j*nouts + k)*2;
+				const float* b = spectra + ((batchsize + j)*nouts + k)*2;
+				re += a[0]*b[0] + a[1]*b[1];
+				im += a[0]*b[1] - a[1]*b[0];
+			}
+			spectrum[k*2] += re;
+			spectrum[k*2 + 1] += im;
+		}
+	}
+
+	//Back to the time domain. Inverse FFT isn't normalized so scale by 1/fftlen as well as the sample count
+	m_reversePlan->Reverse(m_spectrum.data(), m_correlation.data());
+	float scale = 1.0 / (static_cast<double>(fftlen) * end);
+	for(size_t delta=1; delta <= range; delta++)
+		out[delta-1] = m_correlation[delta] * scale;
 }
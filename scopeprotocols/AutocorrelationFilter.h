@@ -35,6 +35,15 @@
 #ifndef AutocorrelationFilter_h
 #define AutocorrelationFilter_h
 
+#include "CPUFFTPlan.h"
+
+/**
+	@brief Autocorrelation of a uniformly sampled waveform over a range of lags
+
+	Short lag ranges are computed directly (one SIMD dot product per lag, lags spread across threads). Longer ranges
+	use the Wiener-Khinchin theorem: the input is split into overlapping blocks, and the cross spectra of all blocks are
+	summed in the frequency domain so only one inverse FFT is needed. The cheaper of the two is picked automatically.
+ */
 class AutocorrelationFilter : public Filter
 {
 public:
@@ -49,7 +58,29 @@ public:
 	PROTOCOL_DECODER_INITPROC(AutocorrelationFilter)
 
 protected:
+	static size_t GetFFTBlockSize(size_t len, size_t range);
+	static void CorrelateDirect(const float* samples, size_t end, size_t range, float* out);
+	void CorrelateFFT(const float* samples, size_t len, size_t end, size_t range, float* out);
+
 	std::string m_maxDeltaName;
+
+	///@brief Batched forward FFT of input blocks
+	std::unique_ptr<CPUFFTPlan> m_forwardPlan;
+
+	///@brief Inverse FFT of the accumulated cross spectrum
+	std::unique_ptr<CPUFFTPlan> m_reversePlan;
+
+	///@brief Time domain input blocks for the FFT path
+	std::vector<float> m_fftIn;
+
+	///@brief Frequency domain blocks for the FFT path
+	std::vector<float> m_fftOut;
+
+	///@brief Accumulated cross spectrum
+	std::vector<float> m_spectrum;
+
+	///@brief Inverse FFT output
+	std::vector<float> m_correlation;
 };
 
 #endif
@@ -145,6 +145,8 @@ bool AverageFilter::ValidateChannel(size_t i, StreamDescriptor stream)
 
 void AverageFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	m_pastSum = 0;
 	m_pastCount = 0;
 
@@ -138,7 +138,7 @@ void BaseMeasurement::Refresh(
 
 	//GPU side histogram calculation
 	size_t nbins = 128;
-	if(g_hasShaderInt64 && g_hasShaderAtomicInt64)
+	if(g_gpuFilterEnabled && g_hasShaderInt64 && g_hasShaderAtomicInt64)
 	{
 		if(sin)
 			MakeHistogram(cmdBuf, queue, *m_histogramPipeline, sin, m_histogramBuf, vmin, vmax, nbins);
@@ -150,6 +150,7 @@ void BaseMeasurement::Refresh(
 	else
 	{
 		PrepareForCpuAccess(sin, uin);
+		m_histogramBuf.resize(nbins);
 		m_histogramBuf.PrepareForCpuAccess();
 
 		auto hist = MakeHistogram(sin, uin, vmin, vmax, nbins);
@@ -182,7 +183,7 @@ void BaseMeasurement::Refresh(
 	//GPU side inner loop
 	//TODO: support sparse
 	const uint32_t nthreads = 4096;
-	if(g_hasShaderInt64 && uin)
+	if(g_gpuFilterEnabled && g_hasShaderInt64 && uin)
 	{
 		float range = (vmax - vmin);
 
@@ -251,7 +252,7 @@ void BaseMeasurement::Refresh(
 		InnerLoop(uin, cap, len, vmin, vmax, fbin);
 
 	//GPU average postprocessing
-	if(g_hasShaderInt64 && uin)
+	if(g_gpuFilterEnabled && g_hasShaderInt64 && uin)
 	{
 		double sum = 0;
 		for(size_t i=0; i<nthreads; i++)
@@ -31,6 +31,8 @@
 #include "CSVExportFilter.h"
 
 #include <cinttypes>
+#include <charconv>
+#include <queue>
 
 using namespace std;
 
@@ -93,6 +95,38 @@ string CSVExportFilter::GetProtocolName()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Actual decoder logic
 
+/**
+	@brief Appends a string to an output buffer
+ */
+static void AppendString(vector<char>& buf, const string& str)
+{
+	buf.insert(buf.end(), str.begin(), str.end());
+}
+
+/**
+	@brief Appends a number to an output buffer, in the shortest form which round-trips exactly
+
+	Unlike printf this is locale independent, so the output is always valid CSV.
+ */
+template<class T>
+static void AppendNumber(vector<char>& buf, T value)
+{
+	char tmp[64];
+
+	//Apple's libc++ has no floating point to_chars on older OS versions
+	#ifdef __APPLE__
+		int len;
+		if constexpr(is_floating_point_v<T>)
+			len = snprintf(tmp, sizeof(tmp), "%.*g", numeric_limits<T>::max_digits10, static_cast<double>(value));
+		else
+			len = snprintf(tmp, sizeof(tmp), "%" PRId64, static_cast<int64_t>(value));
+		buf.insert(buf.end(), tmp, tmp + len);
+	#else
+		auto result = to_chars(tmp, tmp + sizeof(tmp), value);
+		buf.insert(buf.end(), tmp, result.ptr);
+	#endif
+}
+
 void CSVExportFilter::Export()
 {
 	#ifdef HAVE_NVTX
@@ -106,8 +140,14 @@ void CSVExportFilter::Export()
 		return;
 	}
 
+	//Make sure the previous export is fully on disk before we look at the file
+	m_writer.Flush();
+	if(m_writer.GetAndClearError())
+		AddErrorMessage("Write failed", "Failed to write some data from the previous export to the output file");
+
 	//If file is not open, open it and write a header row
 	Unit xunit = GetInput(0).GetXAxisUnits();
+	auto buf = m_writer.GetBuffer();
 	if(!m_fp)
 	{
 		auto mode = static_cast<ExportMode_t>(m_parameters[m_mode].GetIntVal());
@@ -117,118 +157,176 @@ void CSVExportFilter::Export()
 			m_fp = fopen(m_parameters[m_fname].GetFileName().c_str(), "ab");
 		else
 			m_fp = fopen(m_parameters[m_fname].GetFileName().c_str(), "wb");
+		if(!m_fp)
+		{
+			AddErrorMessage("File error", "Couldn't open the output file");
+			return;
+		}
 
 		//See if file is empty. If so, write header
 		fseek(m_fp, 0, SEEK_END);
 		if(ftell(m_fp) == 0)
 		{
 			if(xunit == Unit(Unit::UNIT_FS))
-				fprintf(m_fp, "Time (s)");
+				AppendString(buf, "Time (s)");
 			else if(xunit == Unit(Unit::UNIT_HZ))
-				fprintf(m_fp, "Frequency (Hz)");
+				AppendString(buf, "Frequency (Hz)");
 			else
-				fprintf(m_fp, "X Unit");
+				AppendString(buf, "X Unit");
 
 			//Write other fields
 			for(size_t i=0; i<GetInputCount(); i++)
 			{
 				string colname = GetInput(i).GetName();
 				colname = str_replace(",", "_", colname);
-				fprintf(m_fp, ",%s", colname.c_str());
+				buf.push_back(',');
+				AppendString(buf, colname);
 			}
-			fprintf(m_fp, "\n");
+			buf.push_back('\n');
 		}
 	}
 
-	//Pre-cast some waveforms so we don't have to do it a lot
-	std::vector<SparseWaveformBase*> sparse;
-	std::vector<UniformWaveformBase*> uniform;
-	std::vector<SparseAnalogWaveform*> sa;
-	std::vector<UniformAnalogWaveform*> ua;
-	std::vector<SparseDigitalWaveform*> sd;
-	std::vector<UniformDigitalWaveform*> ud;
-	std::vector<size_t> indexes;
-	std::vector<size_t> lens;
-	for(size_t i=0; i<GetInputCount(); i++)
+	//Pre-cast and index all of the inputs so the main loop doesn't have to
+	size_t ninputs = GetInputCount();
+	vector<SparseWaveformBase*> sparse(ninputs);
+	vector<UniformWaveformBase*> uniform(ninputs);
+	vector<const float*> analog(ninputs, nullptr);
+	vector<const bool*> digital(ninputs, nullptr);
+	vector<const int64_t*> offsets(ninputs, nullptr);
+	vector<Stream::StreamType> types(ninputs);
+	vector<size_t> indexes(ninputs, 0);
+	vector<size_t> lens(ninputs);
+	for(size_t i=0; i<ninputs; i++)
 	{
 		auto data = GetInput(i).GetData();
-		sparse.push_back(dynamic_cast<SparseWaveformBase*>(data));
-		uniform.push_back(dynamic_cast<UniformWaveformBase*>(data));
-		sa.push_back(dynamic_cast<SparseAnalogWaveform*>(data));
-		ua.push_back(dynamic_cast<UniformAnalogWaveform*>(data));
-		sd.push_back(dynamic_cast<SparseDigitalWaveform*>(data));
-		ud.push_back(dynamic_cast<UniformDigitalWaveform*>(data));
-		indexes.push_back(0);
-		lens.push_back(data->size());
+		data->PrepareForCpuAccess();
+		types[i] = GetInput(i).GetType();
+		sparse[i] = dynamic_cast<SparseWaveformBase*>(data);
+		uniform[i] = dynamic_cast<UniformWaveformBase*>(data);
+		lens[i] = data->size();
+		if(sparse[i])
+			offsets[i] = sparse[i]->m_offsets.GetCpuPointer();
+
+		if(auto sa = dynamic_cast<SparseAnalogWaveform*>(data))
+			analog[i] = sa->m_samples.GetCpuPointer();
+		else if(auto ua = dynamic_cast<UniformAnalogWaveform*>(data))
+			analog[i] = ua->m_samples.GetCpuPointer();
+		else if(auto sd = dynamic_cast<SparseDigitalWaveform*>(data))
+			digital[i] = sd->m_samples.GetCpuPointer();
+		else if(auto ud = dynamic_cast<UniformDigitalWaveform*>(data))
+			digital[i] = ud->m_samples.GetCpuPointer();
 	}
 
-	//Main export path
-	int64_t timestamp = INT64_MIN;
-	bool first = true;
-	while(true)
+	//Timestamp of a given sample on an input, in native X axis units
+	auto sampleTime = [&](size_t i, size_t j) -> int64_t
 	{
-		//TODO: handle some waveforms starting earlier than others? we should print empty values prior to the first sample
-		//TODO: handle gaps between events
-
-		//Find next edge on any input
-		int64_t next = INT64_MAX;
-		for(size_t i=0; i<GetInputCount(); i++)
-			next = min(next, GetNextEventTimestampScaled(sparse[i], uniform[i], indexes[i], lens[i], timestamp));
-
-		//If we can't advance any more, we're done
-		if( (next == INT64_MAX) || (next == timestamp) )
-			break;
+		auto w = sparse[i] ? static_cast<WaveformBase*>(sparse[i]) : static_cast<WaveformBase*>(uniform[i]);
+		int64_t off = offsets[i] ? offsets[i][j] : static_cast<int64_t>(j);
+		return off * w->m_timescale + w->m_triggerPhase;
+	};
+
+	/*
+		Rows are generated by a k-way merge of the sample timestamps of all inputs. The heap holds the timestamp of the
+		next sample of each input, so each row only touches the inputs which actually have a new sample.
+
+		Output ends as soon as any input runs out of samples.
+		TODO: handle some waveforms starting earlier than others? we should print empty values prior to the first sample
+		TODO: handle gaps between events
+	 */
+	typedef pair<int64_t, size_t> event;
+	priority_queue<event, vector<event>, greater<event>> pending;
+	bool done = false;
+	for(size_t i=0; i<ninputs; i++)
+	{
+		if(lens[i] < 2)
+			done = true;
+		else
+			pending.push(event(sampleTime(i, 1), i));
+	}
+	if(pending.empty())
+		done = true;
 
-		//First iteration is just indexing
+	//First event is just indexing: the first row printed is at the earliest second sample of any input
+	int64_t timestamp = 0;
+	bool first = true;
+	while(!done)
+	{
 		if(!first)
 		{
 			//Write timestamp
 			if(xunit == Unit(Unit::UNIT_FS))
-				fprintf(m_fp, "%.10e", timestamp / FS_PER_SECOND);
-			else if(xunit == Unit(Unit::UNIT_HZ))
-				fprintf(m_fp, "%" PRId64 "", timestamp);
+				AppendNumber(buf, timestamp / FS_PER_SECOND);
 			else
-				fprintf(m_fp, "%" PRId64 "", timestamp);
+				AppendNumber(buf, timestamp);
 
 			//Write values
-			for(size_t i=0; i<GetInputCount(); i++)
+			for(size_t i=0; i<ninputs; i++)
 			{
-				switch(GetInput(i).GetType())
+				buf.push_back(',');
+				size_t j = indexes[i];
+				switch(types[i])
 				{
 					case Stream::STREAM_TYPE_ANALOG:
-					fprintf(m_fp, ",%f", GetValue(sa[i], ua[i], indexes[i]));
-					break;
+						AppendNumber(buf, analog[i][j]);
+						break;
 
 					case Stream::STREAM_TYPE_DIGITAL:
-						fprintf(m_fp, ",%d", GetValue(sd[i], ud[i], indexes[i]));
+						buf.push_back(digital[i][j] ? '1' : '0');
 						break;
 
 					case Stream::STREAM_TYPE_PROTOCOL:
 						if(sparse[i])
-							fprintf(m_fp, ",%s", sparse[i]->GetText(indexes[i]).c_str());
+							AppendString(buf, sparse[i]->GetText(j));
 						else
-							fprintf(m_fp, ",%s", uniform[i]->GetText(indexes[i]).c_str());
+							AppendString(buf, uniform[i]->GetText(j));
 						break;
 
 					default:
-						fprintf(m_fp, ",%s", "[unimplemented]");
+						AppendString(buf, "[unimplemented]");
 						break;
 				}
 			}
-			fprintf(m_fp, "\n");
+			buf.push_back('\n');
+
+			//Hand off full buffers to the writer thread
+			if(buf.size() >= AsyncFileWriter::BUFFER_SIZE)
+			{
+				m_writer.Write(m_fp, std::move(buf));
+				buf = m_writer.GetBuffer();
+			}
 		}
 		first = false;
 
-		//All good, move on
-		timestamp = next;
-		for(size_t i=0; i<GetInputCount(); i++)
-			AdvanceToTimestampScaled(sparse[i], uniform[i], indexes[i], lens[i], timestamp);
+		//Advance every input which has a sample at the next timestamp
+		timestamp = pending.top().first;
+		while(!pending.empty() && (pending.top().first <= timestamp) )
+		{
+			size_t i = pending.top().second;
+			pending.pop();
+
+			while( (indexes[i] + 1 < lens[i]) && (sampleTime(i, indexes[i] + 1) <= timestamp) )
+				indexes[i] ++;
+
+			if(indexes[i] + 1 < lens[i])
+				pending.push(event(sampleTime(i, indexes[i] + 1), i));
+			else
+				done = true;
+		}
 	}
 
-	fclose(m_fp);
+	//Writer thread closes the file once everything has been written
+	m_writer.Write(m_fp, std::move(buf));
+	m_writer.Close(m_fp);
 	m_fp = nullptr;
 }
 
+void CSVExportFilter::Clear()
+{
+	//Don't truncate the file out from under a write in progress
+	m_writer.Flush();
+	ExportFilter::Clear();
+}
+
 void CSVExportFilter::OnColumnCountChanged()
 {
 	//Close the existing file
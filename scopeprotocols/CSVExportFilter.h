@@ -36,6 +36,7 @@
 #define CSVExportFilter_h
 
 #include "ExportFilter.h"
+#include "../scopehal/AsyncFileWriter.h"
 
 class CSVExportFilter : public ExportFilter
 {
@@ -50,10 +51,14 @@ public:
 
 protected:
 	virtual void Export() override;
+	virtual void Clear() override;
 
 	void OnColumnCountChanged();
 
 	std::string m_inputCount;
+
+	///@brief Background thread which writes formatted rows to disk
+	AsyncFileWriter m_writer;
 };
 
 #endif
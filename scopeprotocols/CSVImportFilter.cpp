@@ -29,7 +29,9 @@
 
 #include "../scopehal/scopehal.h"
 #include "CSVImportFilter.h"
+#include "../scopehal/MappedFile.h"
 #include <charconv>
+#include <omp.h>
 
 using namespace std;
 
@@ -109,83 +111,58 @@ void CSVImportFilter::OnFileNameChanged()
 
 	double start = GetTime();
 
-	//Read the entire file into a buffer
-	//Read it as binary because "read whole file" is problematic in text mode
-	//since length can change and we'll get less than we asked for
-	//(see https://github.com/ngscopeclient/scopehal/issues/1002)
-	FILE* fp = fopen(fname.c_str(), "rb");
-	if(!fp)
+	//Map the file rather than reading it, so multi-GB files don't need a giant heap buffer
+	MappedFile file;
+	if(!file.Open(fname))
 	{
 		AddErrorMessage("Bad file", string("Failed to open file ") + fname);
 		return;
 	}
-	fseek(fp, 0, SEEK_END);
-	size_t flen = ftell(fp);
-	fseek(fp, 0, SEEK_SET);
-	char* buf = new char[flen+1];
-	if(flen != fread(buf, 1, flen, fp))
-	{
-		AddErrorMessage("Bad file", string("Failed to read contents of file ") + fname);
-		return;
-	}
-	buf[flen] = '\0';	//guarantee null termination at end of file
-	fclose(fp);
+	const char* pbuf = file.data();
+	const char* pend = file.end();
 
 	ClearStreams();
 
-	//Read the file
-	//More natural implementation is lots of lines, but that's expensive. Columnar structure has less allocations
-	vector<string> names;
-	vector< vector<char*> > vcolumns;
-	vector<int64_t> timestamps;
-	bool digilentFormat;
-	size_t nrow = 0;
-	size_t ncols = 0;
-	char* pbuf = buf;
-	char* pend = buf + flen;
-	bool xUnitIsFs = m_parameters[m_xunit].GetIntVal() == Unit::UNIT_FS;
-	while(true)
+	//Lines normally end in \n (possibly preceded by \r). Handle bare \r line endings too.
+	char eol = '\n';
+	for(const char* p = pbuf; p < pend; p++)
 	{
-		nrow ++;
-
-		//Stop if at end of file
-		char* pline = pbuf;
-		if(pline >= pend)
+		if(*p == '\n')
 			break;
-
-		//Find first non-blank character in the current line
-		while(isspace(*pline))
-			pline ++;
-
-		//If it's a newline or nul, the line was blank - discard it
-		if( (*pline == '\0') || (*pline == '\n') || (*pline == '\r') )
+		if(*p == '\r')
 		{
-			pbuf ++;
-			continue;
+			if( (p+1 == pend) || (p[1] != '\n') )
+				eol = '\r';
+			break;
 		}
+	}
 
-		//Search until we find the end of the line, then trim the trailing newline if there is one
-		size_t slen = 0;
-		for(; (pline + slen) < pend; slen++)
-		{
-			if(pline[slen] == '\0')
-				break;
-			if( (pline[slen] == '\n') || (pline[slen] == '\r') )
-			{
-				pline[slen] = '\0';
-				break;
-			}
-		}
-		pbuf += slen;
+	//Walk the preamble single threaded: comments, metadata, and the optional header row.
+	//Stop at the first line of actual data.
+	vector<string> names;
+	bool digilentFormat = false;
+	bool seenContent = false;
+	const char* dataStart = pend;
+	const char* p = pbuf;
+	while(p < pend)
+	{
+		const char* pline = p;
+		const char* nl = static_cast<const char*>(memchr(p, eol, pend - p));
+		const char* lend = nl ? nl : pend;
+		p = nl ? (nl + 1) : pend;
 
-		//Skip blank lines (we hit this in files with \r\n line endings)
-		if(slen <= 1)
+		//Trim leading whitespace and trailing line ending characters, then discard blank lines
+		while( (pline < lend) && isspace(*pline) )
+			pline ++;
+		while( (lend > pline) && ( (lend[-1] == '\r') || (lend[-1] == '\n') ) )
+			lend --;
+		if(pline == lend)
 			continue;
+		string s(pline, lend);
 
 		//If the line starts with a #, it's a comment. Discard it, but save timestamp metadata if present
-		if(pline[0] == '#')
+		if(s[0] == '#')
 		{
-			string s = pline;
 			if(s == "#Digilent WaveForms Oscilloscope Acquisition")
 			{
 				digilentFormat = true;
@@ -235,173 +212,193 @@ void CSVImportFilter::OnFileNameChanged()
 			continue;
 		}
 
-		//Parse into 2D vector of timestamps and strings
-		size_t fieldstart = 0;
-		bool foundTimestamp = false;
-		vector<string> headerfields;
-		bool headerRow = false;
-		size_t ncol = 0;
-		for(size_t i=0; i<=slen; i++)
+		//If the first non-comment line has anything but numbers in it, it's a header row
+		if(!seenContent)
 		{
-			//End of field
-			if( (pline[i] == ',') || (pline[i] == '\n') || (pline[i] == '\r') || (pline[i] == '\0') )
-			{
-				//If this is the first row, check if it's numeric
-				if(names.empty() && timestamps.empty())
-				{
-					//See if it's a header row
-					if(!headerRow)
-					{
-						for(size_t j=0; pline[j] != '\0'; j++)
-						{
-							auto c = pline[j];
-							if(	!isdigit(c) && !isspace(c) &&
-								(c != ',') && (c != '.') && (c != '-') && (c != 'e') && (c != '+'))
-							{
-								headerRow = true;
-								auto trimline = Trim(pline);
-								LogTrace("Found header row: %s\n", trimline.c_str());
-								break;
-							}
-						}
-					}
+			seenContent = true;
 
-					//Save the header values
-					if(headerRow)
-					{
-						string s(pline);
-						headerfields.push_back(s.substr(fieldstart, i-fieldstart));
-					}
-				}
-
-				//If this is a header row, don't also try to parse it as a timestamp
-				if(headerRow)
+			bool headerRow = false;
+			for(auto c : s)
+			{
+				if(	!isdigit(c) && !isspace(c) &&
+					(c != ',') && (c != '.') && (c != '-') && (c != 'e') && (c != '+'))
 				{
-					//Start a new field
-					fieldstart = i+1;
-					continue;
+					headerRow = true;
+					break;
 				}
+			}
 
-				//Replace the delimiter with a nul
-				pline[i] = '\0';
+			if(headerRow)
+			{
+				LogTrace("Found header row: %s\n", Trim(s).c_str());
 
-				//Load timestamp
-				if(!foundTimestamp)
+				//Save the header values, minus the name of the timestamp column
+				size_t fieldstart = 0;
+				while(true)
 				{
-					foundTimestamp = true;
-
-					//Parse time to a float and convert to fs
-					if(xUnitIsFs)
-					{
-						//TODO: use fastfloat lib here
-						#ifdef __APPLE__
-							timestamps.push_back(FS_PER_SECOND * strtof(pline+i, nullptr));
-						#else
-							float tmp;
-							from_chars(pline+fieldstart, pline+i, tmp, std::chars_format::general);
-							timestamps.push_back(FS_PER_SECOND * tmp);
-						#endif
-					}
-
-					//other units are as-is
-					else
-						timestamps.push_back(strtoll(pline+fieldstart, nullptr, 10));
+					size_t comma = s.find(',', fieldstart);
+					if(fieldstart != 0)
+						names.push_back(s.substr(fieldstart, comma - fieldstart));
+					if(comma == string::npos)
+						break;
+					fieldstart = comma + 1;
 				}
+				continue;
+			}
+		}
 
-				//Data field. Save it
-				else
-				{
-					if(vcolumns.size() <= ncol)
-						vcolumns.resize(ncol+1);
-					vcolumns[ncol].push_back(pline+fieldstart);
+		//First line of actual data
+		dataStart = pline;
+		break;
+	}
 
-					ncol ++;
-				}
+	//Column count is set by the first line of data (minus the timestamp)
+	const char* pline;
+	const char* lend;
+	p = dataStart;
+	if(!NextDataLine(p, pend, eol, pline, lend))
+		return;
+	size_t ncols = count(pline, lend, ',');
+	if(ncols == 0)
+		return;
 
-				//Start a new field
-				fieldstart = i+1;
-			}
-		}
-		if(fieldstart < slen)
+	//Assume digital, then change to analog if we see anything other than a 0/1 in the first 10 lines
+	vector<bool> digital(ncols, true);
+	p = dataStart;
+	for(size_t j=0; (j < 10) && NextDataLine(p, pend, eol, pline, lend); j++)
+	{
+		//Skip the timestamp
+		const char* field = static_cast<const char*>(memchr(pline, ',', lend - pline));
+		for(size_t i=0; (i < ncols) && field; i++)
 		{
-			if(vcolumns.size() <= ncol)
-				vcolumns.resize(ncol+1);
-			vcolumns[ncol].push_back(pline+fieldstart);
+			field ++;
+			const char* fend = static_cast<const char*>(memchr(field, ',', lend - field));
+			if(!fend)
+				fend = lend;
 
-			ncol ++;
-		}
+			if( (fend - field != 1) || ( (field[0] != '0') && (field[0] != '1') ) )
+				digital[i] = false;
 
-		//Header row gets special treatment
-		if(headerRow)
-		{
-			//delete name of timestamp column
-			headerfields.erase(headerfields.begin());
-			names = headerfields;
-			continue;
+			field = (fend == lend) ? nullptr : fend;
 		}
+	}
 
-		//Sanity check field count
-		if(ncols == 0)
-			ncols = ncol;
-		else if(ncol != ncols)
+	//Split the data into blocks on line boundaries, enough to keep every core busy
+	const size_t minChunkSize = 4 * 1024 * 1024;
+	size_t dataLen = pend - dataStart;
+	size_t nchunks = min(dataLen / minChunkSize + 1, static_cast<size_t>(omp_get_max_threads() * 4));
+	vector<Chunk> chunks(nchunks);
+	const char* chunkStart = dataStart;
+	for(size_t i=0; i<nchunks; i++)
+	{
+		const char* chunkEnd = pend;
+		if(i+1 < nchunks)
 		{
-			AddErrorMessage("Malformed file",
-				string("Line ") + to_string(nrow) + " contains " + to_string(ncol) + " fields, but file started with " +
-				to_string(ncols) + " fields");
-			return;
+			chunkEnd = max(chunkStart, dataStart + (dataLen * (i+1)) / nchunks);
+			const char* nl = static_cast<const char*>(memchr(chunkEnd, eol, pend - chunkEnd));
+			chunkEnd = nl ? (nl + 1) : pend;
 		}
+
+		chunks[i].m_start = chunkStart;
+		chunks[i].m_end = chunkEnd;
+		chunkStart = chunkEnd;
 	}
 
-	if(ncols == 0)
-		return;
-	size_t nrows = min(vcolumns[0].size(), timestamps.size());
+	//First pass: count rows in each block so every block knows where its output goes
+	#pragma omp parallel for schedule(dynamic)
+	for(size_t i=0; i<nchunks; i++)
+		chunks[i].m_rows = CountDataLines(chunks[i].m_start, chunks[i].m_end, eol);
+
+	size_t nrows = 0;
+	for(auto& c : chunks)
+	{
+		c.m_firstRow = nrows;
+		nrows += c.m_rows;
+	}
+	LogTrace("Found %zu lines, %zu columns, %zu names, %zu blocks\n", nrows, ncols, names.size(), nchunks);
 
 	//Assign default names to channels if there's no header row or not enough names
-	LogTrace("Initial parsing completed, %zu lines, %zu columns, %zu names, %zu timestamps\n",
-		nrows, ncols, names.size(), timestamps.size());
 	for(size_t i=0; i<ncols; i++)
 	{
 		if(names.size() <= i)
 			names.push_back(string("Field") + to_string(i));
 	}
 
-	//Figure out if channels are analog or digital and create output streams/waveforms
-	vector<SparseDigitalWaveform*> digwaves;
-	vector<SparseAnalogWaveform*> anwaves;
+	//Parse sample data straight into uniform waveforms, since that's what we almost always end up with.
+	//If the timebase turns out to be irregular we convert afterwards.
+	vector<WaveformBase*> waves;
+	vector<float*> analogSamples(ncols, nullptr);
+	vector<bool*> digitalSamples(ncols, nullptr);
 	for(size_t i=0; i<ncols; i++)
 	{
-		std::string color = colormap[i % colormap.size()];
-		LogIndenter li2;
-
-		//Assume digital, then change to analog if we see anything other than a 0/1 in the first 10 lines
-		bool digital = true;
-		for(size_t j=0; j<nrows && j<10; j++)
+		if(digital[i])
 		{
-			auto field = vcolumns[i][j];
-			if( (field[0] != '0' && field[0] != '1') || field[1] != '\0')
-			{
-				digital = false;
-				break;
-			}
+			auto wfm = new UniformDigitalWaveform;
+			wfm->Resize(nrows);
+			wfm->PrepareForCpuAccess();
+			digitalSamples[i] = wfm->m_samples.GetCpuPointer();
+			waves.push_back(wfm);
 		}
-
-		//Create the output stream
-		if(digital)
+		else
 		{
-			AddStreamColor(Unit(Unit::UNIT_COUNTS), names[i], Stream::STREAM_TYPE_DIGITAL, 0, color);
-
-			auto wfm = new SparseDigitalWaveform;
-			wfm->m_timescale = 1;
-			wfm->m_startTimestamp = timestamp;
-			wfm->m_startFemtoseconds = fs;
-			wfm->m_triggerPhase = 0;
+			auto wfm = new UniformAnalogWaveform;
 			wfm->Resize(nrows);
-			digwaves.push_back(wfm);
-
-			//no analog waveform
-			anwaves.push_back(nullptr);
-			SetData(wfm, i);
+			wfm->PrepareForCpuAccess();
+			analogSamples[i] = wfm->m_samples.GetCpuPointer();
+			waves.push_back(wfm);
 		}
+	}
+	vector<int64_t> timestamps(nrows);
+
+	//Second pass: parse every block in parallel
+	bool xUnitIsFs = m_parameters[m_xunit].GetIntVal() == Unit::UNIT_FS;
+	#pragma omp parallel for schedule(dynamic)
+	for(size_t i=0; i<nchunks; i++)
+		ParseChunk(chunks[i], eol, ncols, xUnitIsFs, timestamps.data(), analogSamples, digitalSamples);
+
+	//Report the first malformed line, if any
+	for(auto& c : chunks)
+	{
+		if(!c.m_badLine)
+			continue;
+
+		size_t line = count(pbuf, c.m_badLine, eol) + 1;
+		AddErrorMessage("Malformed file",
+			string("Line ") + to_string(line) + " contains " + to_string(c.m_badFieldCount) +
+			" fields, but file started with " + to_string(ncols) + " fields");
+
+		for(auto w : waves)
+			delete w;
+		return;
+	}
+
+	//Merge interval statistics across block boundaries.
+	//The last sample's duration is a copy of the previous one, so count that interval twice.
+	IntervalStats intervals;
+	bool first = true;
+	int64_t prevTimestamp = 0;
+	for(auto& c : chunks)
+	{
+		if(c.m_rows == 0)
+			continue;
+		if(!first)
+			intervals.Add(c.m_firstTimestamp - prevTimestamp);
+		intervals.Merge(c.m_intervals);
+		prevTimestamp = c.m_lastTimestamp;
+		first = false;
+	}
+	if(nrows >= 2)
+		intervals.Add(timestamps[nrows-1] - timestamps[nrows-2]);
+
+	//Create output streams and final waveforms
+	uint64_t timescale = 0;
+	bool uniform = (nrows >= 2) && IsTimebaseUniform(intervals, timescale);
+	for(size_t i=0; i<ncols; i++)
+	{
+		std::string color = colormap[i % colormap.size()];
+
+		if(digital[i])
+			AddStreamColor(Unit(Unit::UNIT_COUNTS), names[i], Stream::STREAM_TYPE_DIGITAL, 0, color);
 		else
 		{
 			//TODO: support arbitrarily many y axis unit fields, for now use unit 0 for everything
@@ -411,115 +408,72 @@ void CSVImportFilter::OnFileNameChanged()
 				Stream::STREAM_TYPE_ANALOG,
 				0,
 				color);
-
-			auto wfm = new SparseAnalogWaveform;
-			wfm->m_timescale = 1;
-			wfm->m_startTimestamp = timestamp;
-			wfm->m_startFemtoseconds = fs;
-			wfm->m_triggerPhase = 0;
-			wfm->Resize(nrows);
-			anwaves.push_back(wfm);
-
-			//no digital waveform
-			digwaves.push_back(nullptr);
-			SetData(wfm, i);
 		}
-	}
-
-	m_outputsChangedSignal.emit();
-
-	float max_range = 0.0;
-	float max_offset = 0.0;
 
-	//Process each actual waveform and figure out how to handle it
-	for(size_t i=0; i<ncols; i++)
-	{
-		if(digwaves[i])
+		WaveformBase* wfm = waves[i];
+		if(uniform)
 		{
-			auto wfm = digwaves[i];
-
-			//Read the sample data
-			for(size_t j=0; j<nrows; j++)
-			{
-				wfm->m_offsets[j] = timestamps[j];
-
-				//Last one? copy previous sample duration
-				if(j+1 == nrows)
-					wfm->m_durations[j] = wfm->m_durations[j-1];
-
-				//Set sample duration of previous sample
-				if(j > 0)
-					wfm->m_durations[j-1] = wfm->m_offsets[j] - wfm->m_offsets[j-1];
-
-				//Read waveform data
-				if(vcolumns[i][j][0] == '1')
-					wfm->m_samples[j] = true;
-				else
-					wfm->m_samples[j] = false;
-			}
+			//Use time zero as the trigger phase
+			wfm->m_timescale = timescale;
+			wfm->m_triggerPhase = timestamps[0];
+		}
 
-			if(TryNormalizeTimebase(wfm))
+		//Irregular timebase, move samples into a sparse waveform
+		else
+		{
+			SparseWaveformBase* swfm;
+			if(digital[i])
 			{
-				auto dense = new UniformDigitalWaveform(*wfm);
-				dense->MarkModifiedFromCpu();
-				SetData(dense, i);
+				auto sdig = new SparseDigitalWaveform;
+				sdig->Resize(nrows);
+				sdig->m_samples.CopyFrom(static_cast<UniformDigitalWaveform*>(wfm)->m_samples);
+				swfm = sdig;
 			}
 			else
 			{
-				wfm->MarkModifiedFromCpu();
-
-				//If we end up with zero length samples due to invalid configuration, nuke the channel
-				if(wfm->empty() || (wfm->m_durations[0] == 0) )
-					SetData(nullptr, i);
+				auto sanalog = new SparseAnalogWaveform;
+				sanalog->Resize(nrows);
+				sanalog->m_samples.CopyFrom(static_cast<UniformAnalogWaveform*>(wfm)->m_samples);
+				swfm = sanalog;
 			}
-		}
-
-		//Analog data
-		else
-		{
-			auto wfm = anwaves[i];
+			delete wfm;
+			wfm = swfm;
+			wfm->m_timescale = 1;
+			wfm->m_triggerPhase = 0;
 
-			//Read the sample data
+			swfm->PrepareForCpuAccess();
+			int64_t* offsets = swfm->m_offsets.GetCpuPointer();
+			int64_t* durations = swfm->m_durations.GetCpuPointer();
+			#pragma omp parallel for if(nrows > 1000000)
 			for(size_t j=0; j<nrows; j++)
 			{
-				wfm->m_offsets[j] = timestamps[j];
-
-				//Last one? copy previous sample duration
-				if(j+1 == nrows)
-					wfm->m_durations[j] = wfm->m_durations[j-1];
-
-				//Set sample duration of previous sample
-				if(j > 0)
-					wfm->m_durations[j-1] = wfm->m_offsets[j] - wfm->m_offsets[j-1];
-
-				//Read waveform data
-				//TODO: faster to save length in vcolumns vs recomputing here?
-				float tmp;
-				const char* vline = vcolumns[i][j];
-				#ifdef __APPLE__
-					tmp = strtof(vline, nullptr);
-				#else
-					from_chars(vline, vline+strlen(vline), tmp, std::chars_format::general);
-				#endif
-				wfm->m_samples[j] = tmp;
+				offsets[j] = timestamps[j];
+				if(j+1 < nrows)
+					durations[j] = timestamps[j+1] - timestamps[j];
+				else if(j > 0)
+					durations[j] = timestamps[j] - timestamps[j-1];
+				else
+					durations[j] = 1;
 			}
+		}
 
-			if(TryNormalizeTimebase(wfm))
-			{
-				auto dense = new UniformAnalogWaveform(*wfm);
-				dense->MarkModifiedFromCpu();
-				SetData(dense, i);
-			}
-			else
-			{
-				wfm->MarkModifiedFromCpu();
+		wfm->m_startTimestamp = timestamp;
+		wfm->m_startFemtoseconds = fs;
+		wfm->MarkModifiedFromCpu();
+		SetData(wfm, i);
 
-				//If we end up with zero length samples due to invalid configuration, nuke the channel
-				if(wfm->m_durations[0] == 0)
-					SetData(nullptr, i);
-			}
-		}
+		//If we end up with zero length samples due to invalid configuration, nuke the channel
+		auto swfm = dynamic_cast<SparseWaveformBase*>(wfm);
+		if(swfm && (swfm->m_durations[0] == 0) )
+			SetData(nullptr, i);
+	}
+
+	m_outputsChangedSignal.emit();
 
+	float max_range = 0.0;
+	float max_offset = 0.0;
+	for(size_t i=0; i<ncols; i++)
+	{
 		AutoscaleVertical(i);
 		if (max_range < GetVoltageRange(i))
 		{
@@ -528,7 +482,6 @@ void CSVImportFilter::OnFileNameChanged()
 		}
 	}
 
-	// Process each actual waveform and figure out how to handle it
 	for (size_t i = 0; i < ncols; i++)
 	{
 		SetOffset(max_offset, i);
@@ -536,7 +489,169 @@ void CSVImportFilter::OnFileNameChanged()
 	}
 
 	double dt = GetTime() - start;
-	LogTrace("CSV loading took %.3f sec\n", dt);
+	LogTrace("CSV loading took %.3f sec (%.1f MB/s)\n", dt, file.size() / (dt * 1024 * 1024));
+}
 
-	delete[] buf;
+/**
+	@brief Finds the next line of data (not blank or a comment) in a block of the file
+
+	@param p		Current position, advanced past the returned line
+	@param end		End of the block
+	@param eol		Line ending character
+	@param line		Start of the line, with leading whitespace trimmed
+	@param lineEnd	End of the line, with trailing line ending characters trimmed
+
+	@return True if a line was found, false at the end of the block
+ */
+bool CSVImportFilter::NextDataLine(const char*& p, const char* end, char eol, const char*& line, const char*& lineEnd)
+{
+	while(p < end)
+	{
+		const char* pline = p;
+		const char* nl = static_cast<const char*>(memchr(p, eol, end - p));
+		const char* lend = nl ? nl : end;
+		p = nl ? (nl + 1) : end;
+
+		while( (pline < lend) && isspace(*pline) )
+			pline ++;
+		while( (lend > pline) && ( (lend[-1] == '\r') || (lend[-1] == '\n') ) )
+			lend --;
+
+		if( (pline == lend) || (*pline == '#') )
+			continue;
+
+		line = pline;
+		lineEnd = lend;
+		return true;
+	}
+	return false;
+}
+
+/**
+	@brief Counts the lines of data (not blank or comments) in a block of the file
+ */
+size_t CSVImportFilter::CountDataLines(const char* start, const char* end, char eol)
+{
+	size_t n = 0;
+	const char* line;
+	const char* lineEnd;
+	while(NextDataLine(start, end, eol, line, lineEnd))
+		n ++;
+	return n;
+}
+
+/**
+	@brief Parses a floating point value from a field, ignoring leading whitespace or '+'
+
+	Returns zero if the field is not a valid number.
+ */
+static inline double ParseCSVNumber(const char* start, const char* end)
+{
+	while( (start < end) && ( (*start == ' ') || (*start == '\t') || (*start == '+') ) )
+		start ++;
+
+	double ret = 0;
+	#ifdef __APPLE__
+		//No floating point from_chars. Fields are short, so copy to get a nul terminator for strtod
+		char tmp[64];
+		size_t len = min(static_cast<size_t>(end - start), sizeof(tmp) - 1);
+		memcpy(tmp, start, len);
+		tmp[len] = '\0';
+		ret = strtod(tmp, nullptr);
+	#else
+		from_chars(start, end, ret, std::chars_format::general);
+	#endif
+	return ret;
+}
+
+/**
+	@brief Parses an integer value from a field, ignoring leading whitespace or '+'
+
+	Returns zero if the field is not a valid number.
+ */
+static inline int64_t ParseCSVInteger(const char* start, const char* end)
+{
+	while( (start < end) && ( (*start == ' ') || (*start == '\t') || (*start == '+') ) )
+		start ++;
+
+	int64_t ret = 0;
+	from_chars(start, end, ret);
+	return ret;
+}
+
+/**
+	@brief Parses one block of the file into the output buffers
+
+	@param chunk			The block to parse. Row count and offset must already be filled out.
+	@param eol				Line ending character
+	@param ncols			Number of data columns (not counting the timestamp)
+	@param xUnitIsFs		True if timestamps are in seconds and need conversion to fs
+	@param timestamps		Timestamp of each row
+	@param analogSamples	Output sample buffer for each analog column, or null if the column is digital
+	@param digitalSamples	Output sample buffer for each digital column, or null if the column is analog
+ */
+void CSVImportFilter::ParseChunk(
+	Chunk& chunk,
+	char eol,
+	size_t ncols,
+	bool xUnitIsFs,
+	int64_t* timestamps,
+	const vector<float*>& analogSamples,
+	const vector<bool*>& digitalSamples)
+{
+	const char* p = chunk.m_start;
+	const char* line;
+	const char* lend;
+	size_t row = chunk.m_firstRow;
+	size_t rowEnd = row + chunk.m_rows;
+	for(; (row < rowEnd) && NextDataLine(p, chunk.m_end, eol, line, lend); row++)
+	{
+		//Timestamp is always the first field
+		const char* fend = static_cast<const char*>(memchr(line, ',', lend - line));
+		if(!fend)
+			fend = lend;
+
+		int64_t t;
+		if(xUnitIsFs)
+			t = llround(FS_PER_SECOND * ParseCSVNumber(line, fend));
+
+		//other units are as-is
+		else
+			t = ParseCSVInteger(line, fend);
+		timestamps[row] = t;
+
+		//Data fields
+		size_t col = 0;
+		while(fend != lend)
+		{
+			const char* field = fend + 1;
+			fend = static_cast<const char*>(memchr(field, ',', lend - field));
+			if(!fend)
+				fend = lend;
+
+			if(col < ncols)
+			{
+				if(analogSamples[col])
+					analogSamples[col][row] = ParseCSVNumber(field, fend);
+				else
+					digitalSamples[col][row] = (fend > field) && (field[0] == '1');
+			}
+			col ++;
+		}
+
+		//Sanity check field count
+		if(col != ncols)
+		{
+			chunk.m_badLine = line;
+			chunk.m_badFieldCount = col;
+			return;
+		}
+
+		//Keep running interval statistics so we can detect uniform sampling without another pass
+		if(row == chunk.m_firstRow)
+			chunk.m_firstTimestamp = t;
+		else
+			chunk.m_intervals.Add(t - chunk.m_lastTimestamp);
+		chunk.m_lastTimestamp = t;
+	}
 }
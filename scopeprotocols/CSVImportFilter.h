@@ -47,6 +47,63 @@ public:
 protected:
 	void OnFileNameChanged();
 
+	/**
+		@brief A block of the file, starting and ending on line boundaries, that is parsed by a single thread
+	 */
+	class Chunk
+	{
+	public:
+		Chunk()
+			: m_start(nullptr)
+			, m_end(nullptr)
+			, m_firstRow(0)
+			, m_rows(0)
+			, m_firstTimestamp(0)
+			, m_lastTimestamp(0)
+			, m_badLine(nullptr)
+			, m_badFieldCount(0)
+		{}
+
+		///@brief Start of the block
+		const char* m_start;
+
+		///@brief End of the block (exclusive)
+		const char* m_end;
+
+		///@brief Index of the first data row in this block
+		size_t m_firstRow;
+
+		///@brief Number of data rows in this block
+		size_t m_rows;
+
+		///@brief Timestamp of the first row in this block
+		int64_t m_firstTimestamp;
+
+		///@brief Timestamp of the last row in this block
+		int64_t m_lastTimestamp;
+
+		///@brief Intervals between consecutive rows within this block
+		IntervalStats m_intervals;
+
+		///@brief First line with the wrong number of fields, if any
+		const char* m_badLine;
+
+		///@brief Number of fields on m_badLine
+		size_t m_badFieldCount;
+	};
+
+	static bool NextDataLine(const char*& p, const char* end, char eol, const char*& line, const char*& lineEnd);
+	static size_t CountDataLines(const char* start, const char* end, char eol);
+
+	void ParseChunk(
+		Chunk& chunk,
+		char eol,
+		size_t ncols,
+		bool xUnitIsFs,
+		int64_t* timestamps,
+		const std::vector<float*>& analogSamples,
+		const std::vector<bool*>& digitalSamples);
+
 	std::string m_xunit;
 	std::string m_yunit0;
 };
@@ -109,8 +109,6 @@ void ClipFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHandle
 		return;
 	}
 
-	cmdBuf.begin({});
-
 	//Push constants
 	size_t len = din->size();
 	ClipFilterConstants cfg;
@@ -118,29 +116,61 @@ void ClipFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHandle
 	cfg.clipAbove = m_clipAbove.GetIntVal();
 	cfg.level = m_clipLevel.GetFloatVal();
 
-	//Set up output waveform and bind buffers
+	//Set up output waveform
+	AcceleratorBuffer<float>* inbuf;
+	AcceleratorBuffer<float>* outbuf;
 	if(sdin)
 	{
 		auto cap = SetupSparseOutputWaveform(sdin, 0, 0, 0);
-		m_computePipeline.BindBufferNonblocking(0, sdin->m_samples, cmdBuf);
-		m_computePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
-		cap->MarkSamplesModifiedFromGpu();
+		inbuf = &sdin->m_samples;
+		outbuf = &cap->m_samples;
 	}
-	else if(udin)
+	else
 	{
 		auto cap = SetupEmptyUniformAnalogOutputWaveform(udin, 0);
 		cap->Resize(len);
-		m_computePipeline.BindBufferNonblocking(0, udin->m_samples, cmdBuf);
-		m_computePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
-		cap->MarkSamplesModifiedFromGpu();
+		inbuf = &udin->m_samples;
+		outbuf = &cap->m_samples;
 	}
 
 	//Do the actual clipping
-	const uint32_t compute_block_count = GetComputeBlockCount(len, 64);
-	m_computePipeline.Dispatch(cmdBuf, cfg,
-		min(compute_block_count, 32768u),
-		compute_block_count / 32768 + 1);
+	if(g_gpuFilterEnabled)
+	{
+		cmdBuf.begin({});
+
+		m_computePipeline.BindBufferNonblocking(0, *inbuf, cmdBuf);
+		m_computePipeline.BindBufferNonblocking(1, *outbuf, cmdBuf, true);
+		const uint32_t compute_block_count = GetComputeBlockCount(len, 64);
+		m_computePipeline.Dispatch(cmdBuf, cfg,
+			min(compute_block_count, 32768u),
+			compute_block_count / 32768 + 1);
+
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
 
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
+		outbuf->MarkModifiedFromGpu();
+	}
+	else
+	{
+		inbuf->PrepareForCpuAccess();
+		outbuf->PrepareForCpuAccess();
+
+		float* in = inbuf->GetCpuPointer();
+		float* out = outbuf->GetCpuPointer();
+		float level = cfg.level;
+		if(cfg.clipAbove == 1)
+		{
+			#pragma omp parallel for
+			for(size_t i=0; i<len; i++)
+				out[i] = (in[i] > level) ? level : in[i];
+		}
+		else
+		{
+			#pragma omp parallel for
+			for(size_t i=0; i<len; i++)
+				out[i] = (in[i] < level) ? level : in[i];
+		}
+
+		outbuf->MarkModifiedFromCpu();
+	}
 }
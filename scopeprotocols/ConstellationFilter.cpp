@@ -125,6 +125,8 @@ Filter::DataLocation ConstellationFilter::GetInputLocation()
 
 void ConstellationFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(nullptr, 0);
 	m_evmSum = 0;
 	m_evmCount = 0;
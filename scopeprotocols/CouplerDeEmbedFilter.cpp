@@ -66,20 +66,24 @@ CouplerDeEmbedFilter::CouplerDeEmbedFilter(const string& color)
 	m_cachedNumPoints = 0;
 	m_cachedMaxGain = 0;
 
-	m_scalarTempBuf1.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_scalarTempBuf1.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
+	//Scratch buffers live wherever the FFT backend runs
+	auto cpuHint = g_gpuFilterEnabled ? AcceleratorBuffer<float>::HINT_NEVER : AcceleratorBuffer<float>::HINT_LIKELY;
+	auto gpuHint = g_gpuFilterEnabled ? AcceleratorBuffer<float>::HINT_LIKELY : AcceleratorBuffer<float>::HINT_NEVER;
 
-	m_vectorTempBuf1.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_vectorTempBuf1.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
+	m_scalarTempBuf1.SetCpuAccessHint(cpuHint);
+	m_scalarTempBuf1.SetGpuAccessHint(gpuHint);
 
-	m_vectorTempBuf2.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_vectorTempBuf2.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
+	m_vectorTempBuf1.SetCpuAccessHint(cpuHint);
+	m_vectorTempBuf1.SetGpuAccessHint(gpuHint);
 
-	m_vectorTempBuf3.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_vectorTempBuf3.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
+	m_vectorTempBuf2.SetCpuAccessHint(cpuHint);
+	m_vectorTempBuf2.SetGpuAccessHint(gpuHint);
 
-	m_vectorTempBuf4.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_vectorTempBuf4.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
+	m_vectorTempBuf3.SetCpuAccessHint(cpuHint);
+	m_vectorTempBuf3.SetGpuAccessHint(gpuHint);
+
+	m_vectorTempBuf4.SetCpuAccessHint(cpuHint);
+	m_vectorTempBuf4.SetGpuAccessHint(gpuHint);
 }
 
 CouplerDeEmbedFilter::~CouplerDeEmbedFilter()
@@ -147,8 +151,10 @@ void CouplerDeEmbedFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 		nvtx3::scoped_range nrange("CouplerDeEmbedFilter::Refresh");
 	#endif
 
-	//TODO: implement fallback
-	if(!g_hasPushDescriptor)
+	ClearErrors();
+
+	//TODO: implement fallback for GPUs without push descriptors
+	if(g_gpuFilterEnabled && !g_hasPushDescriptor)
 	{
 		AddErrorMessage(
 			"Missing GPU support",
@@ -193,23 +199,6 @@ void CouplerDeEmbedFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 	//Format the input data as raw samples for the FFT
 	size_t nouts = npoints/2 + 1;
 
-	//Invalidate old vkFFT plans if size has changed
-	if(m_vkForwardPlan)
-	{
-		if(m_vkForwardPlan->size() != npoints)
-			m_vkForwardPlan = nullptr;
-	}
-	if(m_vkForwardPlan2)
-	{
-		if(m_vkForwardPlan2->size() != npoints)
-			m_vkForwardPlan = nullptr;
-	}
-	if(m_vkReversePlan)
-	{
-		if(m_vkReversePlan->size() != npoints)
-			m_vkReversePlan = nullptr;
-	}
-
 	//Set up the FFT and allocate buffers if we change point count
 	bool sizechange = false;
 	if(m_cachedNumPoints != npoints)
@@ -224,13 +213,10 @@ void CouplerDeEmbedFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 		sizechange = true;
 	}
 
-	//Set up new FFT plans
-	if(!m_vkForwardPlan)
-		m_vkForwardPlan = make_unique<VulkanFFTPlan>(npoints, nouts, VulkanFFTPlan::DIRECTION_FORWARD);
-	if(!m_vkForwardPlan2)
-		m_vkForwardPlan2 = make_unique<VulkanFFTPlan>(npoints, nouts, VulkanFFTPlan::DIRECTION_FORWARD);
-	if(!m_vkReversePlan)
-		m_vkReversePlan = make_unique<VulkanFFTPlan>(npoints, nouts, VulkanFFTPlan::DIRECTION_REVERSE);
+	//Set up new FFT plans if size or backend has changed
+	FFTPlan::Update(m_forwardPlan, npoints, nouts, FFTPlan::DIRECTION_FORWARD);
+	FFTPlan::Update(m_forwardPlan2, npoints, nouts, FFTPlan::DIRECTION_FORWARD);
+	FFTPlan::Update(m_reversePlan, npoints, nouts, FFTPlan::DIRECTION_REVERSE);
 
 	//Calculate size of each bin
 	double fs = dinFwd->m_timescale;
@@ -275,13 +261,15 @@ void CouplerDeEmbedFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	//Prepare to do all of our compute stuff in one dispatch call to reduce overhead
-	cmdBuf.begin({});
+	//Prepare to do all of our compute stuff in one dispatch call to reduce overhead.
+	//In CPU-only mode each step below runs immediately instead.
+	if(g_gpuFilterEnabled)
+		cmdBuf.begin({});
 
 	//Pad and FFT both inputs
 	//vec1 = raw rev, vec3 = raw fwd
-	ProcessScalarInput(cmdBuf, m_vkForwardPlan, dinFwd->m_samples, m_vectorTempBuf3, npoints, npoints_raw);
-	ProcessScalarInput(cmdBuf, m_vkForwardPlan2, dinRev->m_samples, m_vectorTempBuf1, npoints, npoints_raw);
+	ProcessScalarInput(cmdBuf, m_forwardPlan, dinFwd->m_samples, m_vectorTempBuf3, npoints, npoints_raw);
+	ProcessScalarInput(cmdBuf, m_forwardPlan2, dinRev->m_samples, m_vectorTempBuf1, npoints, npoints_raw);
 
 	//De-embed the forward path
 	//vec1 = raw rev, vec2 = de-embedded fwd, vec3 = raw fwd
@@ -306,7 +294,7 @@ void CouplerDeEmbedFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 	size_t iend = npoints_raw;
 	int64_t phaseshift = 0;
 	GroupDelayCorrection(m_reverseCoupledParams, istart, iend, phaseshift, true);
-	GenerateScalarOutput(cmdBuf, m_vkReversePlan, istart, iend, dinRev, 1, npoints, phaseshift, m_vectorTempBuf4);
+	GenerateScalarOutput(cmdBuf, m_reversePlan, istart, iend, dinRev, 1, npoints, phaseshift, m_vectorTempBuf4);
 
 	//De-embed the reverse path
 	//vec1 = de-embedded reverse, vec2 = fwd leakage, vec3 = raw fwd
@@ -330,13 +318,16 @@ void CouplerDeEmbedFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 	istart = 0;
 	iend = npoints_raw;
 	GroupDelayCorrection(m_forwardCoupledParams, istart, iend, phaseshift, true);
-	GenerateScalarOutput(cmdBuf, m_vkReversePlan, istart, iend, dinFwd, 0, npoints, phaseshift, m_vectorTempBuf4);
+	GenerateScalarOutput(cmdBuf, m_reversePlan, istart, iend, dinFwd, 0, npoints, phaseshift, m_vectorTempBuf4);
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	//Done, block until the compute operations finish
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
+	if(g_gpuFilterEnabled)
+	{
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+	}
 }
 
 /**
@@ -348,6 +339,19 @@ void CouplerDeEmbedFilter::SubtractInPlace(
 		AcceleratorBuffer<float>& samplesSub,
 		size_t npoints)
 {
+	if(!g_gpuFilterEnabled)
+	{
+		samplesInout.PrepareForCpuAccess();
+		samplesSub.PrepareForCpuAccess();
+		float* data = samplesInout.GetCpuPointer();
+		const float* sub = samplesSub.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<npoints; i++)
+			data[i] -= sub[i];
+		samplesInout.MarkModifiedFromCpu();
+		return;
+	}
+
 	m_subtractInPlaceComputePipeline.Bind(cmdBuf);
 	m_subtractInPlaceComputePipeline.BindBufferNonblocking(0, samplesInout, cmdBuf);
 	m_subtractInPlaceComputePipeline.BindBufferNonblocking(1, samplesSub, cmdBuf);
@@ -369,6 +373,21 @@ void CouplerDeEmbedFilter::Subtract(
 		AcceleratorBuffer<float>& samplesOut,
 		size_t npoints)
 {
+	if(!g_gpuFilterEnabled)
+	{
+		samplesP.PrepareForCpuAccess();
+		samplesN.PrepareForCpuAccess();
+		samplesOut.PrepareForCpuAccess();
+		const float* p = samplesP.GetCpuPointer();
+		const float* n = samplesN.GetCpuPointer();
+		float* out = samplesOut.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<npoints; i++)
+			out[i] = p[i] - n[i];
+		samplesOut.MarkModifiedFromCpu();
+		return;
+	}
+
 	m_subtractComputePipeline.Bind(cmdBuf);
 	m_subtractComputePipeline.BindBufferNonblocking(0, samplesP, cmdBuf);
 	m_subtractComputePipeline.BindBufferNonblocking(1, samplesN, cmdBuf);
@@ -411,7 +430,7 @@ void CouplerDeEmbedFilter::GroupDelayCorrection(
  */
 void CouplerDeEmbedFilter::GenerateScalarOutput(
 	vk::raii::CommandBuffer& cmdBuf,
-	unique_ptr<VulkanFFTPlan>& plan,
+	unique_ptr<FFTPlan>& plan,
 	size_t istart,
 	size_t iend,
 	WaveformBase* refin,
@@ -432,6 +451,18 @@ void CouplerDeEmbedFilter::GenerateScalarOutput(
 	//Do the actual FFT operation
 	plan->AppendReverse(samplesIn, m_scalarTempBuf1, cmdBuf);
 
+	if(!g_gpuFilterEnabled)
+	{
+		cap->PrepareForCpuAccess();
+		const float* rin = m_scalarTempBuf1.GetCpuPointer() + istart;
+		float* rout = cap->m_samples.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<outlen; i++)
+			rout[i] = rin[i] * scale;
+		cap->MarkModifiedFromCpu();
+		return;
+	}
+
 	//Copy and normalize output
 	//TODO: is there any way to fold this into vkFFT? They can normalize, but offset might be tricky...
 	DeEmbedNormalizationArgs nargs;
@@ -462,6 +493,28 @@ void CouplerDeEmbedFilter::ApplySParameters(
 		size_t npoints,
 		size_t nouts)
 {
+	if(!g_gpuFilterEnabled)
+	{
+		samplesIn.PrepareForCpuAccess();
+		samplesOut.PrepareForCpuAccess();
+		params.m_resampledSparamSines.PrepareForCpuAccess();
+		params.m_resampledSparamCosines.PrepareForCpuAccess();
+		const float* din = samplesIn.GetCpuPointer();
+		float* dout = samplesOut.GetCpuPointer();
+		const float* sines = params.m_resampledSparamSines.GetCpuPointer();
+		const float* cosines = params.m_resampledSparamCosines.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<nouts; i++)
+		{
+			float real_orig = din[i*2 + 0];
+			float imag_orig = din[i*2 + 1];
+			dout[i*2 + 0] = real_orig*cosines[i] - imag_orig*sines[i];
+			dout[i*2 + 1] = real_orig*sines[i] + imag_orig*cosines[i];
+		}
+		samplesOut.MarkModifiedFromCpu();
+		return;
+	}
+
 	m_deEmbedComputePipeline.Bind(cmdBuf);
 	m_deEmbedComputePipeline.BindBufferNonblocking(0, samplesIn, cmdBuf);
 	m_deEmbedComputePipeline.BindBufferNonblocking(1, samplesOut, cmdBuf, true);
@@ -486,6 +539,26 @@ void CouplerDeEmbedFilter::ApplySParametersInPlace(
 		size_t npoints,
 		size_t nouts)
 {
+	if(!g_gpuFilterEnabled)
+	{
+		samplesInout.PrepareForCpuAccess();
+		params.m_resampledSparamSines.PrepareForCpuAccess();
+		params.m_resampledSparamCosines.PrepareForCpuAccess();
+		float* data = samplesInout.GetCpuPointer();
+		const float* sines = params.m_resampledSparamSines.GetCpuPointer();
+		const float* cosines = params.m_resampledSparamCosines.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<nouts; i++)
+		{
+			float real_orig = data[i*2 + 0];
+			float imag_orig = data[i*2 + 1];
+			data[i*2 + 0] = real_orig*cosines[i] - imag_orig*sines[i];
+			data[i*2 + 1] = real_orig*sines[i] + imag_orig*cosines[i];
+		}
+		samplesInout.MarkModifiedFromCpu();
+		return;
+	}
+
 	m_deEmbedInPlaceComputePipeline.Bind(cmdBuf);
 	m_deEmbedInPlaceComputePipeline.BindBufferNonblocking(0, samplesInout, cmdBuf);
 	m_deEmbedInPlaceComputePipeline.BindBufferNonblocking(1, params.m_resampledSparamSines, cmdBuf);
@@ -506,7 +579,7 @@ void CouplerDeEmbedFilter::ApplySParametersInPlace(
  */
 void CouplerDeEmbedFilter::ProcessScalarInput(
 	vk::raii::CommandBuffer& cmdBuf,
-	unique_ptr<VulkanFFTPlan>& plan,
+	unique_ptr<FFTPlan>& plan,
 	AcceleratorBuffer<float>& samplesIn,
 	AcceleratorBuffer<float>& samplesOut,
 	size_t npointsPadded,
@@ -522,6 +595,20 @@ void CouplerDeEmbedFilter::ProcessScalarInput(
 	args.alpha1 = 0;
 	args.offsetIn = 0;
 	args.offsetOut = 0;
+
+	if(!g_gpuFilterEnabled)
+	{
+		samplesIn.PrepareForCpuAccess();
+		m_scalarTempBuf1.PrepareForCpuAccess();
+		FFTFilter::ApplyWindowFunction(
+			samplesIn.GetCpuPointer(), m_scalarTempBuf1.GetCpuPointer(), FFTFilter::WINDOW_RECTANGULAR, args);
+		m_scalarTempBuf1.MarkModifiedFromCpu();
+
+		//Do the actual FFT operation
+		plan->AppendForward(m_scalarTempBuf1, samplesOut, cmdBuf);
+		return;
+	}
+
 	m_rectangularComputePipeline.Bind(cmdBuf);
 	m_rectangularComputePipeline.BindBufferNonblocking(0, samplesIn, cmdBuf);
 	m_rectangularComputePipeline.BindBufferNonblocking(1, m_scalarTempBuf1, cmdBuf, true);
@@ -136,7 +136,7 @@ protected:
 
 	void ProcessScalarInput(
 		vk::raii::CommandBuffer& cmdBuf,
-		std::unique_ptr<VulkanFFTPlan>& plan,
+		std::unique_ptr<FFTPlan>& plan,
 		AcceleratorBuffer<float>& samplesIn,
 		AcceleratorBuffer<float>& samplesOut,
 		size_t npointsPadded,
@@ -173,7 +173,7 @@ protected:
 
 	void GenerateScalarOutput(
 		vk::raii::CommandBuffer& cmdBuf,
-		std::unique_ptr<VulkanFFTPlan>& plan,
+		std::unique_ptr<FFTPlan>& plan,
 		size_t istart,
 		size_t iend,
 		WaveformBase* refin,
@@ -219,10 +219,10 @@ protected:
 	ComputePipeline m_subtractInPlaceComputePipeline;
 	ComputePipeline m_subtractComputePipeline;
 
-	std::unique_ptr<VulkanFFTPlan> m_vkForwardPlan;
-	std::unique_ptr<VulkanFFTPlan> m_vkForwardPlan2;
+	std::unique_ptr<FFTPlan> m_forwardPlan;
+	std::unique_ptr<FFTPlan> m_forwardPlan2;
 
-	std::unique_ptr<VulkanFFTPlan> m_vkReversePlan;
+	std::unique_ptr<FFTPlan> m_reversePlan;
 };
 
 #endif
@@ -187,15 +187,23 @@ void DDJMeasurement::Refresh(
 	}
 	else
 	{
-		//Get all of the input on the CPU
-		cmdBuf.begin({});
-		tie->m_offsets.PrepareForCpuAccessNonblocking(cmdBuf);
-		tie->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
-		sampledData->m_offsets.PrepareForCpuAccessNonblocking(cmdBuf);
-		sampledData->m_durations.PrepareForCpuAccessNonblocking(cmdBuf);
-		sampledData->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
-		cmdBuf.end();
-		queue->SubmitAndBlock(cmdBuf);
+		//Get all of the input on the CPU (there's no command buffer to batch the copies in CPU-only mode)
+		if(g_gpuFilterEnabled)
+		{
+			cmdBuf.begin({});
+			tie->m_offsets.PrepareForCpuAccessNonblocking(cmdBuf);
+			tie->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
+			sampledData->m_offsets.PrepareForCpuAccessNonblocking(cmdBuf);
+			sampledData->m_durations.PrepareForCpuAccessNonblocking(cmdBuf);
+			sampledData->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
+			cmdBuf.end();
+			queue->SubmitAndBlock(cmdBuf);
+		}
+		else
+		{
+			tie->PrepareForCpuAccess();
+			sampledData->PrepareForCpuAccess();
+		}
 
 		size_t nbits = 0;
 		int64_t tfirst = tie->m_offsets[0];
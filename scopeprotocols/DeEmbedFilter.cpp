@@ -178,18 +178,6 @@ void DeEmbedFilter::DoRefresh(bool invert, vk::raii::CommandBuffer& cmdBuf, shar
 	//Format the input data as raw samples for the FFT
 	size_t nouts = npoints/2 + 1;
 
-	//Invalidate old vkFFT plans if size has changed
-	if(m_vkForwardPlan)
-	{
-		if(m_vkForwardPlan->size() != npoints)
-			m_vkForwardPlan = nullptr;
-	}
-	if(m_vkReversePlan)
-	{
-		if(m_vkReversePlan->size() != npoints)
-			m_vkReversePlan = nullptr;
-	}
-
 	//Set up the FFT and allocate buffers if we change point count
 	bool sizechange = false;
 	if(m_cachedNumPoints != npoints)
@@ -202,11 +190,9 @@ void DeEmbedFilter::DoRefresh(bool invert, vk::raii::CommandBuffer& cmdBuf, shar
 		sizechange = true;
 	}
 
-	//Set up new FFT plans
-	if(!m_vkForwardPlan)
-		m_vkForwardPlan = make_unique<VulkanFFTPlan>(npoints, nouts, VulkanFFTPlan::DIRECTION_FORWARD);
-	if(!m_vkReversePlan)
-		m_vkReversePlan = make_unique<VulkanFFTPlan>(npoints, nouts, VulkanFFTPlan::DIRECTION_REVERSE);
+	//Set up new FFT plans if size or backend has changed
+	FFTPlan::Update(m_forwardPlan, npoints, nouts, FFTPlan::DIRECTION_FORWARD);
+	FFTPlan::Update(m_reversePlan, npoints, nouts, FFTPlan::DIRECTION_REVERSE);
 
 	//Calculate size of each bin
 	double fs = din->m_timescale;
@@ -288,9 +274,6 @@ void DeEmbedFilter::DoRefresh(bool invert, vk::raii::CommandBuffer& cmdBuf, shar
 	m_cachedOutLen = outlen;
 	m_cachedNouts = nouts;
 
-	//Prepare to do all of our compute stuff in one dispatch call to reduce overhead
-	cmdBuf.begin({});
-
 	//Copy and zero-pad the input as needed
 	WindowFunctionArgs args;
 	args.numActualSamples = npoints_raw;
@@ -300,47 +283,94 @@ void DeEmbedFilter::DoRefresh(bool invert, vk::raii::CommandBuffer& cmdBuf, shar
 	args.alpha1 = 0;
 	args.offsetIn = 0;
 	args.offsetOut = 0;
-	m_rectangularComputePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
-	m_rectangularComputePipeline.BindBufferNonblocking(1, m_forwardInBuf, cmdBuf, true);
-	m_rectangularComputePipeline.Dispatch(cmdBuf, args, GetComputeBlockCount(npoints, 64));
-	m_rectangularComputePipeline.AddComputeMemoryBarrier(cmdBuf);
-	m_forwardInBuf.MarkModifiedFromGpu();
-
-	//Do the actual FFT operation
-	m_vkForwardPlan->AppendForward(m_forwardInBuf, m_forwardOutBuf, cmdBuf);
-
-	//Apply the interpolated S-parameters
-	m_deEmbedComputePipeline.BindBufferNonblocking(0, m_forwardOutBuf, cmdBuf);
-	m_deEmbedComputePipeline.BindBufferNonblocking(1, m_resampledSparamSines, cmdBuf);
-	m_deEmbedComputePipeline.BindBufferNonblocking(2, m_resampledSparamCosines, cmdBuf);
-	const uint32_t compute_block_count = GetComputeBlockCount(npoints, 64);
-	m_deEmbedComputePipeline.Dispatch(cmdBuf, (uint32_t)nouts,
-		min(compute_block_count, 32768u),
-		compute_block_count / 32768 + 1);
-	m_deEmbedComputePipeline.AddComputeMemoryBarrier(cmdBuf);
-	m_forwardOutBuf.MarkModifiedFromGpu();
-
-	//Do the actual FFT operation
-	m_vkReversePlan->AppendReverse(m_forwardOutBuf, m_reverseOutBuf, cmdBuf);
-
-	//Copy and normalize output
-	//TODO: is there any way to fold this into vkFFT? They can normalize, but offset might be tricky...
-	DeEmbedNormalizationArgs nargs;
-	nargs.outlen = outlen;
-	nargs.istart = istart;
-	nargs.scale = scale;
-	m_normalizeComputePipeline.BindBufferNonblocking(0, m_reverseOutBuf, cmdBuf);
-	m_normalizeComputePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
-
-	m_normalizeComputePipeline.Dispatch(cmdBuf, nargs,
-		min(compute_block_count, 32768u),
-		compute_block_count / 32768 + 1);
-	m_normalizeComputePipeline.AddComputeMemoryBarrier(cmdBuf);
-
-	//Done, block until the compute operations finish
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
-	cap->MarkModifiedFromGpu();
+
+	if(g_gpuFilterEnabled)
+	{
+		//Prepare to do all of our compute stuff in one dispatch call to reduce overhead
+		cmdBuf.begin({});
+
+		m_rectangularComputePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
+		m_rectangularComputePipeline.BindBufferNonblocking(1, m_forwardInBuf, cmdBuf, true);
+		m_rectangularComputePipeline.Dispatch(cmdBuf, args, GetComputeBlockCount(npoints, 64));
+		m_rectangularComputePipeline.AddComputeMemoryBarrier(cmdBuf);
+		m_forwardInBuf.MarkModifiedFromGpu();
+
+		//Do the actual FFT operation
+		m_forwardPlan->AppendForward(m_forwardInBuf, m_forwardOutBuf, cmdBuf);
+
+		//Apply the interpolated S-parameters
+		m_deEmbedComputePipeline.BindBufferNonblocking(0, m_forwardOutBuf, cmdBuf);
+		m_deEmbedComputePipeline.BindBufferNonblocking(1, m_resampledSparamSines, cmdBuf);
+		m_deEmbedComputePipeline.BindBufferNonblocking(2, m_resampledSparamCosines, cmdBuf);
+		const uint32_t compute_block_count = GetComputeBlockCount(npoints, 64);
+		m_deEmbedComputePipeline.Dispatch(cmdBuf, (uint32_t)nouts,
+			min(compute_block_count, 32768u),
+			compute_block_count / 32768 + 1);
+		m_deEmbedComputePipeline.AddComputeMemoryBarrier(cmdBuf);
+		m_forwardOutBuf.MarkModifiedFromGpu();
+
+		//Do the actual FFT operation
+		m_reversePlan->AppendReverse(m_forwardOutBuf, m_reverseOutBuf, cmdBuf);
+
+		//Copy and normalize output
+		//TODO: is there any way to fold this into vkFFT? They can normalize, but offset might be tricky...
+		DeEmbedNormalizationArgs nargs;
+		nargs.outlen = outlen;
+		nargs.istart = istart;
+		nargs.scale = scale;
+		m_normalizeComputePipeline.BindBufferNonblocking(0, m_reverseOutBuf, cmdBuf);
+		m_normalizeComputePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
+
+		m_normalizeComputePipeline.Dispatch(cmdBuf, nargs,
+			min(compute_block_count, 32768u),
+			compute_block_count / 32768 + 1);
+		m_normalizeComputePipeline.AddComputeMemoryBarrier(cmdBuf);
+
+		//Done, block until the compute operations finish
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+		cap->MarkModifiedFromGpu();
+	}
+
+	else
+	{
+		din->PrepareForCpuAccess();
+		m_forwardInBuf.PrepareForCpuAccess();
+		FFTFilter::ApplyWindowFunction(
+			din->m_samples.GetCpuPointer(), m_forwardInBuf.GetCpuPointer(), FFTFilter::WINDOW_RECTANGULAR, args);
+		m_forwardInBuf.MarkModifiedFromCpu();
+
+		//Do the actual FFT operation
+		m_forwardPlan->AppendForward(m_forwardInBuf, m_forwardOutBuf, cmdBuf);
+
+		//Apply the interpolated S-parameters
+		m_resampledSparamSines.PrepareForCpuAccess();
+		m_resampledSparamCosines.PrepareForCpuAccess();
+		float* data = m_forwardOutBuf.GetCpuPointer();
+		const float* sines = m_resampledSparamSines.GetCpuPointer();
+		const float* cosines = m_resampledSparamCosines.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<nouts; i++)
+		{
+			float real_orig = data[i*2 + 0];
+			float imag_orig = data[i*2 + 1];
+			data[i*2 + 0] = real_orig*cosines[i] - imag_orig*sines[i];
+			data[i*2 + 1] = real_orig*sines[i] + imag_orig*cosines[i];
+		}
+		m_forwardOutBuf.MarkModifiedFromCpu();
+
+		//Do the actual FFT operation
+		m_reversePlan->AppendReverse(m_forwardOutBuf, m_reverseOutBuf, cmdBuf);
+
+		//Copy and normalize output
+		cap->PrepareForCpuAccess();
+		const float* rin = m_reverseOutBuf.GetCpuPointer() + istart;
+		float* rout = cap->m_samples.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t i=0; i<outlen; i++)
+			rout[i] = rin[i] * scale;
+		cap->MarkModifiedFromCpu();
+	}
 }
 
 /**
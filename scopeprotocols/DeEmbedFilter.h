@@ -113,8 +113,8 @@ protected:
 	ComputePipeline m_rectangularComputePipeline;
 	ComputePipeline m_deEmbedComputePipeline;
 	ComputePipeline m_normalizeComputePipeline;
-	std::unique_ptr<VulkanFFTPlan> m_vkForwardPlan;
-	std::unique_ptr<VulkanFFTPlan> m_vkReversePlan;
+	std::unique_ptr<FFTPlan> m_forwardPlan;
+	std::unique_ptr<FFTPlan> m_reversePlan;
 };
 
 #endif
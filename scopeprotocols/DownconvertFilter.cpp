@@ -127,6 +127,33 @@ void DownconvertFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Queu
 	cfg.trigger_phase_rad = din->m_triggerPhase * (lo_rad_per_sample / din->m_timescale);
 	cfg.lo_rad_per_sample = lo_rad_per_sample;
 
+	if(!g_gpuFilterEnabled)
+	{
+		cap_i->PrepareForCpuAccess();
+		cap_q->PrepareForCpuAccess();
+
+		float* in = din->m_samples.GetCpuPointer();
+		float* out_i = cap_i->m_samples.GetCpuPointer();
+		float* out_q = cap_q->m_samples.GetCpuPointer();
+		double rad = cfg.lo_rad_per_sample;
+		float trigphase = cfg.trigger_phase_rad;
+
+		#pragma omp parallel for
+		for(size_t i=0; i<len; i++)
+		{
+			//Wrap the LO phase in double precision to avoid losing accuracy late in long waveforms
+			float phase = trigphase + static_cast<float>(fmod(rad * i, 2*M_PI));
+			float samp = in[i];
+
+			out_i[i] = samp * sinf(phase);
+			out_q[i] = samp * cosf(phase);
+		}
+
+		cap_i->MarkSamplesModifiedFromCpu();
+		cap_q->MarkSamplesModifiedFromCpu();
+		return;
+	}
+
 	cmdBuf.begin({});
 
 	m_computePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
@@ -159,37 +159,88 @@ void DownsampleFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Queue
 		m_kernel.MarkModifiedFromCpu();
 
 		//Run the filter
-		cmdBuf.begin({});
+		if(g_gpuFilterEnabled)
+		{
+			cmdBuf.begin({});
+
+			m_aaComputePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
+			m_aaComputePipeline.BindBufferNonblocking(1, m_kernel, cmdBuf);
+			m_aaComputePipeline.BindBufferNonblocking(2, cap->m_samples, cmdBuf, true);
+			const uint32_t compute_block_count = GetComputeBlockCount(outlen, 64);
+			m_aaComputePipeline.Dispatch(cmdBuf, cfg,
+				min(compute_block_count, 32768u),
+				compute_block_count / 32768 + 1);
 
-		m_aaComputePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
-		m_aaComputePipeline.BindBufferNonblocking(1, m_kernel, cmdBuf);
-		m_aaComputePipeline.BindBufferNonblocking(2, cap->m_samples, cmdBuf, true);
-		const uint32_t compute_block_count = GetComputeBlockCount(outlen, 64);
-		m_aaComputePipeline.Dispatch(cmdBuf, cfg,
-			min(compute_block_count, 32768u),
-			compute_block_count / 32768 + 1);
+			cmdBuf.end();
+			queue->SubmitAndBlock(cmdBuf);
 
-		cmdBuf.end();
-		queue->SubmitAndBlock(cmdBuf);
+			cap->m_samples.MarkModifiedFromGpu();
+		}
 
-		cap->m_samples.MarkModifiedFromGpu();
+		else
+		{
+			din->PrepareForCpuAccess();
+			cap->PrepareForCpuAccess();
+
+			const float* pin = din->m_samples.GetCpuPointer();
+			const float* kernel = m_kernel.GetCpuPointer();
+			float* pout = cap->m_samples.GetCpuPointer();
+			const int64_t radius = cfg.kernel_radius;
+			const int64_t last = static_cast<int64_t>(len) - 1;
+
+			#pragma omp parallel for
+			for(size_t i=0; i<outlen; i++)
+			{
+				//Clip the kernel to the input so the inner loop has no bounds checks
+				int64_t base = i*factor;
+				int64_t start = max(base - radius, static_cast<int64_t>(0));
+				int64_t end = min(base + radius, last);
+				const float* k = kernel + (start - base + radius);
+
+				float conv = 0;
+				#pragma omp simd reduction(+:conv)
+				for(int64_t pos=start; pos<=end; pos++)
+					conv += pin[pos] * k[pos - start];
+				pout[i] = conv;
+			}
+
+			cap->MarkModifiedFromCpu();
+		}
 	}
 
 	//Optimized path with no AA if the input is known to not contain any higher frequency content
 	else
 	{
-		cmdBuf.begin({});
+		if(g_gpuFilterEnabled)
+		{
+			cmdBuf.begin({});
 
-		m_noAAComputePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
-		m_noAAComputePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
-		const uint32_t compute_block_count = GetComputeBlockCount(outlen, 64);
-		m_noAAComputePipeline.Dispatch(cmdBuf, cfg,
-			min(compute_block_count, 32768u),
-			compute_block_count / 32768 + 1);
+			m_noAAComputePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
+			m_noAAComputePipeline.BindBufferNonblocking(1, cap->m_samples, cmdBuf, true);
+			const uint32_t compute_block_count = GetComputeBlockCount(outlen, 64);
+			m_noAAComputePipeline.Dispatch(cmdBuf, cfg,
+				min(compute_block_count, 32768u),
+				compute_block_count / 32768 + 1);
 
-		cmdBuf.end();
-		queue->SubmitAndBlock(cmdBuf);
+			cmdBuf.end();
+			queue->SubmitAndBlock(cmdBuf);
 
-		cap->m_samples.MarkModifiedFromGpu();
+			cap->m_samples.MarkModifiedFromGpu();
+		}
+
+		else
+		{
+			din->PrepareForCpuAccess();
+			cap->PrepareForCpuAccess();
+
+			const float* pin = din->m_samples.GetCpuPointer();
+			float* pout = cap->m_samples.GetCpuPointer();
+
+			#pragma omp parallel for
+			for(size_t i=0; i<outlen; i++)
+				pout[i] = pin[i*factor];
+
+			cap->MarkModifiedFromCpu();
+		}
 	}
 }
@@ -175,7 +175,7 @@ void DutyCycleMeasurement::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 	cap->Resize(nouts);
 
 	//GPU inner loop requires native int64, plus (for now) an analog input
-	if(g_hasShaderInt64 && (sdin || udin))
+	if(g_gpuFilterEnabled && g_hasShaderInt64 && (sdin || udin))
 	{
 		cmdBuf.begin({});
 
@@ -203,11 +203,18 @@ void DutyCycleMeasurement::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 		cap->MarkModifiedFromGpu();
 	}
 
-	//CPU fallback for digital inputs or no int64 support
+	//CPU fallback for digital inputs, no int64 support, or no GPU at all
 	else
 	{
 		cap->PrepareForCpuAccess();
 
+		//Match the GPU path: analog polarity is determined by the first sample
+		din->PrepareForCpuAccess();
+		if(sdin)
+			initial_polarity = (sdin->m_samples[0] > midpoint);
+		else if(udin)
+			initial_polarity = (udin->m_samples[0] > midpoint);
+
 		//Find the duty cycle per cycle, then average
 		int64_t nedges = 0;
 		edges.PrepareForCpuAccess();
@@ -153,6 +153,21 @@ void EmphasisFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHa
 	cfg.tap0 = taps[0];
 	cfg.tap1 = taps[1];
 
+	if(!g_gpuFilterEnabled)
+	{
+		din->PrepareForCpuAccess();
+		cap->PrepareForCpuAccess();
+
+		float* in = din->m_samples.GetCpuPointer();
+		float* out = cap->m_samples.GetCpuPointer();
+		#pragma omp parallel for
+		for(int64_t i=0; i<outlen; i++)
+			out[i] = (in[i] * taps[1]) + (in[i + samples_per_tap] * taps[0]);
+
+		cap->m_samples.MarkModifiedFromCpu();
+		return;
+	}
+
 	cmdBuf.begin({});
 
 	m_computePipeline.BindBufferNonblocking(0, din->m_samples, cmdBuf);
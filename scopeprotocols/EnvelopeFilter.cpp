@@ -69,6 +69,8 @@ string EnvelopeFilter::GetProtocolName()
 
 void EnvelopeFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(nullptr, 0);
 	SetData(nullptr, 1);
 }
@@ -157,14 +159,51 @@ void EnvelopeFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHa
 		umax->Resize(len);
 		umin->Resize(len);
 
-		cmdBuf.begin({});
-
 		//Push constants
 		EnvelopeFilterConstants cfg;
 		cfg.oldlen = oldlen;
 		cfg.len = len;
 		cfg.delta = 1.0f * (umin->m_triggerPhase - udata->m_triggerPhase) / udata->m_timescale;
 
+		if(!g_gpuFilterEnabled)
+		{
+			udata->PrepareForCpuAccess();
+			umin->PrepareForCpuAccess();
+			umax->PrepareForCpuAccess();
+
+			float* din = udata->m_samples.GetCpuPointer();
+			float* pmin = umin->m_samples.GetCpuPointer();
+			float* pmax = umax->m_samples.GetCpuPointer();
+			float delta = cfg.delta;
+
+			#pragma omp parallel for
+			for(size_t i=0; i<len; i++)
+			{
+				float fb = (i+1 < len) ? din[i+1] : din[i];
+				float f = din[i] + (fb - din[i])*delta;
+
+				//If in overlap region, do min/max
+				if(i < oldlen)
+				{
+					pmin[i] = min(pmin[i], f);
+					pmax[i] = max(pmax[i], f);
+				}
+
+				//Extending
+				else
+				{
+					pmin[i] = f;
+					pmax[i] = f;
+				}
+			}
+
+			umin->m_samples.MarkModifiedFromCpu();
+			umax->m_samples.MarkModifiedFromCpu();
+			return;
+		}
+
+		cmdBuf.begin({});
+
 		m_computePipeline.BindBufferNonblocking(0, udata->m_samples, cmdBuf);
 		m_computePipeline.BindBufferNonblocking(1, umin->m_samples, cmdBuf);
 		m_computePipeline.BindBufferNonblocking(2, umax->m_samples, cmdBuf);
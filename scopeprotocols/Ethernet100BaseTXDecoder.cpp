@@ -170,8 +170,10 @@ void Ethernet100BaseTXDecoder::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_p
 		return;
 	}
 
-	//If we can't do the 4b5b descrambling CPU side, pull all of the timestamps to the CPU
-	if(! (g_hasShaderInt64 && g_hasShaderInt8) )
+	//If we can't do the 4b5b descrambling GPU side, pull all of the timestamps to the CPU
+	//(in CPU-only mode they're already there)
+	bool asyncTimestampCopy = g_gpuFilterEnabled && !(g_hasShaderInt64 && g_hasShaderInt8);
+	if(asyncTimestampCopy)
 	{
 		//Make transfer helpers if this is the first time
 		if(!m_cmdPool)
@@ -315,11 +317,8 @@ void Ethernet100BaseTXDecoder::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_p
 	//CPU side descrambling and SSD search
 	else
 	{
-		//Good sync, descramble it now
-		cmdBuf.begin({});
+		//Good sync, descramble it now (without g_hasShaderInt8, Descramble() runs entirely on the CPU)
 		Descramble(cmdBuf, idle_offset);
-		cmdBuf.end();
-		queue->SubmitAndBlock(cmdBuf);
 
 		//Search until we find a 1100010001 (J-K, start of stream) sequence
 		bool ssd[10] = {1, 1, 0, 0, 0, 1, 0, 0, 0, 1};
@@ -355,7 +354,7 @@ void Ethernet100BaseTXDecoder::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_p
 	LogTrace("Found SSD at %zu\n", i);
 
 	//Wait until all of the timestamps are ready if we're not doing the 4b5b deserialization on the GPU
-	if(! (g_hasShaderInt64 && g_hasShaderInt8) )
+	if(asyncTimestampCopy)
 		m_transferQueue->WaitIdle();
 
 	//Skip the J-K as we already parsed it
@@ -114,7 +114,8 @@ void Ethernet64b66bDecoder::Refresh(
 	cap->PrepareForCpuAccess();
 
 	//Record the value of the data stream at each clock edge
-	SparseDigitalWaveform data;
+	ScratchWaveform<SparseDigitalWaveform> sampled(this, "Ethernet64b66bDecoder.data");
+	auto& data = *sampled;
 	SampleOnAnyEdgesBase(din, clkin, data);
 
 	//Look at each phase and figure out block alignment
@@ -133,15 +133,8 @@ void EthernetGMIIDecoder::Refresh()
 		//TODO: handle error signal (ignored for now)
 		while( (i < len) && (den.m_samples[i]) )
 		{
-			//Convert bits to bytes
-			uint8_t dval = 0;
-			for(size_t j=0; j<8; j++)
-			{
-				if(ddata.m_samples[i][j])
-					dval |= (1 << j);
-			}
-
-			bytes.push_back(dval);
+			//Bus samples are packed LSB first, so the low byte is the data byte
+			bytes.push_back(ddata.m_samples[i].GetBits() & 0xff);
 			starts.push_back(ddata.m_offsets[i]);
 			ends.push_back(ddata.m_offsets[i] + ddata.m_durations[i]);
 			i++;
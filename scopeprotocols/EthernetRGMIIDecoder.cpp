@@ -132,12 +132,7 @@ void EthernetRGMIIDecoder::Refresh()
 		if(!dctl.m_samples[i])
 		{
 			//Extract in-band status
-			uint8_t status = 0;
-			for(size_t j=0; j<4; j++)
-			{
-				if(ddata.m_samples[i][j])
-					status |= (1 << j);
-			}
+			uint8_t status = ddata.m_samples[i].GetBits() & 0xf;
 
 			//Same status? Merge samples
 			bool extend = false;
@@ -80,6 +80,8 @@ string ExponentialMovingAverageFilter::GetProtocolName()
 
 void ExponentialMovingAverageFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(nullptr, 0);
 }
 
@@ -105,11 +105,16 @@ void EyeHeightMeasurement::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Q
 
 	//Create the output
 	auto cap = SetupEmptySparseAnalogOutputWaveform(din, 0);
-	cmdBuf.begin({});
-	din->GetOutData().PrepareForCpuAccessNonblocking(cmdBuf);
 	cap->PrepareForCpuAccess();
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
+	if(g_gpuFilterEnabled)
+	{
+		cmdBuf.begin({});
+		din->GetOutData().PrepareForCpuAccessNonblocking(cmdBuf);
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+	}
+	else
+		din->GetOutData().PrepareForCpuAccess();
 	cap->m_timescale = 1;
 
 	//Make sure times are in the right order
@@ -31,6 +31,7 @@
 #include "EyePattern.h"
 #include "ClockRecoveryFilter.h"
 #include <algorithm>
+#include <omp.h>
 #ifdef __x86_64__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
@@ -178,7 +179,20 @@ FlowGraphNode::DataLocation EyePattern::GetInputLocation()
 
 void EyePattern::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(NULL, 0);
+	ReleaseThreadAccumulators();
+}
+
+/**
+	@brief Frees the per-thread accumulators
+
+	Called when the eye is cleared or resized, so an idle or shrunk eye doesn't keep a full set of tiles allocated.
+ */
+void EyePattern::ReleaseThreadAccumulators()
+{
+	vector<int64_t>().swap(m_threadAccumulators);
 }
 
 void EyePattern::Refresh(
@@ -356,7 +370,6 @@ void EyePattern::Refresh(
 	size_t wend = waveform->size()-1;
 	int32_t ymax = m_height - 1;
 	int32_t xmax = m_width - 1;
-	auto swfm = dynamic_cast<SparseAnalogWaveform*>(waveform);
 	auto uwfm = dynamic_cast<UniformAnalogWaveform*>(waveform);
 	if(m_xscale > FLT_EPSILON)
 	{
@@ -380,24 +393,13 @@ void EyePattern::Refresh(
 					yoff);
 			}
 
-			#ifdef __x86_64__
-			else if(g_hasAvx512F && g_hasFMA)
-				DensePackedInnerLoopAVX512F(uwfm, data, wend, cend, xmax, ymax, xtimescale, yscale, yoff);
-			else if(g_hasAvx2)
-			{
-				if(g_hasFMA)
-					DensePackedInnerLoopAVX2FMA(uwfm, data, wend, cend, xmax, ymax, xtimescale, yscale, yoff);
-				else
-					DensePackedInnerLoopAVX2(uwfm, data, wend, cend, xmax, ymax, xtimescale, yscale, yoff);
-			}
 			else
-			#endif
-				DensePackedInnerLoop(uwfm, data, wend, cend, xmax, ymax, xtimescale, yscale, yoff);
+				IntegrateMultithreaded(waveform, data, wend, cend, xmax, ymax, xtimescale, yscale, yoff);
 		}
 
 		//Normal main loop
 		else
-			SparsePackedInnerLoop(swfm, data, wend, cend, xmax, ymax, xtimescale, yscale, yoff);
+			IntegrateMultithreaded(waveform, data, wend, cend, xmax, ymax, xtimescale, yscale, yoff);
 	}
 	else
 	{
@@ -428,12 +430,197 @@ void EyePattern::Refresh(
 		DoMaskTest(cap);
 }
 
+/**
+	@brief Integrates a waveform into the eye on the CPU, using all available threads
+
+	The waveform is split into one block of samples per thread. Each block starts from the clock edge a single
+	threaded pass would have reached at that point (found by binary search) and integrates into its own private
+	accumulator, so there's no contention on the eye buffer. The first block writes straight to the eye, and the
+	others are summed into it at the end. Very large eyes are split into fewer blocks, so the extra accumulators
+	stay within EYE_MAX_ACCUMULATOR_BYTES.
+
+	@param waveform		Input waveform (uniform or sparse)
+	@param data			Eye accumulator buffer
+	@param wend			One past the last sample to integrate
+	@param cend			Index of the last clock edge
+	@param xmax			Rightmost pixel column of the eye
+	@param ymax			Topmost pixel row of the eye
+	@param xtimescale	Pixels per sample
+	@param yscale		Pixels per volt
+	@param yoff			Pixel offset of 0V
+ */
+void EyePattern::IntegrateMultithreaded(
+	WaveformBase* waveform,
+	int64_t* data,
+	size_t wend,
+	size_t cend,
+	int32_t xmax,
+	int32_t ymax,
+	float xtimescale,
+	float yscale,
+	float yoff
+	)
+{
+	m_clockEdgesMuxed->PrepareForCpuAccess();
+	waveform->PrepareForCpuAccess();
+	auto swfm = dynamic_cast<SparseAnalogWaveform*>(waveform);
+	auto uwfm = dynamic_cast<UniformAnalogWaveform*>(waveform);
+	const int64_t* edges = m_clockEdgesMuxed->GetCpuPointer();
+
+	//Don't split small waveforms, zeroing and merging the extra accumulators would cost more than it saves.
+	//Cap the number of extra accumulators by memory too.
+	size_t npixels = m_width * m_height;
+	size_t nblocks = min<size_t>(omp_get_max_threads(), wend / EYE_MIN_BLOCK_SAMPLES);
+	nblocks = min(nblocks, 1 + EYE_MAX_ACCUMULATOR_BYTES / (max<size_t>(npixels, 1) * sizeof(int64_t)));
+	nblocks = max<size_t>(nblocks, 1);
+	if(nblocks > 1)
+		m_threadAccumulators.resize( (nblocks - 1) * npixels);
+
+	#pragma omp parallel for if(nblocks > 1)
+	for(size_t b=0; b<nblocks; b++)
+	{
+		//Keep block boundaries aligned to the SIMD width, so the vector loops process exactly the same samples
+		//(and the same stragglers at the end) as they would in a single block
+		size_t istart = (b * wend / nblocks) & ~(EYE_BLOCK_ALIGN - 1);
+		size_t iend = wend;
+		if(b+1 < nblocks)
+			iend = ((b+1) * wend / nblocks) & ~(EYE_BLOCK_ALIGN - 1);
+
+		int64_t* accum = data;
+		if(b > 0)
+		{
+			accum = &m_threadAccumulators[(b-1) * npixels];
+			memset(accum, 0, npixels * sizeof(int64_t));
+		}
+
+		//Find the last clock edge at or before the previous sample
+		size_t iclock = 0;
+		if(istart > 0)
+		{
+			int64_t tprev;
+			if(uwfm)
+				tprev = (istart-1) * waveform->m_timescale + waveform->m_triggerPhase;
+			else
+				tprev = swfm->m_offsets[istart-1] * waveform->m_timescale + waveform->m_triggerPhase;
+
+			size_t nedge = upper_bound(edges, edges + cend + 1, tprev) - edges;
+			if(nedge > 0)
+				iclock = nedge - 1;
+		}
+
+		if(uwfm)
+		{
+			#ifdef __x86_64__
+			if(g_hasAvx512F && g_hasFMA)
+			{
+				DensePackedInnerLoopAVX512F(
+					uwfm, accum, istart, iend, iclock, cend, xmax, ymax, xtimescale, yscale, yoff);
+			}
+			else if(g_hasAvx2)
+			{
+				if(g_hasFMA)
+				{
+					DensePackedInnerLoopAVX2FMA(
+						uwfm, accum, istart, iend, iclock, cend, xmax, ymax, xtimescale, yscale, yoff);
+				}
+				else
+				{
+					DensePackedInnerLoopAVX2(
+						uwfm, accum, istart, iend, iclock, cend, xmax, ymax, xtimescale, yscale, yoff);
+				}
+			}
+			else
+			#endif
+				DensePackedInnerLoop(uwfm, accum, istart, iend, iclock, cend, xmax, ymax, xtimescale, yscale, yoff);
+		}
+		else
+			SparsePackedInnerLoop(swfm, accum, istart, iend, iclock, cend, xmax, ymax, xtimescale, yscale, yoff);
+	}
+
+	if(nblocks > 1)
+		MergeAccumulators(data, m_threadAccumulators.data(), nblocks - 1, npixels);
+}
+
+/**
+	@brief Adds a set of per-thread accumulators into the eye
+
+	@param data			Eye accumulator buffer
+	@param tiles		Per-thread accumulators, each npixels long, back to back
+	@param ntiles		Number of per-thread accumulators
+	@param npixels		Number of pixels in the eye
+ */
+void EyePattern::MergeAccumulators(int64_t* data, const int64_t* tiles, size_t ntiles, size_t npixels)
+{
+	//Split the eye into chunks small enough for all of the tiles' slices to stay in cache
+	size_t nchunks = (npixels + EYE_MERGE_CHUNK_PIXELS - 1) / EYE_MERGE_CHUNK_PIXELS;
+
+	#pragma omp parallel for if(nchunks > 1)
+	for(size_t c=0; c<nchunks; c++)
+	{
+		size_t start = c * EYE_MERGE_CHUNK_PIXELS;
+		size_t len = min(npixels - start, EYE_MERGE_CHUNK_PIXELS);
+
+		#ifdef __x86_64__
+		if(g_hasAvx2)
+			MergeAccumulatorsAVX2(data + start, tiles + start, ntiles, npixels, len);
+		else
+		#endif
+			MergeAccumulatorsGeneric(data + start, tiles + start, ntiles, npixels, len);
+	}
+}
+
+/**
+	@brief Generic backend for MergeAccumulators()
+
+	@param data			Start of this chunk of the eye accumulator buffer
+	@param tiles		Start of this chunk of the first per-thread accumulator
+	@param ntiles		Number of per-thread accumulators
+	@param stride		Distance between consecutive per-thread accumulators
+	@param len			Number of pixels to merge
+ */
+void EyePattern::MergeAccumulatorsGeneric(
+	int64_t* data, const int64_t* tiles, size_t ntiles, size_t stride, size_t len)
+{
+	for(size_t t=0; t<ntiles; t++)
+	{
+		const int64_t* tile = tiles + t*stride;
+		for(size_t i=0; i<len; i++)
+			data[i] += tile[i];
+	}
+}
+
+#ifdef __x86_64__
+/**
+	@brief AVX2 backend for MergeAccumulators()
+
+	Sums four pixels of every tile in registers before writing back, so each output pixel is only stored once.
+ */
+__attribute__((target("avx2")))
+void EyePattern::MergeAccumulatorsAVX2(
+	int64_t* data, const int64_t* tiles, size_t ntiles, size_t stride, size_t len)
+{
+	size_t end = len - (len % 4);
+	for(size_t i=0; i<end; i+=4)
+	{
+		__m256i sum = _mm256_loadu_si256(reinterpret_cast<__m256i*>(data + i));
+		for(size_t t=0; t<ntiles; t++)
+			sum = _mm256_add_epi64(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tiles + t*stride + i)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), sum);
+	}
+
+	//Get any extras we didn't get in the SIMD loop
+	MergeAccumulatorsGeneric(data + end, tiles + end, ntiles, stride, len - end);
+}
+#endif /* __x86_64__ */
+
 #ifdef __x86_64__
 __attribute__((target("avx2")))
 void EyePattern::DensePackedInnerLoopAVX2(
 	UniformAnalogWaveform* waveform,
 	int64_t* data,
+	size_t istart,
 	size_t wend,
+	size_t iclock,
 	size_t cend,
 	int32_t xmax,
 	int32_t ymax,
@@ -442,16 +629,11 @@ void EyePattern::DensePackedInnerLoopAVX2(
 	float yoff
 	)
 {
-	m_clockEdgesMuxed->PrepareForCpuAccess();
-	waveform->PrepareForCpuAccess();
-
 	auto cap = dynamic_cast<EyeWaveform*>(GetData(0));
 	int64_t width = cap->GetUIWidth();
 	int64_t halfwidth = width/2;
 
-	size_t iclock = 0;
-
-	size_t wend_rounded = wend - (wend % 8);
+	size_t wend_rounded = wend - ((wend - istart) % 8);
 
 	//Splat some constants into vector regs
 	__m256i vxoff 		= _mm256_set1_epi32((int)m_xoff);
@@ -469,7 +651,7 @@ void EyePattern::DensePackedInnerLoopAVX2(
 	auto& edges = *m_clockEdgesMuxed;
 
 	//Main unrolled loop, 8 samples per iteration
-	size_t i = 0;
+	size_t i = istart;
 	uint32_t bufmax = m_width * (m_height - 1);
 	__m256i vbufmax		= _mm256_set1_epi32(bufmax - 1);
 	for(; i<wend_rounded && iclock < cend; i+= 8)
@@ -628,15 +810,15 @@ void EyePattern::DensePackedInnerLoopAVX2(
 		pix[0] 		 += EYE_ACCUM_SCALE - bin2;
 		pix[m_width] += bin2;
 	}
-
-	waveform->MarkModifiedFromCpu();
 }
 
 __attribute__((target("avx2,fma")))
 void EyePattern::DensePackedInnerLoopAVX2FMA(
 	UniformAnalogWaveform* waveform,
 	int64_t* data,
+	size_t istart,
 	size_t wend,
+	size_t iclock,
 	size_t cend,
 	int32_t xmax,
 	int32_t ymax,
@@ -645,17 +827,13 @@ void EyePattern::DensePackedInnerLoopAVX2FMA(
 	float yoff
 	)
 {
-	m_clockEdgesMuxed->PrepareForCpuAccess();
-	waveform->PrepareForCpuAccess();
 	auto& edges = *m_clockEdgesMuxed;
 
 	auto cap = dynamic_cast<EyeWaveform*>(GetData(0));
 	int64_t width = cap->GetUIWidth();
 	int64_t halfwidth = width/2;
 
-	size_t iclock = 0;
-
-	size_t wend_rounded = wend - (wend % 8);
+	size_t wend_rounded = wend - ((wend - istart) % 8);
 
 	//Splat some constants into vector regs
 	__m256i vxoff 		= _mm256_set1_epi32((int)m_xoff);
@@ -671,7 +849,7 @@ void EyePattern::DensePackedInnerLoopAVX2FMA(
 	float* samples = (float*)&waveform->m_samples[0];
 
 	//Main unrolled loop, 8 samples per iteration
-	size_t i = 0;
+	size_t i = istart;
 	uint32_t bufmax = m_width * (m_height - 1);
 	__m256i vbufmax		= _mm256_set1_epi32(bufmax - 1);
 	for(; i<wend_rounded && iclock < cend; i+= 8)
@@ -827,15 +1005,15 @@ void EyePattern::DensePackedInnerLoopAVX2FMA(
 		pix[0] 		 += EYE_ACCUM_SCALE - bin2;
 		pix[m_width] += bin2;
 	}
-
-	waveform->MarkModifiedFromCpu();
 }
 
 __attribute__((target("avx512f,fma")))
 void EyePattern::DensePackedInnerLoopAVX512F(
 	UniformAnalogWaveform* waveform,
 	int64_t* data,
+	size_t istart,
 	size_t wend,
+	size_t iclock,
 	size_t cend,
 	int32_t xmax,
 	int32_t ymax,
@@ -844,17 +1022,13 @@ void EyePattern::DensePackedInnerLoopAVX512F(
 	float yoff
 	)
 {
-	m_clockEdgesMuxed->PrepareForCpuAccess();
-	waveform->PrepareForCpuAccess();
 	auto& edges = *m_clockEdgesMuxed;
 
 	auto cap = dynamic_cast<EyeWaveform*>(GetData(0));
 	int64_t width = cap->GetUIWidth();
 	int64_t halfwidth = width/2;
 
-	size_t iclock = 0;
-
-	size_t wend_rounded = wend - (wend % 16);
+	size_t wend_rounded = wend - ((wend - istart) % 16);
 
 	//Splat some constants into vector regs
 	__m512i vxoff 		= _mm512_set1_epi32((int)m_xoff);
@@ -869,7 +1043,7 @@ void EyePattern::DensePackedInnerLoopAVX512F(
 	float* samples = (float*)&waveform->m_samples[0];
 
 	//Main unrolled loop, 16 samples per iteration
-	size_t i = 0;
+	size_t i = istart;
 	uint32_t bufmax = m_width * (m_height - 1);
 	for(; i<wend_rounded && iclock < cend; i+= 16)
 	{
@@ -1017,8 +1191,6 @@ void EyePattern::DensePackedInnerLoopAVX512F(
 		pix[0] 		 += EYE_ACCUM_SCALE - bin2;
 		pix[m_width] += bin2;
 	}
-
-	waveform->MarkModifiedFromCpu();
 }
 #endif /* __x86_64__ */
 
@@ -1091,7 +1263,9 @@ void EyePattern::DensePackedInnerLoopGPU(
 void EyePattern::DensePackedInnerLoop(
 	UniformAnalogWaveform* waveform,
 	int64_t* data,
+	size_t istart,
 	size_t wend,
+	size_t iclock,
 	size_t cend,
 	int32_t xmax,
 	int32_t ymax,
@@ -1100,16 +1274,13 @@ void EyePattern::DensePackedInnerLoop(
 	float yoff
 	)
 {
-	m_clockEdgesMuxed->PrepareForCpuAccess();
-	waveform->PrepareForCpuAccess();
 	auto& edges = *m_clockEdgesMuxed;
 
 	auto cap = dynamic_cast<EyeWaveform*>(GetData(0));
 	int64_t width = cap->GetUIWidth();
 	int64_t halfwidth = width/2;
 
-	size_t iclock = 0;
-	for(size_t i=0; i<wend && iclock < cend; i++)
+	for(size_t i=istart; i<wend && iclock < cend; i++)
 	{
 		//Find time of this sample.
 		//If it's past the end of the current UI, move to the next clock edge
@@ -1163,14 +1334,14 @@ void EyePattern::DensePackedInnerLoop(
 		pix[0] 		 += 64 - bin2;
 		pix[m_width] += bin2;
 	}
-
-	waveform->MarkModifiedFromCpu();
 }
 
 void EyePattern::SparsePackedInnerLoop(
 	SparseAnalogWaveform* waveform,
 	int64_t* data,
+	size_t istart,
 	size_t wend,
+	size_t iclock,
 	size_t cend,
 	int32_t xmax,
 	int32_t ymax,
@@ -1179,16 +1350,13 @@ void EyePattern::SparsePackedInnerLoop(
 	float yoff
 	)
 {
-	m_clockEdgesMuxed->PrepareForCpuAccess();
-	waveform->PrepareForCpuAccess();
 	auto& edges = *m_clockEdgesMuxed;
 
 	auto cap = dynamic_cast<EyeWaveform*>(GetData(0));
 	int64_t width = cap->GetUIWidth();
 	int64_t halfwidth = width/2;
 
-	size_t iclock = 0;
-	for(size_t i=0; i<wend && iclock < cend; i++)
+	for(size_t i=istart; i<wend && iclock < cend; i++)
 	{
 		//Find time of this sample.
 		//If it's past the end of the current UI, move to the next clock edge
@@ -1243,8 +1411,6 @@ void EyePattern::SparsePackedInnerLoop(
 		pix[0] 		 += 64 - bin2;
 		pix[m_width] += bin2;
 	}
-
-	waveform->MarkModifiedFromCpu();
 }
 
 EyeWaveform* EyePattern::ReallocateWaveform()
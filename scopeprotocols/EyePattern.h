@@ -91,6 +91,8 @@ public:
 		if(m_width != width)
 		{
 			SetData(NULL, 0);
+			ReleaseThreadAccumulators();
+			InvalidateRefreshState();
 			m_width = width;
 		}
 	}
@@ -100,6 +102,8 @@ public:
 		if(m_height != height)
 		{
 			SetData(NULL, 0);
+			ReleaseThreadAccumulators();
+			InvalidateRefreshState();
 			m_height = height;
 		}
 	}
@@ -151,10 +155,46 @@ protected:
 
 	void RecalculateUIWidth(EyeWaveform* cap);
 
+	void IntegrateMultithreaded(
+		WaveformBase* waveform,
+		int64_t* data,
+		size_t wend,
+		size_t cend,
+		int32_t xmax,
+		int32_t ymax,
+		float xtimescale,
+		float yscale,
+		float yoff
+		);
+
+	static void MergeAccumulators(int64_t* data, const int64_t* tiles, size_t ntiles, size_t npixels);
+	static void MergeAccumulatorsGeneric(
+		int64_t* data, const int64_t* tiles, size_t ntiles, size_t stride, size_t len);
+#ifdef __x86_64__
+	static void MergeAccumulatorsAVX2(
+		int64_t* data, const int64_t* tiles, size_t ntiles, size_t stride, size_t len);
+#endif
+
+	///@brief Minimum number of samples worth giving a thread its own accumulator for
+	static const size_t EYE_MIN_BLOCK_SAMPLES = 1024 * 1024;
+
+	///@brief Alignment of block boundaries in IntegrateMultithreaded(), a multiple of every SIMD loop's width
+	static const size_t EYE_BLOCK_ALIGN = 64;
+
+	///@brief Number of pixels merged at a time by MergeAccumulators()
+	static const size_t EYE_MERGE_CHUNK_PIXELS = 4096;
+
+	///@brief Upper bound on the memory kept in m_threadAccumulators, limits how many threads can split the eye
+	static const size_t EYE_MAX_ACCUMULATOR_BYTES = 64 * 1024 * 1024;
+
+	void ReleaseThreadAccumulators();
+
 	void SparsePackedInnerLoop(
 		SparseAnalogWaveform* waveform,
 		int64_t* data,
+		size_t istart,
 		size_t wend,
+		size_t iclock,
 		size_t cend,
 		int32_t xmax,
 		int32_t ymax,
@@ -166,7 +206,9 @@ protected:
 	void DensePackedInnerLoop(
 		UniformAnalogWaveform* waveform,
 		int64_t* data,
+		size_t istart,
 		size_t wend,
+		size_t iclock,
 		size_t cend,
 		int32_t xmax,
 		int32_t ymax,
@@ -193,7 +235,9 @@ protected:
 	void DensePackedInnerLoopAVX2(
 		UniformAnalogWaveform* waveform,
 		int64_t* data,
+		size_t istart,
 		size_t wend,
+		size_t iclock,
 		size_t cend,
 		int32_t xmax,
 		int32_t ymax,
@@ -205,7 +249,9 @@ protected:
 	void DensePackedInnerLoopAVX2FMA(
 		UniformAnalogWaveform* waveform,
 		int64_t* data,
+		size_t istart,
 		size_t wend,
+		size_t iclock,
 		size_t cend,
 		int32_t xmax,
 		int32_t ymax,
@@ -217,7 +263,9 @@ protected:
 	void DensePackedInnerLoopAVX512F(
 		UniformAnalogWaveform* waveform,
 		int64_t* data,
+		size_t istart,
 		size_t wend,
+		size_t iclock,
 		size_t cend,
 		int32_t xmax,
 		int32_t ymax,
@@ -251,6 +299,10 @@ protected:
 	AcceleratorBuffer<uint32_t> m_indexBuffer;
 
 	AcceleratorBuffer<int64_t>* m_clockEdgesMuxed;
+
+	///@brief Private accumulators for all but the first thread integrating the eye on the CPU
+	std::vector<int64_t> m_threadAccumulators;
+
 	AcceleratorBuffer<int64_t> m_normalizeMaxBuf;
 
 	std::shared_ptr<ComputePipeline> m_eyeComputePipeline;
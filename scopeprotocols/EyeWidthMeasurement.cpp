@@ -101,10 +101,15 @@ void EyeWidthMeasurement::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Qu
 
 	//Create the output
 	auto cap = SetupEmptySparseAnalogOutputWaveform(din, 0);
-	cmdBuf.begin({});
-	din->GetAccumBuffer().PrepareForCpuAccessNonblocking(cmdBuf);
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
+	if(g_gpuFilterEnabled)
+	{
+		cmdBuf.begin({});
+		din->GetAccumBuffer().PrepareForCpuAccessNonblocking(cmdBuf);
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+	}
+	else
+		din->GetAccumBuffer().PrepareForCpuAccess();
 	cap->m_timescale = 1;
 
 	//Make sure voltages are in the right order
@@ -129,19 +129,16 @@ void FFTFilter::ReallocateBuffers(size_t npoints_raw, size_t npoints, size_t nou
 	if(m_cachedNumPointsFFT != npoints)
 		m_cachedNumPointsFFT = npoints;
 
-	//Update our FFT plan if it's out of date
-	m_rdinbuf.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_rdinbuf.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
-	m_rdoutbuf.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_rdoutbuf.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
+	//Scratch buffers live wherever the FFT runs
+	auto cpuHint = g_gpuFilterEnabled ? AcceleratorBuffer<float>::HINT_NEVER : AcceleratorBuffer<float>::HINT_LIKELY;
+	auto gpuHint = g_gpuFilterEnabled ? AcceleratorBuffer<float>::HINT_LIKELY : AcceleratorBuffer<float>::HINT_NEVER;
+	m_rdinbuf.SetCpuAccessHint(cpuHint);
+	m_rdinbuf.SetGpuAccessHint(gpuHint);
+	m_rdoutbuf.SetCpuAccessHint(cpuHint);
+	m_rdoutbuf.SetGpuAccessHint(gpuHint);
 
-	if(m_vkPlan)
-	{
-		if(m_vkPlan->size() != npoints)
-			m_vkPlan = nullptr;
-	}
-	if(!m_vkPlan)
-		m_vkPlan = make_unique<VulkanFFTPlan>(npoints, nouts, VulkanFFTPlan::DIRECTION_FORWARD);
+	//Update our FFT plan if it's out of date
+	FFTPlan::Update(m_plan, npoints, nouts, FFTPlan::DIRECTION_FORWARD);
 
 	m_rdinbuf.resize(npoints);
 	m_rdoutbuf.resize(2*nouts);
@@ -166,7 +163,7 @@ void FFTFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHandle>
 	//Reallocate buffers if size has changed
 	const size_t nouts = npoints/2 + 1;
 	m_cachedNumOuts = nouts;
-	if(m_cachedNumPoints != npoints)
+	if( (m_cachedNumPoints != npoints) || !m_plan || (m_plan->IsGpuPlan() != g_gpuFilterEnabled) )
 		ReallocateBuffers(npoints, npoints, nouts);
 	LogTrace("Output: %zu\n", nouts);
 
@@ -253,64 +250,206 @@ void FFTFilter::DoRefresh(
 	}
 	args.alpha1 = 1 - args.alpha0;
 
-	//Prepare to do all of our compute stuff in one dispatch call to reduce overhead
-	cmdBuf.begin({});
+	ComplexToMagnitudeArgs cargs;
+	cargs.npoints = nouts;
+	if(log_output)
+	{
+		const float impedance = 50;
+		cargs.scale = scale * scale / impedance;
+	}
+	else
+		cargs.scale = scale;
+
+	if(g_gpuFilterEnabled)
+	{
+		//Prepare to do all of our compute stuff in one dispatch call to reduce overhead
+		cmdBuf.begin({});
+
+		//Apply the window function
+		ComputePipeline* wpipe = nullptr;
+		switch(window)
+		{
+			case WINDOW_BLACKMAN_HARRIS:
+				wpipe = &m_blackmanHarrisComputePipeline;
+				break;
+
+			case WINDOW_HANN:
+			case WINDOW_HAMMING:
+				wpipe = &m_cosineSumComputePipeline;
+				break;
+
+			default:
+			case WINDOW_RECTANGULAR:
+				wpipe = &m_rectangularComputePipeline;
+				break;
+		}
+		wpipe->BindBufferNonblocking(0, data, cmdBuf);
+		wpipe->BindBufferNonblocking(1, m_rdinbuf, cmdBuf, true);
+		const uint32_t compute_block_count = GetComputeBlockCount(npoints, 64);
+		wpipe->Dispatch(cmdBuf, args,
+			min(compute_block_count, 32768u),
+			compute_block_count / 32768 + 1);
+		wpipe->AddComputeMemoryBarrier(cmdBuf);
+		m_rdinbuf.MarkModifiedFromGpu();
+
+		//Do the actual FFT operation
+		m_plan->AppendForward(m_rdinbuf, m_rdoutbuf, cmdBuf);
+
+		//Convert complex to real
+		ComputePipeline& pipe = log_output ?
+			m_complexToLogMagnitudeComputePipeline : m_complexToMagnitudeComputePipeline;
+		pipe.BindBuffer(0, m_rdoutbuf);
+		pipe.BindBuffer(1, cap->m_samples);
+		pipe.AddComputeMemoryBarrier(cmdBuf);
+		pipe.Dispatch(cmdBuf, cargs,
+			min(compute_block_count, 32768u),
+			compute_block_count / 32768 + 1);
+
+		//Done, block until the compute operations finish
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+
+		cap->MarkModifiedFromGpu();
+	}
+
+	else
+	{
+		data.PrepareForCpuAccess();
+		m_rdinbuf.PrepareForCpuAccess();
+		ApplyWindowFunction(data.GetCpuPointer(), m_rdinbuf.GetCpuPointer(), window, args);
+		m_rdinbuf.MarkModifiedFromCpu();
+
+		m_plan->AppendForward(m_rdinbuf, m_rdoutbuf, cmdBuf);
+
+		//Convert complex to real
+		cap->PrepareForCpuAccess();
+		const float* fin = m_rdoutbuf.GetCpuPointer();
+		float* fout = cap->m_samples.GetCpuPointer();
+		if(log_output)
+		{
+			#pragma omp parallel for
+			for(size_t i=0; i<nouts; i++)
+			{
+				float v = fin[i*2]*fin[i*2] + fin[i*2 + 1]*fin[i*2 + 1];
+				fout[i] = 10 * log10(v * cargs.scale) + 30;
+			}
+		}
+		else
+		{
+			#pragma omp parallel for
+			for(size_t i=0; i<nouts; i++)
+				fout[i] = sqrt(fin[i*2]*fin[i*2] + fin[i*2 + 1]*fin[i*2 + 1]) * cargs.scale;
+		}
+		cap->MarkModifiedFromCpu();
+	}
+
+	//Peak search (for now this runs on the CPU)
+	FindPeaks(cap, cmdBuf, queue);
+}
+
+/**
+	@brief Applies a window function to a real signal on the CPU
+
+	Same semantics as the window shaders: samples past args.numActualSamples are zero filled.
+
+	@param din		Input samples (read starting at args.offsetIn)
+	@param dout		Output samples (written starting at args.offsetOut)
+	@param window	The window function to use
+	@param args		Window configuration
+ */
+void FFTFilter::ApplyWindowFunction(
+	const float* din,
+	float* dout,
+	WindowFunction window,
+	const WindowFunctionArgs& args)
+{
+	din += args.offsetIn;
+	dout += args.offsetOut;
+	size_t nactual = min(args.numActualSamples, args.npoints);
 
-	//Apply the window function
-	ComputePipeline* wpipe = nullptr;
 	switch(window)
 	{
 		case WINDOW_BLACKMAN_HARRIS:
-			wpipe = &m_blackmanHarrisComputePipeline;
+			#pragma omp parallel for if(nactual > 65536)
+			for(size_t i=0; i<nactual; i++)
+			{
+				float num = i * args.scale;
+				float w =
+					0.35875f -
+					0.48829f * cos(num) +
+					0.14128f * cos(2*num) -
+					0.01168f * cos(6*num);
+				dout[i] = w * din[i];
+			}
 			break;
 
 		case WINDOW_HANN:
 		case WINDOW_HAMMING:
-			wpipe = &m_cosineSumComputePipeline;
+			#pragma omp parallel for if(nactual > 65536)
+			for(size_t i=0; i<nactual; i++)
+				dout[i] = (args.alpha0 - args.alpha1*cos(i*args.scale)) * din[i];
 			break;
 
-		default:
 		case WINDOW_RECTANGULAR:
-			wpipe = &m_rectangularComputePipeline;
+		default:
+			memcpy(dout, din, nactual * sizeof(float));
 			break;
 	}
-	wpipe->BindBufferNonblocking(0, data, cmdBuf);
-	wpipe->BindBufferNonblocking(1, m_rdinbuf, cmdBuf, true);
-	const uint32_t compute_block_count = GetComputeBlockCount(npoints, 64);
-	wpipe->Dispatch(cmdBuf, args,
-		min(compute_block_count, 32768u),
-		compute_block_count / 32768 + 1);
-	wpipe->AddComputeMemoryBarrier(cmdBuf);
-	m_rdinbuf.MarkModifiedFromGpu();
-
-	//Do the actual FFT operation
-	m_vkPlan->AppendForward(m_rdinbuf, m_rdoutbuf, cmdBuf);
-
-	//Convert complex to real
-	ComputePipeline& pipe = log_output ?
-		m_complexToLogMagnitudeComputePipeline : m_complexToMagnitudeComputePipeline;
-	ComplexToMagnitudeArgs cargs;
-	cargs.npoints = nouts;
-	if(log_output)
-	{
-		const float impedance = 50;
-		cargs.scale = scale * scale / impedance;
-	}
-	else
-		cargs.scale = scale;
-	pipe.BindBuffer(0, m_rdoutbuf);
-	pipe.BindBuffer(1, cap->m_samples);
-	pipe.AddComputeMemoryBarrier(cmdBuf);
-	pipe.Dispatch(cmdBuf, cargs,
-		min(compute_block_count, 32768u),
-		compute_block_count / 32768 + 1);
 
-	//Done, block until the compute operations finish
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
+	for(size_t i=nactual; i<args.npoints; i++)
+		dout[i] = 0;
+}
 
-	cap->MarkModifiedFromGpu();
+/**
+	@brief Applies a window function to a complex signal on the CPU, interleaving the output
+
+	@param dinI		In-phase input samples (read starting at args.offsetIn)
+	@param dinQ		Quadrature input samples (read starting at args.offsetIn)
+	@param dout		Interleaved complex output (written starting at complex sample args.offsetOut)
+	@param window	The window function to use
+	@param args		Window configuration
+ */
+void FFTFilter::ApplyComplexWindowFunction(
+	const float* dinI,
+	const float* dinQ,
+	float* dout,
+	WindowFunction window,
+	const WindowFunctionArgs& args)
+{
+	dinI += args.offsetIn;
+	dinQ += args.offsetIn;
+	dout += args.offsetOut*2;
+	size_t nactual = min(args.numActualSamples, args.npoints);
 
-	//Peak search (for now this runs on the CPU)
-	FindPeaks(cap, cmdBuf, queue);
+	#pragma omp parallel for if(nactual > 65536)
+	for(size_t i=0; i<nactual; i++)
+	{
+		float w;
+		float num = i * args.scale;
+		switch(window)
+		{
+			case WINDOW_BLACKMAN_HARRIS:
+				w = 0.35875f - 0.48829f * cos(num) + 0.14128f * cos(2*num) - 0.01168f * cos(6*num);
+				break;
+
+			case WINDOW_HANN:
+			case WINDOW_HAMMING:
+				w = args.alpha0 - args.alpha1*cos(num);
+				break;
+
+			case WINDOW_RECTANGULAR:
+			default:
+				w = 1;
+				break;
+		}
+
+		dout[i*2]		= w * dinI[i];
+		dout[i*2 + 1]	= w * dinQ[i];
+	}
+
+	for(size_t i=nactual; i<args.npoints; i++)
+	{
+		dout[i*2]		= 0;
+		dout[i*2 + 1]	= 0;
+	}
 }
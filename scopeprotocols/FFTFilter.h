@@ -76,6 +76,19 @@ public:
 	void SetWindowFunction(WindowFunction f)
 	{ m_parameters[m_windowName].SetIntVal(f); }
 
+	static void ApplyWindowFunction(
+		const float* din,
+		float* dout,
+		WindowFunction window,
+		const WindowFunctionArgs& args);
+
+	static void ApplyComplexWindowFunction(
+		const float* dinI,
+		const float* dinQ,
+		float* dout,
+		WindowFunction window,
+		const WindowFunctionArgs& args);
+
 	//Accessors for internal values only used by unit tests
 	//TODO: refactor this into a friend class or something?
 	size_t test_GetNumPoints()
@@ -110,7 +123,7 @@ protected:
 
 	std::string m_windowName;
 
-	std::unique_ptr<VulkanFFTPlan> m_vkPlan;
+	std::unique_ptr<FFTPlan> m_plan;
 
 	ComputePipeline m_blackmanHarrisComputePipeline;
 	ComputePipeline m_rectangularComputePipeline;
@@ -142,6 +142,8 @@ void HistogramFilter::SetOffset(float offset, size_t /*stream*/)
 
 void HistogramFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	m_min = FLT_MAX;
 	m_max = -FLT_MAX;
 	m_histogram.clear();
@@ -272,7 +274,7 @@ void HistogramFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueH
 
 	//Calculate histogram for our incoming data
 	size_t vmax = 0;
-	if(g_hasShaderInt64 && g_hasShaderAtomicInt64)
+	if(g_gpuFilterEnabled && g_hasShaderInt64 && g_hasShaderAtomicInt64)
 	{
 		//GPU side histogram calculation
 		if(sdin)
@@ -292,13 +294,18 @@ void HistogramFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueH
 	else
 	{
 		//CPU side fallback
-		cmdBuf.begin({});
-		if(sdin)
-			sdin->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
+		if(g_gpuFilterEnabled)
+		{
+			cmdBuf.begin({});
+			if(sdin)
+				sdin->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
+			else
+				udin->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
+			cmdBuf.end();
+			queue->SubmitAndBlock(cmdBuf);
+		}
 		else
-			udin->m_samples.PrepareForCpuAccessNonblocking(cmdBuf);
-		cmdBuf.end();
-		queue->SubmitAndBlock(cmdBuf);
+			din->PrepareForCpuAccess();
 
 		auto data = MakeHistogram(sdin, udin, m_min, m_max, bins);
 
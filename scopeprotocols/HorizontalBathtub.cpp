@@ -94,10 +94,15 @@ void HorizontalBathtub::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Queu
 
 	//Get the input data
 	auto din = dynamic_cast<EyeWaveform*>(GetInputWaveform(0));
-	cmdBuf.begin({});
-	din->GetAccumBuffer().PrepareForCpuAccessNonblocking(cmdBuf);
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
+	if(g_gpuFilterEnabled)
+	{
+		cmdBuf.begin({});
+		din->GetAccumBuffer().PrepareForCpuAccessNonblocking(cmdBuf);
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+	}
+	else
+		din->GetAccumBuffer().PrepareForCpuAccess();
 	float threshold = m_parameters[m_voltageName].GetFloatVal();
 
 	//Find the eye bin for this height
@@ -114,7 +114,8 @@ void IBM8b10bDecoder::Refresh()
 
 	//Record the value of the data stream at each clock edge
 	//TODO: allow single rate clocks too?
-	SparseDigitalWaveform data;
+	ScratchWaveform<SparseDigitalWaveform> sampled(this, "IBM8b10bDecoder.data");
+	auto& data = *sampled;
 	SampleOnAnyEdgesBase(din, clkin, data);
 	data.PrepareForCpuAccess();
 
@@ -130,17 +130,41 @@ void IQDemuxFilter::Refresh(
 		//Look at a fixed window in the start of the waveform and see which one has the least (0,0) symbols
 		size_t window = min(len, (size_t)10000);
 
+		//No GPU, count them on the CPU instead
+		if(!g_gpuFilterEnabled)
+		{
+			din->PrepareForCpuAccess();
+			m_alignOut.PrepareForCpuAccess();
+
+			for(size_t phase=0; phase<2; phase++)
+			{
+				uint32_t hits = 0;
+				for(size_t i=phase; i+1 < window; i += 2)
+				{
+					//For now, fixed threshold of +/- 250 mV for zero code
+					if( (fabs(din->m_samples[i]) < 0.25) && (fabs(din->m_samples[i+1]) < 0.25) )
+						hits ++;
+				}
+				m_alignOut[phase] = hits;
+			}
+
+			m_alignOut.MarkModifiedFromCpu();
+		}
+
 		//Do the alignment check on the GPU
-		cmdBuf.begin({});
+		else
+		{
+			cmdBuf.begin({});
 
-		m_alignComputePipeline->BindBufferNonblocking(0, din->m_samples, cmdBuf);
-		m_alignComputePipeline->BindBufferNonblocking(1, m_alignOut, cmdBuf, true);
-		m_alignComputePipeline->Dispatch(cmdBuf, (uint32_t)window, 2);
-		m_alignComputePipeline->AddComputeMemoryBarrier(cmdBuf);
-		m_alignOut.PrepareForCpuAccessNonblocking(cmdBuf);
+			m_alignComputePipeline->BindBufferNonblocking(0, din->m_samples, cmdBuf);
+			m_alignComputePipeline->BindBufferNonblocking(1, m_alignOut, cmdBuf, true);
+			m_alignComputePipeline->Dispatch(cmdBuf, (uint32_t)window, 2);
+			m_alignComputePipeline->AddComputeMemoryBarrier(cmdBuf);
+			m_alignOut.PrepareForCpuAccessNonblocking(cmdBuf);
 
-		cmdBuf.end();
-		queue->SubmitAndBlock(cmdBuf);
+			cmdBuf.end();
+			queue->SubmitAndBlock(cmdBuf);
+		}
 
 		LogTrace("Phase 0: zeros = %u\n", m_alignOut[0]);
 		LogTrace("Phase 1: zeros = %u\n", m_alignOut[1]);
@@ -158,7 +182,7 @@ void IQDemuxFilter::Refresh(
 	iout->Resize(outlen);
 	qout->Resize(outlen);
 
-	if(g_hasShaderInt64)
+	if(g_gpuFilterEnabled && g_hasShaderInt64)
 	{
 		cmdBuf.begin({});
 
@@ -190,6 +214,7 @@ void IQDemuxFilter::Refresh(
 
 	else
 	{
+		din->PrepareForCpuAccess();
 		iout->PrepareForCpuAccess();
 		qout->PrepareForCpuAccess();
 
@@ -96,6 +96,12 @@ string NCOFilter::GetProtocolName()
 	return "NCO";
 }
 
+bool NCOFilter::IsRefreshAlwaysRequired()
+{
+	//We're a waveform generator, new output every time even if the frequency input is constant
+	return true;
+}
+
 void NCOFilter::OnUnitChanged()
 {
 	Unit unit(static_cast<Unit::UnitType>(m_parameters[m_unitname].GetIntVal()));
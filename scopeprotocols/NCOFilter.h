@@ -45,6 +45,7 @@ public:
 	static std::string GetProtocolName();
 
 	virtual bool ValidateChannel(size_t i, StreamDescriptor stream) override;
+	virtual bool IsRefreshAlwaysRequired() override;
 
 	PROTOCOL_DECODER_INITPROC(NCOFilter)
 
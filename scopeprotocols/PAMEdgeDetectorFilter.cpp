@@ -185,7 +185,7 @@ void PAMEdgeDetectorFilter::Refresh(
 
 	//Find *all* level crossings
 	//This will double-count some edges (e.g. a +1 to -1 edge will show up as +1 to 0 and 0 to -1)
-	if(g_hasShaderInt8)
+	if(g_gpuFilterEnabled && g_hasShaderInt8)
 	{
 		//Prepare thresholds for GPU
 		//TODO: only if changed
@@ -322,7 +322,7 @@ void PAMEdgeDetectorFilter::Refresh(
 	LogTrace("First pass: Found %zu level crossings\n", m_edgeIndexes.size());
 
 	//GPU merge
-	if(g_hasShaderInt64 && g_hasShaderInt8)
+	if(g_gpuFilterEnabled && g_hasShaderInt64 && g_hasShaderInt8)
 	{
 		cmdBuf.begin({});
 
@@ -92,7 +92,8 @@ void PCIe128b130bDecoder::Refresh()
 	cap->PrepareForCpuAccess();
 
 	//Record the value of the data stream at each clock edge
-	SparseDigitalWaveform data;
+	ScratchWaveform<SparseDigitalWaveform> sampled(this, "PCIe128b130bDecoder.data");
+	auto& data = *sampled;
 	SampleOnAnyEdgesBase(din, clkin, data);
 
 	//Look at each phase and figure out block alignment
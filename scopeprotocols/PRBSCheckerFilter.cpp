@@ -41,6 +41,8 @@ PRBSCheckerFilter::PRBSCheckerFilter(const string& color)
 	, m_polyname("Polynomial")
 {
 	AddDigitalStream("data");
+	AddStream(Unit(Unit::UNIT_COUNTS), "errors", Stream::STREAM_TYPE_ANALOG_SCALAR);
+	AddStream(Unit(Unit::UNIT_RATIO_SCI), "ber", Stream::STREAM_TYPE_ANALOG_SCALAR);
 
 	CreateInput("Data");
 	CreateInput("Clock");
@@ -122,6 +124,8 @@ void PRBSCheckerFilter::Refresh()
 	if(!VerifyAllInputsOK())
 	{
 		SetData(NULL, 0);
+		m_streams[1].m_value = 0;
+		m_streams[2].m_value = 0;
 		return;
 	}
 
@@ -132,7 +136,8 @@ void PRBSCheckerFilter::Refresh()
 	din->PrepareForCpuAccess();
 	clkin->PrepareForCpuAccess();
 
-	SparseDigitalWaveform data;
+	ScratchWaveform<SparseDigitalWaveform> sampled(this, "PRBSChecker.data");
+	auto& data = *sampled;
 	data.PrepareForCpuAccess();
 	SampleOnAnyEdgesBase(din, clkin, data);
 
@@ -146,6 +151,8 @@ void PRBSCheckerFilter::Refresh()
 	if(len < statesize)
 	{
 		SetData(NULL, 0);
+		m_streams[1].m_value = 0;
+		m_streams[2].m_value = 0;
 		return;
 	}
 
@@ -156,25 +163,49 @@ void PRBSCheckerFilter::Refresh()
 	dout->Resize(len);
 
 	//Read the first N bits of state into the seed
+	auto pin = data.m_samples.GetCpuPointer();
+	auto pout = dout->m_samples.GetCpuPointer();
 	uint32_t prbs = 0;
 	for(size_t i=0; i<statesize; i++)
 	{
-		prbs = (prbs << 1) | data.m_samples[i];
-
-		dout->m_offsets[i] = data.m_offsets[i];
-		dout->m_durations[i] = data.m_durations[i];
-		dout->m_samples[i] = 0;
+		prbs = (prbs << 1) | pin[i];
+		pout[i] = 0;
 	}
-
-	//Start checking actual data bits
-	for(size_t i=statesize; i<len; i++)
+	memcpy(dout->m_offsets.GetCpuPointer(), data.m_offsets.GetCpuPointer(), len * sizeof(int64_t));
+	memcpy(dout->m_durations.GetCpuPointer(), data.m_durations.GetCpuPointer(), len * sizeof(int64_t));
+
+	//Generate the expected sequence for the rest of the data, 64 bits at a time
+	size_t nbits = len - statesize;
+	size_t nwords = (nbits + 63) / 64;
+	m_expected.resize(nwords);
+	PRBSGeneratorFilter::GeneratePRBS(prbs, poly, m_expected.data(), nbits);
+
+	//Pack each word of received data, compare against the expected data, and count errors
+	auto expected = m_expected.data();
+	pin += statesize;
+	pout += statesize;
+	int64_t errors = 0;
+	#pragma omp parallel for reduction(+:errors) if(nwords > 16384)
+	for(size_t i=0; i<nwords; i++)
 	{
-		dout->m_offsets[i] = data.m_offsets[i];
-		dout->m_durations[i] = data.m_durations[i];
+		size_t base = i*64;
+		size_t n = min(static_cast<size_t>(64), nbits - base);
+
+		uint64_t w = 0;
+		for(size_t j=0; j<n; j++)
+			w |= static_cast<uint64_t>(pin[base + j]) << j;
 
-		bool value = PRBSGeneratorFilter::RunPRBS(prbs, poly);
-		dout->m_samples[i] = (value != data.m_samples[i]);
+		uint64_t err = w ^ expected[i];
+		if(n < 64)
+			err &= (1ULL << n) - 1;
+		errors += __builtin_popcountll(err);
+
+		for(size_t j=0; j<n; j++)
+			pout[base + j] = (err >> j) & 1;
 	}
 
+	m_streams[1].m_value = errors;
+	m_streams[2].m_value = nbits ? (static_cast<double>(errors) / nbits) : 0;
+
 	dout->MarkModifiedFromCpu();
 }
@@ -51,6 +51,9 @@ public:
 
 protected:
 	std::string m_polyname;
+
+	///@brief Expected data bits, packed LSB first
+	std::vector<uint64_t> m_expected;
 };
 
 #endif
@@ -117,40 +117,224 @@ void PRBSGeneratorFilter::SetDefaultName()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Actual decoder logic
 
-bool PRBSGeneratorFilter::RunPRBS(uint32_t& state, Polynomials poly)
+/**
+	@brief Gets the feedback taps for a polynomial
+
+	The next bit shifted into the LSB of the state is the XOR of state bits tap1 and tap2, so each output bit is the
+	XOR of the bits output (tap1 + 1) and (tap2 + 1) steps earlier.
+ */
+void PRBSGeneratorFilter::GetTaps(Polynomials poly, unsigned int& tap1, unsigned int& tap2)
 {
-	uint32_t next;
 	switch(poly)
 	{
 		case POLY_PRBS7:
-			next = ( (state >> 6) ^ (state >> 5) ) & 1;
+			tap1 = 6;
+			tap2 = 5;
 			break;
 
 		case POLY_PRBS9:
-			next = ( (state >> 8) ^ (state >> 4) ) & 1;
+			tap1 = 8;
+			tap2 = 4;
 			break;
 
 		case POLY_PRBS11:
-			next = ( (state >> 10) ^ (state >> 8) ) & 1;
+			tap1 = 10;
+			tap2 = 8;
 			break;
 
 		case POLY_PRBS15:
-			next = ( (state >> 14) ^ (state >> 13) ) & 1;
+			tap1 = 14;
+			tap2 = 13;
 			break;
 
 		case POLY_PRBS23:
-			next = ( (state >> 22) ^ (state >> 17) ) & 1;
+			tap1 = 22;
+			tap2 = 17;
 			break;
 
 		case POLY_PRBS31:
 		default:
-			next = ( (state >> 30) ^ (state >> 27) ) & 1;
+			tap1 = 30;
+			tap2 = 27;
 			break;
 	}
+}
+
+/**
+	@brief Advances the PRBS by one bit
+
+	@param state	LFSR state (the most recently output bit is in the LSB)
+	@param poly		Polynomial
+
+	@return The new bit
+ */
+bool PRBSGeneratorFilter::RunPRBS(uint32_t& state, Polynomials poly)
+{
+	unsigned int tap1;
+	unsigned int tap2;
+	GetTaps(poly, tap1, tap2);
+
+	uint32_t next = ( (state >> tap1) ^ (state >> tap2) ) & 1;
 	state = (state << 1) | next;
 	return (bool)next;
 }
 
+/**
+	@brief Computes the state of the PRBS after a given number of steps, without generating the intermediate bits
+
+	The LFSR update is linear over GF(2), so stepping is multiplication by a constant matrix. The matrix is repeatedly
+	squared to get the leap-forward matrices for 1, 2, 4, 8... steps, and the ones selected by the bits of the step
+	count are applied to the state. This is O(log steps) rather than O(steps).
+
+	@param state	Initial LFSR state
+	@param poly		Polynomial
+	@param steps	Number of bits to advance by
+
+	@return The new state. Only the low (poly) bits are valid.
+ */
+uint32_t PRBSGeneratorFilter::JumpPRBS(uint32_t state, Polynomials poly, uint64_t steps)
+{
+	unsigned int tap1;
+	unsigned int tap2;
+	GetTaps(poly, tap1, tap2);
+	unsigned int nbits = poly;
+
+	//Column j of the matrix is where state bit j ends up after one step
+	uint32_t cols[32];
+	for(unsigned int j=0; j<nbits; j++)
+	{
+		cols[j] = (j+1 < nbits) ? (1U << (j+1)) : 0;
+		if( (j == tap1) || (j == tap2) )
+			cols[j] |= 1;
+	}
+
+	auto apply = [&](const uint32_t* m, uint32_t v)
+	{
+		uint32_t ret = 0;
+		for(unsigned int j=0; j<nbits; j++)
+		{
+			if(v & (1U << j))
+				ret ^= m[j];
+		}
+		return ret;
+	};
+
+	state &= (nbits == 32) ? 0xffffffff : ( (1U << nbits) - 1);
+	while(steps)
+	{
+		if(steps & 1)
+			state = apply(cols, state);
+
+		//Square the matrix for the next bit of the step count
+		uint32_t squared[32];
+		for(unsigned int j=0; j<nbits; j++)
+			squared[j] = apply(cols, cols[j]);
+		memcpy(cols, squared, sizeof(uint32_t) * nbits);
+
+		steps >>= 1;
+	}
+
+	return state;
+}
+
+/**
+	@brief Generates a block of PRBS output, 64 bits at a time
+
+	Each output bit is the XOR of two earlier bits (b[n] = b[n-N] ^ b[n-M]). Squaring the characteristic polynomial
+	over GF(2) shows that b[n] = b[n-2N] ^ b[n-2M] as well, and likewise for any power of two. Once both lags are at
+	least 64, an entire 64-bit word depends only on words which have already been generated, so after a short serial
+	prefix the block is produced a whole word at a time with two unaligned loads and an XOR.
+
+	@param state	LFSR state at the start of the block
+	@param poly		Polynomial
+	@param out		Output bits, LSB first
+	@param nwords	Number of 64-bit words to generate
+ */
+void PRBSGeneratorFilter::GeneratePRBSBlock(uint32_t state, Polynomials poly, uint64_t* out, size_t nwords)
+{
+	unsigned int tap1;
+	unsigned int tap2;
+	GetTaps(poly, tap1, tap2);
+
+	//Find lags of the decimated recurrence
+	size_t lag1 = tap1 + 1;
+	size_t lag2 = tap2 + 1;
+	while(lag2 < 64)
+	{
+		lag1 *= 2;
+		lag2 *= 2;
+	}
+
+	//Generate enough bits serially to cover the longest lag
+	size_t nserial = min(nwords, (lag1 + 63) / 64);
+	for(size_t i=0; i<nserial; i++)
+	{
+		uint64_t w = 0;
+		for(size_t j=0; j<64; j++)
+			w |= static_cast<uint64_t>(RunPRBS(state, poly)) << j;
+		out[i] = w;
+	}
+
+	//64 bits starting at an arbitrary bit offset within the output
+	auto extract = [&](size_t bit)
+	{
+		size_t word = bit / 64;
+		size_t shift = bit % 64;
+		if(shift == 0)
+			return out[word];
+		return (out[word] >> shift) | (out[word+1] << (64 - shift));
+	};
+
+	//Then generate the rest a whole word at a time
+	for(size_t i=nserial; i<nwords; i++)
+	{
+		size_t bit = i*64;
+		out[i] = extract(bit - lag1) ^ extract(bit - lag2);
+	}
+}
+
+/**
+	@brief Generates a PRBS sequence as packed bits
+
+	Large sequences are split into blocks which are generated in parallel, each starting from the state given by
+	JumpPRBS().
+
+	@param state	Initial LFSR state
+	@param poly		Polynomial
+	@param out		Output bits, LSB first. Must have room for nbits rounded up to a multiple of 64.
+	@param nbits	Number of bits to generate
+ */
+void PRBSGeneratorFilter::GeneratePRBS(uint32_t state, Polynomials poly, uint64_t* out, size_t nbits)
+{
+	size_t nwords = (nbits + 63) / 64;
+
+	const size_t blockwords = 65536;
+	size_t nblocks = (nwords + blockwords - 1) / blockwords;
+
+	#pragma omp parallel for if(nblocks > 1)
+	for(size_t i=0; i<nblocks; i++)
+	{
+		size_t start = i * blockwords;
+		size_t count = min(blockwords, nwords - start);
+		GeneratePRBSBlock(JumpPRBS(state, poly, start*64), poly, out + start, count);
+	}
+}
+
+/**
+	@brief Expands packed bits (LSB first) to an array of bools
+ */
+void PRBSGeneratorFilter::Unpack(const uint64_t* in, bool* out, size_t nbits)
+{
+	#pragma omp parallel for if(nbits > 1000000)
+	for(size_t i=0; i<nbits; i+=64)
+	{
+		uint64_t w = in[i/64];
+		size_t n = min(static_cast<size_t>(64), nbits - i);
+		for(size_t j=0; j<n; j++)
+			out[i+j] = (w >> j) & 1;
+	}
+}
+
 void PRBSGeneratorFilter::Refresh()
 {
 	size_t depth = m_parameters[m_depthname].GetIntVal();
@@ -188,15 +372,17 @@ void PRBSGeneratorFilter::Refresh()
 	clk->m_startFemtoseconds = fs;
 	clk->Resize(depth);
 
-	bool lastclk = false;
-	uint32_t prbs = rand();
+	//Clock toggles every bit, starting low
+	auto pclk = clk->m_samples.GetCpuPointer();
+	#pragma omp parallel for if(depth > 1000000)
 	for(size_t i=0; i<depth; i++)
-	{
-		clk->m_samples[i] = lastclk;
-		lastclk = !lastclk;
+		pclk[i] = (i & 1);
 
-		dat->m_samples[i] = RunPRBS(prbs, poly);
-	}
+	//Generate the data packed, then expand it
+	uint32_t prbs = rand();
+	vector<uint64_t> packed((depth + 63) / 64);
+	GeneratePRBS(prbs, poly, packed.data(), depth);
+	Unpack(packed.data(), dat->m_samples.GetCpuPointer(), depth);
 
 	clk->MarkModifiedFromCpu();
 	dat->MarkModifiedFromCpu();
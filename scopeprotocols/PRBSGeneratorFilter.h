@@ -60,6 +60,13 @@ public:
 	};
 
 	static bool RunPRBS(uint32_t& state, Polynomials poly);
+	static uint32_t JumpPRBS(uint32_t state, Polynomials poly, uint64_t steps);
+	static void GeneratePRBS(uint32_t state, Polynomials poly, uint64_t* out, size_t nbits);
+	static void Unpack(const uint64_t* in, bool* out, size_t nbits);
+
+protected:
+	static void GetTaps(Polynomials poly, unsigned int& tap1, unsigned int& tap2);
+	static void GeneratePRBSBlock(uint32_t state, Polynomials poly, uint64_t* out, size_t nwords);
 
 protected:
 	std::string m_baudname;
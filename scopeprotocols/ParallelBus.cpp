@@ -116,8 +116,10 @@ void ParallelBus::Refresh()
 	#pragma omp parallel for
 	for(size_t i=0; i<len; i++)
 	{
+		uint64_t bits = 0;
 		for(int j=0; j<width; j++)
-			cap->m_samples[i].push_back(inputs[j]->m_samples[i]);
+			bits |= static_cast<uint64_t>(inputs[j]->m_samples[i]) << j;
+		cap->m_samples[i] = DigitalBusSample(bits, width);
 	}
 	SetData(cap, 0);
 
@@ -68,6 +68,8 @@ string PeakHoldFilter::GetProtocolName()
 
 void PeakHoldFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(NULL, 0);
 }
 
@@ -85,19 +85,20 @@ void PeriodMeasurement::Refresh()
 	auto sadin = dynamic_cast<SparseAnalogWaveform*>(din);
 	auto uddin = dynamic_cast<UniformDigitalWaveform*>(din);
 	auto sddin = dynamic_cast<SparseDigitalWaveform*>(din);
-	vector<int64_t> edges;
+	EdgeList pedges;
 
 	//Auto-threshold analog signals at 50% of full scale range
 	if(uadin)
-		FindZeroCrossings(uadin, GetAvgVoltage(uadin), edges);
+		pedges = GetZeroCrossings(uadin, GetAvgVoltage(uadin));
 	else if(sadin)
-		FindZeroCrossings(sadin, GetAvgVoltage(sadin), edges);
+		pedges = GetZeroCrossings(sadin, GetAvgVoltage(sadin));
 
 	//Just find edges in digital signals
 	else if(uddin)
-		FindZeroCrossings(uddin, edges);
+		pedges = GetZeroCrossings(uddin);
 	else
-		FindZeroCrossings(sddin, edges);
+		pedges = GetZeroCrossings(sddin);
+	auto& edges = *pedges;
 
 	//We need at least one full cycle of the waveform to have a meaningful frequency
 	if(edges.size() < 2)
@@ -80,6 +80,8 @@ string RISFilter::GetProtocolName()
 
 void RISFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(nullptr, 0);
 }
 
@@ -70,6 +70,12 @@ string ScalarPulseDelayFilter::GetProtocolName()
 	return "Scalar Pulse Delay";
 }
 
+bool ScalarPulseDelayFilter::IsRefreshAlwaysRequired()
+{
+	//Need to check for timeout even if the input didn't change
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Actual decoder logic
 
@@ -157,18 +157,14 @@ void SpectrogramFilter::ReallocateBuffers(size_t fftlen, size_t nblocks)
 	m_cachedFFTNumBlocks = nblocks;
 
 	size_t nouts = fftlen/2 + 1;
-	if(m_vkPlan)
-	{
-		if(m_vkPlan->size() != fftlen)
-			m_vkPlan = nullptr;
-	}
-	if(!m_vkPlan)
-		m_vkPlan = make_unique<VulkanFFTPlan>(fftlen, nouts, VulkanFFTPlan::DIRECTION_FORWARD, nblocks);
-
-	m_rdinbuf.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_rdinbuf.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
-	m_rdoutbuf.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
-	m_rdoutbuf.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
+	FFTPlan::Update(m_plan, fftlen, nouts, FFTPlan::DIRECTION_FORWARD, nblocks);
+
+	auto cpuHint = g_gpuFilterEnabled ? AcceleratorBuffer<float>::HINT_NEVER : AcceleratorBuffer<float>::HINT_LIKELY;
+	auto gpuHint = g_gpuFilterEnabled ? AcceleratorBuffer<float>::HINT_LIKELY : AcceleratorBuffer<float>::HINT_NEVER;
+	m_rdinbuf.SetCpuAccessHint(cpuHint);
+	m_rdinbuf.SetGpuAccessHint(gpuHint);
+	m_rdoutbuf.SetCpuAccessHint(cpuHint);
+	m_rdoutbuf.SetGpuAccessHint(gpuHint);
 }
 
 FlowGraphNode::DataLocation SpectrogramFilter::GetInputLocation()
@@ -192,7 +188,8 @@ void SpectrogramFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Queu
 	size_t fftlen = m_parameters[m_fftLengthName].GetIntVal();
 	size_t nblocks = floor(inlen * 1.0 / fftlen);
 
-	if( (fftlen != m_cachedFFTLength) || (nblocks != m_cachedFFTNumBlocks) )
+	if( (fftlen != m_cachedFFTLength) || (nblocks != m_cachedFFTNumBlocks) ||
+		!m_plan || (m_plan->IsGpuPlan() != g_gpuFilterEnabled) )
 		ReallocateBuffers(fftlen, nblocks);
 
 	//Figure out range of the FFTs
@@ -238,7 +235,8 @@ void SpectrogramFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Queu
 	cap->m_startFemtoseconds = din->m_startFemtoseconds;
 	cap->m_triggerPhase = din->m_triggerPhase;
 	cap->m_timescale = fs_per_sample * fftlen;
-	cap->PrepareForGpuAccess();
+	if(g_gpuFilterEnabled)
+		cap->PrepareForGpuAccess();
 	SetData(cap, 0);
 
 	//We also need to adjust the scale by the coherent power gain of the window function
@@ -312,54 +310,105 @@ void SpectrogramFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Queu
 	float fullscale = m_parameters[m_rangeMaxName].GetFloatVal();
 	float range = fullscale - minscale;
 
-	//Prepare to do all of our compute stuff in one dispatch call to reduce overhead
-	cmdBuf.begin({});
-
-	//Grab the input and apply the window function
-	wpipe->BindBufferNonblocking(0, din->m_samples, cmdBuf);
-	wpipe->BindBufferNonblocking(1, m_rdinbuf, cmdBuf, true);
-	for(size_t block=0; block<nblocks; block++)
+	if(g_gpuFilterEnabled)
 	{
-		args.offsetIn = block*fftlen;
-		args.offsetOut = block*fftlen;
+		//Prepare to do all of our compute stuff in one dispatch call to reduce overhead
+		cmdBuf.begin({});
 
-		if(block == 0)
-			wpipe->Dispatch(cmdBuf, args, GetComputeBlockCount(fftlen, 64));
-		else
-			wpipe->DispatchNoRebind(cmdBuf, args, GetComputeBlockCount(fftlen, 64));
+		//Grab the input and apply the window function
+		wpipe->BindBufferNonblocking(0, din->m_samples, cmdBuf);
+		wpipe->BindBufferNonblocking(1, m_rdinbuf, cmdBuf, true);
+		for(size_t block=0; block<nblocks; block++)
+		{
+			args.offsetIn = block*fftlen;
+			args.offsetOut = block*fftlen;
+
+			if(block == 0)
+				wpipe->Dispatch(cmdBuf, args, GetComputeBlockCount(fftlen, 64));
+			else
+				wpipe->DispatchNoRebind(cmdBuf, args, GetComputeBlockCount(fftlen, 64));
+		}
+		wpipe->AddComputeMemoryBarrier(cmdBuf);
+
+		//Do the actual FFT
+		m_plan->AppendForward(
+			m_rdinbuf,
+			m_rdoutbuf,
+			cmdBuf);
+
+		//Postprocess the output
+		const float impedance = 50;
+		SpectrogramPostprocessArgs postargs;
+		postargs.nblocks = nblocks;
+		postargs.nouts = nouts;
+		postargs.logscale = 10.0 / log(10);
+		postargs.impscale = scale*scale / impedance;
+		postargs.minscale = minscale;
+		postargs.irange = 1.0 / range;
+		postargs.ygrid = min(g_maxComputeGroupCount[2], nblocks);
+		m_postprocessComputePipeline.AddComputeMemoryBarrier(cmdBuf);
+		m_postprocessComputePipeline.BindBufferNonblocking(0, m_rdoutbuf, cmdBuf);
+		m_postprocessComputePipeline.BindBufferNonblocking(1, cap->GetOutData(), cmdBuf, true);
+		m_postprocessComputePipeline.Dispatch(
+			cmdBuf,
+			postargs,
+			GetComputeBlockCount(nouts, 64),
+			ceil(nblocks * 1.0 / postargs.ygrid),
+			postargs.ygrid
+			);
+
+		//Done, block until the compute operations finish
+		cmdBuf.end();
+		queue->SubmitAndBlock(cmdBuf);
+
+		cap->MarkModifiedFromGpu();
+	}
+
+	else
+	{
+		//Grab the input and apply the window function
+		din->m_samples.PrepareForCpuAccess();
+		m_rdinbuf.PrepareForCpuAccess();
+		#pragma omp parallel for
+		for(size_t block=0; block<nblocks; block++)
+		{
+			WindowFunctionArgs bargs = args;
+			bargs.offsetIn = block*fftlen;
+			bargs.offsetOut = block*fftlen;
+			FFTFilter::ApplyWindowFunction(
+				din->m_samples.GetCpuPointer(), m_rdinbuf.GetCpuPointer(), window, bargs);
+		}
+		m_rdinbuf.MarkModifiedFromCpu();
+
+		//Do the actual FFT
+		m_plan->AppendForward(
+			m_rdinbuf,
+			m_rdoutbuf,
+			cmdBuf);
+
+		//Postprocess the output (same math as SpectrogramPostprocess.glsl)
+		const float impedance = 50;
+		const float logscale = 10.0 / log(10);
+		const float impscale = scale*scale / impedance;
+		const float irange = 1.0 / range;
+		auto& outdata = cap->GetOutData();
+		outdata.PrepareForCpuAccess();
+		const float* fin = m_rdoutbuf.GetCpuPointer();
+		float* fout = outdata.GetCpuPointer();
+		#pragma omp parallel for
+		for(size_t x=0; x<nouts; x++)
+		{
+			for(size_t y=0; y<nblocks; y++)
+			{
+				size_t nin = (nouts*y + x)*2;
+				float vsq = fin[nin]*fin[nin] + fin[nin + 1]*fin[nin + 1];
+				float dbm = logscale * log(vsq * impscale) + 30;
+				if(dbm < minscale)
+					fout[x*nblocks + y] = 0;
+				else
+					fout[x*nblocks + y] = (dbm - minscale) * irange;
+			}
+		}
+		outdata.MarkModifiedFromCpu();
 	}
-	wpipe->AddComputeMemoryBarrier(cmdBuf);
-
-	//Do the actual FFT
-	m_vkPlan->AppendForward(
-		m_rdinbuf,
-		m_rdoutbuf,
-		cmdBuf);
-
-	//Postprocess the output
-	const float impedance = 50;
-	SpectrogramPostprocessArgs postargs;
-	postargs.nblocks = nblocks;
-	postargs.nouts = nouts;
-	postargs.logscale = 10.0 / log(10);
-	postargs.impscale = scale*scale / impedance;
-	postargs.minscale = minscale;
-	postargs.irange = 1.0 / range;
-	postargs.ygrid = min(g_maxComputeGroupCount[2], nblocks);
-	m_postprocessComputePipeline.AddComputeMemoryBarrier(cmdBuf);
-	m_postprocessComputePipeline.BindBufferNonblocking(0, m_rdoutbuf, cmdBuf);
-	m_postprocessComputePipeline.BindBufferNonblocking(1, cap->GetOutData(), cmdBuf, true);
-	m_postprocessComputePipeline.Dispatch(
-		cmdBuf,
-		postargs,
-		GetComputeBlockCount(nouts, 64),
-		ceil(nblocks * 1.0 / postargs.ygrid),
-		postargs.ygrid
-		);
-
-	//Done, block until the compute operations finish
-	cmdBuf.end();
-	queue->SubmitAndBlock(cmdBuf);
-
-	cap->MarkModifiedFromGpu();
 }
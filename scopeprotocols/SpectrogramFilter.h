@@ -127,7 +127,7 @@ protected:
 	std::string m_rangeMinName;
 	std::string m_rangeMaxName;
 
-	std::unique_ptr<VulkanFFTPlan> m_vkPlan;
+	std::unique_ptr<FFTPlan> m_plan;
 
 	ComputePipeline m_blackmanHarrisComputePipeline;
 	ComputePipeline m_rectangularComputePipeline;
@@ -214,7 +214,7 @@ void SubtractFilter::DoRefreshVectorVector(vk::raii::CommandBuffer& cmdBuf, std:
 	}
 
 	//Just regular subtraction, use the GPU filter
-	else
+	else if(g_gpuFilterEnabled)
 	{
 		cmdBuf.begin({});
 
@@ -239,6 +239,30 @@ void SubtractFilter::DoRefreshVectorVector(vk::raii::CommandBuffer& cmdBuf, std:
 		else
 			ucap->m_samples.MarkModifiedFromGpu();
 	}
+
+	//CPU fallback
+	else
+	{
+		din_p->PrepareForCpuAccess();
+		din_n->PrepareForCpuAccess();
+		if(scap)
+			scap->PrepareForCpuAccess();
+		else
+			ucap->PrepareForCpuAccess();
+
+		float* out = scap ? scap->m_samples.GetCpuPointer() : ucap->m_samples.GetCpuPointer();
+		float* a = sdin_p ? sdin_p->m_samples.GetCpuPointer() : udin_p->m_samples.GetCpuPointer();
+		float* b = sdin_n ? sdin_n->m_samples.GetCpuPointer() : udin_n->m_samples.GetCpuPointer();
+
+		#pragma omp parallel for
+		for(size_t i=0; i<len; i++)
+			out[i] = a[i + offsetP] - b[i + offsetN];
+
+		if(scap)
+			scap->m_samples.MarkModifiedFromCpu();
+		else
+			ucap->m_samples.MarkModifiedFromCpu();
+	}
 }
 
 void SubtractFilter::DoRefreshScalarVector(size_t iScalar, size_t iVector)
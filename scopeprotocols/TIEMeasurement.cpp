@@ -139,7 +139,7 @@ void TIEMeasurement::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHa
 	if(pcdr && (fabs(pcdr->GetThreshold() - threshold) < 0.01) && (pcdr->GetInput(0) == GetInput(0)) && uaclk)
 		m_clockEdgesMuxed = &pcdr->GetZeroCrossings();
 
-	//Normal fast path: GPU edge detection on uniform input
+	//Normal fast path: GPU edge detection on uniform input (falls back to the CPU if we have no GPU)
 	else if(uaclk)
 	{
 		m_detector.FindZeroCrossings(uaclk, threshold, cmdBuf, queue);
@@ -167,7 +167,7 @@ void TIEMeasurement::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHa
 
 	//For each input clock edge, find the closest recovered clock edge
 	//Fast path: golden clock came from CDR filter and we have GPU native int64 support
-	if(g_hasShaderInt64 && pcdr && sgolden)
+	if(g_gpuFilterEnabled && g_hasShaderInt64 && pcdr && sgolden)
 	{
 		cmdBuf.begin({});
 
@@ -120,7 +120,7 @@ void ThresholdFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, std::shared_ptr<Q
 		//Optimized inner loop if no hysteresis
 		if(hys == 0)
 		{
-			if(g_hasShaderInt8)
+			if(g_gpuFilterEnabled && g_hasShaderInt8)
 			{
 				cmdBuf.begin({});
 
@@ -184,7 +184,7 @@ void ThresholdFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, std::shared_ptr<Q
 		//Optimized inner loop if no hysteresis
 		if(hys == 0)
 		{
-			if(g_hasShaderInt8)
+			if(g_gpuFilterEnabled && g_hasShaderInt8)
 			{
 				cmdBuf.begin({});
 
@@ -81,8 +81,16 @@ bool TrendFilter::ShouldPersistWaveform()
 	return true;
 }
 
+bool TrendFilter::IsRefreshAlwaysRequired()
+{
+	//We sample the input every time the graph runs, even if it hasn't changed
+	return true;
+}
+
 void TrendFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(nullptr, 0);
 }
 
@@ -48,6 +48,7 @@ public:
 
 	static std::string GetProtocolName();
 	virtual bool ShouldPersistWaveform() override;
+	virtual bool IsRefreshAlwaysRequired() override;
 
 	virtual bool ValidateChannel(size_t i, StreamDescriptor stream) override;
 
@@ -29,6 +29,8 @@
 
 #include "../scopehal/scopehal.h"
 #include "VCDImportFilter.h"
+#include "../scopehal/MappedFile.h"
+#include <charconv>
 
 using namespace std;
 
@@ -67,8 +69,11 @@ void VCDImportFilter::OnFileNameChanged()
 	int64_t fs = 0;
 	GetTimestampOfFile(fname, timestamp, fs);
 
-	FILE* fp = fopen(fname.c_str(), "r");
-	if(!fp)
+	double start = GetTime();
+
+	//Map the file rather than reading it line by line, simulation dumps can be many GB
+	MappedFile file;
+	if(!file.Open(fname))
 	{
 		LogError("Couldn't open VCD file \"%s\"\n", fname.c_str());
 		return;
@@ -96,30 +101,109 @@ void VCDImportFilter::OnFileNameChanged()
 	//Current scope prefix for signals
 	vector<string> scope;
 
-	//Map of signal IDs to signals
-	map<string, WaveformBase*> waveforms;
-	map<string, size_t> widths;
+	//Signals, and lookup table from identifier codes to signals
+	vector<Signal> signals;
+	SymbolTable symbols;
 
 	//VCD is a line based format, so process everything in lines
-	char buf[2048];
-	while(NULL != fgets(buf, sizeof(buf), fp))
+	const char* p = file.data();
+	const char* pend = file.end();
+	while(p < pend)
 	{
-		string s = Trim(buf);
+		//Find the end of the line and trim whitespace
+		const char* pline = p;
+		const char* nl = static_cast<const char*>(memchr(p, '\n', pend - p));
+		const char* lend = nl ? nl : pend;
+		p = nl ? (nl + 1) : pend;
+
+		while( (pline < lend) && isspace(*pline) )
+			pline ++;
+		while( (lend > pline) && isspace(lend[-1]) )
+			lend --;
+		if(pline == lend)
+			continue;
 
 		//Changing time is always legal, even before we get to the main variable dumping section.
 		//(Xilinx Vivado-generated VCDs include a #0 before the $dumpvars section.)
-		if(s[0] == '#')
+		if(pline[0] == '#')
 		{
-			current_time = stoll(buf+1);
+			from_chars(pline+1, lend, current_time);
 			continue;
 		}
 
+		//Value changes are the overwhelming majority of the file, handle them without any string allocation
+		if( ( (state == STATE_INITIAL) || (state == STATE_DUMP) ) && (pline[0] != '$') )
+		{
+			//Vector: first char is 'b', then data, space, symbol name
+			if( (pline[0] == 'b') || (pline[0] == 'B') )
+			{
+				const char* bits = pline + 1;
+				const char* bitsEnd = static_cast<const char*>(memchr(bits, ' ', lend - bits));
+				if(!bitsEnd)
+					continue;
+				const char* symbol = bitsEnd;
+				while( (symbol < lend) && isspace(*symbol) )
+					symbol ++;
+
+				auto idx = symbols.Find(symbol, lend - symbol);
+				if( (idx < 0) || (!signals[idx].m_bus && !signals[idx].m_wideBus) )
+				{
+					LogError("Symbol \"%s\" is not a valid digital bus waveform\n", string(symbol, lend).c_str());
+					continue;
+				}
+				auto& sig = signals[idx];
+				size_t nbits = min(static_cast<size_t>(bitsEnd - bits), sig.m_width);
+
+				//Buses too wide to pack get one bit vector per sample, LSB first, zero padded out to full width
+				if(sig.m_wideBus)
+				{
+					vector<bool> sample(sig.m_width);
+					for(size_t i=0; i<nbits; i++)
+						sample[i] = (bitsEnd[-1 - static_cast<ssize_t>(i)] == '1');
+
+					sig.m_wideBus->m_offsets.push_back_nomarkmod(current_time);
+					sig.m_wideBus->m_samples.push_back_nomarkmod(sample);
+					continue;
+				}
+
+				//Pack the sample data LSB first (rightmost character is bit 0), zero padded out to full width
+				uint64_t word = 0;
+				for(size_t i=0; i<nbits; i++)
+				{
+					if(bitsEnd[-1 - static_cast<ssize_t>(i)] == '1')
+						word |= (1ULL << i);
+				}
+
+				sig.m_bus->m_offsets.push_back_nomarkmod(current_time);
+				sig.m_bus->m_samples.push_back_nomarkmod(DigitalBusSample(word, sig.m_width));
+			}
+
+			//Scalar: first char is boolean value, rest is symbol name
+			else
+			{
+				auto idx = symbols.Find(pline + 1, lend - (pline + 1));
+				if( (idx < 0) || !signals[idx].m_digital)
+				{
+					LogError("Symbol \"%s\" is not a valid digital waveform\n", string(pline + 1, lend).c_str());
+					continue;
+				}
+				auto wfm = signals[idx].m_digital;
+
+				wfm->m_offsets.push_back_nomarkmod(current_time);
+				wfm->m_samples.push_back_nomarkmod(pline[0] == '1');
+			}
+
+			continue;
+		}
+
+		string s(pline, lend);
+
 		//Scope is a bit special since it can nest. Handle that separately.
-		else if(s.find("$scope") != string::npos)
+		if(s.find("$scope") != string::npos)
 		{
 			//Get the actual scope
 			char name[128];
-			if(1 == sscanf(buf, "$scope module %127s", name))
+			if(1 == sscanf(s.c_str(), "$scope module %127s", name))
 				scope.push_back(name);
 			state = STATE_VARS;
 			continue;
@@ -164,7 +248,7 @@ void VCDImportFilter::OnFileNameChanged()
 					char dow[16];
 					char month[16];
 					if(7 == sscanf(
-						buf,
+						s.c_str(),
 						"%3s %3s %d %d:%d:%d %d",
 						dow, month, &stamp.tm_mday, &stamp.tm_hour, &stamp.tm_min, &stamp.tm_sec, &stamp.tm_year))
 					{
@@ -239,12 +323,12 @@ void VCDImportFilter::OnFileNameChanged()
 					int width;
 					char symbol[16];
 					char name[128];
-					if(4 != sscanf(buf, " $var %15[^ ] %d %15[^ ] %127[^ ]", vtype, &width, symbol, name))
+					if(4 != sscanf(s.c_str(), " $var %15[^ ] %d %15[^ ] %127[^ ]", vtype, &width, symbol, name))
 						continue;
 
 					//If the symbol is already in use, skip it.
 					//We don't support one symbol with more than one name for now
-					if(waveforms.find(symbol) != waveforms.end())
+					if(symbols.Find(symbol, strlen(symbol)) >= 0)
 						continue;
 
 					//Create the stream
@@ -253,95 +337,38 @@ void VCDImportFilter::OnFileNameChanged()
 					//Create the waveform
 					WaveformBase* wfm;
 					if(width == 1)
-						wfm = new SparseDigitalWaveform;
+					{
+						auto dwfm = new SparseDigitalWaveform;
+						signals.push_back(Signal(width, dwfm, nullptr, nullptr));
+						wfm = dwfm;
+					}
+					else if(width > static_cast<int>(DigitalBusSample::MAX_WIDTH))
+					{
+						auto bwfm = new SparseWideDigitalBusWaveform;
+						signals.push_back(Signal(width, nullptr, nullptr, bwfm));
+						wfm = bwfm;
+					}
 					else
-						wfm = new SparseDigitalBusWaveform;
+					{
+						auto bwfm = new SparseDigitalBusWaveform;
+						signals.push_back(Signal(max(width, 1), nullptr, bwfm, nullptr));
+						wfm = bwfm;
+					}
 					wfm->PrepareForCpuAccess();
+					symbols.Add(symbol, signals.size() - 1);
 
 					wfm->m_timescale = timescale;
 					wfm->m_startTimestamp = timestamp;
 					wfm->m_startFemtoseconds = fs;
 					wfm->m_triggerPhase = 0;
-					waveforms[symbol] = wfm;
-					widths[symbol] = width;
 					SetData(wfm, m_streams.size() - 1);
 				}
 				break;	//end STATE_VARS
 
 			case STATE_INITIAL:
 			case STATE_DUMP:
-
-				//Parse the current line
-				if(s[0] != '$')
-				{
-					//Vector: first char is 'b', then data, space, symbol name
-					if(s[0] == 'b')
-					{
-						auto ispace = s.find(' ');
-						auto symbol = s.substr(ispace + 1);
-						auto wfm = dynamic_cast<SparseDigitalBusWaveform*>(waveforms[symbol]);
-						if(wfm)
-						{
-							//Parse the sample data (skipping the leading 'b')
-							vector<bool> sample;
-							for(size_t i = ispace-1; i > 0; i--)
-							{
-								if(s[i] == '1')
-									sample.push_back(true);
-								else
-									sample.push_back(false);
-							}
-
-							//Zero-pad the sample out to full width
-							auto width = widths[symbol];
-							while(sample.size() < width)
-								sample.push_back(false);
-
-							//Extend the previous sample, if there is one
-							auto len = wfm->size();
-							if(len)
-							{
-								auto last = len-1;
-								wfm->m_durations[last] = current_time - wfm->m_offsets[last];
-							}
-
-							//Add the new sample
-							wfm->m_offsets.push_back(current_time);
-							wfm->m_durations.push_back(1);
-							wfm->m_samples.push_back(sample);
-							wfm->MarkModifiedFromCpu();
-						}
-						else
-							LogError("Symbol \"%s\" is not a valid digital bus waveform\n", symbol.c_str());
-					}
-
-					//Scalar: first char is boolean value, rest is symbol name
-					else
-					{
-						auto symbol = s.substr(1);
-						auto wfm = dynamic_cast<SparseDigitalWaveform*>(waveforms[symbol]);
-						if(wfm)
-						{
-							//Extend the previous sample, if there is one
-							auto len = wfm->size();
-							if(len)
-							{
-								auto last = len-1;
-								wfm->m_durations[last] = current_time - wfm->m_offsets[last];
-							}
-
-							//Add the new sample
-							wfm->m_offsets.push_back(current_time);
-							wfm->m_durations.push_back(1);
-							wfm->m_samples.push_back(s[0] == '1');
-							wfm->MarkModifiedFromCpu();
-						}
-						else
-							LogError("Symbol \"%s\" is not a valid digital waveform\n", symbol.c_str());
-					}
-				}
-
-				break;	//end STATE_INITIAL / STATE_DUMP
+				//value changes are handled above, nothing else to do
+				break;
 
 			case STATE_COMMENT:
 			case STATE_DUMPALL:
@@ -358,7 +385,36 @@ void VCDImportFilter::OnFileNameChanged()
 				state = STATE_IDLE;
 		}
 	}
-	fclose(fp);
+
+	//Fill in sample durations now that everything is loaded, so each buffer is touched in bulk once
+	//rather than once per value change
+	for(auto& sig : signals)
+	{
+		SparseWaveformBase* wfm = sig.m_digital;
+		if(sig.m_bus)
+			wfm = sig.m_bus;
+		else if(sig.m_wideBus)
+			wfm = sig.m_wideBus;
+
+		//Each sample lasts until the next one
+		size_t len = wfm->m_offsets.size();
+		wfm->m_durations.resize(len);
+		auto offsets = wfm->m_offsets.GetCpuPointer();
+		auto durations = wfm->m_durations.GetCpuPointer();
+		#pragma omp parallel for if(len > 1000000)
+		for(size_t i=0; i<len; i++)
+		{
+			if(i+1 < len)
+				durations[i] = offsets[i+1] - offsets[i];
+			else
+				durations[i] = 1;
+		}
+
+		wfm->MarkModifiedFromCpu();
+	}
+
+	double dt = GetTime() - start;
+	LogTrace("VCD loading took %.3f sec (%.1f MB/s)\n", dt, file.size() / (dt * 1024 * 1024));
 
 	//Nothing to do if we didn't get any channels
 	if(m_streams.empty())
@@ -46,6 +46,95 @@ public:
 
 protected:
 	void OnFileNameChanged();
+
+	/**
+		@brief Lookup table from VCD identifier codes to signal indexes
+
+		Identifier codes are short strings of printable ASCII characters. Nearly every file uses codes of one or two
+		characters, which are looked up in a flat array. Longer codes fall back to a hash table.
+	 */
+	class SymbolTable
+	{
+	public:
+		SymbolTable()
+			: m_short(94 + 94*94, -1)
+		{}
+
+		/**
+			@brief Looks up an identifier code
+
+			@return Index of the signal, or -1 if not found
+		 */
+		int64_t Find(const char* id, size_t len) const
+		{
+			auto i = ShortIndex(id, len);
+			if(i >= 0)
+				return m_short[i];
+
+			auto it = m_long.find(std::string(id, len));
+			if(it == m_long.end())
+				return -1;
+			return it->second;
+		}
+
+		///@brief Adds an identifier code to the table
+		void Add(const std::string& id, int64_t index)
+		{
+			auto i = ShortIndex(id.c_str(), id.length());
+			if(i >= 0)
+				m_short[i] = index;
+			else
+				m_long[id] = index;
+		}
+
+	protected:
+
+		///@brief Returns the flat table index of a one or two character code, or -1 if it's longer
+		static int64_t ShortIndex(const char* id, size_t len)
+		{
+			if( (len == 1) && (id[0] >= '!') && (id[0] <= '~') )
+				return id[0] - '!';
+			else if( (len == 2) && (id[0] >= '!') && (id[0] <= '~') && (id[1] >= '!') && (id[1] <= '~') )
+				return 94 + (id[0] - '!')*94 + (id[1] - '!');
+			return -1;
+		}
+
+		///@brief Signal indexes for one and two character codes
+		std::vector<int64_t> m_short;
+
+		///@brief Signal indexes for longer codes
+		std::unordered_map<std::string, int64_t> m_long;
+	};
+
+	/**
+		@brief State of one signal while the file is being parsed
+	 */
+	class Signal
+	{
+	public:
+		Signal(
+			size_t width,
+			SparseDigitalWaveform* digital,
+			SparseDigitalBusWaveform* bus,
+			SparseWideDigitalBusWaveform* wideBus)
+			: m_width(width)
+			, m_digital(digital)
+			, m_bus(bus)
+			, m_wideBus(wideBus)
+		{}
+
+		///@brief Width of the signal, in bits
+		size_t m_width;
+
+		///@brief Output waveform for scalar signals
+		SparseDigitalWaveform* m_digital;
+
+		///@brief Output waveform for buses up to DigitalBusSample::MAX_WIDTH bits wide
+		SparseDigitalBusWaveform* m_bus;
+
+		///@brief Output waveform for buses too wide to pack into a DigitalBusSample
+		SparseWideDigitalBusWaveform* m_wideBus;
+	};
 };
 
 #endif
@@ -116,6 +116,39 @@ void VectorFrequencyFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<
 	cfg.len = len - 1;	//need two samples for deltas
 	cfg.scale = sample_hz / (2 * M_PI);
 
+	if(!g_gpuFilterEnabled)
+	{
+		din_i->PrepareForCpuAccess();
+		din_q->PrepareForCpuAccess();
+		dout->PrepareForCpuAccess();
+
+		float* pi = din_i->m_samples.GetCpuPointer();
+		float* pq = din_q->m_samples.GetCpuPointer();
+		float* out = dout->m_samples.GetCpuPointer();
+		float scale = cfg.scale;
+		size_t nout = (len > 1) ? (len - 1) : 0;
+		#pragma omp parallel for
+		for(size_t i=0; i<nout; i++)
+		{
+			float dphase = atan2f(pq[i+1], pi[i+1]) - atan2f(pq[i], pi[i]);
+			if(dphase < -M_PI)
+				dphase += 2*M_PI;
+			if(dphase > M_PI)
+				dphase -= 2*M_PI;
+
+			out[i] = dphase * scale;
+		}
+
+		//Last sample has no successor to take a delta against, just hold the previous value
+		if(len > 1)
+			out[len-1] = out[len-2];
+		else if(len == 1)
+			out[0] = 0;
+
+		dout->m_samples.MarkModifiedFromCpu();
+		return;
+	}
+
 	cmdBuf.begin({});
 
 	m_computePipeline.BindBufferNonblocking(0, din_i->m_samples, cmdBuf);
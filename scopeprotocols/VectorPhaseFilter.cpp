@@ -118,6 +118,24 @@ void VectorPhaseFilter::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<Queu
 	cfg.len = len;
 	cfg.scale = 180 / M_PI;
 
+	if(!g_gpuFilterEnabled)
+	{
+		din_i->PrepareForCpuAccess();
+		din_q->PrepareForCpuAccess();
+		dout->PrepareForCpuAccess();
+
+		float* pi = din_i->m_samples.GetCpuPointer();
+		float* pq = din_q->m_samples.GetCpuPointer();
+		float* out = dout->m_samples.GetCpuPointer();
+		float scale = cfg.scale;
+		#pragma omp parallel for
+		for(size_t i=0; i<len; i++)
+			out[i] = atan2f(pq[i], pi[i]) * scale;
+
+		dout->m_samples.MarkModifiedFromCpu();
+		return;
+	}
+
 	cmdBuf.begin({});
 
 	m_computePipeline.BindBufferNonblocking(0, din_i->m_samples, cmdBuf);
@@ -40,11 +40,10 @@ WaterfallWaveform::WaterfallWaveform(size_t width, size_t height)
 	: DensityFunctionWaveform(width, height)
 	, m_tempBuf("WaterfallWaveform.m_tempBuf")
 {
-	//Temporary buffer is GPU-only
+	//Temporary buffer is GPU-only, the CPU path scrolls in place and doesn't need it.
+	//It's allocated on first use by the GPU path.
 	m_tempBuf.SetCpuAccessHint(AcceleratorBuffer<float>::HINT_NEVER);
 	m_tempBuf.SetGpuAccessHint(AcceleratorBuffer<float>::HINT_LIKELY);
-
-	m_tempBuf.resize(width*height);
 }
 
 WaterfallWaveform::~WaterfallWaveform()
@@ -113,6 +112,8 @@ string Waterfall::GetProtocolName()
 
 void Waterfall::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(nullptr, 0);
 }
 
@@ -164,7 +165,40 @@ void Waterfall::Refresh(vk::raii::CommandBuffer& cmdBuf, shared_ptr<QueueHandle>
 	//TODO: is this OK or are we going to lose too much precision doing this?
 	args.timescaleRatio = cap->m_timescale * 1.0 / din->m_timescale;
 
+	if(!g_gpuFilterEnabled)
+	{
+		din->PrepareForCpuAccess();
+		auto& outdata = cap->GetOutData();
+		outdata.PrepareForCpuAccess();
+
+		float* in = din->m_samples.GetCpuPointer();
+		float* out = outdata.GetCpuPointer();
+
+		//Lower rows move down
+		memmove(out, out + m_width, (m_height - 1) * m_width * sizeof(float));
+
+		//Topmost row gets new content
+		float* top = out + (m_height - 1) * m_width;
+		float vmin = 1.0 / 255.0;
+		#pragma omp parallel for
+		for(size_t x=0; x<m_width; x++)
+		{
+			size_t binMin = round(x * args.timescaleRatio);
+			size_t binMax = round((x+1) * args.timescaleRatio) - 1;
+
+			float maxAmplitude = vmin;
+			for(size_t i=binMin; (i <= binMax) && (i < inlen); i++)
+				maxAmplitude = max(maxAmplitude, 1 - ( (in[i] - args.vfs) / -args.vrange));
+			top[x] = maxAmplitude;
+		}
+
+		outdata.MarkModifiedFromCpu();
+		return;
+	}
+
 	//Make sure input is ready
+	if(cap->m_tempBuf.size() != cap->GetOutData().size())
+		cap->m_tempBuf.resize(cap->GetOutData().size());
 	din->PrepareForGpuAccess();
 	cap->PrepareForGpuAccess();
 	cap->m_tempBuf.PrepareForGpuAccess();
@@ -0,0 +1,118 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* libscopeprotocols                                                                                                    *
+*                                                                                                                      *
+* Copyright (c) 2012-2026 Andrew D. Zonenberg and contributors                                                         *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+/**
+	@file
+	@brief Implementation of WaveformFileImportFilter
+ */
+
+#include "../scopehal/scopehal.h"
+#include "WaveformFileImportFilter.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Construction / destruction
+
+WaveformFileImportFilter::WaveformFileImportFilter(const string& color)
+	: ImportFilter(color)
+{
+	m_fpname = "Waveform File";
+
+	m_parameters[m_fpname] = FilterParameter(FilterParameter::TYPE_FILENAME, Unit(Unit::UNIT_COUNTS));
+	m_parameters[m_fpname].m_fileFilterMask = "*.scopewfm";
+	m_parameters[m_fpname].m_fileFilterName = "Native waveform files (*.scopewfm)";
+	m_parameters[m_fpname].signal_changed().connect(
+		sigc::mem_fun(*this, &WaveformFileImportFilter::OnFileNameChanged));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Accessors
+
+string WaveformFileImportFilter::GetProtocolName()
+{
+	return "Waveform File Import";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Actual decoder logic
+
+void WaveformFileImportFilter::OnFileNameChanged()
+{
+	auto fname = m_parameters[m_fpname].ToString();
+	if(fname.empty())
+		return;
+
+	WaveformFileReader reader;
+	if(!reader.Open(fname))
+		return;
+
+	//Set up one output stream per channel in the file
+	ClearStreams();
+	size_t nchans = reader.GetChannelCount();
+	for(size_t i=0; i<nchans; i++)
+	{
+		if(reader.IsDigital(i))
+			AddDigitalStream(reader.GetChannelName(i));
+		else
+			AddStream(reader.GetYAxisUnits(i), reader.GetChannelName(i), Stream::STREAM_TYPE_ANALOG);
+	}
+	if(nchans > 0)
+		SetXAxisUnits(reader.GetXAxisUnits(0));
+
+	//Load the data. Sample buffers stay mapped from the file after the reader is closed.
+	for(size_t i=0; i<nchans; i++)
+		SetData(reader.LoadWaveform(i), i);
+
+	m_outputsChangedSignal.emit();
+
+	float max_range = 0.0;
+	float max_offset = 0.0;
+	for(size_t i=0; i<nchans; i++)
+	{
+		if(reader.IsDigital(i))
+			continue;
+
+		AutoscaleVertical(i);
+		if(max_range < GetVoltageRange(i))
+		{
+			max_offset = GetOffset(i);
+			max_range = GetVoltageRange(i);
+		}
+	}
+
+	for(size_t i=0; i<nchans; i++)
+	{
+		if(reader.IsDigital(i))
+			continue;
+
+		SetOffset(max_offset, i);
+		SetVoltageRange(max_range * 1.05, i);
+	}
+}
@@ -29,6 +29,7 @@
 
 #include "../scopehal/scopehal.h"
 #include <complex>
+#include <omp.h>
 #include "WindowedAutocorrelationFilter.h"
 
 using namespace std;
@@ -95,15 +96,15 @@ void WindowedAutocorrelationFilter::Refresh()
 	SetYAxisUnits(m_inputs[0].GetYAxisUnits(), 0);
 
 	//Convert window and period to samples
-	int window_ps = m_parameters[m_windowName].GetIntVal();
-	size_t window_samples = window_ps / din_i->m_timescale;
-	int period_ps = m_parameters[m_periodName].GetIntVal();
-	size_t period_samples = period_ps / din_i->m_timescale;
+	int64_t window_fs = m_parameters[m_windowName].GetIntVal();
+	size_t window_samples = window_fs / din_i->m_timescale;
+	int64_t period_fs = m_parameters[m_periodName].GetIntVal();
+	size_t period_samples = period_fs / din_i->m_timescale;
 	window_samples = min(window_samples, period_samples);
 
 	//We need meaningful data, bail if it's too short
 	auto len = min(din_i->m_samples.size(), din_q->m_samples.size());
-	if(len < period_samples)
+	if( (len < 2*period_samples) || (window_samples == 0) )
 	{
 		SetData(NULL, 0);
 		return;
@@ -115,24 +116,57 @@ void WindowedAutocorrelationFilter::Refresh()
 	cap->PrepareForCpuAccess();
 	cap->Resize(end);
 
-	for(size_t i=0; i < end; i ++)
+	/*
+		Each output point is the sum of z[k] * z[k + period] over a sliding window. Rather than recomputing the whole
+		window for every point (O(N * window)), take a running sum of the products and difference it, which is O(N)
+		regardless of window size. The prefix sum is done in double precision so the difference of two large sums
+		still has plenty of precision.
+	 */
+	size_t nprod = end + window_samples;
+	m_prefix.resize(nprod + 1);
+	auto pi = din_i->m_samples.GetCpuPointer();
+	auto pq = din_q->m_samples.GetCpuPointer();
+	auto prefix = m_prefix.data();
+
+	//Compute the products and a prefix sum within each block in parallel
+	size_t nblocks = omp_get_max_threads();
+	size_t blocksize = (nprod + nblocks - 1) / nblocks;
+	vector<complex<double>> blocksums(nblocks + 1, 0);
+	#pragma omp parallel for
+	for(size_t b=0; b<nblocks; b++)
 	{
-		complex<float> total = 0;
-		for(size_t j=0; j<window_samples; j++)
+		size_t start = b * blocksize;
+		size_t stop = min(start + blocksize, nprod);
+		complex<double> total = 0;
+		for(size_t k=start; k<stop; k++)
 		{
-			size_t first = i + j;
-			size_t second = first + period_samples;
-
-			complex<float> a(din_i->m_samples[first], din_q->m_samples[first]);
-			complex<float> b(din_i->m_samples[second], din_q->m_samples[second]);
-
-			total += a*b;
+			complex<float> a(pi[k], pq[k]);
+			complex<float> c(pi[k + period_samples], pq[k + period_samples]);
+			total += complex<double>(a*c);
+			prefix[k+1] = total;
 		}
+		blocksums[b+1] = total;
+	}
 
-		float v = abs(total) / window_samples;
-
-		cap->m_samples[i] = v;
+	//Propagate the block totals so the prefix sum covers the whole waveform
+	prefix[0] = 0;
+	for(size_t b=1; b<=nblocks; b++)
+		blocksums[b] += blocksums[b-1];
+	#pragma omp parallel for
+	for(size_t b=1; b<nblocks; b++)
+	{
+		size_t start = b * blocksize;
+		size_t stop = min(start + blocksize, nprod);
+		for(size_t k=start; k<stop; k++)
+			prefix[k+1] += blocksums[b];
 	}
 
+	//Each output is the magnitude of the windowed sum
+	float* out = cap->m_samples.GetCpuPointer();
+	float scale = 1.0f / window_samples;
+	#pragma omp parallel for
+	for(size_t i=0; i<end; i++)
+		out[i] = abs(prefix[i + window_samples] - prefix[i]) * scale;
+
 	cap->MarkModifiedFromCpu();
 }
@@ -35,6 +35,8 @@
 #ifndef WindowedAutocorrelationFilter_h
 #define WindowedAutocorrelationFilter_h
 
+#include <complex>
+
 class WindowedAutocorrelationFilter : public Filter
 {
 public:
@@ -51,6 +53,9 @@ public:
 protected:
 	std::string m_windowName;
 	std::string m_periodName;
+
+	///@brief Running sum of z[k] * z[k + period]
+	std::vector<std::complex<double>> m_prefix;
 };
 
 #endif
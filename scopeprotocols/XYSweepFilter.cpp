@@ -80,6 +80,8 @@ string XYSweepFilter::GetProtocolName()
 
 void XYSweepFilter::ClearSweeps()
 {
+	Filter::ClearSweeps();
+
 	SetData(nullptr, 0);
 }
 
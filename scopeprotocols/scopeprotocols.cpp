@@ -237,6 +237,7 @@ void ScopeProtocolStaticInit()
 	AddDecoderClass(VerticalBathtub);
 	AddDecoderClass(VICPDecoder);
 	AddDecoderClass(Waterfall);
+	AddDecoderClass(WaveformFileImportFilter);
 	AddDecoderClass(WAVImportFilter);
 	AddDecoderClass(WFMImportFilter);
 	AddDecoderClass(WindowedAutocorrelationFilter);
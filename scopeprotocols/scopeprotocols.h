@@ -237,6 +237,7 @@
 #include "VerticalBathtub.h"
 #include "VICPDecoder.h"
 #include "Waterfall.h"
+#include "WaveformFileImportFilter.h"
 #include "WAVImportFilter.h"
 #include "WFMImportFilter.h"
 #include "WindowedAutocorrelationFilter.h"